@@ -0,0 +1,49 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <stddef.h>
+#include "parser.h"
+
+#define DEFAULT_CACHE_CAPACITY 4096
+// 记录最近出现过一次的键（只存哈希），交互模式据此决定是否把一行解析并放入缓存
+#define CACHE_SEEN_SLOTS 256
+
+// 缓存条目：同时挂在哈希桶链与 LRU 双向链表上
+typedef struct CacheEntry {
+    char* key;
+    AstPool pool;                   // 缓存独占的节点池
+    NodeId root;
+    struct CacheEntry* prev;        // LRU 链表（头部为最近使用）
+    struct CacheEntry* next;
+    struct CacheEntry* bucket_next; // 哈希桶链
+} CacheEntry;
+
+// 以规范化输入文本为键、已解析 AST 为值的 LRU 缓存，查找/插入/淘汰均为 O(1)
+typedef struct {
+    CacheEntry** buckets;
+    size_t bucket_count;            // 2 的幂
+    CacheEntry* head;
+    CacheEntry* tail;
+    size_t size;
+    size_t capacity;
+    size_t hits;
+    size_t misses;
+    size_t evictions;
+    size_t seen[CACHE_SEEN_SLOTS];  // 按哈希直接映射，0 表示空槽
+} ExprCache;
+
+// 函数声明
+int init_cache(ExprCache* cache, size_t capacity);
+void free_cache(ExprCache* cache);
+void normalize_expression(const char* input, char* output, size_t output_size);
+// 命中时返回节点池并写入 *root，未命中返回 NULL
+const AstPool* cache_lookup(ExprCache* cache, const char* key, NodeId* root);
+// 成功时缓存接管 pool 中的节点（收缩到实际大小，*pool 置为空池）并返回缓存中的节点池；
+// 返回 NULL 时 pool 保持原样，由调用方释放
+const AstPool* cache_insert(ExprCache* cache, const char* key, AstPool* pool, NodeId root);
+// 键此前出现过（且尚未被同槽的其他键覆盖）时返回 1；否则记下该键并返回 0。不分配内存，
+// 哈希冲突只会让某一行提前或推迟进入缓存，不影响结果
+int cache_seen_before(ExprCache* cache, const char* key);
+void print_cache_stats(const ExprCache* cache);
+
+#endif // CACHE_H
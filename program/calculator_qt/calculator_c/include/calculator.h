@@ -11,9 +11,9 @@ typedef struct {
 
 // 函数声明
 void init_calculator(Calculator* calc);
-double evaluate(Calculator* calc, ASTNode* node);
+double evaluate(Calculator* calc, const AstPool* pool, NodeId node);
 double apply_operator(Calculator* calc, char op, double left, double right);
 double apply_unary_operator(Calculator* calc, char op, double operand);
-double apply_function(Calculator* calc, const char* func_name, double* args, int arg_count);
+double apply_function(Calculator* calc, int function, double* args, int arg_count);
 
 #endif // CALCULATOR_H
\ No newline at end of file
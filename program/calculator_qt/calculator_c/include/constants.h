@@ -12,6 +12,8 @@ typedef struct {
 // 函数声明
 int is_constant(const char* name);
 double get_constant_value(const char* name);
+// 常量在注册表中的编号，AST 节点以编号代替名称；未找到时返回 -1
+int find_constant(const char* name);
 int get_constants_count();
 Constant* get_constant_at(int index);
 
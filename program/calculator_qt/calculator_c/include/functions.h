@@ -14,8 +14,14 @@ typedef struct {
     int max_args;
 } Function;
 
+// 单次调用的最大参数个数，求值时参数放在栈上
+#define MAX_FUNCTION_ARGS 8
+
 // 函数声明
 int is_function(const char* name);
+// 函数在注册表中的编号，AST 节点以编号代替名称；未找到时返回 -1
+int find_function(const char* name);
+const Function* get_function_at(int index);
 FunctionPtr get_function(const char* name);
 int get_function_arg_count(const char* name);
 double evaluate_function(const char* name, double* args, int arg_count);
@@ -0,0 +1,65 @@
+#ifndef IDENTIFIERS_H
+#define IDENTIFIERS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "functions.h"
+
+// 标识符的种类（flags 中的位）
+#define IDENTIFIER_FUNCTION 0x1
+#define IDENTIFIER_CONSTANT 0x2
+
+// 函数或常量的描述符：一次查找即可得到求值所需的全部信息
+typedef struct {
+    const char* name;    // 空槽为 NULL
+    uint8_t length;
+    uint8_t flags;       // IDENTIFIER_FUNCTION 或 IDENTIFIER_CONSTANT
+    uint8_t min_args;
+    uint8_t max_args;
+    uint16_t index;      // 在 functions[] 或 constants[] 中的编号（AST 节点记录的编号）
+    FunctionPtr func;
+    double value;        // 常量的值
+} Identifier;
+
+// 完美哈希表（哈希加位移），由 tools/gen_identifier_table.c 在构建时根据 identifiers.def 生成：
+// 名称的哈希先选一个桶，桶的位移值再把哈希打散到槽位；生成器为每个桶挑选位移，使注册表中的名称两两落在不同槽位。
+// 槽数为不小于名称数两倍的 2 的幂，桶数约为名称数的一半；生成器对 300 个名称也在 1 毫秒内完成
+extern const uint32_t identifier_slot_mask;
+extern const uint32_t identifier_bucket_mask;
+extern const uint16_t identifier_displacements[];
+extern const Identifier identifier_slots[];
+
+// 生成器与查找共用的哈希：名称只遍历一次（32 位 FNV-1a）
+static inline uint32_t identifier_hash(const char* name, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (unsigned char)name[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// 以桶的位移值重新混合哈希（MurmurHash3 的 fmix32），得到槽位
+static inline uint32_t identifier_slot(uint32_t hash, uint32_t displacement) {
+    uint32_t x = hash ^ (displacement * 0x9e3779b9u);
+    x ^= x >> 16;
+    x *= 0x85ebca6bu;
+    x ^= x >> 13;
+    x *= 0xc2b2ae35u;
+    x ^= x >> 16;
+    return x;
+}
+
+// 按名称（不必以 '\0' 结尾）查找：只探查一个槽位并比较一次名称，未找到返回 NULL
+static inline const Identifier* lookup_identifier(const char* name, size_t length) {
+    uint32_t hash = identifier_hash(name, length);
+    uint32_t displacement = identifier_displacements[hash & identifier_bucket_mask];
+    const Identifier* slot = &identifier_slots[identifier_slot(hash, displacement) & identifier_slot_mask];
+    if (slot->length != length || slot->name == NULL || memcmp(slot->name, name, length) != 0) {
+        return NULL;
+    }
+    return slot;
+}
+
+#endif // IDENTIFIERS_H
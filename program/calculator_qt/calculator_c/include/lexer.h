@@ -2,6 +2,9 @@
 #define LEXER_H
 
 #include "error.h"
+#include "char_scan.h"
+#include "identifiers.h"
+#include <stdint.h>
 
 // Token类型枚举
 typedef enum {
@@ -15,18 +18,24 @@ typedef enum {
     TOKEN_ERROR
 } TokenType;
 
-// Token结构
+// Token结构（24 字节）：只记录词素在表达式中的位置与长度，不复制文本；名称可按 offset/length 从表达式读取
 typedef struct {
-    TokenType type;
-    double value;       // 当type为TOKEN_NUMBER时使用
-    char name[32];      // 当type为TOKEN_FUNCTION或TOKEN_CONSTANT时使用
+    uint8_t type;       // TokenType
     char op;            // 当type为TOKEN_OPERATOR时使用
+    uint32_t offset;    // 词素在表达式中的起始位置
+    uint32_t length;    // 词素的字节数
+    union {
+        double value;                 // 当type为TOKEN_NUMBER时使用
+        const Identifier* identifier; // 当type为TOKEN_FUNCTION或TOKEN_CONSTANT时使用：注册表中的描述符
+    };
 } Token;
 
 // 词法分析器结构
 typedef struct {
     const char* expression;
     int pos;
+    int length;         // 表达式长度，数字解析以此为边界
+    CharScanner scanner; // 字符类别位图，跳过空白与标识符时按 64 字节块查找
     Token current_token;
     CalcError error;
 } Lexer;
@@ -36,6 +45,27 @@ void init_lexer(Lexer* lexer, const char* expression);
 Token get_next_token(Lexer* lexer);
 void consume_token(Lexer* lexer);
 int is_operator(char c);
+
+// 一次扫描得到的记号数组，解析器按下标随意前瞻。不超过 TOKEN_INLINE_CAPACITY 个记号时放在结构体内，
+// 不分配堆内存；更长的输入改用按倍数增长的一块堆内存
+#define TOKEN_INLINE_CAPACITY 64
+
+typedef struct {
+    Token* heap;        // 为 NULL 时记号在 inline_tokens 中
+    uint32_t count;     // 含末尾的 TOKEN_END 或 TOKEN_ERROR
+    uint32_t capacity;
+    CalcError error;    // 词法错误，对应末尾的 TOKEN_ERROR
+    Token inline_tokens[TOKEN_INLINE_CAPACITY];
+} TokenArray;
+
+void init_token_array(TokenArray* tokens);
+void free_token_array(TokenArray* tokens);
+// 把整个表达式切分为记号，遇到 TOKEN_END 或 TOKEN_ERROR 为止（该记号也放入数组），之前的内容被覆盖。
+// 成功返回 1；内存不足返回 0，此时数组以 TOKEN_ERROR 结尾
+int tokenize(TokenArray* tokens, const char* expression);
+static inline const Token* token_data(const TokenArray* tokens) {
+    return tokens->heap != NULL ? tokens->heap : tokens->inline_tokens;
+}
 int is_whitespace(char c);
 
 #endif // LEXER_H
\ No newline at end of file
@@ -3,6 +3,8 @@
 
 #include "lexer.h"
 #include "error.h"
+#include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
 
 // AST节点类型枚举
@@ -14,46 +16,102 @@ typedef enum {
     NODE_CONSTANT
 } NodeType;
 
-// AST节点结构
-typedef struct ASTNode {
-    NodeType type;
+// 节点在 AstPool 中的下标；NODE_NONE 表示解析失败或空节点
+typedef uint32_t NodeId;
+#define NODE_NONE UINT32_MAX
+
+// 紧凑的 AST 节点（16 字节）：子节点以下标引用，函数与常量以注册表中的编号引用，不保存名称
+typedef struct {
+    uint8_t type;        // NodeType
+    char op;             // 二元、一元操作符
+    uint16_t id;         // 函数或常量的编号（见 find_function、find_constant）
+    uint32_t arg_count;  // 函数调用的参数个数
     union {
-        double value;  // 当type为NODE_NUMBER时使用
-        struct {
-            char op;
-            struct ASTNode* left;
-            struct ASTNode* right;
-        } binary_op;  // 当type为NODE_BINARY_OP时使用
+        double value;    // 当type为NODE_NUMBER时使用
         struct {
-            char op;
-            struct ASTNode* operand;
-        } unary_op;  // 当type为NODE_UNARY_OP时使用
-        struct {
-            char name[32];
-            struct ASTNode** args;
-            int arg_count;
-        } function_call;  // 当type为NODE_FUNCTION_CALL时使用
-        char constant_name[32];  // 当type为NODE_CONSTANT时使用
+            NodeId left;
+            NodeId right;
+        } binary_op;     // 当type为NODE_BINARY_OP时使用
+        NodeId operand;  // 当type为NODE_UNARY_OP时使用
+        uint32_t first_arg; // 当type为NODE_FUNCTION_CALL时使用：参数在 AstPool::args 中的起始下标
     } data;
 } ASTNode;
 
-// 解析器结构
+// 一次解析的节点池：节点与参数表各占一块连续内存，按倍数增长，逐个创建节点只是移动下标；
+// 整棵树随池一次释放（固定的几次 free，与节点数无关）。池可整体移交给表达式缓存
 typedef struct {
-    Lexer lexer;
-    CalcError error;
+    ASTNode* nodes;
+    uint32_t node_count;
+    uint32_t node_capacity;
+    NodeId* args;
+    uint32_t arg_count;
+    uint32_t arg_capacity;
+    NodeId* pending;     // 正在解析的函数调用已解析出的参数，嵌套调用共用，调用结束时整段移入 args
+    uint32_t pending_count;
+    uint32_t pending_capacity;
+} AstPool;
+
+// 括号、一元操作符与函数调用的嵌套层数上限：每层递归解析一次，过深的输入报告语法错误而不是耗尽调用栈。
+// 构建时可用 -DPARSER_MAX_NESTING=N 调整。同级运算串成的长链在循环中解析，不受此限制
+#ifndef PARSER_MAX_NESTING
+#define PARSER_MAX_NESTING 1000
+#endif
+
+// 解析器结构：记号在 init_parser 时一次切分完毕，按下标前瞻；节点池归解析器所有，
+// 由 free_parser 释放，或由调用方取走（见 cache_insert）
+typedef struct {
+    TokenArray tokens;
+    uint32_t position;   // 当前记号的下标，不会越过末尾的 TOKEN_END/TOKEN_ERROR
+    uint32_t nesting;    // 当前的 parse_factor 递归层数
+    CalcError error;     // 嵌套过深等解析器自身发现的错误，没有时 message 为空
+    AstPool pool;
 } Parser;
 
 // 函数声明
 void init_parser(Parser* parser, const char* expression);
-ASTNode* parse_expression(Parser* parser);
-ASTNode* parse_term(Parser* parser);
-ASTNode* parse_factor(Parser* parser);
-ASTNode* create_number_node(double value);
-ASTNode* create_binary_op_node(char op, ASTNode* left, ASTNode* right);
-ASTNode* create_unary_op_node(char op, ASTNode* operand);
-ASTNode* create_function_call_node(const char* name, ASTNode** args, int arg_count);
-ASTNode* create_constant_node(const char* name);
-void free_ast(ASTNode* node);
+void free_parser(Parser* parser);
+NodeId parse_expression(Parser* parser);
+NodeId parse_term(Parser* parser);
+NodeId parse_factor(Parser* parser);
+
+void init_ast_pool(AstPool* pool);
+// 释放池中的全部节点，之后池为空，可继续使用
+void free_ast_pool(AstPool* pool);
+// 把节点与参数表收缩到实际大小并释放临时参数栈，供长期持有（如缓存）的池使用
+void compact_ast_pool(AstPool* pool);
+// 节点与参数表占用的堆内存（字节）
+size_t ast_pool_bytes(const AstPool* pool);
+// 创建节点，内存不足时返回 NODE_NONE
+NodeId create_number_node(AstPool* pool, double value);
+NodeId create_binary_op_node(AstPool* pool, char op, NodeId left, NodeId right);
+NodeId create_unary_op_node(AstPool* pool, char op, NodeId operand);
+NodeId create_constant_node(AstPool* pool, int constant);
+// 函数调用的参数先逐个压入 pending（mark 为开始前的 pending_count），创建调用节点时整段移入参数表
+int push_pending_arg(AstPool* pool, NodeId arg);
+NodeId create_function_call_node(AstPool* pool, int function, uint32_t mark);
+static inline const ASTNode* ast_node(const AstPool* pool, NodeId id) {
+    return &pool->nodes[id];
+}
+static inline const NodeId* ast_args(const AstPool* pool, const ASTNode* node) {
+    return pool->args + node->data.first_arg;
+}
 int get_operator_precedence(char op);
 
+// 当前位置之后第 k 个记号（k = 0 为当前记号），越过末尾时返回末尾的 TOKEN_END/TOKEN_ERROR
+static inline const Token* parser_peek(const Parser* parser, uint32_t k) {
+    uint32_t index = parser->position + k;
+    uint32_t last = parser->tokens.count - 1;
+    return &token_data(&parser->tokens)[index < last ? index : last];
+}
+static inline const Token* parser_current(const Parser* parser) {
+    return parser_peek(parser, 0);
+}
+// 解析停在未完成的位置时，若当前记号是出错的记号，返回词法错误（如无效的数字），否则返回 NULL
+static inline const CalcError* parser_lexical_error(const Parser* parser) {
+    if (parser_current(parser)->type == TOKEN_ERROR && parser->tokens.error.message[0] != '\0') {
+        return &parser->tokens.error;
+    }
+    return NULL;
+}
+
 #endif // PARSER_H
\ No newline at end of file
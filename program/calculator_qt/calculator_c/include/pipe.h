@@ -0,0 +1,69 @@
+#ifndef PIPE_H
+#define PIPE_H
+
+#include <stddef.h>
+#include "cache.h"
+#include "error.h"
+
+#define PIPE_BLOCK_SIZE (1 << 20)
+
+// 按块读取的行读取器：每次 read 一整块，在缓冲区内用 memchr 找换行并就地截断，
+// 返回的行直接指向缓冲区，不逐行分配内存。跨块的行搬到缓冲区开头，
+// 比缓冲区还长的行使缓冲区按倍数增长，因此行长没有上限
+typedef struct {
+    char* data;
+    size_t capacity;
+    size_t start;       // 下一行的起点
+    size_t end;         // 已读入数据的末尾
+    size_t scanned;     // [start, scanned) 中已确认没有换行，长行跨块时不重复扫描
+    int fd;
+    int eof;
+    unsigned long long bytes;
+} LineReader;
+
+// 输出缓冲：结果先追加到缓冲区，由调用方在每块输入处理完后一次 write 写出
+typedef struct {
+    char* data;
+    size_t capacity;
+    size_t length;
+    int fd;
+    int failed;         // 写出失败（如下游管道已关闭）后不再写
+    unsigned long long bytes;
+} OutputBuffer;
+
+typedef struct {
+    unsigned long long lines;
+    unsigned long long errors;
+    unsigned long long bytes_in;
+    unsigned long long bytes_out;
+    double seconds;
+} PipeStats;
+
+// 函数声明
+int line_reader_init(LineReader* reader, int fd, size_t block_size);
+void line_reader_free(LineReader* reader);
+// 返回下一行（不含换行符与行尾的 '\r'，以 '\0' 结尾），缓冲区内没有完整的行时返回 NULL；
+// 输入结束后最后一行没有换行符也会返回。返回的指针在下次 line_reader_fill 之前有效
+char* line_reader_next(LineReader* reader, size_t* length);
+// 读入下一块：读到数据返回 1，输入结束返回 0，读错误返回 -1
+int line_reader_fill(LineReader* reader);
+
+int output_init(OutputBuffer* output, int fd, size_t capacity);
+void output_free(OutputBuffer* output);
+void output_append(OutputBuffer* output, const char* text, size_t length);
+int output_flush(OutputBuffer* output);
+
+// 求值一行输入：按规范化键查缓存，未命中时解析并交给缓存，交互模式与管道模式共用。
+// key 由调用方提供，至少 strlen(input) + 2 字节。成功返回 1 并写入 *result，失败返回 0 并写入 error
+int evaluate_line(ExprCache* cache, const char* input, char* key, size_t key_size, double* result, CalcError* error);
+
+// 交互模式的求值：命中缓存时与 evaluate_line 相同；未命中时用调度场求值器直接计算，不构造 AST、不分配堆内存，
+// 同一行再次出现（见 cache_seen_before）时才解析并放入缓存。参数与返回值同 evaluate_line
+int evaluate_line_direct(ExprCache* cache, const char* input, char* key, size_t key_size, double* result,
+                         CalcError* error);
+
+// 管道模式：不显示欢迎信息与提示符，每行输入输出一行（"= 结果"、"错误: 信息"，忽略首尾空白，空行与只含空白的行输出空行），
+// 遇到 quit/exit 停止。成功返回 1，读写出错返回 0
+int run_pipe_mode(ExprCache* cache, int input_fd, int output_fd, size_t block_size, PipeStats* stats);
+
+#endif // PIPE_H
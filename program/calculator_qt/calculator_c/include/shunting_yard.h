@@ -0,0 +1,45 @@
+#ifndef SHUNTING_YARD_H
+#define SHUNTING_YARD_H
+
+#include "error.h"
+#include "lexer.h"
+#include "calculator.h"
+#include <stdint.h>
+
+// 操作数栈与操作符栈的容量，构建时可用 -DSHUNTING_YARD_DEPTH=N 调整（CMake 变量 CALCULATOR_C_STACK_DEPTH）。
+// 左结合的同级运算随读随算，栈深只随括号嵌套与优先级交替增长，128 层足以容纳基准语料中 100 层括号的表达式（两个栈共约 1.5 KB）
+#ifndef SHUNTING_YARD_DEPTH
+#define SHUNTING_YARD_DEPTH 128
+#endif
+
+// 操作符栈中的条目：二元、一元操作符，左括号，或函数调用的左括号（记录函数编号）
+typedef enum {
+    PENDING_BINARY,
+    PENDING_UNARY,
+    PENDING_PAREN,
+    PENDING_CALL
+} PendingKind;
+
+typedef struct {
+    uint8_t kind;        // PendingKind
+    char op;             // 二元、一元操作符
+    uint16_t function;   // PENDING_CALL 的函数编号
+} PendingOperator;
+
+// 单遍调度场求值器：直接消费 Lexer 的记号流，按 get_operator_precedence 归约，不构造 AST、不分配堆内存。
+// 语法与 parse_expression 相同（一元 +/- 只作用于紧随的因子），结果与 evaluate 一致
+typedef struct {
+    Lexer lexer;
+    Calculator calc;     // 求值错误（如除零），出现后继续检查语法，语法错误优先报告
+    CalcError error;     // 语法错误与栈溢出
+    double operands[SHUNTING_YARD_DEPTH];
+    PendingOperator operators[SHUNTING_YARD_DEPTH];
+    int operand_count;
+    int operator_count;
+} ShuntingYard;
+
+// 求值一个表达式。成功返回 1 并写入 *result；失败返回 0 并写入 error，
+// 优先级与 evaluate_line 相同：词法错误、语法错误（含栈溢出）、求值错误
+int evaluate_direct(ShuntingYard* yard, const char* expression, double* result, CalcError* error);
+
+#endif // SHUNTING_YARD_H
@@ -1,10 +1,18 @@
 #ifndef UI_H
 #define UI_H
 
+#include <stddef.h>
+
+// get_user_input 的返回值
+#define INPUT_OK     0
+#define INPUT_EOF    1   // 输入结束（如管道关闭或 Ctrl-D）
+#define INPUT_TRUNC  2   // 行超过缓冲区，超出部分已丢弃
+#define INPUT_ERROR  3
+
 // 函数声明
 void show_welcome();
 void show_help();
-void get_user_input(char* buffer, int size);
+int get_user_input(char* buffer, size_t size);
 void show_result(double result);
 void show_error(const char* error);
 
@@ -0,0 +1,252 @@
+#include "cache.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// FNV-1a 哈希
+static size_t hash_key(const char* key) {
+    size_t hash = (size_t)14695981039346656037ULL;
+    for (const unsigned char* p = (const unsigned char*)key; *p != '\0'; p++) {
+        hash ^= *p;
+        hash *= (size_t)1099511628211ULL;
+    }
+    return hash;
+}
+
+int init_cache(ExprCache* cache, size_t capacity) {
+    if (cache == NULL) {
+        return 0;
+    }
+    
+    memset(cache, 0, sizeof(*cache));
+    cache->capacity = capacity;
+    
+    // 桶数取不小于容量的 2 的幂，保持平均链长不超过 1
+    cache->bucket_count = 16;
+    while (cache->bucket_count < capacity) {
+        cache->bucket_count <<= 1;
+    }
+    
+    cache->buckets = (CacheEntry**)calloc(cache->bucket_count, sizeof(CacheEntry*));
+    if (cache->buckets == NULL) {
+        cache->bucket_count = 0;
+        cache->capacity = 0;
+        return 0;
+    }
+    return 1;
+}
+
+void free_cache(ExprCache* cache) {
+    if (cache == NULL) {
+        return;
+    }
+    
+    CacheEntry* entry = cache->head;
+    while (entry != NULL) {
+        CacheEntry* next = entry->next;
+        free_ast_pool(&entry->pool);
+        free(entry->key);
+        free(entry);
+        entry = next;
+    }
+    free(cache->buckets);
+    memset(cache, 0, sizeof(*cache));
+}
+
+static int is_word_char(char c) {
+    return isalnum((unsigned char)c) || c == '.' || c == '_';
+}
+
+// 十进制指数 e/E 与十六进制的二进制指数 p/P
+static int is_exponent_mark(char c) {
+    return c == 'e' || c == 'E' || c == 'p' || c == 'P';
+}
+
+static int is_sign(char c) {
+    return c == '+' || c == '-';
+}
+
+// 去掉这里的空白是否可能改变词法结果："1e -3" 与 "1e- 3" 不能被拼成 "1e-3"
+static int space_is_significant(const char* output, size_t len, char next) {
+    char prev = output[len - 1];
+    if (is_word_char(prev) && is_word_char(next)) {
+        return 1;
+    }
+    if (is_exponent_mark(prev) && is_sign(next)) {
+        return 1;
+    }
+    return is_sign(prev) && isdigit((unsigned char)next) && len >= 2 && is_exponent_mark(output[len - 2]);
+}
+
+void normalize_expression(const char* input, char* output, size_t output_size) {
+    if (output == NULL || output_size == 0) {
+        return;
+    }
+    output[0] = '\0';
+    if (input == NULL) {
+        return;
+    }
+    
+    // 只有去掉空白可能改变词法结果时才保留一个空格，避免 "1 2" 与 "12"、"1e + 5" 与 "1e+5" 同键
+    size_t len = 0;
+    int pending_space = 0;
+    for (const char* p = input; *p != '\0' && len + 1 < output_size; p++) {
+        if (isspace((unsigned char)*p)) {
+            pending_space = 1;
+            continue;
+        }
+        if (pending_space && len > 0 && space_is_significant(output, len, *p)) {
+            if (len + 2 >= output_size) {
+                break;
+            }
+            output[len++] = ' ';
+        }
+        pending_space = 0;
+        output[len++] = *p;
+    }
+    output[len] = '\0';
+}
+
+static void unlink_entry(ExprCache* cache, CacheEntry* entry) {
+    if (entry->prev != NULL) {
+        entry->prev->next = entry->next;
+    } else {
+        cache->head = entry->next;
+    }
+    if (entry->next != NULL) {
+        entry->next->prev = entry->prev;
+    } else {
+        cache->tail = entry->prev;
+    }
+    entry->prev = NULL;
+    entry->next = NULL;
+}
+
+static void push_front(ExprCache* cache, CacheEntry* entry) {
+    entry->prev = NULL;
+    entry->next = cache->head;
+    if (cache->head != NULL) {
+        cache->head->prev = entry;
+    }
+    cache->head = entry;
+    if (cache->tail == NULL) {
+        cache->tail = entry;
+    }
+}
+
+static CacheEntry** find_slot(ExprCache* cache, const char* key) {
+    CacheEntry** slot = &cache->buckets[hash_key(key) & (cache->bucket_count - 1)];
+    while (*slot != NULL && strcmp((*slot)->key, key) != 0) {
+        slot = &(*slot)->bucket_next;
+    }
+    return slot;
+}
+
+const AstPool* cache_lookup(ExprCache* cache, const char* key, NodeId* root) {
+    if (cache == NULL || key == NULL || cache->capacity == 0) {
+        if (cache != NULL) {
+            cache->misses++;
+        }
+        return NULL;
+    }
+    
+    CacheEntry* entry = *find_slot(cache, key);
+    if (entry == NULL) {
+        cache->misses++;
+        return NULL;
+    }
+    
+    cache->hits++;
+    if (entry != cache->head) {
+        unlink_entry(cache, entry);
+        push_front(cache, entry);
+    }
+    *root = entry->root;
+    return &entry->pool;
+}
+
+static void evict_oldest(ExprCache* cache) {
+    CacheEntry* victim = cache->tail;
+    if (victim == NULL) {
+        return;
+    }
+    
+    CacheEntry** slot = find_slot(cache, victim->key);
+    *slot = victim->bucket_next;
+    unlink_entry(cache, victim);
+    
+    free_ast_pool(&victim->pool);
+    free(victim->key);
+    free(victim);
+    cache->size--;
+    cache->evictions++;
+}
+
+const AstPool* cache_insert(ExprCache* cache, const char* key, AstPool* pool, NodeId root) {
+    if (cache == NULL || key == NULL || pool == NULL || root == NODE_NONE || cache->capacity == 0) {
+        return NULL;
+    }
+    
+    CacheEntry** slot = find_slot(cache, key);
+    if (*slot != NULL) {
+        return NULL;
+    }
+    
+    CacheEntry* entry = (CacheEntry*)malloc(sizeof(CacheEntry));
+    if (entry == NULL) {
+        return NULL;
+    }
+    
+    size_t key_len = strlen(key);
+    entry->key = (char*)malloc(key_len + 1);
+    if (entry->key == NULL) {
+        free(entry);
+        return NULL;
+    }
+    memcpy(entry->key, key, key_len + 1);
+    // 整个节点池按值移交，节点本身不复制
+    compact_ast_pool(pool);
+    entry->pool = *pool;
+    entry->root = root;
+    init_ast_pool(pool);
+    entry->bucket_next = NULL;
+    
+    if (cache->size >= cache->capacity) {
+        evict_oldest(cache);
+        // 淘汰可能改动了同一桶链，重新定位插入位置
+        slot = find_slot(cache, key);
+    }
+    
+    *slot = entry;
+    push_front(cache, entry);
+    cache->size++;
+    return &entry->pool;
+}
+
+int cache_seen_before(ExprCache* cache, const char* key) {
+    if (cache == NULL || key == NULL || cache->capacity == 0) {
+        return 0;
+    }
+    
+    size_t hash = hash_key(key) | 1;
+    size_t* slot = &cache->seen[(hash >> 1) & (CACHE_SEEN_SLOTS - 1)];
+    if (*slot == hash) {
+        return 1;
+    }
+    *slot = hash;
+    return 0;
+}
+
+void print_cache_stats(const ExprCache* cache) {
+    if (cache == NULL) {
+        return;
+    }
+    
+    size_t lookups = cache->hits + cache->misses;
+    double hit_rate = lookups == 0 ? 0.0 : 100.0 * (double)cache->hits / (double)lookups;
+    printf("缓存统计:\n");
+    printf("  容量: %zu  条目: %zu\n", cache->capacity, cache->size);
+    printf("  命中: %zu  未命中: %zu  淘汰: %zu  命中率: %.2f%%\n\n",
+           cache->hits, cache->misses, cache->evictions, hit_rate);
+}
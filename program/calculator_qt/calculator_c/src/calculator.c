@@ -2,6 +2,7 @@
 #include "functions.h"
 #include "constants.h"
 #include <stdio.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
@@ -15,73 +16,146 @@ void init_calculator(Calculator* calc) {
     calc->error.message[0] = '\0';
 }
 
-double evaluate(Calculator* calc, ASTNode* node) {
-    if (calc == NULL || node == NULL) {
+// 求值用显式栈代替递归，很长的 1+1+…+1 也不会耗尽调用栈。两个栈先用函数内的定长数组，
+// 树更深时才移到堆上，常见的表达式求值不分配内存
+#define EVAL_INLINE_DEPTH 64
+
+typedef struct {
+    NodeId id;
+    uint32_t done;   // 已求值的子节点个数
+} EvalFrame;
+
+// 容量翻倍，首次增长时把内容从定长数组复制到堆上；内存不足时返回 0
+static int grow_stack(void** data, size_t* capacity, size_t element_size, const void* inline_data) {
+    if (*capacity > SIZE_MAX / 2 / element_size) {
+        return 0;
+    }
+    size_t grown = *capacity * 2;
+    void* resized;
+    if (*data == inline_data) {
+        resized = malloc(grown * element_size);
+        if (resized != NULL) {
+            memcpy(resized, *data, *capacity * element_size);
+        }
+    } else {
+        resized = realloc(*data, grown * element_size);
+    }
+    if (resized == NULL) {
+        return 0;
+    }
+    *data = resized;
+    *capacity = grown;
+    return 1;
+}
+
+double evaluate(Calculator* calc, const AstPool* pool, NodeId id) {
+    if (calc == NULL || pool == NULL || id >= pool->node_count) {
         if (calc != NULL) {
             init_error(&calc->error, EVALUATION_ERROR, "空节点");
         }
         return 0.0;
     }
     
-    switch (node->type) {
-        case NODE_NUMBER:
-            return node->data.value;
-            
-        case NODE_CONSTANT: {
-            if (!is_constant(node->data.constant_name)) {
-                init_error(&calc->error, EVALUATION_ERROR, "未知常量");
-                return 0.0;
+    // frames 为尚未求完的节点，values 为已求出、等待父节点使用的值（函数参数在其中连续存放）
+    EvalFrame inline_frames[EVAL_INLINE_DEPTH];
+    double inline_values[EVAL_INLINE_DEPTH];
+    EvalFrame* frames = inline_frames;
+    double* values = inline_values;
+    size_t frame_capacity = EVAL_INLINE_DEPTH, value_capacity = EVAL_INLINE_DEPTH;
+    size_t frame_count = 0, value_count = 0;
+    frames[frame_count++] = (EvalFrame){id, 0};
+    
+    while (frame_count > 0 && calc->error.message[0] == '\0') {
+        EvalFrame* frame = &frames[frame_count - 1];
+        const ASTNode* node = ast_node(pool, frame->id);
+        int descend = 0;
+        NodeId child = NODE_NONE;
+        double value = 0.0;
+        switch (node->type) {
+            case NODE_NUMBER:
+                value = node->data.value;
+                break;
+                
+            case NODE_CONSTANT: {
+                const Constant* constant = get_constant_at(node->id);
+                if (constant == NULL) {
+                    init_error(&calc->error, EVALUATION_ERROR, "未知常量");
+                    continue;
+                }
+                value = constant->value;
+                break;
             }
-            return get_constant_value(node->data.constant_name);
+                
+            case NODE_BINARY_OP:
+                if (frame->done < 2) {
+                    descend = 1;
+                    child = frame->done == 0 ? node->data.binary_op.left : node->data.binary_op.right;
+                    break;
+                }
+                value_count -= 2;
+                value = apply_operator(calc, node->op, values[value_count], values[value_count + 1]);
+                break;
+                
+            case NODE_UNARY_OP:
+                if (frame->done == 0) {
+                    descend = 1;
+                    child = node->data.operand;
+                    break;
+                }
+                value = apply_unary_operator(calc, node->op, values[--value_count]);
+                break;
+                
+            case NODE_FUNCTION_CALL:
+                if (node->arg_count > MAX_FUNCTION_ARGS) {
+                    init_error(&calc->error, EVALUATION_ERROR, "函数参数过多");
+                    continue;
+                }
+                if (frame->done < node->arg_count) {
+                    descend = 1;
+                    child = ast_args(pool, node)[frame->done];
+                    break;
+                }
+                value_count -= node->arg_count;
+                value = apply_function(calc, node->id, values + value_count, (int)node->arg_count);
+                break;
+                
+            default:
+                init_error(&calc->error, EVALUATION_ERROR, "未知节点类型");
+                continue;
         }
-            
-        case NODE_BINARY_OP: {
-            double left = evaluate(calc, node->data.binary_op.left);
-            if (calc->error.message[0] != '\0') {
-                return 0.0;
+        
+        if (descend) {
+            if (child >= pool->node_count) {
+                init_error(&calc->error, EVALUATION_ERROR, "空节点");
+                continue;
             }
-            
-            double right = evaluate(calc, node->data.binary_op.right);
-            if (calc->error.message[0] != '\0') {
-                return 0.0;
-            }
-            
-            return apply_operator(calc, node->data.binary_op.op, left, right);
-        }
-            
-        case NODE_UNARY_OP: {
-            double operand = evaluate(calc, node->data.unary_op.operand);
-            if (calc->error.message[0] != '\0') {
-                return 0.0;
+            frame->done++;
+            if (frame_count == frame_capacity &&
+                !grow_stack((void**)&frames, &frame_capacity, sizeof(EvalFrame), inline_frames)) {
+                init_error(&calc->error, EVALUATION_ERROR, "内存不足");
+                continue;
             }
-            
-            return apply_unary_operator(calc, node->data.unary_op.op, operand);
+            frames[frame_count++] = (EvalFrame){child, 0};
+            continue;
         }
-            
-        case NODE_FUNCTION_CALL: {
-            double* args = (double*)malloc(node->data.function_call.arg_count * sizeof(double));
-            if (args == NULL) {
-                init_error(&calc->error, EVALUATION_ERROR, "内存分配失败");
-                return 0.0;
-            }
-            
-            for (int i = 0; i < node->data.function_call.arg_count; i++) {
-                args[i] = evaluate(calc, node->data.function_call.args[i]);
-                if (calc->error.message[0] != '\0') {
-                    free(args);
-                    return 0.0;
-                }
-            }
-            
-            double result = apply_function(calc, node->data.function_call.name, args, node->data.function_call.arg_count);
-            free(args);
-            return result;
+        
+        frame_count--;
+        if (value_count == value_capacity &&
+            !grow_stack((void**)&values, &value_capacity, sizeof(double), inline_values)) {
+            init_error(&calc->error, EVALUATION_ERROR, "内存不足");
+            continue;
         }
-            
-        default:
-            init_error(&calc->error, EVALUATION_ERROR, "未知节点类型");
-            return 0.0;
+        values[value_count++] = value;
+    }
+    
+    double result = calc->error.message[0] == '\0' ? values[0] : 0.0;
+    if (frames != inline_frames) {
+        free(frames);
     }
+    if (values != inline_values) {
+        free(values);
+    }
+    return result;
 }
 
 double apply_operator(Calculator* calc, char op, double left, double right) {
@@ -126,15 +200,20 @@ double apply_unary_operator(Calculator* calc, char op, double operand) {
     }
 }
 
-double apply_function(Calculator* calc, const char* func_name, double* args, int arg_count) {
-    if (calc == NULL || func_name == NULL || args == NULL) {
+double apply_function(Calculator* calc, int function, double* args, int arg_count) {
+    if (calc == NULL || args == NULL) {
         return 0.0;
     }
     
-    if (!is_function(func_name)) {
+    const Function* info = get_function_at(function);
+    if (info == NULL) {
         init_error(&calc->error, EVALUATION_ERROR, "未知函数");
         return 0.0;
     }
     
-    return evaluate_function(func_name, args, arg_count);
-}
\ No newline at end of file
+    // 参数个数不符时与 evaluate_function 一致，结果为 0
+    if (arg_count < info->min_args || arg_count > info->max_args) {
+        return 0.0;
+    }
+    return info->func(args, arg_count);
+}
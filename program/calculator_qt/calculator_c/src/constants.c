@@ -1,42 +1,42 @@
 #include "constants.h"
+#include "identifiers.h"
 #include <math.h>
 #include <string.h>
 
-// 定义常量数组
+// 定义常量数组，与生成的哈希表同源（identifiers.def）
 static Constant constants[] = {
-    {"pi", M_PI},
-    {"e", M_E}
+#define FUNCTION(name, func, min_args, max_args)
+#define CONSTANT(name, value) {#name, value},
+#include "identifiers.def"
+#undef FUNCTION
+#undef CONSTANT
 };
 
 // 常量数量
 static int constants_count = sizeof(constants) / sizeof(Constant);
 
-int is_constant(const char* name) {
+// 按名称查常量：完美哈希一次探查
+static const Identifier* lookup_constant(const char* name) {
     if (name == NULL) {
-        return 0;
-    }
-    
-    for (int i = 0; i < constants_count; i++) {
-        if (strcmp(constants[i].name, name) == 0) {
-            return 1;
-        }
+        return NULL;
     }
     
-    return 0;
+    const Identifier* identifier = lookup_identifier(name, strlen(name));
+    return identifier != NULL && (identifier->flags & IDENTIFIER_CONSTANT) ? identifier : NULL;
+}
+
+int is_constant(const char* name) {
+    return lookup_constant(name) != NULL;
 }
 
 double get_constant_value(const char* name) {
-    if (name == NULL) {
-        return 0.0;
-    }
-    
-    for (int i = 0; i < constants_count; i++) {
-        if (strcmp(constants[i].name, name) == 0) {
-            return constants[i].value;
-        }
-    }
-    
-    return 0.0;
+    const Identifier* identifier = lookup_constant(name);
+    return identifier != NULL ? identifier->value : 0.0;
+}
+
+int find_constant(const char* name) {
+    const Identifier* identifier = lookup_constant(name);
+    return identifier != NULL ? identifier->index : -1;
 }
 
 int get_constants_count() {
@@ -1,85 +1,71 @@
 #include "functions.h"
+#include "identifiers.h"
 #include "error.h"
 #include <math.h>
 #include <string.h>
 #include <stdio.h>
 
-// 定义函数数组
+// 定义函数数组，与生成的哈希表同源（identifiers.def）
 static Function functions[] = {
-    {"sin", func_sin, 1, 1},
-    {"cos", func_cos, 1, 1},
-    {"tan", func_tan, 1, 1},
-    {"log", func_log, 1, 1},
-    {"ln", func_ln, 1, 1},
-    {"exp", func_exp, 1, 1},
-    {"sqrt", func_sqrt, 1, 1},
-    {"abs", func_abs, 1, 1}
+#define FUNCTION(name, func, min_args, max_args) {#name, func, min_args, max_args},
+#define CONSTANT(name, value)
+#include "identifiers.def"
+#undef FUNCTION
+#undef CONSTANT
 };
 
 // 函数数量
 static int functions_count = sizeof(functions) / sizeof(Function);
 
-int is_function(const char* name) {
+// 按名称查函数：完美哈希一次探查
+static const Identifier* lookup_function(const char* name) {
     if (name == NULL) {
-        return 0;
-    }
-    
-    for (int i = 0; i < functions_count; i++) {
-        if (strcmp(functions[i].name, name) == 0) {
-            return 1;
-        }
+        return NULL;
     }
     
-    return 0;
+    const Identifier* identifier = lookup_identifier(name, strlen(name));
+    return identifier != NULL && (identifier->flags & IDENTIFIER_FUNCTION) ? identifier : NULL;
 }
 
-FunctionPtr get_function(const char* name) {
-    if (name == NULL) {
+int is_function(const char* name) {
+    return lookup_function(name) != NULL;
+}
+
+int find_function(const char* name) {
+    const Identifier* identifier = lookup_function(name);
+    return identifier != NULL ? identifier->index : -1;
+}
+
+const Function* get_function_at(int index) {
+    if (index < 0 || index >= functions_count) {
         return NULL;
     }
     
-    for (int i = 0; i < functions_count; i++) {
-        if (strcmp(functions[i].name, name) == 0) {
-            return functions[i].func;
-        }
-    }
-    
-    return NULL;
+    return &functions[index];
+}
+
+FunctionPtr get_function(const char* name) {
+    const Identifier* identifier = lookup_function(name);
+    return identifier != NULL ? identifier->func : NULL;
 }
 
 int get_function_arg_count(const char* name) {
-    if (name == NULL) {
-        return 0;
-    }
-    
-    for (int i = 0; i < functions_count; i++) {
-        if (strcmp(functions[i].name, name) == 0) {
-            return functions[i].min_args;
-        }
-    }
-    
-    return 0;
+    const Identifier* identifier = lookup_function(name);
+    return identifier != NULL ? identifier->min_args : 0;
 }
 
 double evaluate_function(const char* name, double* args, int arg_count) {
-    if (name == NULL || args == NULL) {
+    if (args == NULL) {
         return 0.0;
     }
     
-    // 查找函数
-    for (int i = 0; i < functions_count; i++) {
-        if (strcmp(functions[i].name, name) == 0) {
-            // 检查参数数量
-            if (arg_count < functions[i].min_args || arg_count > functions[i].max_args) {
-                return 0.0;
-            }
-            
-            // 调用函数
-            return functions[i].func(args, arg_count);
-        }
+    // 一次查找得到实现与参数个数范围
+    const Identifier* identifier = lookup_function(name);
+    if (identifier == NULL || arg_count < identifier->min_args || arg_count > identifier->max_args) {
+        return 0.0;
     }
     
-    return 0.0;
+    return identifier->func(args, arg_count);
 }
 
 // 各种数学函数的实现
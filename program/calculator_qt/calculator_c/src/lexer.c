@@ -1,6 +1,5 @@
 #include "lexer.h"
-#include "constants.h"
-#include "functions.h"
+#include "number_parse.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -13,6 +12,8 @@ void init_lexer(Lexer* lexer, const char* expression) {
     
     lexer->expression = expression;
     lexer->pos = 0;
+    lexer->length = (int)strlen(expression);
+    char_scanner_init(&lexer->scanner, expression, (size_t)lexer->length);
     lexer->current_token.type = TOKEN_END;
     lexer->error.type = CALC_ERROR;
     lexer->error.message[0] = '\0';
@@ -26,126 +27,101 @@ void skip_whitespace(Lexer* lexer) {
         return;
     }
     
-    while (lexer->expression[lexer->pos] != '\0' && 
-           is_whitespace(lexer->expression[lexer->pos])) {
-        lexer->pos++;
-    }
+    lexer->pos = (int)char_scanner_skip(&lexer->scanner, (size_t)lexer->pos, CHAR_CLASS_BIT(CHAR_WHITESPACE));
 }
 
+// 与字符类别预扫描的 CHAR_WHITESPACE 一致
 int is_whitespace(char c) {
-    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    return c == ' ' || (c >= '\t' && c <= '\r');
 }
 
 int is_operator(char c) {
     return c == '+' || c == '-' || c == '*' || c == '/' || c == '^';
 }
 
+static Token make_token(TokenType type, int start, int end) {
+    Token token;
+    token.type = (uint8_t)type;
+    token.op = 0;
+    token.offset = (uint32_t)start;
+    token.length = (uint32_t)(end - start);
+    token.value = 0.0;
+    return token;
+}
+
 Token get_next_token(Lexer* lexer) {
     if (lexer == NULL || lexer->expression == NULL) {
-        Token error_token = {TOKEN_ERROR, 0.0, "", 0};
-        return error_token;
+        return make_token(TOKEN_ERROR, 0, 0);
     }
     
     skip_whitespace(lexer);
     
     // 检查是否到达表达式末尾
-    if (lexer->expression[lexer->pos] == '\0') {
-        Token end_token = {TOKEN_END, 0.0, "", 0};
-        return end_token;
+    int start = lexer->pos;
+    if (lexer->expression[start] == '\0') {
+        return make_token(TOKEN_END, start, start);
     }
     
-    char ch = lexer->expression[lexer->pos];
+    char ch = lexer->expression[start];
     
-    // 处理数字
+    // 处理数字：共享的数字解析直接读取表达式，不复制词素
     if (isdigit(ch) || ch == '.') {
-        int start = lexer->pos;
-        while (lexer->expression[lexer->pos] != '\0' && 
-               (isdigit(lexer->expression[lexer->pos]) || 
-                lexer->expression[lexer->pos] == '.')) {
-            lexer->pos++;
-        }
-        
-        // 创建临时字符串来存储数字
-        int len = lexer->pos - start;
-        char* num_str = (char*)malloc(len + 1);
-        if (num_str == NULL) {
-            Token error_token = {TOKEN_ERROR, 0.0, "", 0};
-            return error_token;
+        const char* text = &lexer->expression[start];
+        double value = 0.0;
+        NumberResult result = parse_number(text, lexer->expression + lexer->length, &value);
+        lexer->pos += (int)result.length;
+
+        if (result.status != NUMBER_OK) {
+            char message[sizeof(lexer->error.message)];
+            int offset = start + (int)result.error_offset;
+            snprintf(message, sizeof(message), "%s: %.*s（位置 %d）",
+                     result.status == NUMBER_OUT_OF_RANGE ? "数字超出范围" : "无效的数字格式",
+                     (int)result.length, text, offset);
+            init_error(&lexer->error, LEXICAL_ERROR, message);
+            return make_token(TOKEN_ERROR, start, lexer->pos);
         }
-        
-        strncpy(num_str, &lexer->expression[start], len);
-        num_str[len] = '\0';
-        
-        double value = atof(num_str);
-        free(num_str);
-        
-        Token number_token = {TOKEN_NUMBER, value, "", 0};
+
+        Token number_token = make_token(TOKEN_NUMBER, start, lexer->pos);
+        number_token.value = value;
         return number_token;
     }
     
-    // 处理标识符（函数名或常量）
+    // 处理标识符（函数名或常量）：直接在表达式上查完美哈希表，不复制名称
     if (isalpha(ch)) {
-        int start = lexer->pos;
-        while (lexer->expression[lexer->pos] != '\0' && 
-               isalnum(lexer->expression[lexer->pos])) {
-            lexer->pos++;
-        }
-        
-        // 创建临时字符串来存储标识符
-        int len = lexer->pos - start;
-        if (len >= 32) {
-            len = 31; // 防止缓冲区溢出
-        }
-        
-        char name[32];
-        strncpy(name, &lexer->expression[start], len);
-        name[len] = '\0';
-        
-        // 检查是否为常量
-        if (is_constant(name)) {
-            Token constant_token = {TOKEN_CONSTANT, 0.0, "", 0};
-            constant_token.type = TOKEN_CONSTANT;
-            strcpy(constant_token.name, name);
-            return constant_token;
-        }
-        
-        // 检查是否为函数
-        if (is_function(name)) {
-            Token function_token = {TOKEN_FUNCTION, 0.0, "", 0};
-            function_token.type = TOKEN_FUNCTION;
-            strcpy(function_token.name, name);
-            return function_token;
+        lexer->pos = (int)char_scanner_skip(&lexer->scanner, (size_t)start,
+                                            CHAR_CLASS_BIT(CHAR_ALPHA) | CHAR_CLASS_BIT(CHAR_DIGIT));
+        const Identifier* identifier = lookup_identifier(&lexer->expression[start], (size_t)(lexer->pos - start));
+        if (identifier == NULL) {
+            // 未知标识符
+            return make_token(TOKEN_ERROR, start, lexer->pos);
         }
         
-        // 未知标识符
-        Token error_token = {TOKEN_ERROR, 0.0, "", 0};
-        return error_token;
+        Token identifier_token = make_token((identifier->flags & IDENTIFIER_CONSTANT) ? TOKEN_CONSTANT : TOKEN_FUNCTION,
+                                            start, lexer->pos);
+        identifier_token.identifier = identifier;
+        return identifier_token;
     }
     
+    lexer->pos++;
+    
     // 处理操作符
     if (is_operator(ch)) {
-        lexer->pos++;
-        Token operator_token = {TOKEN_OPERATOR, 0.0, "", ch};
+        Token operator_token = make_token(TOKEN_OPERATOR, start, lexer->pos);
+        operator_token.op = ch;
         return operator_token;
     }
     
     // 处理括号
     if (ch == '(') {
-        lexer->pos++;
-        Token lparen_token = {TOKEN_LPAREN, 0.0, "", 0};
-        return lparen_token;
+        return make_token(TOKEN_LPAREN, start, lexer->pos);
     }
     
     if (ch == ')') {
-        lexer->pos++;
-        Token rparen_token = {TOKEN_RPAREN, 0.0, "", 0};
-        return rparen_token;
+        return make_token(TOKEN_RPAREN, start, lexer->pos);
     }
     
     // 未知字符
-    lexer->pos++;
-    Token error_token = {TOKEN_ERROR, 0.0, "", 0};
-    return error_token;
+    return make_token(TOKEN_ERROR, start, lexer->pos);
 }
 
 void consume_token(Lexer* lexer) {
@@ -154,4 +130,81 @@ void consume_token(Lexer* lexer) {
     }
     
     lexer->current_token = get_next_token(lexer);
-}
\ No newline at end of file
+}
+void init_token_array(TokenArray* tokens) {
+    tokens->heap = NULL;
+    tokens->count = 0;
+    tokens->capacity = TOKEN_INLINE_CAPACITY;
+    tokens->error.type = CALC_ERROR;
+    tokens->error.message[0] = '\0';
+}
+
+void free_token_array(TokenArray* tokens) {
+    if (tokens == NULL) {
+        return;
+    }
+    
+    free(tokens->heap);
+    init_token_array(tokens);
+}
+
+// 换到堆上并扩容到至少 capacity 个记号；失败时返回 0，已有记号不变
+static int reserve_tokens(TokenArray* tokens, uint32_t capacity) {
+    if (capacity <= tokens->capacity) {
+        return 1;
+    }
+    Token* heap = (Token*)realloc(tokens->heap, (size_t)capacity * sizeof(Token));
+    if (heap == NULL) {
+        return 0;
+    }
+    if (tokens->heap == NULL) {
+        memcpy(heap, tokens->inline_tokens, tokens->count * sizeof(Token));
+    }
+    tokens->heap = heap;
+    tokens->capacity = capacity;
+    return 1;
+}
+
+int tokenize(TokenArray* tokens, const char* expression) {
+    tokens->count = 0;
+    tokens->error.type = CALC_ERROR;
+    tokens->error.message[0] = '\0';
+    if (expression == NULL) {
+        tokens->inline_tokens[0] = make_token(TOKEN_ERROR, 0, 0);
+        tokens->count = 1;
+        if (tokens->heap != NULL) {
+            tokens->heap[0] = tokens->inline_tokens[0];
+        }
+        return 1;
+    }
+    
+    Lexer lexer;
+    init_lexer(&lexer, expression);
+    // 长输入按平均每 4 字节一个记号预留，通常一次分配即可（预留失败时仍按倍数增长）
+    if ((size_t)lexer.length / 4 > tokens->capacity && (size_t)lexer.length / 4 < UINT32_MAX / 2) {
+        reserve_tokens(tokens, (uint32_t)(lexer.length / 4));
+    }
+    Token* data = tokens->heap != NULL ? tokens->heap : tokens->inline_tokens;
+    for (;;) {
+        // 末尾的 TOKEN_END/TOKEN_ERROR 总要放下，提前一个位置扩容
+        if (tokens->count + 1 >= tokens->capacity &&
+            (tokens->capacity > UINT32_MAX / 2 || !reserve_tokens(tokens, tokens->capacity * 2))) {
+            Token* last = &data[tokens->count];
+            *last = make_token(TOKEN_ERROR, lexer.pos, lexer.pos);
+            tokens->count++;
+            init_error(&tokens->error, LEXICAL_ERROR, "内存不足");
+            return 0;
+        }
+        data = tokens->heap != NULL ? tokens->heap : tokens->inline_tokens;
+        
+        Token token = lexer.current_token;
+        data[tokens->count++] = token;
+        if (token.type == TOKEN_END || token.type == TOKEN_ERROR) {
+            break;
+        }
+        consume_token(&lexer);
+    }
+    
+    tokens->error = lexer.error;
+    return 1;
+}
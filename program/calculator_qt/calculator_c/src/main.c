@@ -1,18 +1,63 @@
 #include "ui.h"
 #include "parser.h"
 #include "calculator.h"
+#include "cache.h"
+#include "pipe.h"
 #include "error.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
-int main() {
+int main(int argc, char* argv[]) {
+    size_t cache_capacity = DEFAULT_CACHE_CAPACITY;
+    int interactive = isatty(STDIN_FILENO);
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--cache-size") == 0 && i + 1 < argc) {
+            cache_capacity = (size_t)strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--interactive") == 0) {
+            interactive = 1;
+        } else {
+            fprintf(stderr, "未知参数: %s\n", argv[i]);
+            fprintf(stderr, "用法: %s [--cache-size N] [--interactive]\n", argv[0]);
+            return 1;
+        }
+    }
+    
+    // 已解析的 AST 按规范化输入缓存，重复的表达式直接求值
+    ExprCache cache;
+    if (!init_cache(&cache, cache_capacity)) {
+        fprintf(stderr, "缓存初始化失败，将不使用缓存\n");
+    }
+    
+    // 管道模式：标准输入不是终端时按块读写，不显示欢迎信息与提示符，吞吐量输出到标准错误
+    if (!interactive) {
+        PipeStats stats;
+        int ok = run_pipe_mode(&cache, STDIN_FILENO, STDOUT_FILENO, PIPE_BLOCK_SIZE, &stats);
+        double megabytes = (double)stats.bytes_in / 1e6;
+        fprintf(stderr, "管道模式: %llu 行, %llu 个错误, %.2f MB, %.3f 秒, %.1f MB/s\n",
+                stats.lines, stats.errors, megabytes, stats.seconds,
+                stats.seconds > 0.0 ? megabytes / stats.seconds : 0.0);
+        free_cache(&cache);
+        return ok ? 0 : 1;
+    }
+    
     show_welcome();
     
     char input[256];
+    char key[sizeof(input) + 2];
     
     while (1) {
-        get_user_input(input, sizeof(input));
+        // 输入结束（Ctrl-D）时与 quit 一样退出
+        int status = get_user_input(input, sizeof(input));
+        if (status == INPUT_EOF || status == INPUT_ERROR) {
+            printf("\n");
+            break;
+        }
+        if (status == INPUT_TRUNC) {
+            show_error("输入过长，已忽略该行");
+            continue;
+        }
         
         // 检查退出命令
         if (strcmp(input, "quit") == 0 || strcmp(input, "exit") == 0) {
@@ -26,46 +71,22 @@ int main() {
             continue;
         }
         
-        // 跳过空输入
-        if (strlen(input) == 0) {
-            continue;
-        }
-        
-        // 初始化解析器
-        Parser parser;
-        init_parser(&parser, input);
-        
-        // 解析表达式
-        ASTNode* ast = parse_expression(&parser);
-        
-        // 检查解析是否成功
-        if (ast == NULL) {
-            show_error("表达式解析失败");
+        // 检查缓存统计命令
+        if (strcmp(input, "stats") == 0) {
+            print_cache_stats(&cache);
             continue;
         }
         
-        // 检查是否还有未处理的字符
-        // 对于正确的表达式解析，这里应该没有未处理的字符
-        // 添加调试信息
-        if (parser.lexer.current_token.type != TOKEN_END) {
-            free_ast(ast);
-            show_error("表达式解析完成后仍有未处理的字符");
+        // 跳过空输入
+        if (strlen(input) == 0) {
             continue;
         }
         
-        // 初始化计算器
-        Calculator calc;
-        init_calculator(&calc);
-        
-        // 计算结果
-        double result = evaluate(&calc, ast);
-        
-        // 释放AST内存
-        free_ast(ast);
-        
-        // 检查计算是否有错误
-        if (calc.error.message[0] != '\0') {
-            show_error(calc.error.message);
+        double result;
+        CalcError error;
+        // 未命中缓存的行由调度场求值器直接计算，重复出现时才解析并缓存
+        if (!evaluate_line_direct(&cache, input, key, sizeof(key), &result, &error)) {
+            show_error(error.message);
             continue;
         }
         
@@ -73,5 +94,6 @@ int main() {
         show_result(result);
     }
     
+    free_cache(&cache);
     return 0;
-}
\ No newline at end of file
+}
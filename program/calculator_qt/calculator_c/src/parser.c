@@ -6,300 +6,350 @@
 #include <string.h>
 
 void init_parser(Parser* parser, const char* expression) {
-    if (parser == NULL || expression == NULL) {
+    if (parser == NULL) {
         return;
     }
     
-    init_lexer(&parser->lexer, expression);
+    // 节点池与记号数组先行初始化，表达式为空时 free_parser 同样安全；此时只有一个 TOKEN_ERROR
+    init_ast_pool(&parser->pool);
+    init_token_array(&parser->tokens);
+    parser->position = 0;
+    parser->nesting = 0;
     parser->error.type = CALC_ERROR;
     parser->error.message[0] = '\0';
+    tokenize(&parser->tokens, expression);
+}
+
+void free_parser(Parser* parser) {
+    if (parser == NULL) {
+        return;
+    }
+    
+    free_ast_pool(&parser->pool);
+    free_token_array(&parser->tokens);
+}
+
+// 前进到下一个记号，停在末尾的 TOKEN_END/TOKEN_ERROR 上
+static void advance(Parser* parser) {
+    if (parser->position + 1 < parser->tokens.count) {
+        parser->position++;
+    }
 }
 
-ASTNode* parse_expression(Parser* parser) {
+NodeId parse_expression(Parser* parser) {
     if (parser == NULL) {
-        return NULL;
+        return NODE_NONE;
     }
     
-    ASTNode* left = parse_term(parser);
-    if (left == NULL) {
-        return NULL;
+    NodeId left = parse_term(parser);
+    if (left == NODE_NONE) {
+        return NODE_NONE;
     }
     
-    while (parser->lexer.current_token.type == TOKEN_OPERATOR && 
-           (parser->lexer.current_token.op == '+' || parser->lexer.current_token.op == '-')) {
-        char op = parser->lexer.current_token.op;
-        consume_token(&parser->lexer); // 消费操作符
-        ASTNode* right = parse_term(parser);
-        if (right == NULL) {
-            free_ast(left);
-            return NULL;
+    // 出错时直接返回，已创建的节点随节点池一并释放
+    const Token* token;
+    while ((token = parser_current(parser))->type == TOKEN_OPERATOR && (token->op == '+' || token->op == '-')) {
+        char op = token->op;
+        advance(parser); // 消费操作符
+        NodeId right = parse_term(parser);
+        if (right == NODE_NONE) {
+            return NODE_NONE;
         }
         
-        ASTNode* node = create_binary_op_node(op, left, right);
-        if (node == NULL) {
-            free_ast(left);
-            free_ast(right);
-            return NULL;
+        left = create_binary_op_node(&parser->pool, op, left, right);
+        if (left == NODE_NONE) {
+            return NODE_NONE;
         }
-        
-        left = node;
     }
     
     return left;
 }
 
-ASTNode* parse_term(Parser* parser) {
+NodeId parse_term(Parser* parser) {
     if (parser == NULL) {
-        return NULL;
+        return NODE_NONE;
     }
     
-    ASTNode* left = parse_factor(parser);
-    if (left == NULL) {
-        return NULL;
+    NodeId left = parse_factor(parser);
+    if (left == NODE_NONE) {
+        return NODE_NONE;
     }
     
-    while (parser->lexer.current_token.type == TOKEN_OPERATOR && 
-           (parser->lexer.current_token.op == '*' || 
-            parser->lexer.current_token.op == '/' || 
-            parser->lexer.current_token.op == '^')) {
-        char op = parser->lexer.current_token.op;
-        consume_token(&parser->lexer); // 消费操作符
-        ASTNode* right = parse_factor(parser);
-        if (right == NULL) {
-            free_ast(left);
-            return NULL;
+    const Token* token;
+    while ((token = parser_current(parser))->type == TOKEN_OPERATOR &&
+           (token->op == '*' || token->op == '/' || token->op == '^')) {
+        char op = token->op;
+        advance(parser); // 消费操作符
+        NodeId right = parse_factor(parser);
+        if (right == NODE_NONE) {
+            return NODE_NONE;
         }
         
-        ASTNode* node = create_binary_op_node(op, left, right);
-        if (node == NULL) {
-            free_ast(left);
-            free_ast(right);
-            return NULL;
+        left = create_binary_op_node(&parser->pool, op, left, right);
+        if (left == NODE_NONE) {
+            return NODE_NONE;
         }
-        
-        left = node;
     }
     
     return left;
 }
 
-ASTNode* parse_factor(Parser* parser) {
+static NodeId parse_primary(Parser* parser);
+
+NodeId parse_factor(Parser* parser) {
     if (parser == NULL) {
-        return NULL;
+        return NODE_NONE;
     }
     
-    Token token = parser->lexer.current_token;
+    // 括号、一元操作符与函数调用都经这里递归
+    if (parser->nesting >= PARSER_MAX_NESTING) {
+        char message[128];
+        snprintf(message, sizeof(message), "表达式嵌套过深（上限 %d 层）", PARSER_MAX_NESTING);
+        init_error(&parser->error, SYNTAX_ERROR, message);
+        return NODE_NONE;
+    }
+    parser->nesting++;
+    NodeId result = parse_primary(parser);
+    parser->nesting--;
+    return result;
+}
+
+static NodeId parse_primary(Parser* parser) {
+    const Token* token = parser_current(parser);
     
     // 处理数字
-    if (token.type == TOKEN_NUMBER) {
-        consume_token(&parser->lexer);
-        return create_number_node(token.value);
+    if (token->type == TOKEN_NUMBER) {
+        advance(parser);
+        return create_number_node(&parser->pool, token->value);
     }
     
-    // 处理常量
-    if (token.type == TOKEN_CONSTANT) {
-        consume_token(&parser->lexer);
-        return create_constant_node(token.name);
+    // 处理常量：词法分析器已查到描述符，节点只记录编号
+    if (token->type == TOKEN_CONSTANT) {
+        advance(parser);
+        return create_constant_node(&parser->pool, token->identifier->index);
     }
     
     // 处理函数调用
-    if (token.type == TOKEN_FUNCTION) {
-        char func_name[32];
-        strcpy(func_name, token.name);
-        consume_token(&parser->lexer); // 消费函数名
-        
-        if (parser->lexer.current_token.type != TOKEN_LPAREN) {
-            // 设置错误信息
-            return NULL;
+    if (token->type == TOKEN_FUNCTION) {
+        // 函数名后必须紧跟左括号，前瞻一个记号即可判断
+        int function = token->identifier->index;
+        if (parser_peek(parser, 1)->type != TOKEN_LPAREN) {
+            advance(parser);
+            return NODE_NONE;
         }
-        consume_token(&parser->lexer); // 消费左括号
-        
-        // 解析参数列表
-        ASTNode** args = NULL;
-        int arg_count = 0;
+        advance(parser); // 消费函数名
+        advance(parser); // 消费左括号
         
-        if (parser->lexer.current_token.type != TOKEN_RPAREN) {
-            ASTNode* first_arg = parse_expression(parser);
-            if (first_arg == NULL) {
-                return NULL;
-            }
-            
-            // 分配参数数组
-            args = (ASTNode**)malloc(sizeof(ASTNode*));
-            if (args == NULL) {
-                free_ast(first_arg);
-                return NULL;
+        // 解析参数列表，参数暂存在 pending 中，嵌套调用在其后继续压入
+        uint32_t mark = parser->pool.pending_count;
+        if (parser_current(parser)->type != TOKEN_RPAREN) {
+            NodeId arg = parse_expression(parser);
+            if (arg == NODE_NONE || !push_pending_arg(&parser->pool, arg)) {
+                return NODE_NONE;
             }
             
-            args[0] = first_arg;
-            arg_count = 1;
-            
-            while (parser->lexer.current_token.type == TOKEN_OPERATOR && 
-                   parser->lexer.current_token.op == ',') {
-                consume_token(&parser->lexer); // 消费逗号
-                ASTNode* arg = parse_expression(parser);
-                if (arg == NULL) {
-                    // 释放已分配的参数
-                    for (int i = 0; i < arg_count; i++) {
-                        free_ast(args[i]);
-                    }
-                    free(args);
-                    return NULL;
-                }
-                
-                // 重新分配参数数组
-                ASTNode** new_args = (ASTNode**)realloc(args, (arg_count + 1) * sizeof(ASTNode*));
-                if (new_args == NULL) {
-                    // 释放已分配的参数
-                    for (int i = 0; i < arg_count; i++) {
-                        free_ast(args[i]);
-                    }
-                    free(args);
-                    free_ast(arg);
-                    return NULL;
+            while (parser_current(parser)->type == TOKEN_OPERATOR && parser_current(parser)->op == ',') {
+                advance(parser); // 消费逗号
+                arg = parse_expression(parser);
+                if (arg == NODE_NONE || !push_pending_arg(&parser->pool, arg)) {
+                    return NODE_NONE;
                 }
-                
-                args = new_args;
-                args[arg_count] = arg;
-                arg_count++;
             }
         }
         
-        if (parser->lexer.current_token.type != TOKEN_RPAREN) {
-            // 释放参数
-            if (args != NULL) {
-                for (int i = 0; i < arg_count; i++) {
-                    free_ast(args[i]);
-                }
-                free(args);
-            }
-            return NULL;
+        if (parser_current(parser)->type != TOKEN_RPAREN) {
+            return NODE_NONE;
         }
-        consume_token(&parser->lexer); // 消费右括号
+        advance(parser); // 消费右括号
         
-        return create_function_call_node(func_name, args, arg_count);
+        return create_function_call_node(&parser->pool, function, mark);
     }
     
     // 处理一元操作符
-    if (token.type == TOKEN_OPERATOR && 
-        (token.op == '+' || token.op == '-')) {
-        char op = token.op;
-        consume_token(&parser->lexer); // 消费操作符
-        ASTNode* operand = parse_factor(parser);
-        if (operand == NULL) {
-            return NULL;
+    if (token->type == TOKEN_OPERATOR && 
+        (token->op == '+' || token->op == '-')) {
+        char op = token->op;
+        advance(parser); // 消费操作符
+        NodeId operand = parse_factor(parser);
+        if (operand == NODE_NONE) {
+            return NODE_NONE;
         }
-        return create_unary_op_node(op, operand);
+        return create_unary_op_node(&parser->pool, op, operand);
     }
     
     // 处理括号表达式
-    if (token.type == TOKEN_LPAREN) {
-        consume_token(&parser->lexer); // 消费左括号
-        ASTNode* expr = parse_expression(parser);
-        if (expr == NULL) {
-            return NULL;
+    if (token->type == TOKEN_LPAREN) {
+        advance(parser); // 消费左括号
+        NodeId expr = parse_expression(parser);
+        if (expr == NODE_NONE) {
+            return NODE_NONE;
         }
         
-        if (parser->lexer.current_token.type != TOKEN_RPAREN) {
-            free_ast(expr);
-            return NULL;
+        if (parser_current(parser)->type != TOKEN_RPAREN) {
+            return NODE_NONE;
         }
-        consume_token(&parser->lexer); // 消费右括号
+        advance(parser); // 消费右括号
         return expr;
     }
     
-    return NULL;
+    return NODE_NONE;
 }
 
-ASTNode* create_number_node(double value) {
-    ASTNode* node = (ASTNode*)malloc(sizeof(ASTNode));
-    if (node == NULL) {
-        return NULL;
+void init_ast_pool(AstPool* pool) {
+    memset(pool, 0, sizeof(*pool));
+}
+
+void free_ast_pool(AstPool* pool) {
+    if (pool == NULL) {
+        return;
     }
     
-    node->type = NODE_NUMBER;
-    node->data.value = value;
-    return node;
+    free(pool->nodes);
+    free(pool->args);
+    free(pool->pending);
+    init_ast_pool(pool);
 }
 
-ASTNode* create_binary_op_node(char op, ASTNode* left, ASTNode* right) {
-    ASTNode* node = (ASTNode*)malloc(sizeof(ASTNode));
-    if (node == NULL) {
-        return NULL;
+// 保证 *data 至少能容纳 needed 个元素，容量按倍数增长；失败时原内存不变并返回 0
+static int reserve(void** data, uint32_t* capacity, uint32_t needed, size_t element_size, uint32_t initial) {
+    if (needed <= *capacity) {
+        return 1;
     }
-    
-    node->type = NODE_BINARY_OP;
-    node->data.binary_op.op = op;
-    node->data.binary_op.left = left;
-    node->data.binary_op.right = right;
-    return node;
+    uint32_t grown = *capacity == 0 ? initial : *capacity;
+    while (grown < needed) {
+        if (grown > UINT32_MAX / 2) {
+            return 0;
+        }
+        grown *= 2;
+    }
+    void* resized = realloc(*data, (size_t)grown * element_size);
+    if (resized == NULL) {
+        return 0;
+    }
+    *data = resized;
+    *capacity = grown;
+    return 1;
 }
 
-ASTNode* create_unary_op_node(char op, ASTNode* operand) {
-    ASTNode* node = (ASTNode*)malloc(sizeof(ASTNode));
-    if (node == NULL) {
-        return NULL;
+// 首次分配 16 个节点（256 字节），常见的单行表达式无需再增长
+static NodeId new_node(AstPool* pool, NodeType type) {
+    if (pool->node_count == NODE_NONE ||
+        !reserve((void**)&pool->nodes, &pool->node_capacity, pool->node_count + 1, sizeof(ASTNode), 16)) {
+        return NODE_NONE;
     }
-    
-    node->type = NODE_UNARY_OP;
-    node->data.unary_op.op = op;
-    node->data.unary_op.operand = operand;
-    return node;
+    NodeId id = pool->node_count++;
+    ASTNode* node = &pool->nodes[id];
+    memset(node, 0, sizeof(*node));
+    node->type = (uint8_t)type;
+    return id;
 }
 
-ASTNode* create_function_call_node(const char* name, ASTNode** args, int arg_count) {
-    ASTNode* node = (ASTNode*)malloc(sizeof(ASTNode));
-    if (node == NULL) {
-        return NULL;
+void compact_ast_pool(AstPool* pool) {
+    if (pool == NULL) {
+        return;
     }
     
-    node->type = NODE_FUNCTION_CALL;
-    strncpy(node->data.function_call.name, name, sizeof(node->data.function_call.name) - 1);
-    node->data.function_call.name[sizeof(node->data.function_call.name) - 1] = '\0';
-    node->data.function_call.args = args;
-    node->data.function_call.arg_count = arg_count;
-    return node;
+    // 收缩失败时保留原内存，结果仍然有效
+    if (pool->node_count < pool->node_capacity && pool->node_count > 0) {
+        ASTNode* nodes = (ASTNode*)realloc(pool->nodes, pool->node_count * sizeof(ASTNode));
+        if (nodes != NULL) {
+            pool->nodes = nodes;
+            pool->node_capacity = pool->node_count;
+        }
+    }
+    if (pool->arg_count == 0) {
+        free(pool->args);
+        pool->args = NULL;
+        pool->arg_capacity = 0;
+    } else if (pool->arg_count < pool->arg_capacity) {
+        NodeId* args = (NodeId*)realloc(pool->args, pool->arg_count * sizeof(NodeId));
+        if (args != NULL) {
+            pool->args = args;
+            pool->arg_capacity = pool->arg_count;
+        }
+    }
+    free(pool->pending);
+    pool->pending = NULL;
+    pool->pending_count = 0;
+    pool->pending_capacity = 0;
+}
+
+size_t ast_pool_bytes(const AstPool* pool) {
+    return (size_t)pool->node_capacity * sizeof(ASTNode) + (size_t)pool->arg_capacity * sizeof(NodeId) +
+           (size_t)pool->pending_capacity * sizeof(NodeId);
 }
 
-ASTNode* create_constant_node(const char* name) {
-    ASTNode* node = (ASTNode*)malloc(sizeof(ASTNode));
-    if (node == NULL) {
-        return NULL;
+NodeId create_number_node(AstPool* pool, double value) {
+    NodeId id = new_node(pool, NODE_NUMBER);
+    if (id != NODE_NONE) {
+        pool->nodes[id].data.value = value;
     }
-    
-    node->type = NODE_CONSTANT;
-    strncpy(node->data.constant_name, name, sizeof(node->data.constant_name) - 1);
-    node->data.constant_name[sizeof(node->data.constant_name) - 1] = '\0';
-    return node;
+    return id;
 }
 
-void free_ast(ASTNode* node) {
-    if (node == NULL) {
-        return;
+NodeId create_binary_op_node(AstPool* pool, char op, NodeId left, NodeId right) {
+    NodeId id = new_node(pool, NODE_BINARY_OP);
+    if (id != NODE_NONE) {
+        pool->nodes[id].op = op;
+        pool->nodes[id].data.binary_op.left = left;
+        pool->nodes[id].data.binary_op.right = right;
     }
-    
-    switch (node->type) {
-        case NODE_BINARY_OP:
-            free_ast(node->data.binary_op.left);
-            free_ast(node->data.binary_op.right);
-            break;
-        case NODE_UNARY_OP:
-            free_ast(node->data.unary_op.operand);
-            break;
-        case NODE_FUNCTION_CALL:
-            for (int i = 0; i < node->data.function_call.arg_count; i++) {
-                free_ast(node->data.function_call.args[i]);
-            }
-            free(node->data.function_call.args);
-            break;
-        default:
-            // 其他节点类型不需要特殊处理
-            break;
+    return id;
+}
+
+NodeId create_unary_op_node(AstPool* pool, char op, NodeId operand) {
+    NodeId id = new_node(pool, NODE_UNARY_OP);
+    if (id != NODE_NONE) {
+        pool->nodes[id].op = op;
+        pool->nodes[id].data.operand = operand;
     }
-    
-    free(node);
+    return id;
 }
 
+NodeId create_constant_node(AstPool* pool, int constant) {
+    if (constant < 0) {
+        return NODE_NONE;
+    }
+    NodeId id = new_node(pool, NODE_CONSTANT);
+    if (id != NODE_NONE) {
+        pool->nodes[id].id = (uint16_t)constant;
+    }
+    return id;
+}
+
+int push_pending_arg(AstPool* pool, NodeId arg) {
+    if (!reserve((void**)&pool->pending, &pool->pending_capacity, pool->pending_count + 1, sizeof(NodeId), 4)) {
+        return 0;
+    }
+    pool->pending[pool->pending_count++] = arg;
+    return 1;
+}
+
+NodeId create_function_call_node(AstPool* pool, int function, uint32_t mark) {
+    if (function < 0 || mark > pool->pending_count) {
+        return NODE_NONE;
+    }
+    uint32_t count = pool->pending_count - mark;
+    if (!reserve((void**)&pool->args, &pool->arg_capacity, pool->arg_count + count, sizeof(NodeId), 4)) {
+        return NODE_NONE;
+    }
+    NodeId id = new_node(pool, NODE_FUNCTION_CALL);
+    if (id == NODE_NONE) {
+        return NODE_NONE;
+    }
+    ASTNode* node = &pool->nodes[id];
+    node->id = (uint16_t)function;
+    node->arg_count = count;
+    node->data.first_arg = pool->arg_count;
+    if (count > 0) {
+        memcpy(pool->args + pool->arg_count, pool->pending + mark, count * sizeof(NodeId));
+    }
+    pool->arg_count += count;
+    pool->pending_count = mark;
+    return id;
+}
+
+// 与 parse_term 一致：'^' 与 '*'、'/' 同级且左结合（2^3^2 = 64），调度场求值器据此归约
 int get_operator_precedence(char op) {
     switch (op) {
         case '+':
@@ -307,10 +357,9 @@ int get_operator_precedence(char op) {
             return 1;
         case '*':
         case '/':
-            return 2;
         case '^':
-            return 3;
+            return 2;
         default:
             return 0;
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,329 @@
+#define _POSIX_C_SOURCE 200809L
+#include "pipe.h"
+#include "calculator.h"
+#include "shunting_yard.h"
+#include "double_format.h"
+#include "ui.h"
+#include <ctype.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+int line_reader_init(LineReader* reader, int fd, size_t block_size) {
+    memset(reader, 0, sizeof(*reader));
+    reader->fd = fd;
+    // 多留一个字节，输入末尾没有换行的行也能就地加 '\0'
+    reader->capacity = (block_size < 64 ? 64 : block_size) + 1;
+    reader->data = (char*)malloc(reader->capacity);
+    return reader->data != NULL;
+}
+
+void line_reader_free(LineReader* reader) {
+    free(reader->data);
+    reader->data = NULL;
+}
+
+char* line_reader_next(LineReader* reader, size_t* length) {
+    if (reader->scanned < reader->start) {
+        reader->scanned = reader->start;
+    }
+    char* line = reader->data + reader->start;
+    char* newline = (char*)memchr(reader->data + reader->scanned, '\n', reader->end - reader->scanned);
+    size_t len;
+    if (newline != NULL) {
+        len = (size_t)(newline - line);
+        reader->start += len + 1;
+    } else if (reader->eof && reader->start < reader->end) {
+        len = reader->end - reader->start;
+        reader->start = reader->end;
+    } else {
+        reader->scanned = reader->end;
+        return NULL;
+    }
+    if (len > 0 && line[len - 1] == '\r') {
+        len--;
+    }
+    line[len] = '\0';
+    *length = len;
+    return line;
+}
+
+int line_reader_fill(LineReader* reader) {
+    if (reader->eof) {
+        return 0;
+    }
+    // 把未完成的行搬到开头；仍占满缓冲区时说明行比缓冲区长，扩容
+    size_t pending = reader->end - reader->start;
+    if (reader->start > 0) {
+        memmove(reader->data, reader->data + reader->start, pending);
+        reader->scanned -= reader->start;
+        reader->start = 0;
+        reader->end = pending;
+    }
+    if (reader->end + 1 >= reader->capacity) {
+        size_t capacity = reader->capacity * 2;
+        char* data = (char*)realloc(reader->data, capacity);
+        if (data == NULL) {
+            return -1;
+        }
+        reader->data = data;
+        reader->capacity = capacity;
+    }
+
+    ssize_t n;
+    do {
+        n = read(reader->fd, reader->data + reader->end, reader->capacity - 1 - reader->end);
+    } while (n < 0 && errno == EINTR);
+    if (n < 0) {
+        return -1;
+    }
+    if (n == 0) {
+        reader->eof = 1;
+        return 0;
+    }
+    reader->end += (size_t)n;
+    reader->bytes += (unsigned long long)n;
+    return 1;
+}
+
+int output_init(OutputBuffer* output, int fd, size_t capacity) {
+    memset(output, 0, sizeof(*output));
+    output->fd = fd;
+    output->capacity = capacity < 4096 ? 4096 : capacity;
+    output->data = (char*)malloc(output->capacity);
+    return output->data != NULL;
+}
+
+void output_free(OutputBuffer* output) {
+    free(output->data);
+    output->data = NULL;
+}
+
+static void write_all(OutputBuffer* output, const char* data, size_t length) {
+    size_t written = 0;
+    while (!output->failed && written < length) {
+        ssize_t n = write(output->fd, data + written, length - written);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            output->failed = 1;
+            break;
+        }
+        written += (size_t)n;
+    }
+    output->bytes += written;
+}
+
+int output_flush(OutputBuffer* output) {
+    write_all(output, output->data, output->length);
+    output->length = 0;
+    return !output->failed;
+}
+
+void output_append(OutputBuffer* output, const char* text, size_t length) {
+    if (output->length + length > output->capacity) {
+        output_flush(output);
+    }
+    // 单次追加比整个缓冲区还大时直接写出
+    if (length > output->capacity) {
+        write_all(output, text, length);
+        return;
+    }
+    memcpy(output->data + output->length, text, length);
+    output->length += length;
+}
+
+// 未命中缓存时解析 input 并交给缓存，随后求值
+static int parse_and_evaluate(ExprCache* cache, const char* input, const char* key, double* result,
+                              CalcError* error) {
+    // 缓存接管后 parser.pool 为空，free_parser 只是空操作
+    Parser parser;
+    init_parser(&parser, input);
+    NodeId root = parse_expression(&parser);
+    if (root == NODE_NONE || parser_current(&parser)->type != TOKEN_END) {
+        // 停在无效的数字等词法错误上时，错误带有具体位置，优先报告
+        const CalcError* lexical = parser_lexical_error(&parser);
+        if (lexical != NULL) {
+            *error = *lexical;
+        } else if (parser.error.message[0] != '\0') {
+            *error = parser.error;
+        } else if (root == NODE_NONE) {
+            init_error(error, SYNTAX_ERROR, "表达式解析失败");
+        } else {
+            // 对于正确的表达式解析，这里应该没有未处理的字符
+            init_error(error, SYNTAX_ERROR, "表达式解析完成后仍有未处理的字符");
+        }
+        free_parser(&parser);
+        return 0;
+    }
+
+    // 插入失败（如容量为 0）时节点仍归解析器，本轮求值后释放
+    const AstPool* pool = cache_insert(cache, key, &parser.pool, root);
+    if (pool == NULL) {
+        pool = &parser.pool;
+    }
+
+    Calculator calc;
+    init_calculator(&calc);
+    *result = evaluate(&calc, pool, root);
+    free_parser(&parser);
+
+    if (calc.error.message[0] != '\0') {
+        *error = calc.error;
+        return 0;
+    }
+    return 1;
+}
+
+static int evaluate_cached(const AstPool* pool, NodeId root, double* result, CalcError* error) {
+    Calculator calc;
+    init_calculator(&calc);
+    *result = evaluate(&calc, pool, root);
+    if (calc.error.message[0] != '\0') {
+        *error = calc.error;
+        return 0;
+    }
+    return 1;
+}
+
+int evaluate_line(ExprCache* cache, const char* input, char* key, size_t key_size, double* result, CalcError* error) {
+    normalize_expression(input, key, key_size);
+    NodeId root;
+    const AstPool* pool = cache_lookup(cache, key, &root);
+    if (pool != NULL) {
+        return evaluate_cached(pool, root, result, error);
+    }
+    return parse_and_evaluate(cache, input, key, result, error);
+}
+
+int evaluate_line_direct(ExprCache* cache, const char* input, char* key, size_t key_size, double* result,
+                         CalcError* error) {
+    normalize_expression(input, key, key_size);
+    NodeId root;
+    const AstPool* pool = cache_lookup(cache, key, &root);
+    if (pool != NULL) {
+        return evaluate_cached(pool, root, result, error);
+    }
+    if (cache_seen_before(cache, key)) {
+        return parse_and_evaluate(cache, input, key, result, error);
+    }
+
+    // 只出现一次的行不值得构造 AST；求值器的两个栈在 ShuntingYard 内，放在调用栈上
+    ShuntingYard yard;
+    return evaluate_direct(&yard, input, result, error);
+}
+
+static double elapsed_seconds(const struct timespec* begin) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)(now.tv_sec - begin->tv_sec) + (double)(now.tv_nsec - begin->tv_nsec) / 1e9;
+}
+
+int run_pipe_mode(ExprCache* cache, int input_fd, int output_fd, size_t block_size, PipeStats* stats) {
+    struct timespec begin;
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+    memset(stats, 0, sizeof(*stats));
+
+    LineReader reader;
+    OutputBuffer output;
+    size_t key_size = 256;
+    char* key = (char*)malloc(key_size);
+    int reader_ok = line_reader_init(&reader, input_fd, block_size);
+    // 短表达式的结果可能比输入长，输出缓冲取两块，通常每块输入只需一次 write
+    int output_ok = output_init(&output, output_fd, block_size * 2);
+    if (key == NULL || !reader_ok || !output_ok) {
+        free(key);
+        line_reader_free(&reader);
+        output_free(&output);
+        return 0;
+    }
+
+    int ok = 1;
+    int quit = 0;
+    while (!quit && !output.failed) {
+        char* line;
+        size_t length;
+        while (!quit && (line = line_reader_next(&reader, &length)) != NULL) {
+            // 与交互模式一致，忽略首尾空白
+            while (length > 0 && isspace((unsigned char)line[length - 1])) {
+                line[--length] = '\0';
+            }
+            while (isspace((unsigned char)*line)) {
+                line++;
+                length--;
+            }
+            if (strcmp(line, "quit") == 0 || strcmp(line, "exit") == 0) {
+                quit = 1;
+                break;
+            }
+            stats->lines++;
+            // 帮助与统计沿用交互模式的输出，先写出已缓冲的结果以保持顺序
+            if (strcmp(line, "help") == 0 || strcmp(line, "stats") == 0) {
+                output_flush(&output);
+                if (line[0] == 'h') {
+                    show_help();
+                } else {
+                    print_cache_stats(cache);
+                }
+                fflush(stdout);
+                continue;
+            }
+            if (length == 0) {
+                output_append(&output, "\n", 1);
+                continue;
+            }
+            // 规范化键不会比输入长，键缓冲只在遇到更长的行时增长
+            if (length + 2 > key_size) {
+                while (length + 2 > key_size) {
+                    key_size *= 2;
+                }
+                char* grown = (char*)realloc(key, key_size);
+                if (grown == NULL) {
+                    ok = 0;
+                    quit = 1;
+                    break;
+                }
+                key = grown;
+            }
+
+            char text[320];
+            int written;
+            double result;
+            CalcError error;
+            if (evaluate_line(cache, line, key, key_size, &result, &error)) {
+                // 结果直接格式化到行缓冲，不经过 printf
+                text[0] = '=';
+                text[1] = ' ';
+                written = 2 + (int)format_shortest(text + 2, sizeof(text) - 2, result);
+                text[written++] = '\n';
+            } else {
+                written = snprintf(text, sizeof(text), "错误: %s\n", error.message);
+                stats->errors++;
+            }
+            output_append(&output, text, (size_t)written < sizeof(text) ? (size_t)written : sizeof(text) - 1);
+        }
+        if (quit || reader.eof) {
+            break;
+        }
+        // 一块输入的结果一次写出
+        output_flush(&output);
+        if (line_reader_fill(&reader) < 0) {
+            ok = 0;
+            break;
+        }
+    }
+    output_flush(&output);
+
+    stats->bytes_in = reader.bytes;
+    stats->bytes_out = output.bytes;
+    stats->seconds = elapsed_seconds(&begin);
+    ok = ok && !output.failed;
+    free(key);
+    line_reader_free(&reader);
+    output_free(&output);
+    return ok;
+}
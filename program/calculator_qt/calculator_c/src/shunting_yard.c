@@ -0,0 +1,238 @@
+#include "shunting_yard.h"
+#include "parser.h"
+#include <stdio.h>
+#include <string.h>
+
+// 记录第一个语法错误，返回 0 便于直接 return
+static int fail(ShuntingYard* yard, const char* message) {
+    if (yard->error.message[0] == '\0') {
+        init_error(&yard->error, SYNTAX_ERROR, message);
+    }
+    return 0;
+}
+
+static int overflow(ShuntingYard* yard) {
+    char message[128];
+    snprintf(message, sizeof(message), "表达式嵌套过深（栈容量 %d）", SHUNTING_YARD_DEPTH);
+    return fail(yard, message);
+}
+
+// 已出现求值错误时不再计算，只维持两个栈的形状以继续检查语法
+static int calc_failed(const ShuntingYard* yard) {
+    return yard->calc.error.message[0] != '\0';
+}
+
+static int push_operand(ShuntingYard* yard, double value) {
+    if (yard->operand_count >= SHUNTING_YARD_DEPTH) {
+        return overflow(yard);
+    }
+    yard->operands[yard->operand_count++] = value;
+    return 1;
+}
+
+static int push_operator(ShuntingYard* yard, PendingKind kind, char op, int function) {
+    if (yard->operator_count >= SHUNTING_YARD_DEPTH) {
+        return overflow(yard);
+    }
+    PendingOperator* pending = &yard->operators[yard->operator_count++];
+    pending->kind = (uint8_t)kind;
+    pending->op = op;
+    pending->function = (uint16_t)function;
+    return 1;
+}
+
+static const PendingOperator* top_operator(const ShuntingYard* yard) {
+    return yard->operator_count > 0 ? &yard->operators[yard->operator_count - 1] : NULL;
+}
+
+// 弹出栈顶的二元操作符，以栈顶两个操作数求值
+static void reduce_binary(ShuntingYard* yard) {
+    char op = yard->operators[--yard->operator_count].op;
+    double right = yard->operands[--yard->operand_count];
+    double* left = &yard->operands[yard->operand_count - 1];
+    if (!calc_failed(yard)) {
+        *left = apply_operator(&yard->calc, op, *left, right);
+    }
+}
+
+// 一个因子读完：作用于它的一元操作符都在栈顶，依次弹出
+static void finish_operand(ShuntingYard* yard) {
+    const PendingOperator* top;
+    while ((top = top_operator(yard)) != NULL && top->kind == PENDING_UNARY) {
+        yard->operator_count--;
+        double* operand = &yard->operands[yard->operand_count - 1];
+        if (!calc_failed(yard)) {
+            *operand = apply_unary_operator(&yard->calc, top->op, *operand);
+        }
+    }
+}
+
+// 归约栈顶所有二元操作符，直到遇到括号或栈空
+static void reduce_all_binary(ShuntingYard* yard) {
+    const PendingOperator* top;
+    while ((top = top_operator(yard)) != NULL && top->kind == PENDING_BINARY) {
+        reduce_binary(yard);
+    }
+}
+
+// 与 parse_expression 的报错一致：没有未闭合的括号时多出的记号算作未处理的字符
+static int fail_unexpected(ShuntingYard* yard) {
+    for (int i = 0; i < yard->operator_count; i++) {
+        if (yard->operators[i].kind == PENDING_PAREN || yard->operators[i].kind == PENDING_CALL) {
+            return fail(yard, "表达式解析失败");
+        }
+    }
+    return fail(yard, "表达式解析完成后仍有未处理的字符");
+}
+
+// 读到一个操作数的位置：数字、常量、函数调用、左括号或一元操作符
+static int accept_operand(ShuntingYard* yard, const Token* token, int* expect_operand) {
+    switch (token->type) {
+        case TOKEN_NUMBER:
+            if (!push_operand(yard, token->value)) {
+                return 0;
+            }
+            break;
+
+        case TOKEN_CONSTANT:
+            // 描述符中直接带有常量值
+            if (!push_operand(yard, token->identifier->value)) {
+                return 0;
+            }
+            break;
+
+        case TOKEN_FUNCTION: {
+            int function = token->identifier->index;
+            consume_token(&yard->lexer); // 消费函数名，左括号由调用方消费
+            if (yard->lexer.current_token.type != TOKEN_LPAREN) {
+                return fail(yard, "表达式解析失败");
+            }
+            return push_operator(yard, PENDING_CALL, 0, function);
+        }
+
+        case TOKEN_LPAREN:
+            return push_operator(yard, PENDING_PAREN, 0, 0);
+
+        case TOKEN_OPERATOR:
+            if (token->op != '+' && token->op != '-') {
+                return fail(yard, "表达式解析失败");
+            }
+            return push_operator(yard, PENDING_UNARY, token->op, 0);
+
+        case TOKEN_RPAREN: {
+            // 只有无参数的函数调用 f() 在这里遇到右括号：栈顶恰好是刚压入的调用
+            const PendingOperator* top = top_operator(yard);
+            if (top == NULL || top->kind != PENDING_CALL) {
+                return fail(yard, "表达式解析失败");
+            }
+            int function = top->function;
+            yard->operator_count--;
+            double value = 0.0;
+            if (!calc_failed(yard)) {
+                double args[1] = {0.0};
+                value = apply_function(&yard->calc, function, args, 0);
+            }
+            if (!push_operand(yard, value)) {
+                return 0;
+            }
+            break;
+        }
+
+        default:
+            return fail(yard, "表达式解析失败");
+    }
+
+    finish_operand(yard);
+    *expect_operand = 0;
+    return 1;
+}
+
+// 读到一个操作符的位置：二元操作符、右括号或表达式结尾。*done 表示已到结尾
+static int accept_operator(ShuntingYard* yard, const Token* token, int* expect_operand, int* done) {
+    switch (token->type) {
+        case TOKEN_OPERATOR: {
+            // 同级左结合：栈顶优先级不低于当前操作符时先归约
+            int precedence = get_operator_precedence(token->op);
+            const PendingOperator* top;
+            while ((top = top_operator(yard)) != NULL && top->kind == PENDING_BINARY &&
+                   get_operator_precedence(top->op) >= precedence) {
+                reduce_binary(yard);
+            }
+            if (!push_operator(yard, PENDING_BINARY, token->op, 0)) {
+                return 0;
+            }
+            *expect_operand = 1;
+            return 1;
+        }
+
+        case TOKEN_RPAREN: {
+            reduce_all_binary(yard);
+            const PendingOperator* top = top_operator(yard);
+            if (top == NULL) {
+                return fail(yard, "表达式解析完成后仍有未处理的字符");
+            }
+            yard->operator_count--;
+            if (top->kind == PENDING_CALL && !calc_failed(yard)) {
+                double* arg = &yard->operands[yard->operand_count - 1];
+                *arg = apply_function(&yard->calc, top->function, arg, 1);
+            }
+            finish_operand(yard);
+            return 1;
+        }
+
+        case TOKEN_END:
+            reduce_all_binary(yard);
+            if (yard->operator_count != 0) {
+                return fail(yard, "表达式解析失败");
+            }
+            *done = 1;
+            return 1;
+
+        default:
+            return fail_unexpected(yard);
+    }
+}
+
+int evaluate_direct(ShuntingYard* yard, const char* expression, double* result, CalcError* error) {
+    yard->operand_count = 0;
+    yard->operator_count = 0;
+    yard->error.type = CALC_ERROR;
+    yard->error.message[0] = '\0';
+    init_calculator(&yard->calc);
+    if (expression == NULL) {
+        init_error(error, SYNTAX_ERROR, "表达式解析失败");
+        return 0;
+    }
+    init_lexer(&yard->lexer, expression);
+
+    int expect_operand = 1;
+    int done = 0;
+    int ok = 1;
+    while (ok && !done) {
+        Token token = yard->lexer.current_token;
+        if (expect_operand) {
+            ok = accept_operand(yard, &token, &expect_operand);
+        } else {
+            ok = accept_operator(yard, &token, &expect_operand, &done);
+        }
+        if (ok && !done) {
+            consume_token(&yard->lexer);
+        }
+    }
+
+    // 词法错误（如无效的数字）带有具体位置，优先报告
+    if (yard->lexer.error.message[0] != '\0') {
+        *error = yard->lexer.error;
+        return 0;
+    }
+    if (!ok) {
+        *error = yard->error;
+        return 0;
+    }
+    if (calc_failed(yard)) {
+        *error = yard->calc.error;
+        return 0;
+    }
+    *result = yard->operands[0];
+    return 1;
+}
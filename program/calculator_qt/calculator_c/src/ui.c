@@ -1,4 +1,7 @@
 #include "ui.h"
+#include "double_format.h"
+#include <ctype.h>
+#include <limits.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -19,6 +22,8 @@ void show_help() {
     printf("  sin, cos, tan, log, ln, exp, sqrt, abs\n\n");
     printf("支持的常量:\n");
     printf("  pi, e\n\n");
+    printf("其他命令:\n");
+    printf("  stats (查看表达式缓存统计)\n\n");
     printf("示例:\n");
     printf("  2 + 3 * 4\n");
     printf("  sin(pi/2)\n");
@@ -26,27 +31,47 @@ void show_help() {
     printf("=============================\n\n");
 }
 
-void get_user_input(char* buffer, int size) {
-    if (buffer == NULL || size <= 0) {
-        return;
+int get_user_input(char* buffer, size_t size) {
+    if (buffer == NULL || size == 0 || size > (size_t)INT_MAX) {
+        return INPUT_ERROR;
     }
     
     printf(">>> ");
     fflush(stdout);
     
-    if (fgets(buffer, size, stdin) != NULL) {
-        // 移除换行符
-        int len = strlen(buffer);
-        if (len > 0 && buffer[len-1] == '\n') {
-            buffer[len-1] = '\0';
-        }
-    } else {
+    if (fgets(buffer, (int)size, stdin) == NULL) {
         buffer[0] = '\0';
+        return feof(stdin) ? INPUT_EOF : INPUT_ERROR;
+    }
+    
+    // 没有读到换行说明行超过缓冲区，丢弃该行剩余的字符
+    size_t len = strlen(buffer);
+    int truncated = 0;
+    if (len == size - 1 && buffer[len - 1] != '\n') {
+        int c;
+        truncated = 1;
+        while ((c = getchar()) != '\n' && c != EOF) {
+        }
     }
+    
+    // 移除换行符与首尾空白
+    size_t start = 0;
+    while (start < len && isspace((unsigned char)buffer[start])) {
+        start++;
+    }
+    while (len > start && isspace((unsigned char)buffer[len - 1])) {
+        len--;
+    }
+    memmove(buffer, buffer + start, len - start);
+    buffer[len - start] = '\0';
+    
+    return truncated ? INPUT_TRUNC : INPUT_OK;
 }
 
 void show_result(double result) {
-    printf("= %.10g\n\n", result);
+    char text[DOUBLE_FORMAT_SHORTEST_SIZE];
+    format_shortest(text, sizeof(text), result);
+    printf("= %s\n\n", text);
 }
 
 void show_error(const char* error) {
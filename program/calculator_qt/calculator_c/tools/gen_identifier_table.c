@@ -0,0 +1,167 @@
+// 构建时工具：根据 identifiers.def 为函数与常量构造完美哈希（哈希加位移），生成 identifier_table.c
+//
+// 用法: gen_identifier_table <输出文件>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "identifiers.h"
+
+typedef struct {
+    const char* name;
+    const char* func;    // 实现的函数名，常量为 NULL
+    int min_args;
+    int max_args;
+    const char* value;   // 常量值的表达式，函数为 NULL
+} Entry;
+
+static const Entry entries[] = {
+#define FUNCTION(name, func, min_args, max_args) {#name, #func, min_args, max_args, NULL},
+#define CONSTANT(name, value) {#name, NULL, 0, 0, #value},
+#include "identifiers.def"
+#undef FUNCTION
+#undef CONSTANT
+};
+
+#define ENTRY_COUNT (sizeof(entries) / sizeof(entries[0]))
+#define MAX_DISPLACEMENT 65536
+
+static uint32_t hashes[ENTRY_COUNT];
+static int bucket_of[ENTRY_COUNT];
+
+static uint32_t round_up_pow2(uint32_t n, uint32_t minimum) {
+    uint32_t size = minimum;
+    while (size < n) {
+        size *= 2;
+    }
+    return size;
+}
+
+// 各桶按名称数从多到少排序，难放的桶先挑位移
+static uint32_t* bucket_sizes;
+static int compare_buckets(const void* a, const void* b) {
+    uint32_t left = bucket_sizes[*(const uint32_t*)a];
+    uint32_t right = bucket_sizes[*(const uint32_t*)b];
+    return left < right ? 1 : left > right ? -1 : (int)(*(const uint32_t*)a) - (int)(*(const uint32_t*)b);
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        fprintf(stderr, "用法: %s <输出文件>\n", argv[0]);
+        return 1;
+    }
+
+    // 重名或 32 位哈希相同的名称无法区分
+    for (size_t i = 0; i < ENTRY_COUNT; i++) {
+        hashes[i] = identifier_hash(entries[i].name, strlen(entries[i].name));
+        for (size_t j = 0; j < i; j++) {
+            if (hashes[i] == hashes[j]) {
+                fprintf(stderr, "identifiers.def 中的名称 %s 与 %s 重复或哈希冲突\n", entries[j].name, entries[i].name);
+                return 1;
+            }
+        }
+    }
+
+    uint32_t slot_count = round_up_pow2(2 * ENTRY_COUNT, 16);
+    uint32_t bucket_count = round_up_pow2((ENTRY_COUNT + 1) / 2, 4);
+    int* slots = (int*)malloc(slot_count * sizeof(int));
+    uint16_t* displacements = (uint16_t*)calloc(bucket_count, sizeof(uint16_t));
+    bucket_sizes = (uint32_t*)calloc(bucket_count, sizeof(uint32_t));
+    uint32_t* order = (uint32_t*)malloc(bucket_count * sizeof(uint32_t));
+    if (slots == NULL || displacements == NULL || bucket_sizes == NULL || order == NULL) {
+        fprintf(stderr, "内存不足\n");
+        return 1;
+    }
+    for (uint32_t i = 0; i < slot_count; i++) {
+        slots[i] = -1;
+    }
+    for (size_t i = 0; i < ENTRY_COUNT; i++) {
+        bucket_of[i] = (int)(hashes[i] & (bucket_count - 1));
+        bucket_sizes[bucket_of[i]]++;
+    }
+    for (uint32_t b = 0; b < bucket_count; b++) {
+        order[b] = b;
+    }
+    qsort(order, bucket_count, sizeof(uint32_t), compare_buckets);
+
+    // 逐个桶尝试位移，直到桶内名称都落在空槽且互不相同
+    for (uint32_t k = 0; k < bucket_count && bucket_sizes[order[k]] > 0; k++) {
+        uint32_t bucket = order[k];
+        uint32_t displacement;
+        for (displacement = 0; displacement < MAX_DISPLACEMENT; displacement++) {
+            int placed = 1;
+            for (size_t i = 0; i < ENTRY_COUNT && placed; i++) {
+                if (bucket_of[i] != (int)bucket) {
+                    continue;
+                }
+                uint32_t slot = identifier_slot(hashes[i], displacement) & (slot_count - 1);
+                if (slots[slot] != -1) {
+                    placed = 0;
+                    break;
+                }
+                slots[slot] = (int)i;
+            }
+            if (placed) {
+                break;
+            }
+            // 撤销本次尝试占用的槽位
+            for (uint32_t s = 0; s < slot_count; s++) {
+                if (slots[s] >= 0 && bucket_of[slots[s]] == (int)bucket) {
+                    slots[s] = -1;
+                }
+            }
+        }
+        if (displacement == MAX_DISPLACEMENT) {
+            fprintf(stderr, "找不到完美哈希，请调整槽数\n");
+            return 1;
+        }
+        displacements[bucket] = (uint16_t)displacement;
+    }
+
+    FILE* out = fopen(argv[1], "w");
+    if (out == NULL) {
+        fprintf(stderr, "无法写入 %s\n", argv[1]);
+        return 1;
+    }
+    fprintf(out, "// 由 gen_identifier_table 根据 identifiers.def 生成，请勿手工修改\n");
+    fprintf(out, "#include <math.h>\n\n#include \"identifiers.h\"\n\n");
+    fprintf(out, "const uint32_t identifier_slot_mask = %uu;\n", slot_count - 1);
+    fprintf(out, "const uint32_t identifier_bucket_mask = %uu;\n\n", bucket_count - 1);
+    fprintf(out, "const uint16_t identifier_displacements[%u] = {", bucket_count);
+    for (uint32_t b = 0; b < bucket_count; b++) {
+        fprintf(out, "%s%u", b % 16 == 0 ? "\n    " : " ", displacements[b]);
+        if (b + 1 < bucket_count) {
+            fprintf(out, ",");
+        }
+    }
+    fprintf(out, "\n};\n\n");
+
+    // 函数与常量各自按清单次序编号，与 functions[]、constants[] 一致
+    int index[ENTRY_COUNT];
+    int functions = 0;
+    int constants = 0;
+    for (size_t i = 0; i < ENTRY_COUNT; i++) {
+        index[i] = entries[i].func != NULL ? functions++ : constants++;
+    }
+    fprintf(out, "const Identifier identifier_slots[%u] = {\n", slot_count);
+    for (uint32_t slot = 0; slot < slot_count; slot++) {
+        if (slots[slot] < 0) {
+            continue;
+        }
+        const Entry* entry = &entries[slots[slot]];
+        if (entry->func != NULL) {
+            fprintf(out, "    [%u] = {\"%s\", %zu, IDENTIFIER_FUNCTION, %d, %d, %d, %s, 0.0},\n", slot, entry->name,
+                    strlen(entry->name), entry->min_args, entry->max_args, index[slots[slot]], entry->func);
+        } else {
+            fprintf(out, "    [%u] = {\"%s\", %zu, IDENTIFIER_CONSTANT, 0, 0, %d, NULL, %s},\n", slot, entry->name,
+                    strlen(entry->name), index[slots[slot]], entry->value);
+        }
+    }
+    fprintf(out, "};\n");
+
+    free(slots);
+    free(displacements);
+    free(bucket_sizes);
+    free(order);
+    return fclose(out) == 0 ? 0 : 1;
+}
@@ -0,0 +1,92 @@
+// 单元测试：表达式缓存的键规范化、LRU 淘汰顺序与统计计数
+#include <stdio.h>
+#include <string.h>
+
+#include "cache.h"
+
+// 解析到 pool，返回根节点
+static NodeId parse(const char* input, AstPool* pool) {
+    Parser parser;
+    init_parser(&parser, input);
+    NodeId root = parse_expression(&parser);
+    *pool = parser.pool;
+    return root;
+}
+
+int main(void) {
+    /* 1) 规范化：空白不敏感，但不合并相邻的数字/标识符 */
+    {
+        const char* cases[][2] = {
+            {"2+3", "2+3"},
+            {"  2 +\t3  ", "2+3"},
+            {"sin ( pi / 2 )", "sin(pi/2)"},
+            {"1   2", "1 2"},
+        };
+        char key[64];
+        for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+            normalize_expression(cases[i][0], key, sizeof(key));
+            if (strcmp(key, cases[i][1]) != 0) {
+                fprintf(stderr, "测试失败：normalize('%s') 期望 '%s'，实际 '%s'\n", cases[i][0], cases[i][1], key);
+                return 1;
+            }
+        }
+    }
+
+    /* 2) LRU 淘汰顺序与计数 */
+    {
+        ExprCache cache;
+        if (!init_cache(&cache, 2)) {
+            fprintf(stderr, "测试失败：缓存初始化失败\n");
+            return 1;
+        }
+        AstPool pools[3];
+        NodeId roots[3];
+        roots[0] = parse("1+1", &pools[0]);
+        roots[1] = parse("2+2", &pools[1]);
+        roots[2] = parse("3+3", &pools[2]);
+        const AstPool* a = cache_insert(&cache, "a", &pools[0], roots[0]);
+        cache_insert(&cache, "b", &pools[1], roots[1]);
+        if (a == NULL || pools[0].nodes != NULL) {  /* 缓存接管节点，调用方的池被清空 */
+            fprintf(stderr, "测试失败：插入后缓存应接管节点池\n");
+            return 1;
+        }
+        NodeId root;
+        if (cache_lookup(&cache, "a", &root) != a || root != roots[0]) {  /* a 变为最近使用 */
+            fprintf(stderr, "测试失败：期望命中 a\n");
+            return 1;
+        }
+        const AstPool* c = cache_insert(&cache, "c", &pools[2], roots[2]);  /* 淘汰 b */
+        if (cache_lookup(&cache, "b", &root) != NULL) {
+            fprintf(stderr, "测试失败：b 应已被淘汰\n");
+            return 1;
+        }
+        if (cache_lookup(&cache, "a", &root) != a || cache_lookup(&cache, "c", &root) != c) {
+            fprintf(stderr, "测试失败：a、c 应仍在缓存中\n");
+            return 1;
+        }
+        if (cache.hits != 3 || cache.misses != 1 || cache.evictions != 1 || cache.size != 2) {
+            fprintf(stderr, "测试失败：统计不符 hits=%zu misses=%zu evictions=%zu size=%zu\n",
+                    cache.hits, cache.misses, cache.evictions, cache.size);
+            return 1;
+        }
+        free_cache(&cache);
+    }
+
+    /* 3) 容量为 0 时不接管节点池 */
+    {
+        ExprCache cache;
+        init_cache(&cache, 0);
+        AstPool a;
+        NodeId root = parse("1+1", &a);
+        if (cache_insert(&cache, "a", &a, root) != NULL || cache_lookup(&cache, "a", &root) != NULL ||
+            a.nodes == NULL) {
+            fprintf(stderr, "测试失败：容量为 0 时不应缓存\n");
+            return 1;
+        }
+        free_ast_pool(&a);
+        free_cache(&cache);
+    }
+
+    printf("表达式缓存单元测试通过\n");
+    return 0;
+}
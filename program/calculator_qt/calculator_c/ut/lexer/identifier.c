@@ -0,0 +1,109 @@
+// 单元测试：函数与常量的完美哈希查找（注册表中每个名称一次命中，其他名称不误判）与词法分析器的描述符
+#include <stdio.h>
+#include <string.h>
+
+#include "identifiers.h"
+#include "functions.h"
+#include "constants.h"
+// 同目录的 lexer.h 是占位文件，词法分析器的声明经 parser.h 引入
+#include "parser.h"
+
+int main(void) {
+    /* 1) 注册表中的每个函数与常量都能查到，描述符与 functions[]、constants[] 一致 */
+    {
+        int found = 0;
+        for (int i = 0; get_function_at(i) != NULL; i++, found++) {
+            const Function* function = get_function_at(i);
+            const Identifier* identifier = lookup_identifier(function->name, strlen(function->name));
+            if (identifier == NULL || !(identifier->flags & IDENTIFIER_FUNCTION) || identifier->index != i ||
+                identifier->func != function->func || identifier->min_args != function->min_args ||
+                identifier->max_args != function->max_args || find_function(function->name) != i) {
+                fprintf(stderr, "测试失败：函数 %s 的描述符不符\n", function->name);
+                return 1;
+            }
+        }
+        for (int i = 0; i < get_constants_count(); i++, found++) {
+            const Constant* constant = get_constant_at(i);
+            const Identifier* identifier = lookup_identifier(constant->name, strlen(constant->name));
+            if (identifier == NULL || !(identifier->flags & IDENTIFIER_CONSTANT) || identifier->index != i ||
+                identifier->value != constant->value || get_constant_value(constant->name) != constant->value) {
+                fprintf(stderr, "测试失败：常量 %s 的描述符不符\n", constant->name);
+                return 1;
+            }
+        }
+        int slots = 0;
+        for (uint32_t i = 0; i <= identifier_slot_mask; i++) {
+            slots += identifier_slots[i].name != NULL;
+        }
+        if (slots != found || identifier_slot_mask + 1 < 2 * (uint32_t)found) {
+            fprintf(stderr, "测试失败：哈希表有 %d 个名称、%u 个槽位，注册表有 %d 个\n", slots,
+                    identifier_slot_mask + 1, found);
+            return 1;
+        }
+    }
+
+    /* 2) 前缀、加长、大小写不同与空名称都查不到；函数名不算常量，反之亦然 */
+    {
+        const char* names[] = {"", "s", "si", "sinh", "Sin", "SQRT", "p", "pii", "ee", "lg", "abs1", "x"};
+        for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+            if (lookup_identifier(names[i], strlen(names[i])) != NULL || is_function(names[i]) ||
+                is_constant(names[i])) {
+                fprintf(stderr, "测试失败：'%s' 不应被识别\n", names[i]);
+                return 1;
+            }
+        }
+        if (is_constant("sin") || is_function("pi") || find_function("e") != -1 || find_constant("cos") != -1) {
+            fprintf(stderr, "测试失败：函数与常量不应混淆\n");
+            return 1;
+        }
+    }
+
+    /* 3) 名称不必以 '\0' 结尾：直接在表达式中按长度查找 */
+    {
+        const char* text = "sqrtpi";
+        const Identifier* sqrt_identifier = lookup_identifier(text, 4);
+        const Identifier* pi_identifier = lookup_identifier(text + 4, 2);
+        if (sqrt_identifier == NULL || strcmp(sqrt_identifier->name, "sqrt") != 0 || pi_identifier == NULL ||
+            strcmp(pi_identifier->name, "pi") != 0 || lookup_identifier(text, 6) != NULL) {
+            fprintf(stderr, "测试失败：按长度查找不符\n");
+            return 1;
+        }
+        double arg = 16.0;
+        if (evaluate_function("sqrt", &arg, 1) != 4.0 || evaluate_function("sqrt", &arg, 2) != 0.0 ||
+            evaluate_function("nope", &arg, 1) != 0.0 || get_function("abs") != func_abs ||
+            get_function_arg_count("ln") != 1) {
+            fprintf(stderr, "测试失败：按名称求值不符\n");
+            return 1;
+        }
+    }
+
+    /* 4) 词法分析器的记号带有描述符，超长标识符不会被截断后误判 */
+    {
+        Lexer lexer;
+        init_lexer(&lexer, "cos(e)");
+        if (lexer.current_token.type != TOKEN_FUNCTION || lexer.current_token.identifier == NULL ||
+            lexer.current_token.identifier->index != find_function("cos")) {
+            fprintf(stderr, "测试失败：函数记号应带有描述符\n");
+            return 1;
+        }
+        consume_token(&lexer);
+        consume_token(&lexer);
+        if (lexer.current_token.type != TOKEN_CONSTANT || lexer.current_token.identifier->value != get_constant_value("e")) {
+            fprintf(stderr, "测试失败：常量记号应带有描述符\n");
+            return 1;
+        }
+
+        char name[48];
+        memset(name, 'a', sizeof(name) - 1);
+        memcpy(name, "abs", 3);
+        name[sizeof(name) - 1] = '\0';
+        init_lexer(&lexer, name);
+        if (lexer.current_token.type != TOKEN_ERROR) {
+            fprintf(stderr, "测试失败：超长标识符应为未知标识符\n");
+            return 1;
+        }
+    }
+
+    printf("标识符查找单元测试通过\n");
+    return 0;
+}
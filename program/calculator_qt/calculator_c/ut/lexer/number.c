@@ -0,0 +1,85 @@
+// 单元测试：词法分析器的数字字面量（指数、十六进制、分隔符）与数字错误的位置信息
+#include <stdio.h>
+#include <string.h>
+
+// 同目录的 lexer.h 是占位文件，词法分析器的声明经 parser.h 引入
+#include "parser.h"
+#include "pipe.h"
+
+int main(void) {
+    /* 1) 数字字面量及其后的 Token */
+    {
+        struct { const char* input; double value; TokenType next; } cases[] = {
+            {"42", 42.0, TOKEN_END},
+            {".5", 0.5, TOKEN_END},
+            {"1.5e3", 1500.0, TOKEN_END},
+            {"2.5E-1)", 0.25, TOKEN_RPAREN},
+            {"0x1.8p1", 3.0, TOKEN_END},
+            {"1_000 + 1", 1000.0, TOKEN_OPERATOR},
+            {"2e", 2.0, TOKEN_CONSTANT},
+        };
+        for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+            Lexer lexer;
+            init_lexer(&lexer, cases[i].input);
+            if (lexer.current_token.type != TOKEN_NUMBER || lexer.current_token.value != cases[i].value) {
+                fprintf(stderr, "测试失败：'%s' 应识别为数字 %g\n", cases[i].input, cases[i].value);
+                return 1;
+            }
+            consume_token(&lexer);
+            if (lexer.current_token.type != cases[i].next) {
+                fprintf(stderr, "测试失败：'%s' 数字之后的 Token 类型不符\n", cases[i].input);
+                return 1;
+            }
+        }
+    }
+
+    /* 2) 格式错误与上溢：错误 Token，信息给出完整词素与出错字符的位置 */
+    {
+        struct { const char* input; const char* message; } cases[] = {
+            {"1 + 1.2.3", "无效的数字格式: 1.2.3（位置 7）"},
+            {"1__0", "无效的数字格式: 1__0（位置 1）"},
+            {"2 * 1e999", "数字超出范围: 1e999（位置 4）"},
+        };
+        for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+            Lexer lexer;
+            init_lexer(&lexer, cases[i].input);
+            while (lexer.current_token.type != TOKEN_END && lexer.current_token.type != TOKEN_ERROR) {
+                consume_token(&lexer);
+            }
+            if (lexer.current_token.type != TOKEN_ERROR || lexer.error.type != LEXICAL_ERROR ||
+                strcmp(lexer.error.message, cases[i].message) != 0) {
+                fprintf(stderr, "测试失败：'%s' 的错误信息为 '%s'，期望 '%s'\n", cases[i].input,
+                        lexer.error.message, cases[i].message);
+                return 1;
+            }
+        }
+    }
+
+    /* 3) 求值入口报告词法错误而不是笼统的解析失败 */
+    {
+        ExprCache cache;
+        init_cache(&cache, 4);
+        char key[64];
+        double result = 0.0;
+        CalcError error;
+        if (evaluate_line(&cache, "3 * 1.2.3", key, sizeof(key), &result, &error) ||
+            strcmp(error.message, "无效的数字格式: 1.2.3（位置 7）") != 0) {
+            fprintf(stderr, "测试失败：求值入口的错误信息为 '%s'\n", error.message);
+            return 1;
+        }
+        if (!evaluate_line(&cache, "0x10 + 1_000", key, sizeof(key), &result, &error) || result != 1016.0) {
+            fprintf(stderr, "测试失败：'0x10 + 1_000' 的结果为 %g\n", result);
+            return 1;
+        }
+        // 缓存键保留指数标记与符号之间的空白："1e + 5" 是 1 与常量 e 之后多余的输入，不能命中 "1e+5"
+        if (!evaluate_line(&cache, "1e+5", key, sizeof(key), &result, &error) || result != 1e5 ||
+            evaluate_line(&cache, "1e + 5", key, sizeof(key), &result, &error)) {
+            fprintf(stderr, "测试失败：'1e + 5' 不应命中 '1e+5' 的缓存\n");
+            return 1;
+        }
+        free_cache(&cache);
+    }
+
+    printf("词法分析单元测试通过\n");
+    return 0;
+}
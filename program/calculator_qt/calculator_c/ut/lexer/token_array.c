@@ -0,0 +1,132 @@
+// 单元测试：一次切分的记号数组（偏移与长度引用原文、结构体内缓冲与堆上增长、与逐个取记号一致）及解析器前瞻
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// 同目录的 lexer.h 是占位文件，词法分析器的声明经 parser.h 引入
+#include "parser.h"
+#include "constants.h"
+
+int main(void) {
+    /* 1) 记号只记录位置与长度，数字就地解析，标识符带描述符 */
+    {
+        if (sizeof(Token) != 24) {
+            fprintf(stderr, "测试失败：Token 应为 24 字节，实际 %zu\n", sizeof(Token));
+            return 1;
+        }
+        const char* input = "  sqrt(1.5e3) * pi-0x10";
+        struct { TokenType type; const char* text; } expected[] = {
+            {TOKEN_FUNCTION, "sqrt"}, {TOKEN_LPAREN, "("}, {TOKEN_NUMBER, "1.5e3"}, {TOKEN_RPAREN, ")"},
+            {TOKEN_OPERATOR, "*"}, {TOKEN_CONSTANT, "pi"}, {TOKEN_OPERATOR, "-"}, {TOKEN_NUMBER, "0x10"},
+            {TOKEN_END, ""},
+        };
+        TokenArray tokens;
+        init_token_array(&tokens);
+        size_t count = sizeof(expected) / sizeof(expected[0]);
+        if (!tokenize(&tokens, input) || tokens.count != count || tokens.heap != NULL) {
+            fprintf(stderr, "测试失败：应切分出 %zu 个记号且不分配堆内存\n", count);
+            return 1;
+        }
+        const Token* data = token_data(&tokens);
+        for (size_t i = 0; i < count; i++) {
+            if (data[i].type != expected[i].type || data[i].length != strlen(expected[i].text) ||
+                strncmp(input + data[i].offset, expected[i].text, data[i].length) != 0) {
+                fprintf(stderr, "测试失败：第 %zu 个记号应为 '%s'\n", i + 1, expected[i].text);
+                return 1;
+            }
+        }
+        if (data[2].value != 1500.0 || data[7].value != 16.0 || data[0].identifier != lookup_identifier("sqrt", 4) ||
+            data[5].identifier->value != get_constant_at(find_constant("pi"))->value || data[4].op != '*') {
+            fprintf(stderr, "测试失败：记号的值或描述符不符\n");
+            return 1;
+        }
+        free_token_array(&tokens);
+    }
+
+    /* 2) 长输入换到堆上并逐次加倍，与逐个取记号的结果一致 */
+    {
+        size_t terms = 5000;
+        char* input = (char*)malloc(terms * 16 + 1);
+        size_t length = 0;
+        for (size_t i = 0; i < terms; i++) {
+            length += (size_t)sprintf(input + length, "%s%zu.5*abs(e)", i == 0 ? "" : " + ", i);
+        }
+        TokenArray tokens;
+        init_token_array(&tokens);
+        if (!tokenize(&tokens, input) || tokens.heap == NULL || tokens.count > tokens.capacity) {
+            fprintf(stderr, "测试失败：长输入应放在堆上\n");
+            return 1;
+        }
+        Lexer lexer;
+        init_lexer(&lexer, input);
+        const Token* data = token_data(&tokens);
+        for (uint32_t i = 0; i < tokens.count; i++) {
+            const Token* token = &lexer.current_token;
+            if (data[i].type != token->type || data[i].offset != token->offset || data[i].length != token->length ||
+                memcmp(&data[i].value, &token->value, sizeof(double)) != 0) {
+                fprintf(stderr, "测试失败：第 %u 个记号与逐个取记号的结果不同\n", i + 1);
+                return 1;
+            }
+            consume_token(&lexer);
+        }
+        if (data[tokens.count - 1].type != TOKEN_END || tokens.count != terms * 7 - 1 + 1) {
+            fprintf(stderr, "测试失败：记号个数 %u 不符\n", tokens.count);
+            return 1;
+        }
+        // 再次切分短输入时复用已有的堆内存
+        Token* heap = tokens.heap;
+        if (!tokenize(&tokens, "1 + 2") || tokens.heap != heap || tokens.count != 4) {
+            fprintf(stderr, "测试失败：重新切分应复用数组\n");
+            return 1;
+        }
+        free_token_array(&tokens);
+        free(input);
+    }
+
+    /* 3) 词法错误：数组以 TOKEN_ERROR 结尾并带有错误信息 */
+    {
+        TokenArray tokens;
+        init_token_array(&tokens);
+        tokenize(&tokens, "1 + 1.2.3 + 4");
+        const Token* last = &token_data(&tokens)[tokens.count - 1];
+        if (tokens.count != 3 || last->type != TOKEN_ERROR || last->offset != 4 || tokens.error.type != LEXICAL_ERROR) {
+            fprintf(stderr, "测试失败：词法错误应结束记号数组\n");
+            return 1;
+        }
+        free_token_array(&tokens);
+    }
+
+    /* 4) 解析器按下标前瞻，越过末尾时停在末尾的记号上 */
+    {
+        Parser parser;
+        init_parser(&parser, "abs(-2)");
+        if (parser_peek(&parser, 0)->type != TOKEN_FUNCTION || parser_peek(&parser, 3)->type != TOKEN_NUMBER ||
+            parser_peek(&parser, 5)->type != TOKEN_END || parser_peek(&parser, 100)->type != TOKEN_END) {
+            fprintf(stderr, "测试失败：前瞻结果不符\n");
+            return 1;
+        }
+        NodeId root = parse_expression(&parser);
+        if (root == NODE_NONE || parser_current(&parser)->type != TOKEN_END || parser.position != 5) {
+            fprintf(stderr, "测试失败：解析应停在末尾\n");
+            return 1;
+        }
+        free_parser(&parser);
+
+        // 未完成的解析停在无效数字上时报告词法错误，停在之前时不报告
+        init_parser(&parser, "(1 + 2..5)");
+        if (parse_expression(&parser) != NODE_NONE || parser_lexical_error(&parser) == NULL) {
+            fprintf(stderr, "测试失败：应报告词法错误\n");
+            return 1;
+        }
+        free_parser(&parser);
+        init_parser(&parser, "(1 2) + 2..5");
+        if (parse_expression(&parser) != NODE_NONE || parser_lexical_error(&parser) != NULL) {
+            fprintf(stderr, "测试失败：解析停在词法错误之前时不应报告\n");
+            return 1;
+        }
+        free_parser(&parser);
+    }
+
+    printf("记号数组单元测试通过\n");
+    return 0;
+}
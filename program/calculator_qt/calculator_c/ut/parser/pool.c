@@ -0,0 +1,110 @@
+// 单元测试：AST 节点池的紧凑节点、函数调用参数表、出错时的整体释放与收缩
+#include <stdio.h>
+#include <string.h>
+
+#include "parser.h"
+#include "calculator.h"
+#include "functions.h"
+#include "constants.h"
+
+static int parse_and_evaluate(const char* input, double* value, AstPool* pool) {
+    Parser parser;
+    init_parser(&parser, input);
+    NodeId root = parse_expression(&parser);
+    if (root == NODE_NONE || parser_current(&parser)->type != TOKEN_END) {
+        free_parser(&parser);
+        return 0;
+    }
+    Calculator calc;
+    init_calculator(&calc);
+    *value = evaluate(&calc, &parser.pool, root);
+    *pool = parser.pool;
+    return calc.error.message[0] == '\0';
+}
+
+int main(void) {
+    /* 1) 节点只含编号与下标，不再内嵌名称 */
+    if (sizeof(ASTNode) != 16) {
+        fprintf(stderr, "测试失败：ASTNode 应为 16 字节，实际 %zu\n", sizeof(ASTNode));
+        return 1;
+    }
+
+    /* 2) 求值结果不变；嵌套调用的参数各自连续存放 */
+    {
+        struct { const char* input; double value; uint32_t nodes; } cases[] = {
+            {"2 + 3 * 4", 14.0, 5},
+            {"-(-2) + +3", 5.0, 6},
+            {"sqrt(abs(-16)) + abs(sqrt(81))", 13.0, 8},
+            {"sqrt(16) * pi / pi", 4.0, 6},
+            {"exp(ln(abs(-(2))))", 2.0, 5},
+        };
+        for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+            double value;
+            AstPool pool;
+            if (!parse_and_evaluate(cases[i].input, &value, &pool)) {
+                fprintf(stderr, "测试失败：'%s' 解析或求值失败\n", cases[i].input);
+                return 1;
+            }
+            if (value != cases[i].value || pool.node_count != cases[i].nodes) {
+                fprintf(stderr, "测试失败：'%s' 结果 %g、%u 个节点，期望 %g、%u 个\n", cases[i].input, value,
+                        pool.node_count, cases[i].value, cases[i].nodes);
+                return 1;
+            }
+            if (pool.pending_count != 0) {
+                fprintf(stderr, "测试失败：'%s' 解析结束后参数栈应为空\n", cases[i].input);
+                return 1;
+            }
+            free_ast_pool(&pool);
+        }
+    }
+
+    /* 3) 节点记录注册表编号 */
+    {
+        Parser parser;
+        init_parser(&parser, "cos(e)");
+        NodeId root = parse_expression(&parser);
+        const ASTNode* call = ast_node(&parser.pool, root);
+        const ASTNode* arg = ast_node(&parser.pool, ast_args(&parser.pool, call)[0]);
+        if (call->type != NODE_FUNCTION_CALL || call->id != find_function("cos") || call->arg_count != 1 ||
+            arg->type != NODE_CONSTANT || arg->id != find_constant("e")) {
+            fprintf(stderr, "测试失败：函数与常量节点应记录注册表编号\n");
+            return 1;
+        }
+        free_parser(&parser);
+    }
+
+    /* 4) 语法错误时部分构造的树随节点池一次释放 */
+    {
+        const char* inputs[] = {"sqrt(1 + ", "(2 * (3 + 4)", "1 + * 2", "abs(sin(1)"};
+        for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+            Parser parser;
+            init_parser(&parser, inputs[i]);
+            if (parse_expression(&parser) != NODE_NONE && parser_current(&parser)->type == TOKEN_END) {
+                fprintf(stderr, "测试失败：'%s' 应解析失败\n", inputs[i]);
+                return 1;
+            }
+            free_parser(&parser);
+            if (parser.pool.nodes != NULL || parser.pool.node_count != 0) {
+                fprintf(stderr, "测试失败：free_parser 后节点池应为空\n");
+                return 1;
+            }
+        }
+    }
+
+    /* 5) 收缩到实际大小：节点与参数表各一块，临时参数栈释放 */
+    {
+        double value;
+        AstPool pool;
+        parse_and_evaluate("abs(-1) + 2", &value, &pool);
+        compact_ast_pool(&pool);
+        size_t expected = pool.node_count * sizeof(ASTNode) + pool.arg_count * sizeof(NodeId);
+        if (pool.pending != NULL || ast_pool_bytes(&pool) != expected || pool.node_count != 5) {
+            fprintf(stderr, "测试失败：收缩后占用 %zu 字节，期望 %zu 字节\n", ast_pool_bytes(&pool), expected);
+            return 1;
+        }
+        free_ast_pool(&pool);
+    }
+
+    printf("AST 节点池单元测试通过\n");
+    return 0;
+}
@@ -0,0 +1,147 @@
+// 单元测试：调度场求值器与 AST 求值结果、报错一致，栈溢出报错，交互模式的缓存准入
+#include <stdio.h>
+#include <string.h>
+
+#include "shunting_yard.h"
+#include "parser.h"
+#include "calculator.h"
+#include "cache.h"
+#include "pipe.h"
+
+// 经 AST 求值（不使用缓存），作为对照
+static int evaluate_ast(const char* input, double* result, CalcError* error) {
+    ExprCache cache;
+    init_cache(&cache, 0);
+    char key[512];
+    int ok = evaluate_line(&cache, input, key, sizeof(key), result, error);
+    free_cache(&cache);
+    return ok;
+}
+
+int main(void) {
+    ShuntingYard yard;
+
+    /* 1) 结果与 AST 求值逐位相同：优先级、左结合的 '^'、一元操作符、函数与常量 */
+    {
+        const char* inputs[] = {
+            "2 + 3 * 4", "2 * 3 ^ 2", "2 ^ 3 ^ 2", "10 - 4 - 3", "64 / 4 / 2", "-2 ^ 2", "2 ^ -1",
+            "--3 - -+2", "-(2 + 3) * -4", "sqrt(16) + abs(-3) * 2", "sin(pi / 6) ^ 2 + cos(pi / 6) ^ 2",
+            "exp(ln(abs(-(2))))", "((((((2+3)*4)-5)/6)^2)+1)", "2^(3+1) - sqrt(16) * 2", "-sqrt(4)",
+            "log(1000) / ln(e)", "0x10 + 1_000", "sqrt()", "1.5e3 * .5", "3",
+        };
+        for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+            double expected = 0.0;
+            double actual = 0.0;
+            CalcError error;
+            if (!evaluate_ast(inputs[i], &expected, &error)) {
+                fprintf(stderr, "测试失败：'%s' AST 求值失败：%s\n", inputs[i], error.message);
+                return 1;
+            }
+            if (!evaluate_direct(&yard, inputs[i], &actual, &error)) {
+                fprintf(stderr, "测试失败：'%s' 调度场求值失败：%s\n", inputs[i], error.message);
+                return 1;
+            }
+            if (memcmp(&actual, &expected, sizeof(double)) != 0) {
+                fprintf(stderr, "测试失败：'%s' 结果 %.17g，AST 求值 %.17g\n", inputs[i], actual, expected);
+                return 1;
+            }
+        }
+    }
+
+    /* 2) 出错时的类型与信息与 AST 求值相同：词法错误优先，其次语法错误，最后求值错误 */
+    {
+        const char* inputs[] = {
+            "", "1 +", "* 2", "(1 + 2", "1 + 2)", "2 3", "(2 3)", "sqrt 4", "sqrt(1 + ", "foo + 1",
+            "1 + foo", "1 / 0", "1 / (2 - 2) + 3", "1 / 0 + (", "3 * 1.2.3", "1 / 0 + 1.2.3", "()", "2 $ 3",
+        };
+        for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+            double result;
+            CalcError expected;
+            CalcError actual;
+            if (evaluate_ast(inputs[i], &result, &expected) || evaluate_direct(&yard, inputs[i], &result, &actual)) {
+                fprintf(stderr, "测试失败：'%s' 应求值失败\n", inputs[i]);
+                return 1;
+            }
+            if (actual.type != expected.type || strcmp(actual.message, expected.message) != 0) {
+                fprintf(stderr, "测试失败：'%s' 报错 \"%s\"，AST 求值报错 \"%s\"\n", inputs[i], actual.message,
+                        expected.message);
+                return 1;
+            }
+        }
+    }
+
+    /* 3) 栈容量：嵌套到容量以内可以求值，超出时报告语法错误而不越界 */
+    {
+        char input[4 * SHUNTING_YARD_DEPTH + 16];
+        size_t length = 0;
+        for (int i = 0; i < SHUNTING_YARD_DEPTH - 1; i++) {
+            input[length++] = '(';
+        }
+        input[length++] = '1';
+        for (int i = 0; i < SHUNTING_YARD_DEPTH - 1; i++) {
+            input[length++] = ')';
+        }
+        input[length] = '\0';
+        double result = 0.0;
+        CalcError error;
+        if (!evaluate_direct(&yard, input, &result, &error) || result != 1.0) {
+            fprintf(stderr, "测试失败：%d 层括号应能求值\n", SHUNTING_YARD_DEPTH - 1);
+            return 1;
+        }
+
+        length = 0;
+        for (int i = 0; i < SHUNTING_YARD_DEPTH + 1; i++) {
+            input[length++] = '-';
+        }
+        input[length++] = '1';
+        input[length] = '\0';
+        if (evaluate_direct(&yard, input, &result, &error) || error.type != SYNTAX_ERROR ||
+            strstr(error.message, "嵌套过深") == NULL) {
+            fprintf(stderr, "测试失败：超出栈容量时应报告嵌套过深\n");
+            return 1;
+        }
+        // 左结合的同级运算随读随算，长链不占栈
+        length = 0;
+        for (int i = 0; i < 4 * SHUNTING_YARD_DEPTH && length + 3 < sizeof(input); i++) {
+            input[length++] = '1';
+            input[length++] = '+';
+        }
+        input[length++] = '1';
+        input[length] = '\0';
+        if (!evaluate_direct(&yard, input, &result, &error) || result != (double)(length / 2 + 1)) {
+            fprintf(stderr, "测试失败：长加法链应能求值\n");
+            return 1;
+        }
+    }
+
+    /* 4) 交互模式：首次出现的行直接求值不入缓存，再次出现时解析并缓存，之后命中 */
+    {
+        ExprCache cache;
+        init_cache(&cache, 16);
+        char key[64];
+        double result = 0.0;
+        CalcError error;
+        size_t expected_size[] = {0, 1, 1};
+        for (size_t round = 0; round < 3; round++) {
+            if (!evaluate_line_direct(&cache, "2 * (3 + 4)", key, sizeof(key), &result, &error) || result != 14.0 ||
+                cache.size != expected_size[round]) {
+                fprintf(stderr, "测试失败：第 %zu 次求值后缓存有 %zu 个条目\n", round + 1, cache.size);
+                return 1;
+            }
+        }
+        if (cache.hits != 1 || cache.misses != 2) {
+            fprintf(stderr, "测试失败：命中 %zu 次、未命中 %zu 次\n", cache.hits, cache.misses);
+            return 1;
+        }
+        // 直接求值时的求值错误照常报告
+        if (evaluate_line_direct(&cache, "1 / 0", key, sizeof(key), &result, &error) ||
+            strcmp(error.message, "除零错误") != 0) {
+            fprintf(stderr, "测试失败：'1 / 0' 应报告除零错误\n");
+            return 1;
+        }
+        free_cache(&cache);
+    }
+
+    printf("调度场求值器单元测试通过\n");
+    return 0;
+}
@@ -0,0 +1,164 @@
+// 单元测试：管道模式的按块行读取（跨块的长行、无换行结尾、\r\n）与逐行输出
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "pipe.h"
+
+// 写入临时文件并回到开头
+static FILE* temp_input(const char* text, size_t length) {
+    FILE* file = tmpfile();
+    if (file == NULL || fwrite(text, 1, length, file) != length) {
+        return NULL;
+    }
+    fflush(file);
+    rewind(file);
+    return file;
+}
+
+static char* read_all(FILE* file) {
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    rewind(file);
+    char* text = (char*)malloc((size_t)size + 1);
+    size_t n = fread(text, 1, (size_t)size, file);
+    text[n] = '\0';
+    return text;
+}
+
+int main(void) {
+    /* 1) 行读取：块只有 64 字节，超长行使缓冲区增长，最后一行没有换行 */
+    {
+        char text[20000];
+        size_t length = 0;
+        memcpy(text, "ab\r\n\n", 5);
+        length = 5;
+        memset(text + length, 'x', 10000);
+        length += 10000;
+        text[length++] = '\n';
+        memcpy(text + length, "tail", 4);
+        length += 4;
+
+        FILE* file = temp_input(text, length);
+        LineReader reader;
+        if (file == NULL || !line_reader_init(&reader, fileno(file), 64)) {
+            fprintf(stderr, "测试失败：初始化行读取器失败\n");
+            return 1;
+        }
+        size_t expected[] = {2, 0, 10000, 4};
+        size_t count = 0;
+        int status = 1;
+        while (status > 0) {
+            char* line;
+            size_t line_length;
+            while ((line = line_reader_next(&reader, &line_length)) != NULL) {
+                if (count >= 4 || line_length != expected[count] || strlen(line) != line_length) {
+                    fprintf(stderr, "测试失败：第 %zu 行长度 %zu 不符\n", count + 1, line_length);
+                    return 1;
+                }
+                count++;
+            }
+            status = line_reader_fill(&reader);
+        }
+        char* line;
+        size_t line_length;
+        while ((line = line_reader_next(&reader, &line_length)) != NULL) {
+            if (count >= 4 || line_length != expected[count]) {
+                fprintf(stderr, "测试失败：第 %zu 行长度 %zu 不符\n", count + 1, line_length);
+                return 1;
+            }
+            count++;
+        }
+        if (status < 0 || count != 4 || reader.bytes != length) {
+            fprintf(stderr, "测试失败：读到 %zu 行、%llu 字节\n", count, reader.bytes);
+            return 1;
+        }
+        line_reader_free(&reader);
+        fclose(file);
+    }
+
+    /* 2) 管道模式：每行输入一行输出，空行与只含空白的行输出空行，quit 之后的行不再求值 */
+    {
+        char* text = (char*)malloc(32768);
+        strcpy(text, "1+2\n\n \t \n  sqrt(16) \r\n1/0\n");
+        size_t length = strlen(text);
+        for (int i = 0; i < 5000; i++) {
+            memcpy(text + length, i == 0 ? "1" : "+1", i == 0 ? 1 : 2);
+            length += i == 0 ? 1 : 2;
+        }
+        memcpy(text + length, "\n2^10\nquit\n3+3\n", 15);
+        length += 15;
+
+        FILE* input = temp_input(text, length);
+        FILE* output = tmpfile();
+        ExprCache cache;
+        PipeStats stats;
+        if (input == NULL || output == NULL || !init_cache(&cache, 16) ||
+            !run_pipe_mode(&cache, fileno(input), fileno(output), 64, &stats)) {
+            fprintf(stderr, "测试失败：管道模式运行失败\n");
+            return 1;
+        }
+        char* actual = read_all(output);
+        const char* head = "= 3\n\n\n= 4\n错误: ";
+        const char* tail = "\n= 5000\n= 1024\n";
+        size_t actual_length = strlen(actual);
+        if (strncmp(actual, head, strlen(head)) != 0 || actual_length < strlen(tail) ||
+            strcmp(actual + actual_length - strlen(tail), tail) != 0) {
+            fprintf(stderr, "测试失败：管道模式输出不符：\n%s\n", actual);
+            return 1;
+        }
+        if (stats.lines != 7 || stats.errors != 1 || stats.bytes_out != actual_length) {
+            fprintf(stderr, "测试失败：统计不符（%llu 行，%llu 个错误）\n", stats.lines, stats.errors);
+            return 1;
+        }
+        free(actual);
+        free(text);
+        free_cache(&cache);
+        fclose(input);
+        fclose(output);
+    }
+
+    /* 3) 数百 KB 的单行：20 万项的加法链照常求值，10 万层括号报告嵌套过深，都不会耗尽调用栈 */
+    {
+        const size_t terms = 200000, depth = 100000;
+        char* text = (char*)malloc(2 * terms + 2 * depth + 16);
+        size_t length = 0;
+        for (size_t i = 0; i < terms; i++) {
+            memcpy(text + length, i == 0 ? "1" : "+1", i == 0 ? 1 : 2);
+            length += i == 0 ? 1 : 2;
+        }
+        text[length++] = '\n';
+        memset(text + length, '(', depth);
+        length += depth;
+        text[length++] = '1';
+        memset(text + length, ')', depth);
+        length += depth;
+        memcpy(text + length, "\n2*3\n", 5);
+        length += 5;
+
+        FILE* input = temp_input(text, length);
+        FILE* output = tmpfile();
+        ExprCache cache;
+        PipeStats stats;
+        if (input == NULL || output == NULL || !init_cache(&cache, 16) ||
+            !run_pipe_mode(&cache, fileno(input), fileno(output), 4096, &stats)) {
+            fprintf(stderr, "测试失败：长行管道模式运行失败\n");
+            return 1;
+        }
+        char* actual = read_all(output);
+        if (strncmp(actual, "= 200000\n错误: ", strlen("= 200000\n错误: ")) != 0 ||
+            strstr(actual, "嵌套过深") == NULL || strstr(actual, "\n= 6\n") == NULL || stats.lines != 3) {
+            fprintf(stderr, "测试失败：长行输出不符：\n%s\n", actual);
+            return 1;
+        }
+        free(actual);
+        free(text);
+        free_cache(&cache);
+        fclose(input);
+        fclose(output);
+    }
+
+    printf("管道模式单元测试通过\n");
+    return 0;
+}
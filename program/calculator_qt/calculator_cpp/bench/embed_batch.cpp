@@ -0,0 +1,94 @@
+// 嵌入基准：同一表达式按批求值，比较每批启动一次可执行文件（管道模式）与 libcalc 预编译句柄的每批耗时
+//
+// 用法: bench_embed_batch [批次数] [每批行数] [可执行文件路径]
+#include "libcalc.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+namespace {
+
+const char* const expression = "sin(x) * cos(y) + sqrt(abs(x * y))";
+
+double xValue(size_t row) {
+    return 0.25 + 0.013 * static_cast<double>(row);
+}
+
+double yValue(size_t row) {
+    return 1.5 - 0.007 * static_cast<double>(row);
+}
+
+template <typename Fn>
+double secondsOf(Fn&& fn) {
+    auto begin = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t batches = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20;
+    size_t rows = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 10000;
+    std::string executable = argc > 3 ? argv[3] : "./scientific_calculator_cpp";
+
+    // 外部进程方式：每行代入取值后写成一个表达式
+    char path[] = "/tmp/bench_embed_batchXXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        std::perror("mkstemp");
+        return 1;
+    }
+    FILE* input = fdopen(fd, "w");
+    for (size_t row = 0; row < rows; row++) {
+        std::fprintf(input, "sin(%.17g) * cos(%.17g) + sqrt(abs(%.17g * %.17g))\n", xValue(row), yValue(row),
+                     xValue(row), yValue(row));
+    }
+    std::fclose(input);
+
+    std::string command = executable + " < " + path + " 2>/dev/null";
+    size_t lines = 0;
+    double process = secondsOf([&] {
+        for (size_t batch = 0; batch < batches; batch++) {
+            FILE* pipe = popen(command.c_str(), "r");
+            if (pipe == nullptr) {
+                return;
+            }
+            char buffer[256];
+            while (std::fgets(buffer, sizeof(buffer), pipe) != nullptr) {
+                lines++;
+            }
+            pclose(pipe);
+        }
+    });
+    std::remove(path);
+    if (lines != batches * rows) {
+        std::fprintf(stderr, "%s 输出 %zu 行，期望 %zu 行（可用第三个参数指定可执行文件路径）\n", executable.c_str(),
+                     lines, batches * rows);
+        return 1;
+    }
+
+    // 嵌入方式：编译一次，每批一次列式求值
+    std::vector<double> xs(rows), ys(rows), out(rows);
+    for (size_t row = 0; row < rows; row++) {
+        xs[row] = xValue(row);
+        ys[row] = yValue(row);
+    }
+    calc::Expression expr(expression);
+    std::vector<const double*> columns(expr.variableCount());
+    columns[static_cast<size_t>(expr.variableSlot("x"))] = xs.data();
+    columns[static_cast<size_t>(expr.variableSlot("y"))] = ys.data();
+    double embedded = secondsOf([&] {
+        for (size_t batch = 0; batch < batches; batch++) {
+            expr.evaluate(columns.data(), rows, out.data());
+        }
+    });
+
+    std::printf("%zu 批，每批 %zu 行\n", batches, rows);
+    std::printf("  启动进程   %10.3f 毫秒/批\n", process * 1e3 / static_cast<double>(batches));
+    std::printf("  libcalc    %10.3f 毫秒/批\n", embedded * 1e3 / static_cast<double>(batches));
+    return 0;
+}
@@ -0,0 +1,141 @@
+// 错误路径基准：在有效与无效表达式混合的输入上，比较逐行捕获异常与不抛异常的错误通道的吞吐量
+//
+// 用法: bench_error_path [行数] [无效行百分比]
+#include "parser.h"
+#include "optimizer.h"
+#include "compiler.h"
+#include "vm.h"
+#include "status.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char* const validLines[] = {
+    "2 + 3 * 4",
+    "sqrt(16) + log(100) * 2",
+    "sin(pi / 6) + cos(pi / 3)",
+    "((1.5e3 - 20) / 4) ^ 2",
+    "abs(-5) * exp(1) - ln(e)",
+};
+
+// 覆盖词法、语法与计算三类错误
+const char* const invalidLines[] = {
+    "1 / (3 - 3)",
+    "sqrt(-4) + 1",
+    "2 + $",
+    "sin(1",
+    "1.2.3 * 2",
+    "log(0)",
+};
+
+std::vector<std::string> generateLines(size_t count, unsigned invalidPercent) {
+    std::mt19937 rng(2024);
+    std::vector<std::string> lines;
+    lines.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        // 追加序号，使每一行都需要完整解析与编译
+        std::string suffix = " + " + std::to_string(i % 1000);
+        if (rng() % 100 < invalidPercent) {
+            lines.push_back(invalidLines[rng() % 6] + suffix);
+        } else {
+            lines.push_back(validLines[rng() % 5] + suffix);
+        }
+    }
+    return lines;
+}
+
+struct Totals {
+    double sum = 0.0;
+    size_t errors = 0;
+};
+
+// 旧方式：异常接口，逐行 try/catch
+Totals runWithExceptions(const std::vector<std::string>& lines) {
+    AstArena arena;
+    Optimizer optimizer;
+    VirtualMachine vm;
+    Totals totals;
+    for (const std::string& line : lines) {
+        try {
+            arena.reset();
+            Parser parser(line, arena);
+            NodeId root = optimizer.optimize(arena, parser.parse());
+            totals.sum += vm.execute(Compiler::compile(arena, root));
+        } catch (const CalcError&) {
+            totals.errors++;
+        }
+    }
+    return totals;
+}
+
+// 新方式：错误码沿返回值传递，信息不构造
+Totals runWithStatus(const std::vector<std::string>& lines) {
+    AstArena arena;
+    Optimizer optimizer;
+    VirtualMachine vm;
+    Totals totals;
+    for (const std::string& line : lines) {
+        arena.reset();
+        Expected<NodeId> root = Parser(line, arena).tryParse();
+        if (!root.ok()) {
+            totals.errors++;
+            continue;
+        }
+        Expected<Program> program = Compiler::tryCompile(arena, optimizer.optimize(arena, root.value()));
+        if (!program.ok()) {
+            totals.errors++;
+            continue;
+        }
+        Expected<double> result = vm.tryExecute(program.value());
+        if (!result.ok()) {
+            totals.errors++;
+            continue;
+        }
+        totals.sum += result.value();
+    }
+    return totals;
+}
+
+template <typename Fn>
+double measure(Fn&& fn, Totals& totals) {
+    // 取多轮中的最好成绩
+    double best = 1e300;
+    for (int round = 0; round < 5; round++) {
+        auto begin = std::chrono::steady_clock::now();
+        totals = fn();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        if (seconds < best) {
+            best = seconds;
+        }
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    unsigned invalidPercent = argc > 2 ? static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10)) : 5;
+    std::vector<std::string> lines = generateLines(count, invalidPercent);
+
+    Totals thrown;
+    double thrownSeconds = measure([&]() { return runWithExceptions(lines); }, thrown);
+    Totals status;
+    double statusSeconds = measure([&]() { return runWithStatus(lines); }, status);
+
+    if (thrown.errors != status.errors || thrown.sum != status.sum) {
+        std::fprintf(stderr, "两种方式结果不一致: 错误 %zu / %zu\n", thrown.errors, status.errors);
+        return 1;
+    }
+
+    std::printf("%zu 行，其中无效 %zu 行 (%u%%)\n", lines.size(), status.errors, invalidPercent);
+    std::printf("异常接口:  %10.0f 行/秒\n", lines.size() / thrownSeconds);
+    std::printf("错误通道:  %10.0f 行/秒\n", lines.size() / statusSeconds);
+    std::printf("加速比: %.2fx\n", thrownSeconds / statusSeconds);
+    return 0;
+}
@@ -0,0 +1,71 @@
+// JIT 基准：同一表达式反复执行时，比较字节码解释执行与本机代码的每次求值耗时
+//
+// 用法: bench_jit_tiering [执行次数]
+#include "parser.h"
+#include "optimizer.h"
+#include "compiler.h"
+#include "vm.h"
+#include "jit.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+const char* const expressions[] = {
+    "x * x + 3 * x - 2",
+    "(x + 1) / (x - 0.5) * (y + 2) - x / 3",
+    "sin(x) * cos(y) + sqrt(abs(x * y))",
+    "((x - 1) ^ 2 + (y - 2) ^ 2) / (2 * pi)",
+};
+
+template <typename Fn>
+double nanosecondsPerCall(size_t iterations, Fn&& fn) {
+    auto begin = std::chrono::steady_clock::now();
+    fn();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    return seconds * 1e9 / static_cast<double>(iterations);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t iterations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 5000000;
+    if (!JitCode::available()) {
+        std::printf("当前平台不支持 JIT\n");
+        return 0;
+    }
+
+    for (const char* input : expressions) {
+        AstArena arena;
+        Parser parser(input, arena);
+        Program program = Compiler::compile(arena, Optimizer().optimize(arena, parser.parse()));
+        std::unique_ptr<JitCode> native = JitCode::compile(program);
+
+        VirtualMachine vm;
+        double vars[2] = {0.0, 0.75};
+        double interpretedSum = 0.0;
+        double interpreted = nanosecondsPerCall(iterations, [&]() {
+            for (size_t i = 0; i < iterations; i++) {
+                vars[0] = 1.0 + static_cast<double>(i & 1023) * 0.001;
+                interpretedSum += vm.tryExecute(program, vars).value();
+            }
+        });
+
+        double nativeSum = 0.0;
+        double compiled = nanosecondsPerCall(iterations, [&]() {
+            for (size_t i = 0; i < iterations; i++) {
+                vars[0] = 1.0 + static_cast<double>(i & 1023) * 0.001;
+                nativeSum += native->run(program, vars).value();
+            }
+        });
+
+        if (interpretedSum != nativeSum) {
+            std::fprintf(stderr, "结果不一致: %s\n", input);
+            return 1;
+        }
+        std::printf("%-45s 解释 %6.1f ns/次  本机代码 %6.1f ns/次  加速 %.2fx  (%zu 字节)\n", input, interpreted,
+                    compiled, interpreted / compiled, native->codeSize());
+    }
+    return 0;
+}
@@ -0,0 +1,170 @@
+// 词法分析吞吐量基准：在生成的长表达式上比较旧词法分析器（substr + std::stod + 持有 std::string 的 Token）
+// 与 string_view/from_chars 词法分析器的 tokens/sec
+//
+// 用法: bench_lexer_throughput [表达式项数]
+#include "lexer.h"
+#include "functions.h"
+#include "constants.h"
+#include <chrono>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+
+namespace {
+
+// 旧实现的等价副本，仅用于对比
+namespace legacy {
+
+struct Token {
+    TokenType type;
+    double value;
+    std::string name;
+    char op;
+
+    Token(TokenType t, double v = 0.0, const std::string& n = "", char o = 0)
+        : type(t), value(v), name(n), op(o) {}
+};
+
+class Lexer {
+public:
+    explicit Lexer(std::string_view expression) : expression(expression), pos(0), currentToken(END) {}
+
+    const Token& next() {
+        currentToken = getNextToken();
+        return currentToken;
+    }
+
+private:
+    std::string_view expression;
+    size_t pos;
+    Token currentToken;
+
+    Token getNextToken() {
+        while (pos < expression.length() && std::isspace(expression[pos])) {
+            pos++;
+        }
+        if (pos >= expression.length()) {
+            return Token(END);
+        }
+        char ch = expression[pos];
+        if (std::isdigit(ch) || ch == '.') {
+            size_t start = pos;
+            while (pos < expression.length() && (std::isdigit(expression[pos]) || expression[pos] == '.')) {
+                pos++;
+            }
+            std::string numStr(expression.substr(start, pos - start));
+            return Token(NUMBER, std::stod(numStr));
+        }
+        if (std::isalpha(ch)) {
+            size_t start = pos;
+            while (pos < expression.length() && std::isalnum(expression[pos])) {
+                pos++;
+            }
+            std::string name(expression.substr(start, pos - start));
+            if (const Constants::Info* constant = Constants::find(name)) {
+                return Token(CONSTANT, constant->value, name);
+            }
+            if (Functions::find(name) != nullptr) {
+                return Token(FUNCTION, 0.0, name);
+            }
+            return Token(VARIABLE, 0.0, name);
+        }
+        pos++;
+        if (ch == '(') {
+            return Token(LPAREN);
+        }
+        if (ch == ')') {
+            return Token(RPAREN);
+        }
+        return Token(OPERATOR, 0.0, "", ch);
+    }
+};
+
+} // namespace legacy
+
+// 生成由 terms 个项组成的表达式；不使用指数记数法，以便旧实现也能处理
+std::string generateExpression(size_t terms) {
+    static const char* functions[] = {"sin", "cos", "sqrt", "abs", "ln", "exp"};
+    static const char* atoms[] = {"pi", "e", "x", "rate", "value2"};
+    static const char ops[] = {'+', '-', '*', '/', '^'};
+
+    std::mt19937 rng(12345);
+    std::string expr;
+    for (size_t i = 0; i < terms; i++) {
+        if (i > 0) {
+            expr += ' ';
+            expr += ops[rng() % 5];
+            expr += ' ';
+        }
+        switch (rng() % 3) {
+            case 0:
+                expr += std::to_string(rng() % 100000) + "." + std::to_string(rng() % 1000);
+                break;
+            case 1:
+                expr += atoms[rng() % 5];
+                break;
+            default:
+                expr += functions[rng() % 6];
+                expr += "(";
+                expr += std::to_string(rng() % 1000);
+                expr += ")";
+                break;
+        }
+    }
+    return expr;
+}
+
+template <typename Fn>
+double measure(Fn&& fn, size_t& tokens) {
+    // 取多轮中的最好成绩
+    double best = 1e300;
+    for (int round = 0; round < 5; round++) {
+        auto begin = std::chrono::steady_clock::now();
+        tokens = fn();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        if (seconds < best) {
+            best = seconds;
+        }
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t terms = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    std::string expr = generateExpression(terms);
+
+    size_t legacyTokens = 0;
+    double legacySeconds = measure([&]() {
+        legacy::Lexer lexer(expr);
+        size_t count = 0;
+        while (lexer.next().type != END) {
+            count++;
+        }
+        return count;
+    }, legacyTokens);
+
+    size_t tokens = 0;
+    double seconds = measure([&]() {
+        Lexer lexer(expr);
+        size_t count = 0;
+        while (lexer.next().type != END) {
+            count++;
+        }
+        return count;
+    }, tokens);
+
+    if (tokens != legacyTokens) {
+        std::fprintf(stderr, "Token 数不一致: 旧实现 %zu，新实现 %zu\n", legacyTokens, tokens);
+        return 1;
+    }
+
+    std::printf("表达式长度: %zu 字节，%zu 个 Token\n", expr.size(), tokens);
+    std::printf("旧词法分析器:  %10.2f 百万 tokens/s\n", legacyTokens / legacySeconds / 1e6);
+    std::printf("新词法分析器:  %10.2f 百万 tokens/s\n", tokens / seconds / 1e6);
+    std::printf("加速比: %.2fx\n", legacySeconds / seconds);
+    return 0;
+}
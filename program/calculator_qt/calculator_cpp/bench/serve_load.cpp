@@ -0,0 +1,173 @@
+// 服务模式负载生成器：多个连接并发地按批流水线发送请求，统计吞吐量与客户端观测到的延迟分位数。
+// 不指定地址时在进程内启动服务并监听临时的 Unix 套接字
+//
+// 用法: bench_serve_load [地址|-] [连接数] [每连接请求数] [流水线深度] [服务线程数]
+#include "server.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const char* const expressions[] = {
+    "2 + 3 * 4",
+    "sqrt(16) + log(100) * 2",
+    "sin(pi / 6) + cos(pi / 3)",
+    "((1.5e3 - 20) / 4) ^ 2",
+    "abs(-5) * exp(1) - ln(e)",
+};
+
+int connectTo(const ServerAddress& address, uint16_t port) {
+    int fd;
+    if (address.isUnix()) {
+        sockaddr_un remote{};
+        remote.sun_family = AF_UNIX;
+        address.unixPath.copy(remote.sun_path, sizeof(remote.sun_path) - 1);
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&remote), sizeof(remote)) == 0) {
+            return fd;
+        }
+    } else {
+        sockaddr_in remote{};
+        remote.sin_family = AF_INET;
+        remote.sin_port = htons(port);
+        remote.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&remote), sizeof(remote)) == 0) {
+            return fd;
+        }
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+    return -1;
+}
+
+// 一个连接：每批发送 depth 个请求后读取这一批的全部回复，延迟从整批发出时算起
+bool runClient(const ServerAddress& address, uint16_t port, size_t requests, size_t depth, size_t seed,
+               LatencyHistogram& latency) {
+    int fd = connectTo(address, port);
+    if (fd < 0) {
+        return false;
+    }
+    std::string batch;
+    char buffer[65536];
+    size_t sent = 0;
+    while (sent < requests) {
+        size_t count = std::min(depth, requests - sent);
+        batch.clear();
+        for (size_t i = 0; i < count; i++) {
+            batch += expressions[(seed + sent + i) % 5];
+            batch += " + " + std::to_string((sent + i) % 1000) + "\n";
+        }
+        Clock::time_point begin = Clock::now();
+        if (send(fd, batch.data(), batch.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(batch.size())) {
+            close(fd);
+            return false;
+        }
+        size_t lines = 0;
+        while (lines < count) {
+            ssize_t n = read(fd, buffer, sizeof(buffer));
+            if (n <= 0) {
+                close(fd);
+                return false;
+            }
+            Clock::time_point now = Clock::now();
+            uint64_t nanoseconds = static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(now - begin).count());
+            for (ssize_t i = 0; i < n; i++) {
+                if (buffer[i] == '\n') {
+                    latency.record(nanoseconds);
+                    lines++;
+                }
+            }
+        }
+        sent += count;
+    }
+    close(fd);
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string target = argc > 1 ? argv[1] : "-";
+    size_t connections = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 8;
+    size_t requests = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 100000;
+    size_t depth = argc > 4 ? std::max<size_t>(std::strtoul(argv[4], nullptr, 10), 1) : 64;
+    size_t workers = argc > 5 ? std::strtoul(argv[5], nullptr, 10) : 0;
+
+    std::unique_ptr<Server> server;
+    std::thread loop;
+    ServerAddress address;
+    uint16_t port = 0;
+    if (target == "-") {
+        ServerOptions options;
+        options.address = ServerAddress::parse("unix:/tmp/calculator_bench_serve_" + std::to_string(getpid()));
+        options.workers = workers;
+        server = std::make_unique<Server>(options);
+        server->listen();
+        loop = std::thread([&server]() { server->run(); });
+        address = options.address;
+    } else {
+        address = ServerAddress::parse(target);
+        port = address.port;
+    }
+
+    std::vector<LatencyHistogram> histograms(connections);
+    std::vector<char> succeeded(connections, 0);
+    std::vector<std::thread> clients;
+    Clock::time_point begin = Clock::now();
+    for (size_t c = 0; c < connections; c++) {
+        clients.emplace_back([&, c]() { succeeded[c] = runClient(address, port, requests, depth, c, histograms[c]); });
+    }
+    for (std::thread& client : clients) {
+        client.join();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+
+    LatencyHistogram total;
+    size_t failed = 0;
+    for (size_t c = 0; c < connections; c++) {
+        total.merge(histograms[c]);
+        failed += succeeded[c] ? 0 : 1;
+    }
+    std::printf("%zu 个连接 x %zu 个请求，流水线深度 %zu\n", connections, requests, depth);
+    std::printf("吞吐量: %.0f 请求/秒\n", total.count() / seconds);
+    std::printf("客户端延迟: %s\n", total.summary().c_str());
+
+    if (server) {
+        server->stop();
+        loop.join();
+        std::printf("服务端延迟: %s\n", server->stats().latency.summary().c_str());
+    }
+    if (failed != 0) {
+        std::fprintf(stderr, "%zu 个连接失败\n", failed);
+        return 1;
+    }
+    return 0;
+}
+
+#else
+
+int main() {
+    std::printf("当前平台不支持服务模式\n");
+    return 0;
+}
+
+#endif
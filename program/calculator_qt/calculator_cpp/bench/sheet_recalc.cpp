@@ -0,0 +1,73 @@
+// 增量重算基准：在由输入、两层派生量组成的依赖图上，比较全部重算与修改单个输入后的增量重算，
+// 以及宽层的串行与并行重算
+//
+// 用法: bench_sheet_recalc [每层单元格数] [线程数]
+#include "spreadsheet.h"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace {
+
+const size_t INPUTS = 1000;
+
+// in_i 为输入；a_j 依赖两个输入，b_j 依赖相邻的两个 a
+void build(Spreadsheet& sheet, size_t width) {
+    for (size_t i = 0; i < INPUTS; i++) {
+        sheet.assign("in" + std::to_string(i), std::to_string(i) + " / 7");
+    }
+    for (size_t j = 0; j < width; j++) {
+        std::string left = "in" + std::to_string(j % INPUTS);
+        std::string right = "in" + std::to_string((j * 7 + 1) % INPUTS);
+        sheet.assign("a" + std::to_string(j), left + " * 2 + sin(" + right + ")");
+    }
+    for (size_t j = 0; j < width; j++) {
+        std::string left = "a" + std::to_string(j);
+        std::string right = "a" + std::to_string((j + 1) % width);
+        sheet.assign("b" + std::to_string(j), "sqrt(abs(" + left + " * " + right + ")) + ln(1 + abs(" + left + "))");
+    }
+}
+
+void report(const char* label, const RecalcStats& stats) {
+    std::printf("%-18s %8zu 个单元格 %2zu 层（并行 %zu 层） %10.3f 毫秒\n", label, stats.evaluated, stats.levels,
+                stats.parallelLevels, stats.seconds * 1e3);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t width = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    size_t jobs = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 0;
+
+    SheetOptions serialOptions;
+    SheetOptions parallelOptions;
+    parallelOptions.jobs = jobs;
+    Spreadsheet serial(serialOptions);
+    Spreadsheet parallel(parallelOptions);
+    build(serial, width);
+    build(parallel, width);
+    std::printf("%zu 个单元格\n", serial.size());
+
+    RecalcStats full = serial.recalculate();
+    report("全部重算（串行）", full);
+    report("全部重算（并行）", parallel.recalculate());
+
+    // 修改一个输入：只有引用它的 a 与相邻的 b 需要重算
+    serial.assign("in0", "3.5");
+    RecalcStats incremental = serial.recalculate();
+    report("修改一个输入", incremental);
+    std::printf("增量重算加速比: %.1fx\n", full.seconds / incremental.seconds);
+
+    // 修改全部输入，两层派生量整层重算
+    for (size_t i = 0; i < INPUTS; i++) {
+        std::string name = "in" + std::to_string(i);
+        serial.assign(name, "1.5");
+        parallel.assign(name, "1.5");
+    }
+    RecalcStats serialWide = serial.recalculate();
+    RecalcStats parallelWide = parallel.recalculate();
+    report("修改全部输入（串行）", serialWide);
+    report("修改全部输入（并行）", parallelWide);
+    std::printf("并行加速比: %.2fx\n", serialWide.seconds / parallelWide.seconds);
+    return 0;
+}
@@ -0,0 +1,39 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// 批量求值选项
+struct BatchOptions {
+    size_t jobs = 0;              // 工作线程数，0 表示使用硬件并发数
+    size_t chunkLines = 16384;    // 每个任务块包含的行数
+    uint32_t jitThreshold = 100;  // 同一表达式执行这么多次后编译为本机代码，0 表示只解释执行
+};
+
+// 批量求值统计
+struct BatchStats {
+    size_t lines = 0;
+    size_t errors = 0;
+    double seconds = 0.0;
+    double linesPerSecond() const { return seconds > 0 ? lines / seconds : 0.0; }
+};
+
+// 批量求值：将输入按行切分为任务块，由工作线程池并行求值，
+// 结果按输入顺序写出（每行输入对应一行输出，空行原样保留）。
+// 每个工作线程持有独立的节点池、优化器、虚拟机与表达式缓存，线程间无共享可变状态。
+// 某个任务块因内存不足等异常整体失败时，该块每行输出一行错误并计入错误数，其余任务块不受影响。
+class BatchEvaluator {
+public:
+    explicit BatchEvaluator(const BatchOptions& options = BatchOptions()) : options(options) {}
+
+    BatchStats run(const std::string& input, std::ostream& out) const;
+    BatchStats runFile(const std::string& path, std::ostream& out) const;
+
+private:
+    BatchOptions options;
+};
+
+#endif // BATCH_H
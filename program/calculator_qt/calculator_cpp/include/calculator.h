@@ -1,17 +1,35 @@
 #ifndef CALCULATOR_H
 #define CALCULATOR_H
 
-#include <memory>
+#include <cstdint>
+#include <vector>
 #include "parser.h"
+#include "status.h"
 
 class Calculator {
 public:
-    double evaluate(std::shared_ptr<ASTNode> node);
+    // variables 按槽位顺序给出变量取值（见 AstArena::variableName），表达式不含变量时可为空
+    // 出错时抛出 EvaluationError
+    double evaluate(const AstArena& arena, NodeId root, const double* variables = nullptr);
+    // 不抛异常：出错时返回第一个计算错误
+    Expected<double> tryEvaluate(const AstArena& arena, NodeId root, const double* variables = nullptr);
+    // 最近一次求值实际计算的节点数；共享节点（见 DagBuilder）每次求值只计算一次
+    size_t evaluatedNodes() const { return visited; }
     
 private:
-    double applyFunction(const std::string& funcName, const std::vector<double>& args);
+    const double* variables = nullptr;
+    Status status;
+    size_t visited = 0;
+    // 共享节点的求值结果，memoEpoch[id] 等于当前 epoch 时有效；容量在各次求值间复用
+    std::vector<double> memoValues;
+    std::vector<uint32_t> memoEpoch;
+    uint32_t epoch = 0;
+
+    double fail(const Status& error);
+    double evaluateNode(const AstArena& arena, NodeId id);
+    double computeNode(const AstArena& arena, const ASTNode& node);
     double applyOperator(char op, double left, double right);
     double applyUnaryOperator(char op, double operand);
 };
 
-#endif // CALCULATOR_H
\ No newline at end of file
+#endif // CALCULATOR_H
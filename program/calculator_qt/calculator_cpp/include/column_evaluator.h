@@ -0,0 +1,33 @@
+#ifndef COLUMN_EVALUATOR_H
+#define COLUMN_EVALUATOR_H
+
+#include <vector>
+#include "compiler.h"
+#include "simd_kernels.h"
+#include "vector_math.h"
+
+// 列式求值：对整列输入一次执行字节码，每条指令作用于一个行块，
+// 四则运算与取负由 SIMD 运算核完成。默认（MATH_LIBM）结果与逐行 VirtualMachine::execute 逐位一致；
+// 选择 MATH_ULP1 / MATH_ULP4 时内置函数整块调用向量数学核，误差不超过相应的 ULP 档位。
+class ColumnEvaluator {
+public:
+    static constexpr size_t BLOCK_SIZE = 512;
+
+    explicit ColumnEvaluator(SimdLevel level = detectSimdLevel(), MathAccuracy accuracy = MATH_LIBM);
+
+    // columns[slot] 指向 Program::variables[slot] 的 count 个取值，结果写入 out[0..count)
+    void evaluate(const Program& program, const double* const* columns, size_t count, double* out);
+    SimdLevel level() const { return simdLevel; }
+    MathAccuracy accuracy() const { return mathAccuracy; }
+
+private:
+    SimdLevel simdLevel;
+    const ColumnKernels& kernels;
+    MathAccuracy mathAccuracy;
+    const MathKernels& math;
+    std::vector<double> lanes;        // maxStack 个行块组成的值栈，其后是 temps 个临时行块
+
+    void evaluateBlock(const Program& program, const double* const* columns, size_t offset, size_t rows, double* out);
+};
+
+#endif // COLUMN_EVALUATOR_H
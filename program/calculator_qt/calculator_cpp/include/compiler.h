@@ -0,0 +1,80 @@
+#ifndef COMPILER_H
+#define COMPILER_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "parser.h"
+#include "functions.h"
+#include "status.h"
+
+// 字节码操作码
+enum OpCode : uint8_t {
+    OP_PUSH_CONST,  // 压入常量池中的值
+    OP_LOAD_VAR,    // 压入变量槽位中的值
+    OP_ADD,
+    OP_SUB,
+    OP_MUL,
+    OP_DIV,
+    OP_POW,
+    OP_NEG,         // 一元负号
+    OP_CALL,        // 按函数槽位调用，参数个数在 argc 中
+    OP_STORE_TEMP,  // 把栈顶复制到临时槽位（不出栈），供共享子表达式复用
+    OP_LOAD_TEMP    // 压入临时槽位中的值
+};
+
+// 字节码指令
+struct Instruction {
+    OpCode op;
+    uint8_t argc;       // OP_CALL 的参数个数
+    uint32_t operand;   // 常量下标、变量槽位、函数槽位或临时槽位
+};
+
+class JitCode;
+
+// 分层执行状态：先解释执行，执行次数达到阈值后由 VirtualMachine 升级为本机代码
+struct ProgramTier {
+    uint32_t executions = 0;
+    bool jitFailed = false;                 // JIT 不可用或编译失败，不再尝试
+    std::shared_ptr<const JitCode> native;  // 本机代码不可变，副本之间可以共享
+};
+
+// 编译后的表达式：与 AstArena 无关，可由调用方长期持有并反复执行
+struct Program {
+    std::vector<Instruction> code;
+    std::vector<double> constants;
+    std::vector<const Functions::Info*> functions;
+    std::vector<std::string> variables;   // 变量名，下标即槽位
+    size_t maxStack = 0;   // 执行所需的最大栈深度
+    size_t temps = 0;      // 共享子表达式占用的临时槽位数
+    // 只影响执行速度、不影响结果，因此 const Program 也可升级；同一 Program 不可被多个线程同时执行
+    mutable ProgramTier tier;
+};
+
+// 将 AST 降级为线性字节码
+class Compiler {
+public:
+    // 出错时抛出 EvaluationError
+    static Program compile(const AstArena& arena, NodeId root);
+    // 不抛异常：AST 不合法或嵌套过深时返回错误
+    static Expected<Program> tryCompile(const AstArena& arena, NodeId root);
+
+private:
+    Compiler(const AstArena& arena, Program& program) : arena(arena), program(program) {}
+
+    const AstArena& arena;
+    Program& program;
+    size_t depth = 0;
+    Status status;
+    std::vector<uint32_t> tempSlots;   // 共享节点已分配的临时槽位，未分配为 NO_TEMP
+
+    static constexpr uint32_t NO_TEMP = UINT32_MAX;
+
+    void emit(OpCode op, uint32_t operand = 0, uint8_t argc = 0);
+    void compileNode(NodeId id);
+    uint32_t addConstant(double value);
+    uint32_t addFunction(const Functions::Info* function);
+    void fail(const char* message);
+};
+
+#endif // COMPILER_H
@@ -2,18 +2,24 @@
 #define CONSTANTS_H
 
 #include <string>
+#include <string_view>
 #include <unordered_map>
 
+// 常量注册表：首次访问时构建（线程安全），之后只读，可在线程间共享
 class Constants {
 public:
-    static const std::unordered_map<std::string, double>& getConstants();
+    // 常量描述符：解析阶段即解析为该描述符，求值时不再查表
+    struct Info {
+        const char* name;
+        double value;
+    };
+
+    // 键指向静态描述符表中的名称，查找时无需构造 std::string
+    static const std::unordered_map<std::string_view, Info>& getConstants();
     static bool isConstant(const std::string& name);
     static double getValue(const std::string& name);
-
-private:
-    static std::unordered_map<std::string, double> constants;
-    static bool initialized;
-    static void initialize();
+    // 未找到时返回 nullptr；返回的指针在程序运行期间一直有效
+    static const Info* find(std::string_view name);
 };
 
-#endif // CONSTANTS_H
\ No newline at end of file
+#endif // CONSTANTS_H
@@ -0,0 +1,37 @@
+#ifndef DAG_H
+#define DAG_H
+
+#include <cstdint>
+#include <vector>
+#include "parser.h"
+
+// DAG 统计信息
+struct DagStats {
+    size_t treeNodes = 0;     // 按树展开的节点数（共享子树按出现次数计）
+    size_t dagNodes = 0;      // 合并后互不相同的节点数
+    size_t sharedNodes = 0;   // 被多个父节点引用的内部节点数
+};
+
+// 哈希合并（hash-consing）：把结构相同的子树合并为同一个节点，树变为 DAG。
+// 自底向上处理，子节点先替换为代表节点，因此两个节点结构相同当且仅当其字段与代表子节点都相同；
+// 函数调用按函数描述符与参数列表逐项比较。被多次引用的内部节点标记为 shared，
+// 求值器与编译器据此对每个共享子表达式只计算一次。
+// 数字按位比较，-0 与 0、不同的 NaN 不会被合并。
+class DagBuilder {
+public:
+    NodeId build(AstArena& arena, NodeId root);
+    const DagStats& stats() const { return lastStats; }
+
+private:
+    DagStats lastStats;
+    std::vector<NodeId> representative;   // 每个节点合并后的代表节点
+    std::vector<NodeId> table;            // 开放寻址哈希表，存放代表节点
+    std::vector<uint32_t> parents;        // DAG 中每个节点的父节点数
+
+    NodeId intern(AstArena& arena, NodeId id);
+    uint64_t hash(const AstArena& arena, const ASTNode& node) const;
+    bool equal(const AstArena& arena, const ASTNode& a, const ASTNode& b) const;
+    void countParents(AstArena& arena, NodeId id);
+};
+
+#endif // DAG_H
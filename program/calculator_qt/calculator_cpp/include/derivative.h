@@ -0,0 +1,74 @@
+#ifndef DERIVATIVE_H
+#define DERIVATIVE_H
+
+#include <cstdint>
+#include <vector>
+#include "parser.h"
+#include "status.h"
+
+// 前向模式自动微分：每个节点携带取值与对全部变量的偏导数（对偶数），一次遍历得到函数值与梯度，
+// 代替逐个变量前后扰动的有限差分（2N+1 次求值，且截断误差与舍入误差此消彼长）。
+// 覆盖 Calculator 支持的全部运算符与函数注册表中的全部函数；错误与 Calculator 相同：
+// 除数为零、函数参数超出定义域、变量未绑定。另外 u^v 的指数含变量时要求底数大于 0（导数含 ln u），
+// 指数为 0 时对底数的导数取 0（u^0 恒为 1，包括 u = 0），abs 在 0 处的导数取 0。
+// 不含变量的子树导数恒为 0，不参与导数运算
+class DualEvaluator {
+public:
+    // variables 与 Calculator::evaluate 相同；gradient 须有 arena.variableCount() 个元素，按槽位写入偏导数。
+    // 出错时抛出 EvaluationError
+    double evaluate(const AstArena& arena, NodeId root, const double* variables, double* gradient);
+    // 不抛异常：出错时返回第一个计算错误，gradient 的内容无效
+    Expected<double> tryEvaluate(const AstArena& arena, NodeId root, const double* variables, double* gradient);
+
+private:
+    const double* variables = nullptr;
+    size_t width = 0;                   // 变量个数，即每个节点的偏导数个数
+    Status status;
+    // 按节点编号存放取值与偏导数（tangents[id * width] 起的 width 个元素），容量在各次求值间复用；
+    // valueEpoch[id] 等于当前 epoch 时有效，共享节点每次求值只计算一次
+    std::vector<double> values;
+    std::vector<double> tangents;
+    std::vector<uint8_t> constant;      // 子树不含变量，导数恒为 0
+    std::vector<uint32_t> valueEpoch;
+    uint32_t epoch = 0;
+
+    bool fail(const Status& error);
+    bool evaluateNode(const AstArena& arena, NodeId id);
+    bool computeNode(const AstArena& arena, NodeId id);
+    double* tangent(NodeId id) { return tangents.data() + static_cast<size_t>(id) * width; }
+};
+
+// 符号求导：在同一个 AstArena 中构造 ∂root/∂x 的 AST（x 为变量槽位），导数式引用原式的子树。
+// 求导规则与 DualEvaluator 相同，不含该变量的子树直接视为 0，不生成 0 * u 之类的项；
+// 结果交给 Optimizer 折叠常量、合并公共子表达式，再由 Compiler 编译后即可与普通表达式一样缓存、反复执行。
+// 导数式不再检查原式的定义域（如 ln u 的导数 1/u 对 u < 0 也有值），调用方应同时求原式的值
+class Differentiator {
+public:
+    // 出错（AST 不合法或函数没有求导规则）时抛出 EvaluationError
+    static NodeId differentiate(AstArena& arena, NodeId root, uint32_t slot);
+    // 不抛异常
+    static Expected<NodeId> tryDifferentiate(AstArena& arena, NodeId root, uint32_t slot);
+
+private:
+    Differentiator(AstArena& arena, uint32_t slot) : arena(arena), slot(slot) {}
+
+    AstArena& arena;
+    uint32_t slot;
+    Status status;
+    std::vector<NodeId> memo;   // 每个节点的导数，DAG 中的共享节点只求导一次；ZERO 表示恒为 0
+
+    static constexpr NodeId ZERO = INVALID_NODE;
+    static constexpr NodeId PENDING = INVALID_NODE - 1;
+
+    NodeId derive(NodeId id);
+    NodeId deriveNode(NodeId id);
+    NodeId deriveCall(NodeId id);
+    NodeId add(NodeId left, NodeId right);
+    NodeId subtract(NodeId left, NodeId right);
+    NodeId multiply(NodeId left, NodeId right);
+    NodeId fail(const Status& error);
+    // 子树不含变量且值为 0
+    bool isConstantZero(NodeId id) const;
+};
+
+#endif // DERIVATIVE_H
@@ -0,0 +1,51 @@
+#ifndef EXPRESSION_CACHE_H
+#define EXPRESSION_CACHE_H
+
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include "compiler.h"
+
+// 缓存统计信息
+struct CacheStats {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t evictions = 0;
+    size_t size = 0;
+    size_t capacity = 0;
+};
+
+// 以规范化输入文本为键、已优化并编译的字节码为值的 LRU 缓存。
+// 查找、插入与淘汰均为 O(1)：哈希表定位链表节点，链表头部为最近使用项。
+class ExpressionCache {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 4096;
+
+    explicit ExpressionCache(size_t capacity = DEFAULT_CAPACITY);
+
+    // 去除与语义无关的空白：只有当空白两侧都是数字/标识符字符时才保留一个空格，
+    // 因此 "2+3" 与 " 2 + 3 " 同键，而 "1 2" 不会与 "12" 混淆；
+    // 指数记数法中的符号两侧同样保留空白，"1e -3" 不会与 "1e-3" 混淆
+    static std::string normalize(std::string_view input);
+    // 同上，写入调用方复用的 key，容量足够时不分配内存
+    static void normalize(std::string_view input, std::string& key);
+
+    // 命中时将条目移到最近使用位置并返回，未命中返回 nullptr
+    const Program* find(const std::string& key);
+    // 插入新条目，超出容量时淘汰最久未使用的条目；容量为 0 时不缓存
+    const Program& insert(const std::string& key, Program program);
+
+    const CacheStats& stats() const { return counters; }
+
+private:
+    using Entry = std::pair<std::string, Program>;
+
+    std::list<Entry> entries;
+    std::unordered_map<std::string, std::list<Entry>::iterator> index;
+    Program uncached;   // 容量为 0 时保存最近一次插入的程序
+    CacheStats counters;
+};
+
+#endif // EXPRESSION_CACHE_H
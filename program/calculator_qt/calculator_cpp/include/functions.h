@@ -1,23 +1,45 @@
 #ifndef FUNCTIONS_H
 #define FUNCTIONS_H
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <functional>
 #include <unordered_map>
+#include "vector_math.h"
 
+// 函数注册表：首次访问时构建（C++11 局部静态变量的初始化是线程安全的），之后只读，可在线程间共享
 class Functions {
 public:
-    using FunctionType = std::function<double(const std::vector<double>&)>;
+    // 参数按顺序连续存放，个数等于 Info::arity
+    using FunctionPtr = double (*)(const double* args);
+    // 定义域检查：参数在定义域内时返回 true
+    using DomainPtr = bool (*)(const double* args);
+    // 单参数函数对应的 C 数学库入口
+    using DirectPtr = double (*)(double);
 
-    static const std::unordered_map<std::string, FunctionType>& getFunctions();
+    // 函数描述符：解析阶段即解析为该描述符，求值时直接通过指针调用。
+    // 函数本身不抛异常，定义域由 domain 单独检查，以便求值器以错误码报告
+    struct Info {
+        const char* name;
+        FunctionPtr function;
+        uint8_t arity;
+        DomainPtr domain;          // 为 nullptr 时定义域为全体实数
+        const char* domainError;   // 参数超出定义域时的错误信息
+        DirectPtr direct;          // 与 function 结果相同的数学库函数，供 JIT 直接调用；可为 nullptr
+        MathFunction vector;       // 列式求值时整块调用的向量数学核；MATH_NONE 表示逐行调用 function
+
+        bool accepts(const double* args) const { return domain == nullptr || domain(args); }
+    };
+
+    static constexpr size_t MAX_ARITY = 4;
+
+    // 键指向静态描述符表中的名称，查找时无需构造 std::string
+    static const std::unordered_map<std::string_view, Info>& getFunctions();
     static bool isFunction(const std::string& name);
+    // 未找到时返回 nullptr；返回的指针在程序运行期间一直有效
+    static const Info* find(std::string_view name);
     static double evaluate(const std::string& name, const std::vector<double>& args);
-
-private:
-    static std::unordered_map<std::string, FunctionType> functions;
-    static bool initialized;
-    static void initialize();
 };
 
-#endif // FUNCTIONS_H
\ No newline at end of file
+#endif // FUNCTIONS_H
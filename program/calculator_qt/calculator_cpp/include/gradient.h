@@ -0,0 +1,29 @@
+#ifndef GRADIENT_H
+#define GRADIENT_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include "parser.h"
+#include "optimizer.h"
+#include "vm.h"
+#include "expression_cache.h"
+#include "spreadsheet.h"
+#include "status.h"
+
+// 求导命令 "diff 表达式"：输出表达式的值与对各变量的偏导数，交互模式与管道模式共用
+class GradientCommand {
+public:
+    // line 以 "diff " 开头时返回 true，expression 为其后的表达式
+    static bool split(std::string_view line, std::string_view& expression);
+
+    // 各变量的偏导数式编译后以 "规范化表达式\n变量名" 为键缓存（规范化的输入不含换行，不会与普通表达式同键），
+    // 未命中时对表达式符号求导、折叠常量后编译；求值时变量取已赋值的值。
+    // key 为 expression 的规范化键，names 为原式 Program::variables 的副本（插入缓存可能淘汰原式的 Program），
+    // partials 按 names 的顺序写入
+    static Status evaluate(const std::string& key, std::string_view expression, const std::vector<std::string>& names,
+                           std::vector<double>& partials, AstArena& arena, Optimizer& optimizer,
+                           ExpressionCache& cache, const Spreadsheet& sheet, VirtualMachine& vm);
+};
+
+#endif // GRADIENT_H
@@ -0,0 +1,39 @@
+#ifndef JIT_H
+#define JIT_H
+
+#include <cstddef>
+#include <memory>
+#include "compiler.h"
+#include "status.h"
+
+// x86-64 本机代码后端：把字节码逐条翻译为 SSE2 标量指令，栈顶缓存在 xmm0 中，
+// 其余栈槽位于本机栈帧；pow 与各内置函数直接调用 C 数学库。
+// 仅在定义了 CALCULATOR_JIT 的 x86-64 Linux 构建中可用，且要求系统允许
+// 先写后改为可执行（W^X）的匿名映射，否则 compile() 返回 nullptr，由调用方继续解释执行
+class JitCode {
+public:
+    ~JitCode();
+    JitCode(const JitCode&) = delete;
+    JitCode& operator=(const JitCode&) = delete;
+
+    // 当前进程能否使用 JIT（首次调用时探测一次）
+    static bool available();
+    // 失败或不可用时返回 nullptr
+    static std::unique_ptr<JitCode> compile(const Program& program);
+
+    // program 必须是编译时使用的同一个 Program
+    Expected<double> run(const Program& program, const double* variables) const;
+    size_t codeSize() const { return size; }
+
+private:
+    // 返回 0 表示成功，结果写入 *result；否则为错误码（见 jit.cpp）
+    using Entry = int (*)(const double* constants, const double* variables, double* result);
+
+    JitCode(void* memory, size_t size);
+
+    void* memory;
+    size_t size;
+    Entry entry;
+};
+
+#endif // JIT_H
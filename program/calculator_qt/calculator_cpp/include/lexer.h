@@ -0,0 +1,60 @@
+#ifndef LEXER_H
+#define LEXER_H
+
+#include <cstddef>
+#include <string_view>
+#include "status.h"
+#include "char_scan.h"
+#include "functions.h"
+#include "constants.h"
+
+// Token类型枚举
+enum TokenType {
+    NUMBER,
+    OPERATOR,
+    FUNCTION,
+    CONSTANT,
+    VARIABLE,
+    LPAREN,
+    RPAREN,
+    END,
+    INVALID   // 词法错误，错误码在 Token::error 中
+};
+
+// Token结构：text 是输入中的切片，不复制字符，生命周期与输入相同
+struct Token {
+    TokenType type = END;
+    char op = 0;               // 当type为OPERATOR时使用
+    ErrorCode error = ErrorCode::OK;  // 当type为INVALID时使用
+    double value = 0.0;        // 当type为NUMBER时使用
+    std::string_view text;     // 词素原文；FUNCTION、CONSTANT或VARIABLE时即为名称
+    size_t offset = 0;         // 词素在输入中的起始位置
+    const Functions::Info* function = nullptr;  // 当type为FUNCTION时使用
+    const Constants::Info* constant = nullptr;  // 当type为CONSTANT时使用
+};
+
+// 词法分析器：按需产生下一个 Token，不分配内存。
+// 空白与标识符按 64 字节块的字符类别位图跳过，长表达式中不再逐字节判断
+class Lexer {
+public:
+    explicit Lexer(std::string_view input) : input(input) {
+        char_scanner_init(&scanner, input.data(), input.size());
+    }
+
+    // 不抛异常：词法错误以 INVALID Token 返回，text 为出错的词素
+    Token scan();
+    // 词法错误时抛出 LexicalError
+    Token next();
+    size_t position() const { return pos; }
+
+private:
+    std::string_view input;
+    size_t pos = 0;
+    CharScanner scanner;
+
+    Token lexNumber();
+    Token lexIdentifier();
+    static Token invalid(Token token, ErrorCode error);
+};
+
+#endif // LEXER_H
@@ -0,0 +1,140 @@
+#ifndef LIBCALC_H
+#define LIBCALC_H
+
+/*
+ * libcalc：可嵌入的求值核心（词法、语法分析、优化、编译与执行），不含界面与各运行模式。
+ * C 接口保持稳定，C++ 调用方可使用文件末尾的 calc::Expression 包装。
+ *
+ * calc_prepare 把表达式解析、优化并编译为不可变的句柄；同一句柄可被任意多个线程同时求值，
+ * 直到 calc_release 为止。变量按槽位传入，槽位顺序即变量在表达式中首次出现的顺序，
+ * 可用 calc_variable_name / calc_variable_slot 查询。
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#define CALC_API __declspec(dllexport)
+#else
+#define CALC_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 错误类别，与可执行文件输出的 "词法错误"、"语法错误"、"计算错误" 前缀对应 */
+typedef enum {
+    CALC_OK = 0,
+    CALC_LEXICAL_ERROR,
+    CALC_SYNTAX_ERROR,
+    CALC_EVALUATION_ERROR,
+    CALC_INVALID_ARGUMENT   /* 句柄或输出缓冲为空 */
+} calc_status;
+
+#define CALC_ERROR_MESSAGE_SIZE 256
+
+typedef struct {
+    calc_status status;
+    uint32_t offset;                          /* 词法与语法错误在输入中的字节偏移 */
+    char message[CALC_ERROR_MESSAGE_SIZE];    /* 完整错误信息（UTF-8），超长时截断 */
+} calc_error;
+
+typedef struct calc_expr calc_expr;
+
+/* 编译表达式。失败返回 NULL，error 非空时写入原因 */
+CALC_API calc_expr* calc_prepare(const char* text, calc_error* error);
+CALC_API void calc_release(calc_expr* expr);
+
+CALC_API size_t calc_variable_count(const calc_expr* expr);
+/* 槽位越界时返回 NULL；返回的字符串随句柄释放 */
+CALC_API const char* calc_variable_name(const calc_expr* expr, size_t slot);
+/* 变量不存在时返回 -1 */
+CALC_API int calc_variable_slot(const calc_expr* expr, const char* name);
+
+/* vars 按槽位给出一组取值，表达式不含变量时可为 NULL。出错时返回 NaN，error 非空时写入原因 */
+CALC_API double calc_eval(const calc_expr* expr, const double* vars, calc_error* error);
+
+/* 列式批量求值：columns[slot] 指向该变量的 n 个取值，结果写入 out[0..n)。
+ * 任一行出错时整批失败，返回错误类别，out 的内容不确定 */
+CALC_API calc_status calc_eval_batch(const calc_expr* expr, const double* const* columns, size_t n, double* out,
+                                     calc_error* error);
+
+#ifdef __cplusplus
+} /* extern "C" */
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace calc {
+
+// calc_error 对应的异常，what() 为完整错误信息
+class Error : public std::runtime_error {
+public:
+    explicit Error(const calc_error& error)
+        : std::runtime_error(error.message), errorStatus(error.status), errorOffset(error.offset) {}
+
+    calc_status status() const { return errorStatus; }
+    uint32_t offset() const { return errorOffset; }
+
+private:
+    calc_status errorStatus;
+    uint32_t errorOffset;
+};
+
+// 预编译表达式的 RAII 包装，只经 C 接口访问 libcalc，与库的 C++ 运行时版本无关。
+// 可移动不可复制；const 成员函数可被多个线程同时调用
+class Expression {
+public:
+    // 出错时抛出 calc::Error
+    explicit Expression(const std::string& text) {
+        calc_error error;
+        handle = calc_prepare(text.c_str(), &error);
+        if (handle == nullptr) {
+            throw Error(error);
+        }
+    }
+    ~Expression() { calc_release(handle); }
+
+    Expression(Expression&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+    Expression& operator=(Expression&& other) noexcept {
+        std::swap(handle, other.handle);
+        return *this;
+    }
+    Expression(const Expression&) = delete;
+    Expression& operator=(const Expression&) = delete;
+
+    size_t variableCount() const { return calc_variable_count(handle); }
+    std::string variableName(size_t slot) const {
+        const char* name = calc_variable_name(handle, slot);
+        return name != nullptr ? name : std::string();
+    }
+    int variableSlot(const std::string& name) const { return calc_variable_slot(handle, name.c_str()); }
+
+    double operator()(const double* vars = nullptr) const {
+        calc_error error;
+        double value = calc_eval(handle, vars, &error);
+        if (error.status != CALC_OK) {
+            throw Error(error);
+        }
+        return value;
+    }
+
+    void evaluate(const double* const* columns, size_t n, double* out) const {
+        calc_error error;
+        if (calc_eval_batch(handle, columns, n, out, &error) != CALC_OK) {
+            throw Error(error);
+        }
+    }
+
+    const calc_expr* get() const { return handle; }
+
+private:
+    calc_expr* handle;
+};
+
+} // namespace calc
+#endif /* __cplusplus */
+
+#endif /* LIBCALC_H */
@@ -0,0 +1,34 @@
+#ifndef LINE_EVALUATOR_H
+#define LINE_EVALUATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include "parser.h"
+#include "optimizer.h"
+#include "vm.h"
+#include "expression_cache.h"
+#include "status.h"
+
+// 逐行求值上下文：持有节点池、优化器、虚拟机与表达式缓存，批量模式与服务模式的每个工作线程各持有一个。
+// 同一对象不可被多个线程同时使用
+class LineEvaluator {
+public:
+    explicit LineEvaluator(uint32_t jitThreshold) : vm(jitThreshold) {}
+
+    // 写出一行结果（不含换行），出错时 errors 加一；首尾空白（含行尾的 '\r'）被忽略，空行与只含空白的行不输出任何内容
+    void evaluate(std::string_view line, std::ostream& out, size_t& errors);
+    // 不抛异常：出错时返回错误，结果写入 value
+    Status evaluateLine(std::string_view line, double& value);
+
+private:
+    AstArena arena;
+    Optimizer optimizer;
+    VirtualMachine vm;
+    ExpressionCache cache;
+    std::string key;    // 规范化键在各行之间复用，缓存命中时不分配内存
+};
+
+#endif // LINE_EVALUATOR_H
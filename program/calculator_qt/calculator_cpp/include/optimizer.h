@@ -0,0 +1,33 @@
+#ifndef OPTIMIZER_H
+#define OPTIMIZER_H
+
+#include "parser.h"
+#include "dag.h"
+
+// 优化统计信息
+struct OptimizerStats {
+    size_t nodesBefore = 0;   // 优化前可达节点数
+    size_t nodesAfter = 0;    // 优化后可达节点数
+    size_t dagNodes = 0;      // 合并公共子表达式后的节点数
+    size_t removed() const { return nodesBefore - nodesAfter; }
+};
+
+// 位于 Parser::parse() 与求值之间的 AST 优化遍：
+// 折叠常量子树（含常量节点与纯函数调用），并应用不改变 IEEE 语义的代数恒等式。
+// 会产生除零或定义域错误的子树保持原样，错误留到求值时按原方式报告。
+// 最后由 DagBuilder 合并结构相同的子树，结果是 DAG，共享节点在求值时只计算一次。
+class Optimizer {
+public:
+    NodeId optimize(AstArena& arena, NodeId root);
+    const OptimizerStats& stats() const { return lastStats; }
+
+private:
+    OptimizerStats lastStats;
+    DagBuilder dag;
+
+    NodeId fold(AstArena& arena, NodeId id);
+    NodeId foldBinary(AstArena& arena, NodeId id);
+    NodeId foldCall(AstArena& arena, NodeId id);
+};
+
+#endif // OPTIMIZER_H
@@ -1,32 +1,13 @@
 #ifndef PARSER_H
 #define PARSER_H
 
+#include <array>
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
-#include <memory>
-#include "error.h"
-
-// Token类型枚举
-enum TokenType {
-    NUMBER,
-    OPERATOR,
-    FUNCTION,
-    CONSTANT,
-    LPAREN,
-    RPAREN,
-    END
-};
-
-// Token结构
-struct Token {
-    TokenType type;
-    double value;      // 当type为NUMBER时使用
-    std::string name;  // 当type为FUNCTION或CONSTANT时使用
-    char op;           // 当type为OPERATOR时使用
-    
-    Token(TokenType t, double v = 0.0, const std::string& n = "", char o = 0)
-        : type(t), value(v), name(n), op(o) {}
-};
+#include "lexer.h"
 
 // AST节点类型枚举
 enum NodeType {
@@ -34,45 +15,125 @@ enum NodeType {
     BIN_OP_NODE,
     UNARY_OP_NODE,
     FUNC_CALL_NODE,
-    CONSTANT_NODE
+    CONSTANT_NODE,
+    VARIABLE_NODE
 };
 
-// AST节点结构
+// AST节点索引，指向 AstArena 中的节点
+using NodeId = uint32_t;
+constexpr NodeId INVALID_NODE = static_cast<NodeId>(-1);
+
+// AST节点结构（紧凑布局：子节点以索引相连，名称和参数列表存放在 AstArena 中）
 struct ASTNode {
     NodeType type;
-    double value;              // 当type为NUM_NODE时使用
     char op;                   // 当type为BIN_OP_NODE或UNARY_OP_NODE时使用
-    std::string name;          // 当type为FUNC_CALL_NODE或CONSTANT_NODE时使用
-    std::shared_ptr<ASTNode> left;   // 左子树
-    std::shared_ptr<ASTNode> right;  // 右子树
-    std::shared_ptr<ASTNode> operand; // 操作数（用于一元运算）
-    std::vector<std::shared_ptr<ASTNode>> args; // 函数参数列表
-    
-    ASTNode(NodeType t) : type(t), value(0), op(0) {}
+    bool shared;               // 由 DagBuilder 标记：该节点在 DAG 中被多个父节点引用
+    uint16_t height;           // 以该节点为根的树高（叶子为 1），超过 UINT16_MAX 时不再增长
+    union {
+        double value;          // 当type为NUM_NODE时使用
+        struct {
+            NodeId left;
+            NodeId right;
+        } binary;              // 当type为BIN_OP_NODE时使用
+        struct {
+            NodeId operand;
+        } unary;               // 当type为UNARY_OP_NODE时使用
+        struct {
+            const Functions::Info* function;  // 解析阶段确定的函数描述符
+            uint32_t firstArg; // 参数在 AstArena 参数表中的起始下标
+            uint32_t argCount;
+        } call;                // 当type为FUNC_CALL_NODE时使用
+        struct {
+            const Constants::Info* info;  // 解析阶段确定的常量描述符
+        } constant;            // 当type为CONSTANT_NODE时使用
+        struct {
+            uint32_t slot;     // 变量槽位，求值时对应输入数组/列的下标
+        } variable;            // 当type为VARIABLE_NODE时使用
+    } data;
+};
+
+// AST节点池：一次解析的全部节点连续存放，reset() 后保留容量供下一行复用
+class AstArena {
+public:
+    NodeId addNumber(double value);
+    NodeId addBinary(char op, NodeId left, NodeId right);
+    NodeId addUnary(char op, NodeId operand);
+    NodeId addConstant(const Constants::Info* constant);
+    // 同名变量共享一个槽位，槽位按首次出现的顺序编号
+    NodeId addVariable(std::string_view name);
+
+    // 函数参数先压入待定栈，函数调用节点创建时再整体移入参数表，
+    // 这样嵌套调用的参数不会彼此交错
+    size_t argMark() const { return pendingArgs.size(); }
+    void pushArg(NodeId arg) { pendingArgs.push_back(arg); }
+    NodeId addCall(const Functions::Info* function, size_t mark);
+
+    const ASTNode& node(NodeId id) const { return nodes[id]; }
+    ASTNode& node(NodeId id) { return nodes[id]; }
+    std::string_view name(const ASTNode& node) const;
+    const NodeId* args(const ASTNode& node) const { return argIds.data() + node.data.call.firstArg; }
+    void setArg(const ASTNode& node, uint32_t index, NodeId arg) { argIds[node.data.call.firstArg + index] = arg; }
+    size_t size() const { return nodes.size(); }
+    // 无效节点的树高为 0
+    uint16_t height(NodeId id) const { return id < nodes.size() ? nodes[id].height : 0; }
+    // 以 root 为根的树中节点数（共享子树按出现次数计）
+    size_t treeSize(NodeId root) const;
+
+    size_t variableCount() const { return variables.size(); }
+    std::string_view variableName(size_t slot) const;
+
+    void reset();
+
+private:
+    std::vector<ASTNode> nodes;
+    std::vector<NodeId> argIds;
+    std::vector<NodeId> pendingArgs;
+    std::string names;                                     // 变量名字符池
+    std::vector<std::pair<uint32_t, uint32_t>> variables;  // 变量名在 names 中的偏移与长度
+
+    NodeId push(const ASTNode& node);
+    uint32_t internName(std::string_view name);
 };
 
-// 解析器类
+// 解析器类（表达式以视图方式持有，调用方需保证其在解析期间有效）
 class Parser {
 public:
-    Parser(const std::string& expression);
-    std::shared_ptr<ASTNode> parse();
+    Parser(std::string_view expression, AstArena& arena);
+    // 出错时抛出 LexicalError 或 SyntaxError
+    NodeId parse();
+    // 不抛异常：出错时返回第一个错误及其在输入中的位置
+    Expected<NodeId> tryParse();
+
+    // 可向前查看的 Token 个数
+    static constexpr size_t LOOKAHEAD = 4;
+    // 括号、一元操作符与函数调用的嵌套层数上限：每层递归解析一次
+    static constexpr size_t MAX_NESTING = 1000;
+    // 树高上限：优化、编译、求值与求导都递归遍历语法树，很长的 1+1+…+1 同样会耗尽调用栈
+    static constexpr uint16_t MAX_HEIGHT = 10000;
 
 private:
-    std::string expression;
-    size_t pos;
-    Token currentToken;
-    
-    std::vector<Token> tokenize();
-    Token getNextToken();
+    Lexer lexer;
+    AstArena& arena;
+    std::array<Token, LOOKAHEAD> lookahead;  // 环形缓冲区，按需从词法分析器补充
+    size_t head = 0;
+    size_t buffered = 0;
+    size_t nesting = 0;
+    Status status;   // 第一个词法或语法错误
+
+    // 查看当前位置之后第 offset 个 Token（0 为当前 Token），offset 必须小于 LOOKAHEAD
+    const Token& peek(size_t offset = 0);
     void consumeToken();
-    
-    std::shared_ptr<ASTNode> parseExpression();
-    std::shared_ptr<ASTNode> parseTerm();
-    std::shared_ptr<ASTNode> parseFactor();
-    
-    void skipWhitespace();
-    bool isOperator(char c);
+    // 记录错误并返回 INVALID_NODE；出错后各层解析函数尽快返回
+    NodeId fail(ErrorCode code, const Token& token, const Functions::Info* function = nullptr);
+    // 新节点的树高超出上限时在 token 处报错
+    NodeId limitHeight(NodeId id, const Token& token);
+
+    NodeId parseExpression();
+    NodeId parseTerm();
+    NodeId parseFactor();
+    NodeId parsePrimary();
+
     int getOperatorPrecedence(char op);
 };
 
-#endif // PARSER_H
\ No newline at end of file
+#endif // PARSER_H
@@ -0,0 +1,98 @@
+#ifndef PIPE_MODE_H
+#define PIPE_MODE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "parser.h"
+#include "optimizer.h"
+#include "vm.h"
+#include "expression_cache.h"
+#include "spreadsheet.h"
+
+// 按块读取的行读取器：每次 read 一整块，用 memchr 在缓冲区内找换行，返回指向缓冲区的视图，
+// 不逐行分配内存。跨块的行搬到缓冲区开头，比缓冲区还长的行使缓冲区按倍数增长，行长没有上限
+class LineReader {
+public:
+    LineReader(int fd, size_t blockSize);
+
+    // 取出下一行（不含换行符与行尾的 '\r'），缓冲区内没有完整的行时返回 false；
+    // 输入结束后最后一行没有换行符也会返回。视图在下次 fill() 之前有效
+    bool next(std::string_view& line);
+    // 读入下一块：读到数据返回 1，输入结束返回 0，读错误返回 -1
+    int fill();
+    bool eof() const { return finished; }
+    uint64_t bytes() const { return total; }
+
+private:
+    std::vector<char> buffer;
+    size_t start = 0;       // 下一行的起点
+    size_t end = 0;         // 已读入数据的末尾
+    size_t scanned = 0;     // [start, scanned) 中已确认没有换行，长行跨块时不重复扫描
+    int fd;
+    bool finished = false;
+    uint64_t total = 0;
+};
+
+// 输出缓冲：结果先追加到缓冲区，由调用方在每块输入处理完后一次 write 写出
+class OutputBuffer {
+public:
+    OutputBuffer(int fd, size_t capacity);
+
+    void append(std::string_view text);
+    // 写出失败（如下游管道已关闭）后不再写，返回 false
+    bool flush();
+    bool failed() const { return broken; }
+    uint64_t bytes() const { return total; }
+
+private:
+    void writeAll(const char* data, size_t size);
+
+    std::vector<char> buffer;
+    size_t length = 0;
+    int fd;
+    bool broken = false;
+    uint64_t total = 0;
+};
+
+struct PipeStats {
+    size_t lines = 0;
+    size_t errors = 0;
+    uint64_t bytesIn = 0;
+    uint64_t bytesOut = 0;
+    double seconds = 0.0;
+
+    double megabytesPerSecond() const { return seconds > 0.0 ? bytesIn / 1e6 / seconds : 0.0; }
+};
+
+// 管道模式：标准输入不是终端时使用，语言与交互模式相同（含赋值与 diff 求导），但不显示欢迎信息与提示符。
+// 每行输入输出一行："= 结果"、"变量 = 值"、"= 结果  ∂/∂x = 偏导数 ..."、"错误: 信息"，
+// 忽略首尾空白，空行（含只有空白的行）输出空行；
+// help 与 stats 的输出与交互模式相同，遇到 quit/exit 停止
+class PipeSession {
+public:
+    static constexpr size_t DEFAULT_BLOCK_SIZE = 1 << 20;
+
+    PipeSession(size_t cacheCapacity, uint32_t jitThreshold, const SheetOptions& sheetOptions = SheetOptions());
+
+    // 读写出错时 ok 为 false
+    PipeStats run(int inputFd, int outputFd, bool& ok, size_t blockSize = DEFAULT_BLOCK_SIZE);
+
+private:
+    // 遇到 quit/exit 时返回 false
+    bool handleLine(std::string_view line, OutputBuffer& out, PipeStats& stats);
+    void writeError(OutputBuffer& out, const std::string& message, PipeStats& stats);
+
+    AstArena arena;
+    Optimizer optimizer;
+    VirtualMachine vm;
+    ExpressionCache cache;
+    Spreadsheet sheet;
+    std::string key;        // 规范化键在各行之间复用
+    std::vector<std::string> names;     // 求导命令的变量名与偏导数
+    std::vector<double> partials;
+};
+
+#endif // PIPE_MODE_H
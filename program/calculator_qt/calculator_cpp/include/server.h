@@ -0,0 +1,98 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// 延迟直方图：每个 2 的幂区间再均分为 16 个桶，相对误差不超过 1/16，记录为 O(1)
+class LatencyHistogram {
+public:
+    void record(uint64_t nanoseconds, uint64_t times = 1);
+    void merge(const LatencyHistogram& other);
+    uint64_t count() const { return total; }
+    // p 取 0 到 100，返回所在桶的上界（纳秒）；没有样本时返回 0
+    uint64_t percentile(double p) const;
+    uint64_t max() const { return largest; }
+    // "n=... p50=...us p90=... p99=... p99.9=... max=..." 形式的单行摘要
+    std::string summary() const;
+
+private:
+    static constexpr int SUB_BITS = 4;
+    static constexpr size_t BUCKETS = (64 - SUB_BITS + 1) << SUB_BITS;
+
+    std::array<uint64_t, BUCKETS> buckets{};
+    uint64_t total = 0;
+    uint64_t largest = 0;
+
+    static size_t bucketOf(uint64_t value);
+    static uint64_t upperBound(size_t bucket);
+};
+
+// 监听地址："unix:<路径>" 或 "tcp:<端口>"（只绑定 127.0.0.1，端口 0 表示由系统分配）
+struct ServerAddress {
+    std::string unixPath;
+    uint16_t port = 0;
+
+    // 格式错误时抛出 CalcError
+    static ServerAddress parse(const std::string& text);
+    bool isUnix() const { return !unixPath.empty(); }
+};
+
+struct ServerOptions {
+    ServerAddress address;
+    size_t workers = 0;                // 求值线程数，0 表示使用硬件并发数
+    uint32_t jitThreshold = 100;       // 同一表达式执行这么多次后编译为本机代码，0 表示只解释执行
+    size_t maxLineBytes = 1 << 20;     // 超长的行视为协议错误，回复错误后关闭连接
+    size_t maxInFlight = 1 << 16;      // 单个连接未回复的请求达到上限时暂停读取
+};
+
+// 服务统计，只在 run() 返回后或在 I/O 线程内读取
+struct ServerStats {
+    size_t connections = 0;   // 累计接受的连接数
+    size_t requests = 0;      // 累计回复的请求数
+    size_t errors = 0;        // 其中回复错误的请求数
+    LatencyHistogram latency; // 从收到完整一行到回复写入发送缓冲的延迟
+};
+
+// 本地求值服务（仅 Linux）。协议按行：每行一个表达式，每个请求回复一行，
+// 内容与批量模式的输出相同（"= 结果" 或 "错误: 信息"，空行回复空行）。
+// 客户端可以不等回复连续发送（流水线），同一连接的回复严格按请求顺序返回。
+// 请求 "stats" 回复一行延迟分位数：本连接与全局，单位微秒，统计截至读到该请求时已回复的请求。
+//
+// 单个 I/O 线程用 epoll 多路复用全部连接，把完整的行按块交给固定大小的求值线程池，
+// 同一连接的多个块可由不同线程并行求值，I/O 线程按序号重排后写回
+class Server {
+public:
+    explicit Server(const ServerOptions& options);
+    ~Server();
+    Server(const Server&) = delete;
+    Server& operator=(const Server&) = delete;
+
+    // 创建并绑定监听套接字，失败时抛出 CalcError
+    void listen();
+    // 处理连接直到 stop() 被调用；必须先调用 listen()
+    void run();
+    // 可在任意线程或信号处理函数中调用
+    void stop();
+
+    // 实际绑定的 TCP 端口（地址为 tcp:0 时由系统分配）
+    uint16_t port() const { return boundPort; }
+    const ServerStats& stats() const { return totals; }
+
+private:
+    struct State;
+
+    ServerOptions options;
+    int listenFd = -1;
+    int wakeFd = -1;
+    uint16_t boundPort = 0;
+    std::atomic<bool> stopping{false};
+    ServerStats totals;
+    std::unique_ptr<State> state;
+};
+
+#endif // SERVER_H
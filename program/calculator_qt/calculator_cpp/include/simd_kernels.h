@@ -0,0 +1,30 @@
+#ifndef SIMD_KERNELS_H
+#define SIMD_KERNELS_H
+
+#include <cstddef>
+
+// 列运算所使用的指令集级别
+enum SimdLevel {
+    SIMD_SCALAR,
+    SIMD_SSE2,
+    SIMD_AVX2
+};
+
+// 逐元素的列运算核：二元运算为 dst[i] = dst[i] op src[i]
+struct ColumnKernels {
+    void (*add)(double* dst, const double* src, size_t n);
+    void (*sub)(double* dst, const double* src, size_t n);
+    void (*mul)(double* dst, const double* src, size_t n);
+    void (*div)(double* dst, const double* src, size_t n);
+    void (*pow)(double* dst, const double* src, size_t n);
+    void (*neg)(double* dst, size_t n);
+    bool (*anyZero)(const double* src, size_t n);   // 用于除零检查
+};
+
+// 运行时检测当前 CPU 支持的最高级别（非 x86-64 平台恒为 SIMD_SCALAR）
+SimdLevel detectSimdLevel();
+const char* simdLevelName(SimdLevel level);
+// 取指定级别的运算核；当前 CPU 不支持该级别时退回到可用的最高级别
+const ColumnKernels& columnKernels(SimdLevel level);
+
+#endif // SIMD_KERNELS_H
@@ -0,0 +1,98 @@
+#ifndef SPREADSHEET_H
+#define SPREADSHEET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "parser.h"
+#include "optimizer.h"
+#include "compiler.h"
+#include "vm.h"
+#include "status.h"
+
+// 增量重算选项
+struct SheetOptions {
+    size_t jobs = 1;                  // 重算线程数，0 表示使用硬件并发数
+    size_t parallelThreshold = 4096;  // 同一层的脏单元格达到这么多时才并行求值
+    uint32_t jitThreshold = 0;        // 同一单元格执行这么多次后编译为本机代码，0 表示只解释执行
+};
+
+// 一次重算的统计
+struct RecalcStats {
+    size_t evaluated = 0;        // 重新求值的单元格数
+    size_t errors = 0;           // 其中结果为错误的单元格数
+    size_t levels = 0;           // 拓扑层数
+    size_t parallelLevels = 0;   // 其中并行求值的层数
+    double seconds = 0.0;
+};
+
+// 电子表格式的增量重算引擎：每个单元格由 "名称 = 表达式" 定义，表达式中的变量即其他单元格。
+// 单元格之间的引用构成依赖图；重新定义一个单元格只把它及其传递依赖者标记为脏，
+// recalculate() 按拓扑顺序逐层求值脏单元格，同一层内互不依赖，层足够宽时由多个线程并行求值。
+// 引入循环引用的定义会被拒绝，表格保持原状。
+// 引用尚未定义的名称时结果为未绑定变量错误，该名称一旦定义，引用它的单元格随之重算；
+// 输入单元格的错误沿依赖链原样传递。除 recalculate() 内部外，对象不可被多个线程同时使用
+class Spreadsheet {
+public:
+    explicit Spreadsheet(const SheetOptions& options = SheetOptions());
+
+    // 把 "名称 = 表达式" 拆为两部分（名称去掉首尾空白），不含 '=' 时返回 false
+    static bool splitAssignment(std::string_view line, std::string_view& name, std::string_view& expression);
+    // 定义或重新定义单元格，不立即求值；出错时返回错误，表格保持原状。
+    // 词法与语法错误的位置相对于 expression，错误信息中的文本指向 name 或 expression
+    Status assign(std::string_view name, std::string_view expression);
+
+    // 按拓扑顺序重算全部脏单元格
+    RecalcStats recalculate();
+
+    // 最近一次重算后的取值；未定义的名称返回未绑定变量错误
+    Expected<double> value(std::string_view name) const;
+    // 以各单元格的当前取值绑定 program 的变量并执行
+    Expected<double> evaluate(const Program& program, VirtualMachine& vm) const;
+
+    size_t size() const { return cells.size(); }
+    size_t dirtyCount() const { return dirty.size(); }
+
+private:
+    struct Cell {
+        std::string name;
+        bool defined = false;
+        bool dirty = false;
+        Program program;
+        std::vector<uint32_t> inputs;      // 下标即 Program::variables 的槽位
+        std::vector<uint32_t> dependents;  // 直接引用本单元格的单元格
+        double value = 0.0;
+        Status status;                     // 非 OK 时 value 无效
+        uint32_t pending = 0;              // 重算时尚未求值的脏输入个数
+    };
+
+    SheetOptions options;
+    std::deque<Cell> cells;                                 // 地址稳定，名称可被视图引用
+    std::unordered_map<std::string_view, uint32_t> index;   // 键指向 Cell::name
+
+    AstArena arena;
+    Optimizer optimizer;
+    VirtualMachine vm;
+    std::vector<double> args;
+
+    std::vector<uint32_t> dirty;       // 脏单元格，顺序无关
+    std::vector<uint32_t> wave;        // 当前层
+    std::vector<uint32_t> nextWave;
+    std::vector<uint32_t> stack;       // 遍历依赖图用的显式栈
+    std::vector<uint32_t> visitMark;   // 按 markEpoch 判断本次遍历是否访问过
+    std::vector<uint32_t> targetMark;
+    uint32_t markEpoch = 0;
+
+    uint32_t intern(std::string_view name);
+    bool createsCycle(uint32_t id, const std::vector<uint32_t>& inputs);
+    void markDirty(uint32_t id);
+    void evaluateWave(RecalcStats& stats);
+    void evaluateCell(Cell& cell, VirtualMachine& machine, std::vector<double>& values);
+    void nextMarkEpoch();
+};
+
+#endif // SPREADSHEET_H
@@ -0,0 +1,89 @@
+#ifndef STATUS_H
+#define STATUS_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include "error.h"
+#include "functions.h"
+
+// 错误类别，对应 error.h 中的异常类
+enum class ErrorKind : uint8_t {
+    NONE,
+    LEXICAL,
+    SYNTAX,
+    EVALUATION
+};
+
+// 具体错误，决定错误信息的模板
+enum class ErrorCode : uint8_t {
+    OK,
+    INVALID_NUMBER,      // 词法：无效的数字格式，offset 为出错字符的位置
+    NUMBER_OUT_OF_RANGE, // 词法：数字超出双精度范围
+    UNKNOWN_CHARACTER,   // 词法：未知字符
+    TRAILING_INPUT,      // 语法：表达式之后仍有字符
+    EXPECTED_LPAREN,     // 语法：函数名后缺少左括号
+    MISSING_RPAREN,      // 语法：缺少右括号
+    UNEXPECTED_TOKEN,    // 语法：意外的标记
+    ARITY_MISMATCH,      // 语法：函数参数个数不符
+    INVALID_ASSIGNMENT,  // 语法：赋值目标不是合法的变量名
+    UNKNOWN_FUNCTION,    // 语法：未知的函数（变量名后紧跟左括号），text 为函数名
+    TOO_DEEP,            // 语法：嵌套层数或树高超出解析上限
+    DIVISION_BY_ZERO,    // 计算：除零
+    DOMAIN_ERROR,        // 计算：函数参数超出定义域
+    UNBOUND_VARIABLE,    // 计算：变量未绑定取值
+    CYCLIC_DEPENDENCY,   // 计算：单元格之间循环引用
+    NESTING_TOO_DEEP,    // 计算：超出虚拟机栈容量
+    INTERNAL_ERROR       // 计算：AST 或字节码不合法，text 为说明
+};
+
+// 不抛异常的错误通道：出错时只记录错误码与位置，错误信息在 message() 中按需构造。
+// text 指向输入、Program 中的变量名或静态字符串，须在它们失效之前取用信息
+struct Status {
+    ErrorCode code = ErrorCode::OK;
+    uint32_t offset = 0;                        // 出错位置在输入中的偏移（词法与语法错误）
+    std::string_view text;                      // 出错的词素、变量名或内部错误说明
+    const Functions::Info* function = nullptr;  // 参数个数或定义域错误涉及的函数
+
+    Status() = default;
+    Status(ErrorCode code, size_t offset = 0, std::string_view text = std::string_view(),
+           const Functions::Info* function = nullptr)
+        : code(code), offset(static_cast<uint32_t>(offset)), text(text), function(function) {}
+
+    bool ok() const { return code == ErrorCode::OK; }
+    ErrorKind kind() const;
+    // 不含类别前缀的错误信息
+    std::string detail() const;
+    // 完整错误信息，与对应异常的 what() 相同
+    std::string message() const;
+    // 抛出与错误类别对应的 CalcError 子类
+    [[noreturn]] void raise() const;
+};
+
+// expected 风格的结果：要么是值，要么是错误
+template <typename T>
+class Expected {
+public:
+    Expected(T value) : result(std::move(value)) {}
+    Expected(const Status& status) : status(status) {}
+
+    bool ok() const { return status.ok(); }
+    const Status& error() const { return status; }
+    T& value() { return result; }
+    const T& value() const { return result; }
+
+    // 供沿用异常接口的调用方使用：出错时抛出对应异常
+    T valueOrThrow() && {
+        if (!status.ok()) {
+            status.raise();
+        }
+        return std::move(result);
+    }
+
+private:
+    T result{};
+    Status status;
+};
+
+#endif // STATUS_H
@@ -0,0 +1,35 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <string>
+#include "column_evaluator.h"
+
+// 扫描区间：variable 从 start 以 step 为步长取值直到 stop（含端点）
+struct SweepSpec {
+    std::string variable;
+    double start = 0.0;
+    double stop = 0.0;
+    double step = 1.0;
+
+    // 点数上限：超出时按下标计算的取值失去精度，扫描也要运行数十分钟以上
+    static constexpr double MAX_POINTS = 1e12;
+
+    // 解析 "x=0:1e7:0.001" 形式的描述，格式错误或点数超出 MAX_POINTS 时抛出 CalcError
+    static SweepSpec parse(const std::string& text);
+    size_t count() const;
+};
+
+// 扫描统计
+struct SweepStats {
+    size_t points = 0;
+    double min = 0.0;
+    double max = 0.0;
+    double sum = 0.0;
+    double seconds = 0.0;
+    double pointsPerSecond() const { return seconds > 0 ? points / seconds : 0.0; }
+};
+
+// 在扫描区间上分块生成输入列并列式求值，只保留汇总统计
+SweepStats runSweep(const Program& program, const SweepSpec& spec, ColumnEvaluator& evaluator);
+
+#endif // SWEEP_H
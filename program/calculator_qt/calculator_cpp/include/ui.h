@@ -1,15 +1,34 @@
 #ifndef UI_H
 #define UI_H
 
+#include <ostream>
 #include <string>
+#include <vector>
+#include "expression_cache.h"
+#include "optimizer.h"
+#include "spreadsheet.h"
 
 class UI {
 public:
     static void showWelcome();
     static void showHelp();
-    static std::string getUserInput();
+    // 输入结束（如 Ctrl-D）时返回 false
+    static bool getUserInput(std::string& input);
     static void showResult(double result);
     static void showError(const std::string& error);
+    static void showCacheStats(const CacheStats& stats);
+    static void showOptimizerStats(const OptimizerStats& stats);
+    static void showAssignment(std::string_view name, double value, const RecalcStats& stats);
+    // 求导命令的结果：表达式的值与对各变量的偏导数，partials 与 names 一一对应
+    static void showGradient(double value, const std::vector<std::string>& names, const std::vector<double>& partials);
+    // 写出结果与错误的单行文本（不含换行），交互模式与批量模式共用
+    static void writeResult(std::ostream& out, double result);
+    static void writeError(std::ostream& out, const std::string& error);
+    // 求导结果的单行文本（不含换行），供管道模式使用："= 值  ∂/∂x = 偏导数  ∂/∂y = ..."
+    static void writeGradient(std::ostream& out, double value, const std::vector<std::string>& names,
+                              const std::vector<double>& partials);
+    // 与 writeResult 相同的文本（"= " 加最短往返表示）写入 buffer，返回长度（不含 '\0'），供管道模式直接写入输出缓冲
+    static size_t formatResult(char* buffer, size_t size, double result);
     static bool shouldContinue();
 };
 
@@ -0,0 +1,47 @@
+#ifndef VECTOR_MATH_H
+#define VECTOR_MATH_H
+
+#include <cstddef>
+#include <string>
+#include "simd_kernels.h"
+
+// 可向量化的单参数数学函数
+enum MathFunction {
+    MATH_SIN,
+    MATH_COS,
+    MATH_TAN,
+    MATH_LOG,      // 常用对数 log10
+    MATH_LN,
+    MATH_EXP,
+    MATH_SQRT,
+    MATH_ABS,
+    MATH_FUNCTION_COUNT,
+    MATH_NONE = MATH_FUNCTION_COUNT
+};
+
+// 精度档位，误差以相对正确舍入结果的 ULP（最后一位单位）计：
+//   MATH_LIBM  逐元素调用数学库，与逐行求值逐位一致（默认）
+//   MATH_ULP1  多项式逼近，误差 ≤ 1 ULP：区间约简带尾项补偿，结果重建采用高低位拆分
+//   MATH_ULP4  多项式逼近，误差 ≤ 4 ULP：省去尾项补偿与拆分重建，tan 由 sin / cos 相除
+// sqrt 与 abs 两档都是精确结果；sin/cos/tan 的参数超过约 1.6e6（|x| ≥ 2^20·π/2）或非有限时该元素退回数学库
+enum MathAccuracy {
+    MATH_LIBM,
+    MATH_ULP1,
+    MATH_ULP4
+};
+
+// 逐元素的数学函数核：dst[i] = f(dst[i])。定义域由调用方检查，定义域外的结果与数学库一致（NaN、±inf）
+using MathKernel = void (*)(double* dst, size_t n);
+
+struct MathKernels {
+    MathKernel kernel[MATH_FUNCTION_COUNT];
+};
+
+const char* mathFunctionName(MathFunction function);
+const char* mathAccuracyName(MathAccuracy accuracy);
+// 解析 "libm"、"ulp1"、"ulp4"，无法识别时返回 false
+bool parseMathAccuracy(const std::string& name, MathAccuracy& accuracy);
+// 取指定级别与档位的函数核；当前 CPU 不支持该级别时退回到可用的最高级别（AVX2 级别同时要求 FMA）
+const MathKernels& mathKernels(SimdLevel level, MathAccuracy accuracy);
+
+#endif // VECTOR_MATH_H
@@ -0,0 +1,33 @@
+#ifndef VM_H
+#define VM_H
+
+#include <array>
+#include "compiler.h"
+
+// 基于固定大小值栈的字节码虚拟机
+class VirtualMachine {
+public:
+    static constexpr size_t STACK_CAPACITY = 256;
+    // 共享子表达式临时槽位的上限，超出部分由编译器按树展开
+    static constexpr size_t TEMP_CAPACITY = 256;
+    // 前端默认的分层阈值：同一 Program 解释执行这么多次后编译为本机代码
+    static constexpr uint32_t DEFAULT_JIT_THRESHOLD = 100;
+
+    // jitThreshold 为 0 时只解释执行；JIT 不可用时自动退回解释执行
+    explicit VirtualMachine(uint32_t jitThreshold = 0) : jitThreshold(jitThreshold) {}
+
+    // variables 按 Program::variables 的槽位顺序给出变量取值，程序不含变量时可为空
+    // 出错时抛出 EvaluationError
+    double execute(const Program& program, const double* variables = nullptr);
+    // 不抛异常：除零、定义域错误等以错误码返回
+    Expected<double> tryExecute(const Program& program, const double* variables = nullptr);
+
+private:
+    uint32_t jitThreshold;
+    std::array<double, STACK_CAPACITY> stack;
+    std::array<double, TEMP_CAPACITY> temps;
+
+    Expected<double> interpret(const Program& program, const double* variables);
+};
+
+#endif // VM_H
@@ -0,0 +1,142 @@
+#include "batch.h"
+#include "line_evaluator.h"
+#include "error.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// 一个任务块：输入行区间与对应的输出缓冲
+struct Chunk {
+    size_t firstLine = 0;
+    size_t lineCount = 0;
+    std::string output;
+    size_t errors = 0;
+    bool done = false;
+};
+
+std::vector<std::string_view> splitLines(const std::string& input) {
+    std::vector<std::string_view> lines;
+    size_t start = 0;
+    while (start < input.size()) {
+        size_t end = input.find('\n', start);
+        if (end == std::string::npos) {
+            end = input.size();
+        }
+        lines.emplace_back(input.data() + start, end - start);
+        start = end + 1;
+    }
+    return lines;
+}
+
+// 整块失败时每行输入输出一行错误，保持逐行对应；连错误行也无法构造时返回空串
+std::string failedChunk(size_t lineCount, const char* reason) noexcept {
+    try {
+        std::string line = "错误: 未知错误: " + std::string(reason) + "\n";
+        std::string output;
+        output.reserve(line.size() * lineCount);
+        for (size_t i = 0; i < lineCount; i++) {
+            output += line;
+        }
+        return output;
+    } catch (const std::exception&) {
+        return std::string();
+    }
+}
+
+} // namespace
+
+BatchStats BatchEvaluator::run(const std::string& input, std::ostream& out) const {
+    auto begin = std::chrono::steady_clock::now();
+
+    std::vector<std::string_view> lines = splitLines(input);
+    size_t chunkLines = std::max<size_t>(options.chunkLines, 1);
+    size_t chunkCount = (lines.size() + chunkLines - 1) / chunkLines;
+    std::vector<Chunk> chunks(chunkCount);
+    for (size_t i = 0; i < chunkCount; i++) {
+        chunks[i].firstLine = i * chunkLines;
+        chunks[i].lineCount = std::min(chunkLines, lines.size() - chunks[i].firstLine);
+    }
+
+    size_t jobs = options.jobs != 0 ? options.jobs : std::max(1u, std::thread::hardware_concurrency());
+    jobs = std::min(jobs, std::max<size_t>(chunkCount, 1));
+
+    std::atomic<size_t> nextChunk{0};
+    std::mutex mutex;
+    std::condition_variable ready;
+
+    auto work = [&]() {
+        std::unique_ptr<LineEvaluator> worker;
+        size_t index;
+        while ((index = nextChunk.fetch_add(1)) < chunkCount) {
+            Chunk& chunk = chunks[index];
+            std::string output;
+            size_t errors = 0;
+            // 逐行的错误由 LineEvaluator 处理；这里兜住内存不足之类使整块失败的异常，
+            // 块仍须标记完成，否则写出线程会一直等待
+            try {
+                if (!worker) {
+                    worker = std::make_unique<LineEvaluator>(options.jitThreshold);
+                }
+                std::ostringstream buffer;
+                for (size_t i = 0; i < chunk.lineCount; i++) {
+                    worker->evaluate(lines[chunk.firstLine + i], buffer, errors);
+                    buffer << '\n';
+                }
+                output = buffer.str();
+            } catch (const std::exception& e) {
+                errors = chunk.lineCount;
+                output = failedChunk(chunk.lineCount, e.what());
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            chunk.output = std::move(output);
+            chunk.errors = errors;
+            chunk.done = true;
+            ready.notify_all();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < jobs; i++) {
+        threads.emplace_back(work);
+    }
+
+    // 按输入顺序写出已完成的任务块，写出后立即释放其缓冲
+    BatchStats stats;
+    for (Chunk& chunk : chunks) {
+        std::unique_lock<std::mutex> lock(mutex);
+        ready.wait(lock, [&chunk] { return chunk.done; });
+        std::string output = std::move(chunk.output);
+        stats.errors += chunk.errors;
+        lock.unlock();
+        out.write(output.data(), static_cast<std::streamsize>(output.size()));
+    }
+    out.flush();
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    stats.lines = lines.size();
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    return stats;
+}
+
+BatchStats BatchEvaluator::runFile(const std::string& path, std::ostream& out) const {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw CalcError("无法打开批量输入文件: " + path);
+    }
+    std::string input((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return run(input, out);
+}
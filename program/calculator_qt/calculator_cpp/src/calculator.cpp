@@ -1,46 +1,105 @@
 #include "calculator.h"
 #include "functions.h"
-#include "constants.h"
+#include <algorithm>
 #include <cmath>
-#include <stdexcept>
 
-double Calculator::evaluate(std::shared_ptr<ASTNode> node) {
-    if (!node) {
-        throw EvaluationError("空节点");
+double Calculator::evaluate(const AstArena& arena, NodeId root, const double* variables) {
+    return tryEvaluate(arena, root, variables).valueOrThrow();
+}
+
+Expected<double> Calculator::tryEvaluate(const AstArena& arena, NodeId root, const double* variables) {
+    this->variables = variables;
+    status = Status();
+    visited = 0;
+    if (++epoch == 0) {
+        // 计数回绕时清空，避免误用很久以前的结果
+        std::fill(memoEpoch.begin(), memoEpoch.end(), 0);
+        epoch = 1;
+    }
+    double result = evaluateNode(arena, root);
+    if (!status.ok()) {
+        return status;
+    }
+    return result;
+}
+
+double Calculator::fail(const Status& error) {
+    // 只保留第一个错误；返回值在出错后不再被使用
+    if (status.ok()) {
+        status = error;
+    }
+    return 0.0;
+}
+
+double Calculator::evaluateNode(const AstArena& arena, NodeId id) {
+    if (id == INVALID_NODE || id >= arena.size()) {
+        return fail(Status(ErrorCode::INTERNAL_ERROR, 0, "空节点"));
     }
     
-    switch (node->type) {
+    const ASTNode& node = arena.node(id);
+    if (!node.shared) {
+        return computeNode(arena, node);
+    }
+    // 只有含共享节点的表达式才需要缓存，纯树求值不分配
+    if (memoEpoch.size() < arena.size()) {
+        memoValues.resize(arena.size());
+        memoEpoch.resize(arena.size(), 0);
+    }
+    if (memoEpoch[id] == epoch) {
+        return memoValues[id];
+    }
+    double value = computeNode(arena, node);
+    memoValues[id] = value;
+    memoEpoch[id] = epoch;
+    return value;
+}
+
+double Calculator::computeNode(const AstArena& arena, const ASTNode& node) {
+    visited++;
+    switch (node.type) {
         case NUM_NODE:
-            return node->value;
+            return node.data.value;
+            
+        case CONSTANT_NODE:
+            return node.data.constant.info->value;
             
-        case CONSTANT_NODE: {
-            if (!Constants::isConstant(node->name)) {
-                throw EvaluationError("未知常量: " + node->name);
+        case VARIABLE_NODE: {
+            if (variables == nullptr) {
+                return fail(Status(ErrorCode::UNBOUND_VARIABLE, 0, arena.variableName(node.data.variable.slot)));
             }
-            return Constants::getValue(node->name);
+            return variables[node.data.variable.slot];
         }
             
         case BIN_OP_NODE: {
-            double left = evaluate(node->left);
-            double right = evaluate(node->right);
-            return applyOperator(node->op, left, right);
+            double left = evaluateNode(arena, node.data.binary.left);
+            double right = evaluateNode(arena, node.data.binary.right);
+            return applyOperator(node.op, left, right);
         }
             
         case UNARY_OP_NODE: {
-            double operand = evaluate(node->operand);
-            return applyUnaryOperator(node->op, operand);
+            double operand = evaluateNode(arena, node.data.unary.operand);
+            return applyUnaryOperator(node.op, operand);
         }
             
         case FUNC_CALL_NODE: {
-            std::vector<double> args;
-            for (const auto& arg : node->args) {
-                args.push_back(evaluate(arg));
+            // 参数个数已在解析阶段检查，嵌套调用各自使用栈上的参数数组
+            double args[Functions::MAX_ARITY];
+            const NodeId* argIds = arena.args(node);
+            for (uint32_t i = 0; i < node.data.call.argCount; i++) {
+                args[i] = evaluateNode(arena, argIds[i]);
             }
-            return applyFunction(node->name, args);
+            const Functions::Info* function = node.data.call.function;
+            if (!status.ok()) {
+                return 0.0;
+            }
+            if (!function->accepts(args)) {
+                return fail(Status(ErrorCode::DOMAIN_ERROR, 0, std::string_view(), function));
+            }
+            return function->function(args);
         }
             
         default:
-            throw EvaluationError("未知节点类型");
+            return fail(Status(ErrorCode::INTERNAL_ERROR, 0, "未知节点类型"));
     }
 }
 
@@ -54,13 +113,13 @@ double Calculator::applyOperator(char op, double left, double right) {
             return left * right;
         case '/':
             if (right == 0) {
-                throw EvaluationError("除零错误");
+                return fail(Status(ErrorCode::DIVISION_BY_ZERO));
             }
             return left / right;
         case '^':
             return std::pow(left, right);
         default:
-            throw EvaluationError("未知操作符: " + std::string(1, op));
+            return fail(Status(ErrorCode::INTERNAL_ERROR, 0, "未知操作符"));
     }
 }
 
@@ -71,13 +130,6 @@ double Calculator::applyUnaryOperator(char op, double operand) {
         case '-':
             return -operand;
         default:
-            throw EvaluationError("未知一元操作符: " + std::string(1, op));
+            return fail(Status(ErrorCode::INTERNAL_ERROR, 0, "未知一元操作符"));
     }
 }
-
-double Calculator::applyFunction(const std::string& funcName, const std::vector<double>& args) {
-    if (!Functions::isFunction(funcName)) {
-        throw EvaluationError("未知函数: " + funcName);
-    }
-    return Functions::evaluate(funcName, args);
-}
\ No newline at end of file
@@ -0,0 +1,104 @@
+#include "column_evaluator.h"
+#include <algorithm>
+#include <cstring>
+
+ColumnEvaluator::ColumnEvaluator(SimdLevel level, MathAccuracy accuracy)
+    : simdLevel(std::min(level, detectSimdLevel())), kernels(columnKernels(level)), mathAccuracy(accuracy),
+      math(mathKernels(level, accuracy)) {}
+
+void ColumnEvaluator::evaluate(const Program& program, const double* const* columns, size_t count, double* out) {
+    if (columns == nullptr && !program.variables.empty()) {
+        throw EvaluationError("未绑定的变量: " + program.variables[0]);
+    }
+    lanes.resize((std::max<size_t>(program.maxStack, 1) + program.temps) * BLOCK_SIZE);
+    for (size_t offset = 0; offset < count; offset += BLOCK_SIZE) {
+        evaluateBlock(program, columns, offset, std::min(BLOCK_SIZE, count - offset), out + offset);
+    }
+}
+
+void ColumnEvaluator::evaluateBlock(const Program& program, const double* const* columns, size_t offset,
+                                    size_t rows, double* out) {
+    double* base = lanes.data();
+    size_t sp = 0;   // 下一个空闲的行块
+    auto slot = [base](size_t index) { return base + index * BLOCK_SIZE; };
+    // 临时槽位的行块排在值栈之后
+    size_t tempBase = std::max<size_t>(program.maxStack, 1);
+
+    for (const Instruction& ins : program.code) {
+        switch (ins.op) {
+            case OP_PUSH_CONST:
+                std::fill(slot(sp), slot(sp) + rows, program.constants[ins.operand]);
+                sp++;
+                break;
+            case OP_LOAD_VAR:
+                std::memcpy(slot(sp), columns[ins.operand] + offset, rows * sizeof(double));
+                sp++;
+                break;
+            case OP_ADD:
+                sp--;
+                kernels.add(slot(sp - 1), slot(sp), rows);
+                break;
+            case OP_SUB:
+                sp--;
+                kernels.sub(slot(sp - 1), slot(sp), rows);
+                break;
+            case OP_MUL:
+                sp--;
+                kernels.mul(slot(sp - 1), slot(sp), rows);
+                break;
+            case OP_DIV:
+                sp--;
+                if (kernels.anyZero(slot(sp), rows)) {
+                    throw EvaluationError("除零错误");
+                }
+                kernels.div(slot(sp - 1), slot(sp), rows);
+                break;
+            case OP_POW:
+                sp--;
+                kernels.pow(slot(sp - 1), slot(sp), rows);
+                break;
+            case OP_NEG:
+                kernels.neg(slot(sp - 1), rows);
+                break;
+            case OP_CALL: {
+                // 函数逐行调用，结果写回第一个参数所在的行块
+                sp -= ins.argc;
+                const Functions::Info* function = program.functions[ins.operand];
+                if (function->vector != MATH_NONE && mathAccuracy != MATH_LIBM) {
+                    // 向量数学核整块求值；定义域仍逐行检查
+                    if (function->domain != nullptr) {
+                        for (size_t row = 0; row < rows; row++) {
+                            if (!function->domain(slot(sp) + row)) {
+                                throw EvaluationError(function->domainError);
+                            }
+                        }
+                    }
+                    math.kernel[function->vector](slot(sp), rows);
+                    sp++;
+                    break;
+                }
+                double args[Functions::MAX_ARITY];
+                for (size_t row = 0; row < rows; row++) {
+                    for (size_t arg = 0; arg < ins.argc; arg++) {
+                        args[arg] = slot(sp + arg)[row];
+                    }
+                    if (!function->accepts(args)) {
+                        throw EvaluationError(function->domainError);
+                    }
+                    slot(sp)[row] = function->function(args);
+                }
+                sp++;
+                break;
+            }
+            case OP_STORE_TEMP:
+                std::memcpy(slot(tempBase + ins.operand), slot(sp - 1), rows * sizeof(double));
+                break;
+            case OP_LOAD_TEMP:
+                std::memcpy(slot(sp), slot(tempBase + ins.operand), rows * sizeof(double));
+                sp++;
+                break;
+        }
+    }
+
+    std::memcpy(out, slot(0), rows * sizeof(double));
+}
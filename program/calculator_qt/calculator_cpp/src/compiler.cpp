@@ -0,0 +1,138 @@
+#include "compiler.h"
+#include "vm.h"
+
+Program Compiler::compile(const AstArena& arena, NodeId root) {
+    return tryCompile(arena, root).valueOrThrow();
+}
+
+Expected<Program> Compiler::tryCompile(const AstArena& arena, NodeId root) {
+    Program program;
+    for (size_t slot = 0; slot < arena.variableCount(); slot++) {
+        program.variables.emplace_back(arena.variableName(slot));
+    }
+    Compiler compiler(arena, program);
+    compiler.tempSlots.assign(arena.size(), NO_TEMP);
+    compiler.compileNode(root);
+    if (!compiler.status.ok()) {
+        return compiler.status;
+    }
+    if (program.maxStack > VirtualMachine::STACK_CAPACITY) {
+        return Status(ErrorCode::NESTING_TOO_DEEP);
+    }
+    return Expected<Program>(std::move(program));
+}
+
+void Compiler::fail(const char* message) {
+    if (status.ok()) {
+        status = Status(ErrorCode::INTERNAL_ERROR, 0, message);
+    }
+}
+
+void Compiler::emit(OpCode op, uint32_t operand, uint8_t argc) {
+    program.code.push_back(Instruction{op, argc, operand});
+}
+
+uint32_t Compiler::addConstant(double value) {
+    program.constants.push_back(value);
+    return static_cast<uint32_t>(program.constants.size() - 1);
+}
+
+uint32_t Compiler::addFunction(const Functions::Info* function) {
+    for (size_t i = 0; i < program.functions.size(); i++) {
+        if (program.functions[i] == function) {
+            return static_cast<uint32_t>(i);
+        }
+    }
+    program.functions.push_back(function);
+    return static_cast<uint32_t>(program.functions.size() - 1);
+}
+
+void Compiler::compileNode(NodeId id) {
+    if (id == INVALID_NODE || id >= arena.size()) {
+        fail("空节点");
+        return;
+    }
+
+    const ASTNode& node = arena.node(id);
+
+    // 共享子表达式：首次计算后存入临时槽位，之后直接读取
+    if (node.shared && tempSlots[id] != NO_TEMP) {
+        emit(OP_LOAD_TEMP, tempSlots[id]);
+        depth++;
+        if (depth > program.maxStack) {
+            program.maxStack = depth;
+        }
+        return;
+    }
+
+    switch (node.type) {
+        case NUM_NODE:
+            emit(OP_PUSH_CONST, addConstant(node.data.value));
+            depth++;
+            break;
+
+        case CONSTANT_NODE:
+            // 常量在解析阶段已取得描述符，执行时不再查表
+            emit(OP_PUSH_CONST, addConstant(node.data.constant.info->value));
+            depth++;
+            break;
+
+        case VARIABLE_NODE:
+            emit(OP_LOAD_VAR, node.data.variable.slot);
+            depth++;
+            break;
+
+        case BIN_OP_NODE: {
+            compileNode(node.data.binary.left);
+            compileNode(node.data.binary.right);
+            switch (node.op) {
+                case '+': emit(OP_ADD); break;
+                case '-': emit(OP_SUB); break;
+                case '*': emit(OP_MUL); break;
+                case '/': emit(OP_DIV); break;
+                case '^': emit(OP_POW); break;
+                default:
+                    fail("未知操作符");
+                    return;
+            }
+            depth--;
+            break;
+        }
+
+        case UNARY_OP_NODE: {
+            compileNode(node.data.unary.operand);
+            if (node.op == '-') {
+                emit(OP_NEG);
+            } else if (node.op != '+') {
+                fail("未知一元操作符");
+                return;
+            }
+            break;
+        }
+
+        case FUNC_CALL_NODE: {
+            const NodeId* args = arena.args(node);
+            for (uint32_t i = 0; i < node.data.call.argCount; i++) {
+                compileNode(args[i]);
+            }
+            emit(OP_CALL, addFunction(node.data.call.function), static_cast<uint8_t>(node.data.call.argCount));
+            depth -= node.data.call.argCount;
+            depth++;
+            break;
+        }
+
+        default:
+            fail("未知节点类型");
+            return;
+    }
+
+    // 临时槽位用尽时，其余共享节点按树展开重复计算，结果相同
+    if (node.shared && program.temps < VirtualMachine::TEMP_CAPACITY) {
+        tempSlots[id] = static_cast<uint32_t>(program.temps++);
+        emit(OP_STORE_TEMP, tempSlots[id]);
+    }
+
+    if (depth > program.maxStack) {
+        program.maxStack = depth;
+    }
+}
@@ -1,38 +1,28 @@
 #include "constants.h"
 #include <cmath>
 
-std::unordered_map<std::string, double> Constants::constants;
-bool Constants::initialized = false;
-
-void Constants::initialize() {
-    if (!initialized) {
-        constants["pi"] = M_PI;
-        constants["e"] = M_E;
-        initialized = true;
-    }
-}
-
-const std::unordered_map<std::string, double>& Constants::getConstants() {
-    if (!initialized) {
-        initialize();
-    }
+const std::unordered_map<std::string_view, Constants::Info>& Constants::getConstants() {
+    static const std::unordered_map<std::string_view, Info> constants = {
+        {"pi", {"pi", M_PI}},
+        {"e", {"e", M_E}},
+    };
     return constants;
 }
 
 bool Constants::isConstant(const std::string& name) {
-    if (!initialized) {
-        initialize();
-    }
-    return constants.find(name) != constants.end();
+    return find(name) != nullptr;
 }
 
 double Constants::getValue(const std::string& name) {
-    if (!initialized) {
-        initialize();
-    }
+    const Info* info = find(name);
+    return info != nullptr ? info->value : 0.0;
+}
+
+const Constants::Info* Constants::find(std::string_view name) {
+    const auto& constants = getConstants();
     auto it = constants.find(name);
     if (it != constants.end()) {
-        return it->second;
+        return &it->second;
     }
-    return 0.0;
-}
\ No newline at end of file
+    return nullptr;
+}
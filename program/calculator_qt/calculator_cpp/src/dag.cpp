@@ -0,0 +1,176 @@
+#include "dag.h"
+#include <cstring>
+
+namespace {
+
+uint64_t mix(uint64_t h, uint64_t value) {
+    h ^= value + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+    return h;
+}
+
+uint64_t bits(double value) {
+    uint64_t result;
+    std::memcpy(&result, &value, sizeof(result));
+    return result;
+}
+
+// 叶节点重新读取的代价不高于查表，不作为共享节点处理
+bool isInterior(const ASTNode& node) {
+    return node.type == BIN_OP_NODE || node.type == UNARY_OP_NODE || node.type == FUNC_CALL_NODE;
+}
+
+uint64_t bits(const void* pointer) {
+    return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(pointer));
+}
+
+} // namespace
+
+NodeId DagBuilder::build(AstArena& arena, NodeId root) {
+    lastStats = DagStats();
+    if (root == INVALID_NODE || root >= arena.size()) {
+        return root;
+    }
+    lastStats.treeNodes = arena.treeSize(root);
+
+    // 容量在各次调用间复用，稳态下不再分配
+    size_t count = arena.size();
+    size_t capacity = 16;
+    while (capacity < count * 2) {
+        capacity *= 2;
+    }
+    representative.assign(count, INVALID_NODE);
+    table.assign(capacity, INVALID_NODE);
+    NodeId result = intern(arena, root);
+
+    parents.assign(count, 0);
+    for (size_t id = 0; id < count; id++) {
+        arena.node(static_cast<NodeId>(id)).shared = false;
+    }
+    lastStats.dagNodes = 1;
+    countParents(arena, result);
+    return result;
+}
+
+NodeId DagBuilder::intern(AstArena& arena, NodeId id) {
+    if (representative[id] != INVALID_NODE) {
+        return representative[id];
+    }
+
+    // 先把子节点替换为各自的代表节点
+    ASTNode& node = arena.node(id);
+    switch (node.type) {
+        case BIN_OP_NODE:
+            node.data.binary.left = intern(arena, node.data.binary.left);
+            node.data.binary.right = intern(arena, node.data.binary.right);
+            break;
+        case UNARY_OP_NODE:
+            node.data.unary.operand = intern(arena, node.data.unary.operand);
+            break;
+        case FUNC_CALL_NODE:
+            for (uint32_t i = 0; i < node.data.call.argCount; i++) {
+                arena.setArg(node, i, intern(arena, arena.args(node)[i]));
+            }
+            break;
+        default:
+            break;
+    }
+
+    size_t mask = table.size() - 1;
+    for (size_t slot = hash(arena, node) & mask;; slot = (slot + 1) & mask) {
+        if (table[slot] == INVALID_NODE) {
+            table[slot] = id;
+            representative[id] = id;
+            return id;
+        }
+        if (equal(arena, arena.node(table[slot]), node)) {
+            representative[id] = table[slot];
+            return table[slot];
+        }
+    }
+}
+
+uint64_t DagBuilder::hash(const AstArena& arena, const ASTNode& node) const {
+    uint64_t h = mix(static_cast<uint64_t>(node.type), static_cast<uint8_t>(node.op));
+    switch (node.type) {
+        case NUM_NODE:
+            return mix(h, bits(node.data.value));
+        case CONSTANT_NODE:
+            return mix(h, bits(node.data.constant.info));
+        case VARIABLE_NODE:
+            return mix(h, node.data.variable.slot);
+        case UNARY_OP_NODE:
+            return mix(h, node.data.unary.operand);
+        case BIN_OP_NODE:
+            return mix(mix(h, node.data.binary.left), node.data.binary.right);
+        case FUNC_CALL_NODE: {
+            h = mix(h, bits(node.data.call.function));
+            for (uint32_t i = 0; i < node.data.call.argCount; i++) {
+                h = mix(h, arena.args(node)[i]);
+            }
+            return h;
+        }
+    }
+    return h;
+}
+
+bool DagBuilder::equal(const AstArena& arena, const ASTNode& a, const ASTNode& b) const {
+    if (a.type != b.type || a.op != b.op) {
+        return false;
+    }
+    switch (a.type) {
+        case NUM_NODE:
+            return bits(a.data.value) == bits(b.data.value);
+        case CONSTANT_NODE:
+            return a.data.constant.info == b.data.constant.info;
+        case VARIABLE_NODE:
+            return a.data.variable.slot == b.data.variable.slot;
+        case UNARY_OP_NODE:
+            return a.data.unary.operand == b.data.unary.operand;
+        case BIN_OP_NODE:
+            return a.data.binary.left == b.data.binary.left && a.data.binary.right == b.data.binary.right;
+        case FUNC_CALL_NODE: {
+            if (a.data.call.function != b.data.call.function || a.data.call.argCount != b.data.call.argCount) {
+                return false;
+            }
+            const NodeId* argsA = arena.args(a);
+            const NodeId* argsB = arena.args(b);
+            for (uint32_t i = 0; i < a.data.call.argCount; i++) {
+                if (argsA[i] != argsB[i]) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+void DagBuilder::countParents(AstArena& arena, NodeId id) {
+    auto visit = [&](NodeId child) {
+        if (parents[child]++ == 0) {
+            lastStats.dagNodes++;
+            countParents(arena, child);
+        } else if (parents[child] == 2 && isInterior(arena.node(child))) {
+            arena.node(child).shared = true;
+            lastStats.sharedNodes++;
+        }
+    };
+
+    const ASTNode& node = arena.node(id);
+    switch (node.type) {
+        case BIN_OP_NODE:
+            visit(node.data.binary.left);
+            visit(node.data.binary.right);
+            break;
+        case UNARY_OP_NODE:
+            visit(node.data.unary.operand);
+            break;
+        case FUNC_CALL_NODE:
+            for (uint32_t i = 0; i < node.data.call.argCount; i++) {
+                visit(arena.args(node)[i]);
+            }
+            break;
+        default:
+            break;
+    }
+}
@@ -0,0 +1,449 @@
+#include "derivative.h"
+#include "calculator.h"
+#include "functions.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr double LN10 = 2.30258509299404568402;
+
+// abs 的导数，0 处取 0；不在注册表中，只出现在导数式里
+double funcSign(const double* args) {
+    return args[0] > 0 ? 1.0 : (args[0] < 0 ? -1.0 : args[0]);
+}
+
+const Functions::Info signFunction = {"sign", funcSign, 1, nullptr, nullptr, nullptr, MATH_NONE};
+
+const Functions::Info* lnFunction() {
+    static const Functions::Info* ln = Functions::find("ln");
+    return ln;
+}
+
+// f'(u)：value 为 f(u)。注册表中的函数都有对应的 MathFunction 编号，按编号选择求导规则；
+// 与 Differentiator::deriveCall 构造的导数式逐项对应
+bool functionDerivative(const Functions::Info* function, double u, double value, double& slope) {
+    switch (function->vector) {
+        case MATH_SIN: slope = std::cos(u); return true;
+        case MATH_COS: slope = -std::sin(u); return true;
+        case MATH_TAN: slope = 1.0 + value * value; return true;
+        case MATH_LOG: slope = 1.0 / (u * LN10); return true;
+        case MATH_LN: slope = 1.0 / u; return true;
+        case MATH_EXP: slope = value; return true;
+        case MATH_SQRT: slope = 0.5 * std::pow(value, -1.0); return true;
+        case MATH_ABS: slope = funcSign(&u); return true;
+        default: return false;
+    }
+}
+
+} // namespace
+
+double DualEvaluator::evaluate(const AstArena& arena, NodeId root, const double* variables, double* gradient) {
+    return tryEvaluate(arena, root, variables, gradient).valueOrThrow();
+}
+
+Expected<double> DualEvaluator::tryEvaluate(const AstArena& arena, NodeId root, const double* variables,
+                                            double* gradient) {
+    this->variables = variables;
+    width = arena.variableCount();
+    status = Status();
+    if (++epoch == 0) {
+        std::fill(valueEpoch.begin(), valueEpoch.end(), 0);
+        epoch = 1;
+    }
+    // 求值期间不再扩容，各节点的偏导数指针保持有效
+    if (values.size() < arena.size()) {
+        values.resize(arena.size());
+        constant.resize(arena.size());
+        valueEpoch.resize(arena.size(), 0);
+    }
+    if (tangents.size() < arena.size() * width) {
+        tangents.resize(arena.size() * width);
+    }
+    if (!evaluateNode(arena, root)) {
+        return status;
+    }
+    if (constant[root]) {
+        std::fill(gradient, gradient + width, 0.0);
+    } else {
+        std::copy(tangent(root), tangent(root) + width, gradient);
+    }
+    return values[root];
+}
+
+bool DualEvaluator::fail(const Status& error) {
+    if (status.ok()) {
+        status = error;
+    }
+    return false;
+}
+
+bool DualEvaluator::evaluateNode(const AstArena& arena, NodeId id) {
+    if (id == INVALID_NODE || id >= arena.size()) {
+        return fail(Status(ErrorCode::INTERNAL_ERROR, 0, "空节点"));
+    }
+    if (arena.node(id).shared && valueEpoch[id] == epoch) {
+        return true;
+    }
+    if (!computeNode(arena, id)) {
+        return false;
+    }
+    valueEpoch[id] = epoch;
+    return true;
+}
+
+bool DualEvaluator::computeNode(const AstArena& arena, NodeId id) {
+    const ASTNode& node = arena.node(id);
+    double* d = tangent(id);
+    switch (node.type) {
+        case NUM_NODE:
+            values[id] = node.data.value;
+            constant[id] = 1;
+            return true;
+
+        case CONSTANT_NODE:
+            values[id] = node.data.constant.info->value;
+            constant[id] = 1;
+            return true;
+
+        case VARIABLE_NODE: {
+            uint32_t slot = node.data.variable.slot;
+            if (variables == nullptr) {
+                return fail(Status(ErrorCode::UNBOUND_VARIABLE, 0, arena.variableName(slot)));
+            }
+            values[id] = variables[slot];
+            constant[id] = 0;
+            std::fill(d, d + width, 0.0);
+            d[slot] = 1.0;
+            return true;
+        }
+
+        case UNARY_OP_NODE: {
+            NodeId operand = node.data.unary.operand;
+            if (!evaluateNode(arena, operand)) {
+                return false;
+            }
+            if (node.op != '+' && node.op != '-') {
+                return fail(Status(ErrorCode::INTERNAL_ERROR, 0, "未知一元操作符"));
+            }
+            bool negate = node.op == '-';
+            values[id] = negate ? -values[operand] : values[operand];
+            constant[id] = constant[operand];
+            if (!constant[id]) {
+                const double* du = tangent(operand);
+                for (size_t i = 0; i < width; i++) {
+                    d[i] = negate ? -du[i] : du[i];
+                }
+            }
+            return true;
+        }
+
+        case BIN_OP_NODE: {
+            NodeId left = node.data.binary.left;
+            NodeId right = node.data.binary.right;
+            if (!evaluateNode(arena, left) || !evaluateNode(arena, right)) {
+                return false;
+            }
+            double u = values[left];
+            double v = values[right];
+            bool constantLeft = constant[left];
+            bool constantRight = constant[right];
+            constant[id] = constantLeft && constantRight;
+            const double* du = tangent(left);
+            const double* dv = tangent(right);
+            switch (node.op) {
+                case '+':
+                case '-': {
+                    bool subtract = node.op == '-';
+                    values[id] = subtract ? u - v : u + v;
+                    if (constant[id]) {
+                        return true;
+                    }
+                    for (size_t i = 0; i < width; i++) {
+                        if (constantRight) {
+                            d[i] = du[i];
+                        } else if (constantLeft) {
+                            d[i] = subtract ? -dv[i] : dv[i];
+                        } else {
+                            d[i] = subtract ? du[i] - dv[i] : du[i] + dv[i];
+                        }
+                    }
+                    return true;
+                }
+                case '/': {
+                    if (v == 0) {
+                        return fail(Status(ErrorCode::DIVISION_BY_ZERO));
+                    }
+                    // (du - q * dv) / v，与 Differentiator 构造的导数式相同
+                    double q = u / v;
+                    values[id] = q;
+                    if (constant[id]) {
+                        return true;
+                    }
+                    for (size_t i = 0; i < width; i++) {
+                        double numerator = constantRight ? du[i] : (constantLeft ? -(q * dv[i]) : du[i] - q * dv[i]);
+                        d[i] = numerator / v;
+                    }
+                    return true;
+                }
+                default:
+                    break;
+            }
+
+            // 乘法与幂的导数是 du * a + dv * b 的形式，常量一侧的项省去
+            double a = 0.0;
+            double b = 0.0;
+            if (node.op == '*') {
+                values[id] = u * v;
+                a = v;
+                b = u;
+            } else if (node.op == '^') {
+                double p = std::pow(u, v);
+                values[id] = p;
+                // u^0 恒为 1，导数为 0；不能按 0 * u^-1 计算，u = 0 时得 0 * inf = NaN
+                if (!constantLeft && v != 0) {
+                    a = v * std::pow(u, v - 1.0);
+                }
+                // 指数含变量时导数含 ln u，底数须在 ln 的定义域内
+                if (!constantRight) {
+                    if (!(u > 0)) {
+                        return fail(Status(ErrorCode::DOMAIN_ERROR, 0, std::string_view(), lnFunction()));
+                    }
+                    b = p * std::log(u);
+                }
+            } else {
+                return fail(Status(ErrorCode::INTERNAL_ERROR, 0, "未知操作符"));
+            }
+            if (constant[id]) {
+                return true;
+            }
+            for (size_t i = 0; i < width; i++) {
+                if (constantRight) {
+                    d[i] = du[i] * a;
+                } else if (constantLeft) {
+                    d[i] = dv[i] * b;
+                } else {
+                    d[i] = du[i] * a + dv[i] * b;
+                }
+            }
+            return true;
+        }
+
+        case FUNC_CALL_NODE: {
+            const Functions::Info* function = node.data.call.function;
+            uint32_t argCount = node.data.call.argCount;
+            const NodeId* argIds = arena.args(node);
+            double args[Functions::MAX_ARITY] = {};
+            for (uint32_t i = 0; i < argCount; i++) {
+                if (!evaluateNode(arena, argIds[i])) {
+                    return false;
+                }
+                args[i] = values[argIds[i]];
+            }
+            if (!function->accepts(args)) {
+                return fail(Status(ErrorCode::DOMAIN_ERROR, 0, std::string_view(), function));
+            }
+            values[id] = function->function(args);
+            constant[id] = 1;
+            for (uint32_t i = 0; i < argCount; i++) {
+                constant[id] = constant[id] && constant[argIds[i]];
+            }
+            if (constant[id]) {
+                return true;
+            }
+            double slope;
+            if (argCount != 1 || !functionDerivative(function, args[0], values[id], slope)) {
+                return fail(Status(ErrorCode::INTERNAL_ERROR, 0, "函数没有求导规则"));
+            }
+            const double* du = tangent(argIds[0]);
+            for (size_t i = 0; i < width; i++) {
+                d[i] = du[i] * slope;
+            }
+            return true;
+        }
+
+        default:
+            return fail(Status(ErrorCode::INTERNAL_ERROR, 0, "未知节点类型"));
+    }
+}
+
+NodeId Differentiator::differentiate(AstArena& arena, NodeId root, uint32_t slot) {
+    return tryDifferentiate(arena, root, slot).valueOrThrow();
+}
+
+Expected<NodeId> Differentiator::tryDifferentiate(AstArena& arena, NodeId root, uint32_t slot) {
+    Differentiator differentiator(arena, slot);
+    differentiator.memo.assign(arena.size(), PENDING);
+    NodeId result = differentiator.derive(root);
+    if (!differentiator.status.ok()) {
+        return differentiator.status;
+    }
+    return result == ZERO ? arena.addNumber(0.0) : result;
+}
+
+NodeId Differentiator::fail(const Status& error) {
+    if (status.ok()) {
+        status = error;
+    }
+    return ZERO;
+}
+
+NodeId Differentiator::derive(NodeId id) {
+    if (id == INVALID_NODE || id >= memo.size()) {
+        return fail(Status(ErrorCode::INTERNAL_ERROR, 0, "空节点"));
+    }
+    // 节点只会在求导完成后被再次引用（AST 无环），因此 PENDING 只表示尚未求导
+    if (memo[id] == PENDING) {
+        memo[id] = deriveNode(id);
+    }
+    return memo[id];
+}
+
+NodeId Differentiator::deriveNode(NodeId id) {
+    // 构造新节点会使节点引用失效，先取出所需字段
+    ASTNode node = arena.node(id);
+    switch (node.type) {
+        case NUM_NODE:
+        case CONSTANT_NODE:
+            return ZERO;
+
+        case VARIABLE_NODE:
+            return node.data.variable.slot == slot ? arena.addNumber(1.0) : ZERO;
+
+        case UNARY_OP_NODE: {
+            NodeId du = derive(node.data.unary.operand);
+            if (node.op == '+') {
+                return du;
+            }
+            if (node.op != '-') {
+                return fail(Status(ErrorCode::INTERNAL_ERROR, 0, "未知一元操作符"));
+            }
+            return du == ZERO ? ZERO : arena.addUnary('-', du);
+        }
+
+        case BIN_OP_NODE: {
+            NodeId u = node.data.binary.left;
+            NodeId v = node.data.binary.right;
+            NodeId du = derive(u);
+            NodeId dv = derive(v);
+            switch (node.op) {
+                case '+':
+                    return add(du, dv);
+                case '-':
+                    return subtract(du, dv);
+                case '*':
+                    return add(multiply(du, v), multiply(dv, u));
+                case '/': {
+                    NodeId numerator = subtract(du, multiply(id, dv));
+                    return numerator == ZERO ? ZERO : arena.addBinary('/', numerator, v);
+                }
+                case '^': {
+                    // d(u^v) = du * (v * u^(v-1)) + dv * (u^v * ln u)；
+                    // 指数是值为 0 的常量时 u^0 恒为 1，与 DualEvaluator 一样取 0，避免 u = 0 时 0 * inf = NaN
+                    NodeId result = ZERO;
+                    if (du != ZERO && !isConstantZero(v)) {
+                        NodeId exponent = arena.addBinary('-', v, arena.addNumber(1.0));
+                        result = multiply(du, arena.addBinary('*', v, arena.addBinary('^', u, exponent)));
+                    }
+                    if (dv != ZERO) {
+                        size_t mark = arena.argMark();
+                        arena.pushArg(u);
+                        NodeId ln = arena.addCall(lnFunction(), mark);
+                        result = add(result, multiply(dv, arena.addBinary('*', id, ln)));
+                    }
+                    return result;
+                }
+                default:
+                    return fail(Status(ErrorCode::INTERNAL_ERROR, 0, "未知操作符"));
+            }
+        }
+
+        case FUNC_CALL_NODE:
+            return deriveCall(id);
+
+        default:
+            return fail(Status(ErrorCode::INTERNAL_ERROR, 0, "未知节点类型"));
+    }
+}
+
+NodeId Differentiator::deriveCall(NodeId id) {
+    const Functions::Info* function = arena.node(id).data.call.function;
+    if (arena.node(id).data.call.argCount != 1) {
+        return fail(Status(ErrorCode::INTERNAL_ERROR, 0, "函数没有求导规则"));
+    }
+    NodeId u = arena.args(arena.node(id))[0];
+    NodeId du = derive(u);
+    if (du == ZERO) {
+        return ZERO;
+    }
+
+    auto call = [this](const Functions::Info* callee, NodeId arg) {
+        size_t mark = arena.argMark();
+        arena.pushArg(arg);
+        return arena.addCall(callee, mark);
+    };
+    NodeId slope;
+    switch (function->vector) {
+        case MATH_SIN:
+            slope = call(Functions::find("cos"), u);
+            break;
+        case MATH_COS:
+            slope = arena.addUnary('-', call(Functions::find("sin"), u));
+            break;
+        case MATH_TAN:
+            slope = arena.addBinary('+', arena.addNumber(1.0), arena.addBinary('*', id, id));
+            break;
+        case MATH_LOG:
+            slope = arena.addBinary('/', arena.addNumber(1.0), arena.addBinary('*', u, arena.addNumber(LN10)));
+            break;
+        case MATH_LN:
+            slope = arena.addBinary('/', arena.addNumber(1.0), u);
+            break;
+        case MATH_EXP:
+            slope = id;
+            break;
+        case MATH_SQRT:
+            // 0 处的导数为 +inf，用负指数幂而不是除法，避免报除零错误
+            slope = arena.addBinary('*', arena.addNumber(0.5), arena.addBinary('^', id, arena.addNumber(-1.0)));
+            break;
+        case MATH_ABS:
+            slope = call(&signFunction, u);
+            break;
+        default:
+            return fail(Status(ErrorCode::INTERNAL_ERROR, 0, "函数没有求导规则"));
+    }
+    return multiply(du, slope);
+}
+
+bool Differentiator::isConstantZero(NodeId id) const {
+    // 子树含变量时求值报告未绑定变量，不视为常量
+    Expected<double> value = Calculator().tryEvaluate(arena, id);
+    return value.ok() && value.value() == 0;
+}
+
+NodeId Differentiator::add(NodeId left, NodeId right) {
+    if (left == ZERO) {
+        return right;
+    }
+    if (right == ZERO) {
+        return left;
+    }
+    return arena.addBinary('+', left, right);
+}
+
+NodeId Differentiator::subtract(NodeId left, NodeId right) {
+    if (right == ZERO) {
+        return left;
+    }
+    if (left == ZERO) {
+        return arena.addUnary('-', right);
+    }
+    return arena.addBinary('-', left, right);
+}
+
+NodeId Differentiator::multiply(NodeId left, NodeId right) {
+    if (left == ZERO || right == ZERO) {
+        return ZERO;
+    }
+    return arena.addBinary('*', left, right);
+}
@@ -0,0 +1,92 @@
+#include "expression_cache.h"
+#include <cctype>
+
+ExpressionCache::ExpressionCache(size_t capacity) {
+    counters.capacity = capacity;
+    index.reserve(capacity);
+}
+
+static bool isWordChar(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '.' || c == '_';
+}
+
+// 十进制指数 e/E 与十六进制的二进制指数 p/P
+static bool isExponentMark(char c) {
+    return c == 'e' || c == 'E' || c == 'p' || c == 'P';
+}
+
+static bool isSign(char c) {
+    return c == '+' || c == '-';
+}
+
+// 去掉这里的空白是否可能改变词法结果
+static bool spaceIsSignificant(const std::string& key, char next) {
+    char prev = key.back();
+    if (isWordChar(prev) && isWordChar(next)) {
+        return true;
+    }
+    // 指数记数法："1e -3" 与 "1e- 3" 不能被拼成 "1e-3"
+    if (isExponentMark(prev) && isSign(next)) {
+        return true;
+    }
+    return isSign(prev) && std::isdigit(static_cast<unsigned char>(next)) &&
+           key.size() >= 2 && isExponentMark(key[key.size() - 2]);
+}
+
+std::string ExpressionCache::normalize(std::string_view input) {
+    std::string key;
+    normalize(input, key);
+    return key;
+}
+
+void ExpressionCache::normalize(std::string_view input, std::string& key) {
+    key.clear();
+    key.reserve(input.size());
+    bool pendingSpace = false;
+    for (char c : input) {
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            pendingSpace = true;
+            continue;
+        }
+        if (pendingSpace && !key.empty() && spaceIsSignificant(key, c)) {
+            key.push_back(' ');
+        }
+        pendingSpace = false;
+        key.push_back(c);
+    }
+}
+
+const Program* ExpressionCache::find(const std::string& key) {
+    auto it = index.find(key);
+    if (it == index.end()) {
+        counters.misses++;
+        return nullptr;
+    }
+    counters.hits++;
+    entries.splice(entries.begin(), entries, it->second);
+    return &it->second->second;
+}
+
+const Program& ExpressionCache::insert(const std::string& key, Program program) {
+    if (counters.capacity == 0) {
+        uncached = std::move(program);
+        return uncached;
+    }
+
+    auto it = index.find(key);
+    if (it != index.end()) {
+        it->second->second = std::move(program);
+        entries.splice(entries.begin(), entries, it->second);
+        return it->second->second;
+    }
+
+    if (entries.size() >= counters.capacity) {
+        index.erase(entries.back().first);
+        entries.pop_back();
+        counters.evictions++;
+    }
+    entries.emplace_front(key, std::move(program));
+    index.emplace(key, entries.begin());
+    counters.size = entries.size();
+    return entries.front().second;
+}
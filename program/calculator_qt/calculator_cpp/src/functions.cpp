@@ -2,84 +2,108 @@
 #include <cmath>
 #include <stdexcept>
 
-std::unordered_map<std::string, Functions::FunctionType> Functions::functions;
-bool Functions::initialized = false;
-
-void Functions::initialize() {
-    if (!initialized) {
-        // Trigonometric functions
-        functions["sin"] = [](const std::vector<double>& args) -> double {
-            if (args.size() != 1) throw std::invalid_argument("sin函数需要1个参数");
-            return std::sin(args[0]);
-        };
-        
-        functions["cos"] = [](const std::vector<double>& args) -> double {
-            if (args.size() != 1) throw std::invalid_argument("cos函数需要1个参数");
-            return std::cos(args[0]);
-        };
-        
-        functions["tan"] = [](const std::vector<double>& args) -> double {
-            if (args.size() != 1) throw std::invalid_argument("tan函数需要1个参数");
-            return std::tan(args[0]);
-        };
-        
-        // Logarithmic functions
-        functions["log"] = [](const std::vector<double>& args) -> double {
-            if (args.size() != 1) throw std::invalid_argument("log函数需要1个参数");
-            if (args[0] <= 0) throw std::invalid_argument("log函数的参数必须大于0");
-            return std::log10(args[0]);
-        };
-        
-        functions["ln"] = [](const std::vector<double>& args) -> double {
-            if (args.size() != 1) throw std::invalid_argument("ln函数需要1个参数");
-            if (args[0] <= 0) throw std::invalid_argument("ln函数的参数必须大于0");
-            return std::log(args[0]);
-        };
-        
-        // Exponential functions
-        functions["exp"] = [](const std::vector<double>& args) -> double {
-            if (args.size() != 1) throw std::invalid_argument("exp函数需要1个参数");
-            return std::exp(args[0]);
-        };
-        
-        // Power functions
-        functions["sqrt"] = [](const std::vector<double>& args) -> double {
-            if (args.size() != 1) throw std::invalid_argument("sqrt函数需要1个参数");
-            if (args[0] < 0) throw std::invalid_argument("sqrt函数的参数不能为负数");
-            return std::sqrt(args[0]);
-        };
-        
-        // Absolute value
-        functions["abs"] = [](const std::vector<double>& args) -> double {
-            if (args.size() != 1) throw std::invalid_argument("abs函数需要1个参数");
-            return std::abs(args[0]);
-        };
-        
-        initialized = true;
-    }
+namespace {
+
+// Trigonometric functions
+double funcSin(const double* args) {
+    return std::sin(args[0]);
+}
+
+double funcCos(const double* args) {
+    return std::cos(args[0]);
+}
+
+double funcTan(const double* args) {
+    return std::tan(args[0]);
+}
+
+// Logarithmic functions
+double funcLog(const double* args) {
+    return std::log10(args[0]);
+}
+
+double funcLn(const double* args) {
+    return std::log(args[0]);
+}
+
+// Exponential functions
+double funcExp(const double* args) {
+    return std::exp(args[0]);
+}
+
+// Power functions
+double funcSqrt(const double* args) {
+    return std::sqrt(args[0]);
+}
+
+// Absolute value
+double funcAbs(const double* args) {
+    return std::abs(args[0]);
+}
+
+// 从重载集中取出 double 版本的数学库函数
+Functions::DirectPtr libm(double (*function)(double)) {
+    return function;
 }
 
-const std::unordered_map<std::string, Functions::FunctionType>& Functions::getFunctions() {
-    if (!initialized) {
-        initialize();
+// Domain checks
+bool positive(const double* args) {
+    return args[0] > 0;
+}
+
+bool nonNegative(const double* args) {
+    return args[0] >= 0;
+}
+
+std::unordered_map<std::string_view, Functions::Info> buildFunctions() {
+    static const Functions::Info table[] = {
+        {"sin", funcSin, 1, nullptr, nullptr, libm(std::sin), MATH_SIN},
+        {"cos", funcCos, 1, nullptr, nullptr, libm(std::cos), MATH_COS},
+        {"tan", funcTan, 1, nullptr, nullptr, libm(std::tan), MATH_TAN},
+        {"log", funcLog, 1, positive, "log函数的参数必须大于0", libm(std::log10), MATH_LOG},
+        {"ln", funcLn, 1, positive, "ln函数的参数必须大于0", libm(std::log), MATH_LN},
+        {"exp", funcExp, 1, nullptr, nullptr, libm(std::exp), MATH_EXP},
+        {"sqrt", funcSqrt, 1, nonNegative, "sqrt函数的参数不能为负数", libm(std::sqrt), MATH_SQRT},
+        {"abs", funcAbs, 1, nullptr, nullptr, libm(std::fabs), MATH_ABS},
+    };
+
+    std::unordered_map<std::string_view, Functions::Info> functions;
+    for (const Functions::Info& info : table) {
+        functions.emplace(info.name, info);
     }
     return functions;
 }
 
+} // namespace
+
+const std::unordered_map<std::string_view, Functions::Info>& Functions::getFunctions() {
+    static const std::unordered_map<std::string_view, Info> functions = buildFunctions();
+    return functions;
+}
+
 bool Functions::isFunction(const std::string& name) {
-    if (!initialized) {
-        initialize();
+    return find(name) != nullptr;
+}
+
+const Functions::Info* Functions::find(std::string_view name) {
+    const auto& functions = getFunctions();
+    auto it = functions.find(name);
+    if (it != functions.end()) {
+        return &it->second;
     }
-    return functions.find(name) != functions.end();
+    return nullptr;
 }
 
 double Functions::evaluate(const std::string& name, const std::vector<double>& args) {
-    if (!initialized) {
-        initialize();
+    const Info* info = find(name);
+    if (info == nullptr) {
+        throw std::invalid_argument("未知函数: " + name);
     }
-    auto it = functions.find(name);
-    if (it != functions.end()) {
-        return it->second(args);
+    if (args.size() != info->arity) {
+        throw std::invalid_argument(name + "函数需要" + std::to_string(info->arity) + "个参数");
     }
-    throw std::invalid_argument("未知函数: " + name);
-}
\ No newline at end of file
+    if (!info->accepts(args.data())) {
+        throw std::invalid_argument(info->domainError);
+    }
+    return info->function(args.data());
+}
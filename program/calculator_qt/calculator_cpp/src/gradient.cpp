@@ -0,0 +1,48 @@
+#include "gradient.h"
+#include "compiler.h"
+#include "derivative.h"
+
+bool GradientCommand::split(std::string_view line, std::string_view& expression) {
+    if (line.compare(0, 5, "diff ") != 0) {
+        return false;
+    }
+    expression = line.substr(5);
+    return true;
+}
+
+Status GradientCommand::evaluate(const std::string& key, std::string_view expression,
+                                 const std::vector<std::string>& names, std::vector<double>& partials,
+                                 AstArena& arena, Optimizer& optimizer, ExpressionCache& cache,
+                                 const Spreadsheet& sheet, VirtualMachine& vm) {
+    partials.clear();
+    NodeId root = INVALID_NODE;
+    for (uint32_t slot = 0; slot < names.size(); slot++) {
+        std::string derivativeKey = key + '\n' + names[slot];
+        const Program* program = cache.find(derivativeKey);
+        if (program == nullptr) {
+            if (root == INVALID_NODE) {
+                arena.reset();
+                Expected<NodeId> parsed = Parser(expression, arena).tryParse();
+                if (!parsed.ok()) {
+                    return parsed.error();
+                }
+                root = parsed.value();
+            }
+            Expected<NodeId> derivative = Differentiator::tryDifferentiate(arena, root, slot);
+            if (!derivative.ok()) {
+                return derivative.error();
+            }
+            Expected<Program> compiled = Compiler::tryCompile(arena, optimizer.optimize(arena, derivative.value()));
+            if (!compiled.ok()) {
+                return compiled.error();
+            }
+            program = &cache.insert(derivativeKey, std::move(compiled.value()));
+        }
+        Expected<double> partial = sheet.evaluate(*program, vm);
+        if (!partial.ok()) {
+            return partial.error();
+        }
+        partials.push_back(partial.value());
+    }
+    return Status();
+}
@@ -0,0 +1,346 @@
+#include "jit.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <vector>
+
+#if defined(CALCULATOR_JIT) && defined(__x86_64__) && defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define CALCULATOR_JIT_SUPPORTED 1
+#endif
+
+namespace {
+
+// 本机代码的返回值：0 成功，1 除零，2 + i 表示 Program::functions[i] 的参数超出定义域
+enum : int {
+    JIT_OK = 0,
+    JIT_DIVISION_BY_ZERO = 1,
+    JIT_DOMAIN_ERROR = 2
+};
+
+#ifdef CALCULATOR_JIT_SUPPORTED
+
+// 最小的 x86-64 指令编码器，只覆盖本后端用到的指令形式。
+// 寄存器约定：rbx 栈槽基址，r12 常量池，r13 变量数组，r14 结果地址，xmm0 栈顶
+class Assembler {
+public:
+    std::vector<uint8_t> code;
+
+    void bytes(std::initializer_list<uint8_t> values) {
+        code.insert(code.end(), values);
+    }
+
+    void imm32(uint32_t value) {
+        for (int i = 0; i < 4; i++) {
+            code.push_back(static_cast<uint8_t>(value >> (8 * i)));
+        }
+    }
+
+    void imm64(uint64_t value) {
+        for (int i = 0; i < 8; i++) {
+            code.push_back(static_cast<uint8_t>(value >> (8 * i)));
+        }
+    }
+
+    // 以 [base + disp32] 为操作数的指令，opcode 末字节为 ModRM
+    void withDisp(std::initializer_list<uint8_t> opcode, size_t index) {
+        bytes(opcode);
+        imm32(static_cast<uint32_t>(index * sizeof(double)));
+    }
+
+    void storeTop(size_t slot) { withDisp({0xF2, 0x0F, 0x11, 0x83}, slot); }           // movsd [rbx+d], xmm0
+    void loadTop(size_t slot) { withDisp({0xF2, 0x0F, 0x10, 0x83}, slot); }            // movsd xmm0, [rbx+d]
+    void loadSecond(size_t slot) { withDisp({0xF2, 0x0F, 0x10, 0x8B}, slot); }        // movsd xmm1, [rbx+d]
+    void loadConstant(size_t index) { withDisp({0xF2, 0x41, 0x0F, 0x10, 0x84, 0x24}, index); }  // movsd xmm0, [r12+d]
+    void loadVariable(size_t slot) { withDisp({0xF2, 0x41, 0x0F, 0x10, 0x85}, slot); }  // movsd xmm0, [r13+d]
+    void leaArgs(size_t slot) { withDisp({0x48, 0x8D, 0xBB}, slot); }                  // lea rdi, [rbx+d]
+
+    void call(const void* target) {
+        bytes({0x48, 0xB8});   // mov rax, imm64
+        imm64(reinterpret_cast<uint64_t>(target));
+        bytes({0xFF, 0xD0});   // call rax
+    }
+
+    // je rel32，目标稍后回填；返回 rel32 所在位置
+    size_t jumpIfEqual() {
+        bytes({0x0F, 0x84});
+        size_t at = code.size();
+        imm32(0);
+        return at;
+    }
+
+    size_t jump() {
+        bytes({0xE9});
+        size_t at = code.size();
+        imm32(0);
+        return at;
+    }
+
+    void patch(size_t at, size_t target) {
+        uint32_t rel = static_cast<uint32_t>(target - (at + 4));
+        std::memcpy(code.data() + at, &rel, sizeof(rel));
+    }
+};
+
+template <typename Fn>
+const void* address(Fn* function) {
+    return reinterpret_cast<const void*>(function);
+}
+
+// 生成本机代码；遇到无法翻译的程序时返回 false
+bool assemble(const Program& program, Assembler& as) {
+    struct ErrorSite {
+        size_t at;
+        int code;
+    };
+    std::vector<ErrorSite> errorSites;
+
+    // 临时槽位排在值栈之后，同在本机栈帧中
+    size_t tempBase = std::max<size_t>(program.maxStack, 1);
+    size_t frame = ((tempBase + program.temps) * sizeof(double) + 15) & ~size_t(15);
+
+    // 入口处 rsp ≡ 8 (mod 16)，压入 5 个寄存器后对齐到 16，帧大小也是 16 的倍数
+    as.bytes({0x55});                      // push rbp
+    as.bytes({0x48, 0x89, 0xE5});          // mov rbp, rsp
+    as.bytes({0x53});                      // push rbx
+    as.bytes({0x41, 0x54});                // push r12
+    as.bytes({0x41, 0x55});                // push r13
+    as.bytes({0x41, 0x56});                // push r14
+    as.bytes({0x48, 0x81, 0xEC});          // sub rsp, frame
+    as.imm32(static_cast<uint32_t>(frame));
+    as.bytes({0x48, 0x89, 0xE3});          // mov rbx, rsp
+    as.bytes({0x49, 0x89, 0xFC});          // mov r12, rdi
+    as.bytes({0x49, 0x89, 0xF5});          // mov r13, rsi
+    as.bytes({0x49, 0x89, 0xD6});          // mov r14, rdx
+
+    // depth 为编译期已知的栈深度：栈顶在 xmm0，其余在 [rbx + 8*i]
+    size_t depth = 0;
+    for (const Instruction& ins : program.code) {
+        switch (ins.op) {
+            case OP_PUSH_CONST:
+            case OP_LOAD_VAR:
+                if (depth > 0) {
+                    as.storeTop(depth - 1);
+                }
+                if (ins.op == OP_PUSH_CONST) {
+                    as.loadConstant(ins.operand);
+                } else {
+                    as.loadVariable(ins.operand);
+                }
+                depth++;
+                break;
+
+            case OP_ADD:
+            case OP_MUL:
+                if (depth < 2) {
+                    return false;
+                }
+                // 加法与乘法可交换：xmm0 = xmm0 op [左操作数]
+                as.withDisp({0xF2, 0x0F, static_cast<uint8_t>(ins.op == OP_ADD ? 0x58 : 0x59), 0x83}, depth - 2);
+                depth--;
+                break;
+
+            case OP_DIV:
+                if (depth < 2) {
+                    return false;
+                }
+                // 与解释器相同：除数等于 ±0 时报错，NaN 不报错（ucomisd 对 NaN 置 PF）
+                as.bytes({0x66, 0x0F, 0x57, 0xD2});   // xorpd xmm2, xmm2
+                as.bytes({0x66, 0x0F, 0x2E, 0xC2});   // ucomisd xmm0, xmm2
+                as.bytes({0x7A, 0x06});               // jp +6（跳过下面的 je rel32）
+                errorSites.push_back({as.jumpIfEqual(), JIT_DIVISION_BY_ZERO});
+                [[fallthrough]];
+            case OP_SUB:
+                if (depth < 2) {
+                    return false;
+                }
+                as.loadSecond(depth - 2);
+                as.bytes({0xF2, 0x0F, static_cast<uint8_t>(ins.op == OP_SUB ? 0x5C : 0x5E), 0xC8});  // subsd/divsd xmm1, xmm0
+                as.bytes({0x66, 0x0F, 0x28, 0xC1});   // movapd xmm0, xmm1
+                depth--;
+                break;
+
+            case OP_POW:
+                if (depth < 2) {
+                    return false;
+                }
+                as.bytes({0x66, 0x0F, 0x28, 0xC8});   // movapd xmm1, xmm0
+                as.loadTop(depth - 2);
+                as.call(address(static_cast<double (*)(double, double)>(std::pow)));
+                depth--;
+                break;
+
+            case OP_NEG:
+                if (depth < 1) {
+                    return false;
+                }
+                as.bytes({0x48, 0xB8});               // mov rax, 符号位
+                as.imm64(0x8000000000000000ULL);
+                as.bytes({0x66, 0x48, 0x0F, 0x6E, 0xC8});   // movq xmm1, rax
+                as.bytes({0x66, 0x0F, 0x57, 0xC1});   // xorpd xmm0, xmm1
+                break;
+
+            case OP_CALL: {
+                if (depth < ins.argc || ins.operand >= program.functions.size()) {
+                    return false;
+                }
+                const Functions::Info* function = program.functions[ins.operand];
+                if (depth > 0) {
+                    as.storeTop(depth - 1);
+                }
+                size_t base = depth - ins.argc;
+                if (function->domain != nullptr) {
+                    as.leaArgs(base);
+                    as.call(address(function->domain));
+                    as.bytes({0x84, 0xC0});           // test al, al
+                    errorSites.push_back({as.jumpIfEqual(), JIT_DOMAIN_ERROR + static_cast<int>(ins.operand)});
+                }
+                if (ins.argc == 1 && function->direct != nullptr) {
+                    // 单参数函数直接调用数学库
+                    as.loadTop(base);
+                    as.call(address(function->direct));
+                } else {
+                    as.leaArgs(base);
+                    as.call(address(function->function));
+                }
+                depth = base + 1;
+                break;
+            }
+
+            case OP_STORE_TEMP:
+                if (depth < 1 || ins.operand >= program.temps) {
+                    return false;
+                }
+                as.storeTop(tempBase + ins.operand);
+                break;
+
+            case OP_LOAD_TEMP:
+                if (ins.operand >= program.temps) {
+                    return false;
+                }
+                if (depth > 0) {
+                    as.storeTop(depth - 1);
+                }
+                as.loadTop(tempBase + ins.operand);
+                depth++;
+                break;
+
+            default:
+                return false;
+        }
+    }
+    if (depth != 1) {
+        return false;
+    }
+
+    as.bytes({0xF2, 0x41, 0x0F, 0x11, 0x06});  // movsd [r14], xmm0
+    as.bytes({0x31, 0xC0});                    // xor eax, eax
+    size_t exit = as.code.size();
+    as.bytes({0x48, 0x81, 0xC4});              // add rsp, frame
+    as.imm32(static_cast<uint32_t>(frame));
+    as.bytes({0x41, 0x5E});                    // pop r14
+    as.bytes({0x41, 0x5D});                    // pop r13
+    as.bytes({0x41, 0x5C});                    // pop r12
+    as.bytes({0x5B});                          // pop rbx
+    as.bytes({0x5D});                          // pop rbp
+    as.bytes({0xC3});                          // ret
+
+    // 出错出口放在主体之后，不占用热路径
+    for (const ErrorSite& site : errorSites) {
+        as.patch(site.at, as.code.size());
+        as.bytes({0xB8});                      // mov eax, code
+        as.imm32(static_cast<uint32_t>(site.code));
+        as.patch(as.jump(), exit);
+    }
+    return true;
+}
+
+// 申请可写映射、写入代码后改为只读可执行；任何一步被拒绝都返回 nullptr
+void* mapExecutable(const std::vector<uint8_t>& code, size_t& mapped) {
+    size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    mapped = (code.size() + page - 1) / page * page;
+    void* memory = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        return nullptr;
+    }
+    std::memcpy(memory, code.data(), code.size());
+    if (mprotect(memory, mapped, PROT_READ | PROT_EXEC) != 0) {
+        munmap(memory, mapped);
+        return nullptr;
+    }
+    return memory;
+}
+
+bool probe() {
+    // 生成并执行一段只有 ret 的代码，确认系统允许 W^X 映射
+    std::vector<uint8_t> code = {0xC3};
+    size_t mapped = 0;
+    void* memory = mapExecutable(code, mapped);
+    if (memory == nullptr) {
+        return false;
+    }
+    reinterpret_cast<void (*)()>(memory)();
+    munmap(memory, mapped);
+    return true;
+}
+
+#endif // CALCULATOR_JIT_SUPPORTED
+
+} // namespace
+
+JitCode::JitCode(void* memory, size_t size)
+    : memory(memory), size(size), entry(reinterpret_cast<Entry>(memory)) {}
+
+JitCode::~JitCode() {
+#ifdef CALCULATOR_JIT_SUPPORTED
+    munmap(memory, size);
+#endif
+}
+
+bool JitCode::available() {
+#ifdef CALCULATOR_JIT_SUPPORTED
+    static const bool supported = probe();
+    return supported;
+#else
+    return false;
+#endif
+}
+
+std::unique_ptr<JitCode> JitCode::compile(const Program& program) {
+#ifdef CALCULATOR_JIT_SUPPORTED
+    if (!available()) {
+        return nullptr;
+    }
+    Assembler as;
+    if (!assemble(program, as)) {
+        return nullptr;
+    }
+    size_t mapped = 0;
+    void* memory = mapExecutable(as.code, mapped);
+    if (memory == nullptr) {
+        return nullptr;
+    }
+    return std::unique_ptr<JitCode>(new JitCode(memory, mapped));
+#else
+    (void)program;
+    return nullptr;
+#endif
+}
+
+Expected<double> JitCode::run(const Program& program, const double* variables) const {
+    if (variables == nullptr && !program.variables.empty()) {
+        return Status(ErrorCode::UNBOUND_VARIABLE, 0, program.variables[0]);
+    }
+    double result = 0.0;
+    int code = entry(program.constants.data(), variables, &result);
+    if (code == JIT_OK) {
+        return result;
+    }
+    if (code == JIT_DIVISION_BY_ZERO) {
+        return Status(ErrorCode::DIVISION_BY_ZERO);
+    }
+    return Status(ErrorCode::DOMAIN_ERROR, 0, std::string_view(), program.functions[code - JIT_DOMAIN_ERROR]);
+}
@@ -0,0 +1,123 @@
+#include "lexer.h"
+#include "number_parse.h"
+#include <cctype>
+
+namespace {
+
+bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+bool isAlpha(char c) {
+    return std::isalpha(static_cast<unsigned char>(c)) != 0;
+}
+
+bool isOperator(char c) {
+    return c == '+' || c == '-' || c == '*' || c == '/' || c == '^';
+}
+
+} // namespace
+
+Token Lexer::next() {
+    Token token = scan();
+    if (token.type == INVALID) {
+        Status(token.error, token.offset, token.text).raise();
+    }
+    return token;
+}
+
+Token Lexer::invalid(Token token, ErrorCode error) {
+    token.type = INVALID;
+    token.error = error;
+    return token;
+}
+
+Token Lexer::scan() {
+    pos = char_scanner_skip(&scanner, pos, CHAR_CLASS_BIT(CHAR_WHITESPACE));
+
+    Token token;
+    token.offset = pos;
+    if (pos >= input.size()) {
+        return token;
+    }
+
+    char ch = input[pos];
+
+    // 数字
+    if (isDigit(ch) || ch == '.') {
+        return lexNumber();
+    }
+
+    // 标识符（函数名、常量或变量）
+    if (isAlpha(ch)) {
+        return lexIdentifier();
+    }
+
+    token.text = input.substr(pos, 1);
+    pos++;
+
+    // 操作符
+    if (isOperator(ch)) {
+        token.type = OPERATOR;
+        token.op = ch;
+        return token;
+    }
+
+    // 括号
+    if (ch == '(') {
+        token.type = LPAREN;
+        return token;
+    }
+
+    if (ch == ')') {
+        token.type = RPAREN;
+        return token;
+    }
+
+    return invalid(token, ErrorCode::UNKNOWN_CHARACTER);
+}
+
+Token Lexer::lexNumber() {
+    // 共享的数字解析：与区域设置无关、不分配内存，并给出出错字符的准确位置
+    const char* start = input.data() + pos;
+    Token token;
+    token.type = NUMBER;
+    NumberResult result = parse_number(start, input.data() + input.size(), &token.value);
+    token.offset = pos;
+    token.text = input.substr(pos, result.length);
+    pos += result.length;
+
+    if (result.status == NUMBER_INVALID) {
+        token.offset += result.error_offset;
+        return invalid(token, ErrorCode::INVALID_NUMBER);
+    }
+    if (result.status == NUMBER_OUT_OF_RANGE) {
+        return invalid(token, ErrorCode::NUMBER_OUT_OF_RANGE);
+    }
+    return token;
+}
+
+Token Lexer::lexIdentifier() {
+    size_t start = pos;
+    pos = char_scanner_skip(&scanner, pos, CHAR_CLASS_BIT(CHAR_ALPHA) | CHAR_CLASS_BIT(CHAR_DIGIT));
+
+    Token token;
+    token.offset = start;
+    token.text = input.substr(start, pos - start);
+
+    // 检查是否为常量：在词法阶段解析为常量描述符
+    if ((token.constant = Constants::find(token.text)) != nullptr) {
+        token.type = CONSTANT;
+        return token;
+    }
+
+    // 检查是否为函数：在词法阶段解析为函数描述符
+    if ((token.function = Functions::find(token.text)) != nullptr) {
+        token.type = FUNCTION;
+        return token;
+    }
+
+    // 其余标识符视为变量，求值时由调用方绑定
+    token.type = VARIABLE;
+    return token;
+}
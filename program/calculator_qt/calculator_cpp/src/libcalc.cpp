@@ -0,0 +1,163 @@
+#include "libcalc.h"
+#include "parser.h"
+#include "optimizer.h"
+#include "compiler.h"
+#include "vm.h"
+#include "jit.h"
+#include "column_evaluator.h"
+#include <cmath>
+#include <cstring>
+#include <memory>
+
+// 句柄在 calc_prepare 返回后不再修改：Program 不经 VirtualMachine 的分层执行（阈值为 0），
+// 本机代码在编译时一次生成，求值所需的可变状态都在各线程自己的虚拟机与列式求值器中
+struct calc_expr {
+    Program program;
+    std::unique_ptr<JitCode> native;   // JIT 不可用时为空，解释执行
+};
+
+namespace {
+
+calc_status statusOf(ErrorKind kind) {
+    switch (kind) {
+        case ErrorKind::NONE:
+            return CALC_OK;
+        case ErrorKind::LEXICAL:
+            return CALC_LEXICAL_ERROR;
+        case ErrorKind::SYNTAX:
+            return CALC_SYNTAX_ERROR;
+        default:
+            return CALC_EVALUATION_ERROR;
+    }
+}
+
+// 写入错误信息，超长时在 UTF-8 字符边界处截断
+void report(calc_error* error, calc_status status, uint32_t offset, const char* message) {
+    if (error == nullptr) {
+        return;
+    }
+    error->status = status;
+    error->offset = offset;
+    size_t length = std::strlen(message);
+    if (length >= CALC_ERROR_MESSAGE_SIZE) {
+        length = CALC_ERROR_MESSAGE_SIZE - 1;
+        while (length > 0 && (static_cast<unsigned char>(message[length]) & 0xC0) == 0x80) {
+            length--;
+        }
+    }
+    std::memcpy(error->message, message, length);
+    error->message[length] = '\0';
+}
+
+void report(calc_error* error, const Status& status) {
+    report(error, statusOf(status.kind()), status.offset, status.message().c_str());
+}
+
+void succeed(calc_error* error) {
+    if (error != nullptr) {
+        error->status = CALC_OK;
+        error->offset = 0;
+        error->message[0] = '\0';
+    }
+}
+
+// 异常不能越过 C 接口：把 CalcError 与内存不足等异常转成错误类别
+calc_status reportException(calc_error* error, const std::exception& e) {
+    calc_status status = CALC_EVALUATION_ERROR;
+    if (dynamic_cast<const LexicalError*>(&e) != nullptr) {
+        status = CALC_LEXICAL_ERROR;
+    } else if (dynamic_cast<const SyntaxError*>(&e) != nullptr) {
+        status = CALC_SYNTAX_ERROR;
+    }
+    report(error, status, 0, e.what());
+    return status;
+}
+
+} // namespace
+
+calc_expr* calc_prepare(const char* text, calc_error* error) {
+    if (text == nullptr) {
+        report(error, CALC_INVALID_ARGUMENT, 0, "表达式为空");
+        return nullptr;
+    }
+    try {
+        AstArena arena;
+        Expected<NodeId> parsed = Parser(text, arena).tryParse();
+        if (!parsed.ok()) {
+            report(error, parsed.error());
+            return nullptr;
+        }
+        NodeId root = Optimizer().optimize(arena, parsed.value());
+        Expected<Program> compiled = Compiler::tryCompile(arena, root);
+        if (!compiled.ok()) {
+            report(error, compiled.error());
+            return nullptr;
+        }
+        std::unique_ptr<calc_expr> expr(new calc_expr{std::move(compiled.value()), nullptr});
+        expr->native = JitCode::compile(expr->program);
+        succeed(error);
+        return expr.release();
+    } catch (const std::exception& e) {
+        reportException(error, e);
+        return nullptr;
+    }
+}
+
+void calc_release(calc_expr* expr) {
+    delete expr;
+}
+
+size_t calc_variable_count(const calc_expr* expr) {
+    return expr != nullptr ? expr->program.variables.size() : 0;
+}
+
+const char* calc_variable_name(const calc_expr* expr, size_t slot) {
+    if (expr == nullptr || slot >= expr->program.variables.size()) {
+        return nullptr;
+    }
+    return expr->program.variables[slot].c_str();
+}
+
+int calc_variable_slot(const calc_expr* expr, const char* name) {
+    if (expr == nullptr || name == nullptr) {
+        return -1;
+    }
+    const std::vector<std::string>& variables = expr->program.variables;
+    for (size_t slot = 0; slot < variables.size(); slot++) {
+        if (variables[slot] == name) {
+            return static_cast<int>(slot);
+        }
+    }
+    return -1;
+}
+
+double calc_eval(const calc_expr* expr, const double* vars, calc_error* error) {
+    if (expr == nullptr) {
+        report(error, CALC_INVALID_ARGUMENT, 0, "句柄为空");
+        return NAN;
+    }
+    thread_local VirtualMachine vm;
+    Expected<double> result = expr->native ? expr->native->run(expr->program, vars) : vm.tryExecute(expr->program, vars);
+    if (!result.ok()) {
+        report(error, result.error());
+        return NAN;
+    }
+    succeed(error);
+    return result.value();
+}
+
+calc_status calc_eval_batch(const calc_expr* expr, const double* const* columns, size_t n, double* out,
+                            calc_error* error) {
+    if (expr == nullptr || (out == nullptr && n != 0)) {
+        report(error, CALC_INVALID_ARGUMENT, 0, expr == nullptr ? "句柄为空" : "输出缓冲为空");
+        return CALC_INVALID_ARGUMENT;
+    }
+    try {
+        thread_local ColumnEvaluator evaluator;
+        evaluator.evaluate(expr->program, columns, n, out);
+    } catch (const std::exception& e) {
+        return reportException(error, e);
+    }
+    succeed(error);
+    return CALC_OK;
+}
@@ -0,0 +1,56 @@
+#include "line_evaluator.h"
+#include "compiler.h"
+#include "ui.h"
+#include <cctype>
+#include <exception>
+#include <string>
+
+void LineEvaluator::evaluate(std::string_view line, std::ostream& out, size_t& errors) {
+    // 与两个版本的管道模式一致：忽略首尾空白（含行尾的 '\r'），只含空白的行与空行相同
+    while (!line.empty() && std::isspace(static_cast<unsigned char>(line.back()))) {
+        line.remove_suffix(1);
+    }
+    while (!line.empty() && std::isspace(static_cast<unsigned char>(line.front()))) {
+        line.remove_prefix(1);
+    }
+    if (line.empty()) {
+        return;
+    }
+    // 无效行按错误码处理，不经过异常展开；这里只兜住内存不足之类的意外异常
+    try {
+        double result = 0.0;
+        Status status = evaluateLine(line, result);
+        if (status.ok()) {
+            UI::writeResult(out, result);
+        } else {
+            UI::writeError(out, status.message());
+            errors++;
+        }
+    } catch (const std::exception& e) {
+        UI::writeError(out, "未知错误: " + std::string(e.what()));
+        errors++;
+    }
+}
+
+Status LineEvaluator::evaluateLine(std::string_view line, double& value) {
+    ExpressionCache::normalize(line, key);
+    const Program* program = cache.find(key);
+    if (program == nullptr) {
+        arena.reset();
+        Expected<NodeId> root = Parser(line, arena).tryParse();
+        if (!root.ok()) {
+            return root.error();
+        }
+        Expected<Program> compiled = Compiler::tryCompile(arena, optimizer.optimize(arena, root.value()));
+        if (!compiled.ok()) {
+            return compiled.error();
+        }
+        program = &cache.insert(key, std::move(compiled.value()));
+    }
+    Expected<double> executed = vm.tryExecute(*program);
+    if (!executed.ok()) {
+        return executed.error();
+    }
+    value = executed.value();
+    return Status();
+}
@@ -1,15 +1,178 @@
 #include "ui.h"
 #include "parser.h"
-#include "calculator.h"
+#include "optimizer.h"
+#include "compiler.h"
+#include "gradient.h"
+#include "vm.h"
+#include "expression_cache.h"
+#include "batch.h"
+#include "sweep.h"
+#include "spreadsheet.h"
+#include "server.h"
+#include "pipe_mode.h"
 #include "error.h"
+#include <csignal>
+#include <cstdlib>
 #include <iostream>
 #include <string>
+#include <string_view>
+#include <vector>
+#include <unistd.h>
+
+namespace {
+
+Server* activeServer = nullptr;
+
+void stopServer(int) {
+    if (activeServer != nullptr) {
+        activeServer->stop();
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t cacheCapacity = ExpressionCache::DEFAULT_CAPACITY;
+    std::string batchFile;
+    BatchOptions batchOptions;
+    std::string sweepSpec;
+    std::string sweepExpression;
+    std::string serveAddress;
+    MathAccuracy mathAccuracy = MATH_LIBM;
+    uint32_t jitThreshold = VirtualMachine::DEFAULT_JIT_THRESHOLD;
+    bool interactive = isatty(STDIN_FILENO);
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--cache-size" && i + 1 < argc) {
+            cacheCapacity = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--batch" && i + 1 < argc) {
+            batchFile = argv[++i];
+        } else if (arg == "--jobs" && i + 1 < argc) {
+            batchOptions.jobs = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--jit-threshold" && i + 1 < argc) {
+            jitThreshold = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--serve" && i + 1 < argc) {
+            serveAddress = argv[++i];
+        } else if (arg == "--math" && i + 1 < argc && parseMathAccuracy(argv[i + 1], mathAccuracy)) {
+            i++;
+        } else if (arg == "--interactive") {
+            interactive = true;
+        } else if (arg == "--sweep" && i + 2 < argc) {
+            sweepSpec = argv[++i];
+            sweepExpression = argv[++i];
+        } else {
+            std::cerr << "未知参数: " << arg << "\n";
+            std::cerr << "用法: " << argv[0] << " [--cache-size N] [--jit-threshold N] [--interactive]"
+                      << " [--batch <file> [--jobs N]]"
+                      << " [--sweep <变量=起点:终点:步长> <表达式> [--math libm|ulp1|ulp4]]"
+                      << " [--serve <unix:路径|tcp:端口> [--jobs N]]\n";
+            return 1;
+        }
+    }
+
+    // 扫描模式：在区间上列式求值表达式，输出汇总与吞吐量
+    if (!sweepSpec.empty()) {
+        try {
+            SweepSpec spec = SweepSpec::parse(sweepSpec);
+            AstArena arena;
+            Parser parser(sweepExpression, arena);
+            NodeId root = Optimizer().optimize(arena, parser.parse());
+            Program program = Compiler::compile(arena, root);
+            ColumnEvaluator evaluator(detectSimdLevel(), mathAccuracy);
+            SweepStats stats = runSweep(program, spec, evaluator);
+            std::cout << "扫描: " << spec.variable << " 从 " << spec.start << " 到 " << spec.stop
+                      << " 步长 " << spec.step << ", 共 " << stats.points << " 个点\n";
+            std::cout << "指令集: " << simdLevelName(evaluator.level()) << "  数学函数: "
+                      << mathAccuracyName(evaluator.accuracy()) << "\n";
+            std::cout << "最小值: " << stats.min << "  最大值: " << stats.max
+                      << "  平均值: " << stats.sum / stats.points << "\n";
+            std::cout << "用时: " << stats.seconds << " 秒, " << static_cast<size_t>(stats.pointsPerSecond())
+                      << " 点/秒\n";
+        } catch (const CalcError& e) {
+            std::cerr << "错误: " << e.what() << "\n";
+            return 1;
+        } catch (const std::exception& e) {
+            std::cerr << "错误: 未知错误: " << e.what() << "\n";
+            return 1;
+        }
+        return 0;
+    }
+
+    // 服务模式：按行协议处理本地客户端的请求，收到 SIGINT/SIGTERM 后停止并输出统计
+    if (!serveAddress.empty()) {
+        try {
+            ServerOptions serverOptions;
+            serverOptions.address = ServerAddress::parse(serveAddress);
+            serverOptions.workers = batchOptions.jobs;
+            serverOptions.jitThreshold = jitThreshold;
+            Server server(serverOptions);
+            server.listen();
+            if (serverOptions.address.isUnix()) {
+                std::cerr << "正在监听 unix:" << serverOptions.address.unixPath << "\n";
+            } else {
+                std::cerr << "正在监听 tcp:127.0.0.1:" << server.port() << "\n";
+            }
+            activeServer = &server;
+            std::signal(SIGINT, stopServer);
+            std::signal(SIGTERM, stopServer);
+            server.run();
+            activeServer = nullptr;
+            const ServerStats& stats = server.stats();
+            std::cerr << "服务统计: " << stats.connections << " 个连接, " << stats.requests << " 个请求, "
+                      << stats.errors << " 个错误\n";
+            std::cerr << "延迟: " << stats.latency.summary() << "\n";
+        } catch (const CalcError& e) {
+            std::cerr << "错误: " << e.what() << "\n";
+            return 1;
+        }
+        return 0;
+    }
+
+    // 批量模式：不显示提示符，按输入顺序输出每一行的结果，吞吐量输出到标准错误
+    if (!batchFile.empty()) {
+        try {
+            batchOptions.jitThreshold = jitThreshold;
+            BatchStats stats = BatchEvaluator(batchOptions).runFile(batchFile, std::cout);
+            std::cerr << "批量求值: " << stats.lines << " 行, " << stats.errors << " 个错误, "
+                      << stats.seconds << " 秒, " << static_cast<size_t>(stats.linesPerSecond()) << " 行/秒\n";
+        } catch (const CalcError& e) {
+            std::cerr << "错误: " << e.what() << "\n";
+            return 1;
+        }
+        return 0;
+    }
+
+    SheetOptions sheetOptions;
+    sheetOptions.jobs = batchOptions.jobs;
+
+    // 管道模式：标准输入不是终端时按块读写，不显示欢迎信息与提示符，吞吐量输出到标准错误
+    if (!interactive) {
+        bool ok = true;
+        PipeStats stats = PipeSession(cacheCapacity, jitThreshold, sheetOptions).run(STDIN_FILENO, STDOUT_FILENO, ok);
+        std::cerr << "管道模式: " << stats.lines << " 行, " << stats.errors << " 个错误, " << stats.bytesIn / 1e6
+                  << " MB, " << stats.seconds << " 秒, " << stats.megabytesPerSecond() << " MB/s\n";
+        return ok ? 0 : 1;
+    }
 
-int main() {
     UI::showWelcome();
     
+    // 节点池在各行之间复用，稳态下解析不再分配内存；
+    // 编译后的字节码按规范化输入缓存，重复的表达式直接执行
+    AstArena arena;
+    Optimizer optimizer;
+    VirtualMachine vm(jitThreshold);
+    ExpressionCache cache(cacheCapacity);
+    Spreadsheet sheet(sheetOptions);
+    std::string input;
+    std::vector<std::string> names;
+    std::vector<double> partials;
+    
     while (true) {
-        std::string input = UI::getUserInput();
+        // 输入结束（Ctrl-D）时与 quit 一样退出
+        if (!UI::getUserInput(input)) {
+            std::cout << "\n";
+            break;
+        }
         
         // 检查退出命令
         if (input == "quit" || input == "exit") {
@@ -23,28 +186,91 @@ int main() {
             continue;
         }
         
+        // 检查缓存与优化统计命令
+        if (input == "stats") {
+            UI::showCacheStats(cache.stats());
+            UI::showOptimizerStats(optimizer.stats());
+            continue;
+        }
+        
         // 跳过空输入
         if (input.empty()) {
             continue;
         }
         
+        // 错误沿错误码返回，不经过异常展开；这里只兜住内存不足之类的意外异常
         try {
-            // 解析表达式
-            Parser parser(input);
-            std::shared_ptr<ASTNode> ast = parser.parse();
+            // 赋值：定义或重新定义变量，只重算依赖它的变量
+            std::string_view name;
+            std::string_view expression;
+            if (Spreadsheet::splitAssignment(input, name, expression)) {
+                Status status = sheet.assign(name, expression);
+                if (!status.ok()) {
+                    UI::showError(status.message());
+                    continue;
+                }
+                RecalcStats recalc = sheet.recalculate();
+                Expected<double> value = sheet.value(name);
+                if (!value.ok()) {
+                    UI::showError(value.error().message());
+                    continue;
+                }
+                UI::showAssignment(name, value.value(), recalc);
+                continue;
+            }
+
+            // 求导："diff 表达式" 输出表达式的值与对各变量的偏导数
+            bool gradient = GradientCommand::split(input, expression);
+            if (!gradient) {
+                expression = input;
+            }
+
+            std::string key = ExpressionCache::normalize(expression);
+            const Program* program = cache.find(key);
+            if (program == nullptr) {
+                // 解析表达式
+                arena.reset();
+                Expected<NodeId> root = Parser(expression, arena).tryParse();
+                if (!root.ok()) {
+                    UI::showError(root.error().message());
+                    continue;
+                }
+                
+                // 折叠常量子树并编译为字节码
+                Expected<Program> compiled = Compiler::tryCompile(arena, optimizer.optimize(arena, root.value()));
+                if (!compiled.ok()) {
+                    UI::showError(compiled.error().message());
+                    continue;
+                }
+                program = &cache.insert(key, std::move(compiled.value()));
+            }
             
-            // 计算结果
-            Calculator calc;
-            double result = calc.evaluate(ast);
+            // 计算结果，变量取已赋值的值
+            Expected<double> result = sheet.evaluate(*program, vm);
+            if (!result.ok()) {
+                UI::showError(result.error().message());
+                continue;
+            }
             
+            if (gradient) {
+                // 插入导数程序可能淘汰 program，先复制变量名
+                names = program->variables;
+                Status status =
+                    GradientCommand::evaluate(key, expression, names, partials, arena, optimizer, cache, sheet, vm);
+                if (!status.ok()) {
+                    UI::showError(status.message());
+                    continue;
+                }
+                UI::showGradient(result.value(), names, partials);
+                continue;
+            }
+
             // 显示结果
-            UI::showResult(result);
-        } catch (const CalcError& e) {
-            UI::showError(e.what());
+            UI::showResult(result.value());
         } catch (const std::exception& e) {
             UI::showError("未知错误: " + std::string(e.what()));
         }
     }
     
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,161 @@
+#include "optimizer.h"
+#include <cmath>
+
+namespace {
+
+bool isNumber(const AstArena& arena, NodeId id, double* value = nullptr) {
+    const ASTNode& node = arena.node(id);
+    if (node.type != NUM_NODE) {
+        return false;
+    }
+    if (value != nullptr) {
+        *value = node.data.value;
+    }
+    return true;
+}
+
+// 数值相等且符号位一致（区分 +0 与 -0）
+bool isExactly(const AstArena& arena, NodeId id, double expected) {
+    double value;
+    return isNumber(arena, id, &value) && value == expected && std::signbit(value) == std::signbit(expected);
+}
+
+void replaceWithNumber(AstArena& arena, NodeId id, double value) {
+    ASTNode& node = arena.node(id);
+    node.type = NUM_NODE;
+    node.op = 0;
+    node.height = 1;
+    node.data.value = value;
+}
+
+} // namespace
+
+NodeId Optimizer::optimize(AstArena& arena, NodeId root) {
+    lastStats.nodesBefore = arena.treeSize(root);
+    NodeId result = fold(arena, root);
+    lastStats.nodesAfter = arena.treeSize(result);
+    result = dag.build(arena, result);
+    lastStats.dagNodes = dag.stats().dagNodes;
+    return result;
+}
+
+NodeId Optimizer::fold(AstArena& arena, NodeId id) {
+    if (id == INVALID_NODE || id >= arena.size()) {
+        return id;
+    }
+
+    switch (arena.node(id).type) {
+        case NUM_NODE:
+            return id;
+
+        case CONSTANT_NODE:
+            replaceWithNumber(arena, id, arena.node(id).data.constant.info->value);
+            return id;
+
+        case UNARY_OP_NODE: {
+            NodeId operand = fold(arena, arena.node(id).data.unary.operand);
+            arena.node(id).data.unary.operand = operand;
+            char op = arena.node(id).op;
+            if (op == '+') {
+                return operand;
+            }
+            if (op != '-') {
+                return id;
+            }
+            double value;
+            if (isNumber(arena, operand, &value)) {
+                replaceWithNumber(arena, id, -value);
+                return id;
+            }
+            // 双重取负：-(-x) == x
+            const ASTNode& inner = arena.node(operand);
+            if (inner.type == UNARY_OP_NODE && inner.op == '-') {
+                return inner.data.unary.operand;
+            }
+            return id;
+        }
+
+        case BIN_OP_NODE:
+            return foldBinary(arena, id);
+
+        case FUNC_CALL_NODE:
+            return foldCall(arena, id);
+
+        default:
+            return id;
+    }
+}
+
+NodeId Optimizer::foldBinary(AstArena& arena, NodeId id) {
+    NodeId left = fold(arena, arena.node(id).data.binary.left);
+    NodeId right = fold(arena, arena.node(id).data.binary.right);
+    arena.node(id).data.binary.left = left;
+    arena.node(id).data.binary.right = right;
+    char op = arena.node(id).op;
+
+    double l, r;
+    if (isNumber(arena, left, &l) && isNumber(arena, right, &r)) {
+        switch (op) {
+            case '+': replaceWithNumber(arena, id, l + r); return id;
+            case '-': replaceWithNumber(arena, id, l - r); return id;
+            case '*': replaceWithNumber(arena, id, l * r); return id;
+            case '/':
+                // 除零留给求值阶段报错
+                if (r != 0) {
+                    replaceWithNumber(arena, id, l / r);
+                }
+                return id;
+            case '^': replaceWithNumber(arena, id, std::pow(l, r)); return id;
+            default: return id;
+        }
+    }
+
+    // 代数恒等式，仅保留对所有 IEEE 值（含 NaN、无穷与 -0）都精确成立的形式。
+    // 注意 x + 0 对 x == -0 会得到 +0，因此只化简 x + (-0) 与 x - 0。
+    switch (op) {
+        case '*':
+            if (isExactly(arena, right, 1.0)) return left;
+            if (isExactly(arena, left, 1.0)) return right;
+            break;
+        case '/':
+            if (isExactly(arena, right, 1.0)) return left;
+            break;
+        case '+':
+            if (isExactly(arena, right, -0.0)) return left;
+            if (isExactly(arena, left, -0.0)) return right;
+            break;
+        case '-':
+            if (isExactly(arena, right, 0.0)) return left;
+            break;
+        case '^':
+            if (isExactly(arena, right, 1.0)) return left;
+            break;
+        default:
+            break;
+    }
+    return id;
+}
+
+NodeId Optimizer::foldCall(AstArena& arena, NodeId id) {
+    uint32_t argCount = arena.node(id).data.call.argCount;
+    bool allConstant = true;
+    for (uint32_t i = 0; i < argCount; i++) {
+        NodeId arg = fold(arena, arena.args(arena.node(id))[i]);
+        arena.setArg(arena.node(id), i, arg);
+        allConstant = allConstant && isNumber(arena, arg);
+    }
+    if (!allConstant) {
+        return id;
+    }
+
+    double args[Functions::MAX_ARITY];
+    for (uint32_t i = 0; i < argCount; i++) {
+        args[i] = arena.node(arena.args(arena.node(id))[i]).data.value;
+    }
+    // 注册表中的函数都是纯函数；定义域错误时保留调用，由求值阶段报告
+    const Functions::Info* function = arena.node(id).data.call.function;
+    if (function->accepts(args)) {
+        replaceWithNumber(arena, id, function->function(args));
+    }
+    return id;
+}
@@ -1,99 +1,197 @@
 #include "parser.h"
-#include "constants.h"
-#include "functions.h"
-#include <cctype>
+#include <algorithm>
 #include <stdexcept>
-#include <iostream>
 
-Parser::Parser(const std::string& expr) : expression(expr), pos(0), currentToken(END) {
-    consumeToken();
+namespace {
+
+uint16_t above(uint16_t height) {
+    return height < UINT16_MAX ? static_cast<uint16_t>(height + 1) : height;
 }
 
-std::shared_ptr<ASTNode> Parser::parse() {
-    auto result = parseExpression();
-    if (currentToken.type != END) {
-        throw SyntaxError("表达式解析完成后仍有未处理的字符");
-    }
-    return result;
+} // namespace
+
+NodeId AstArena::push(const ASTNode& node) {
+    nodes.push_back(node);
+    return static_cast<NodeId>(nodes.size() - 1);
 }
 
-void Parser::skipWhitespace() {
-    while (pos < expression.length() && std::isspace(expression[pos])) {
-        pos++;
+uint32_t AstArena::internName(std::string_view name) {
+    uint32_t offset = static_cast<uint32_t>(names.size());
+    names.append(name.data(), name.size());
+    return offset;
+}
+
+NodeId AstArena::addNumber(double value) {
+    ASTNode node{};
+    node.type = NUM_NODE;
+    node.height = 1;
+    node.data.value = value;
+    return push(node);
+}
+
+NodeId AstArena::addBinary(char op, NodeId left, NodeId right) {
+    ASTNode node{};
+    node.type = BIN_OP_NODE;
+    node.op = op;
+    node.height = above(std::max(height(left), height(right)));
+    node.data.binary.left = left;
+    node.data.binary.right = right;
+    return push(node);
+}
+
+NodeId AstArena::addUnary(char op, NodeId operand) {
+    ASTNode node{};
+    node.type = UNARY_OP_NODE;
+    node.op = op;
+    node.height = above(height(operand));
+    node.data.unary.operand = operand;
+    return push(node);
+}
+
+NodeId AstArena::addConstant(const Constants::Info* constant) {
+    ASTNode node{};
+    node.type = CONSTANT_NODE;
+    node.height = 1;
+    node.data.constant.info = constant;
+    return push(node);
+}
+
+NodeId AstArena::addVariable(std::string_view name) {
+    uint32_t slot = 0;
+    while (slot < variables.size() && variableName(slot) != name) {
+        slot++;
+    }
+    if (slot == variables.size()) {
+        variables.emplace_back(internName(name), static_cast<uint32_t>(name.size()));
     }
+
+    ASTNode node{};
+    node.type = VARIABLE_NODE;
+    node.height = 1;
+    node.data.variable.slot = slot;
+    return push(node);
 }
 
-Token Parser::getNextToken() {
-    skipWhitespace();
-    
-    if (pos >= expression.length()) {
-        return Token(END);
+std::string_view AstArena::variableName(size_t slot) const {
+    return std::string_view(names.data() + variables[slot].first, variables[slot].second);
+}
+
+NodeId AstArena::addCall(const Functions::Info* function, size_t mark) {
+    ASTNode node{};
+    node.type = FUNC_CALL_NODE;
+    node.height = 1;
+    for (size_t i = mark; i < pendingArgs.size(); i++) {
+        node.height = std::max(node.height, above(height(pendingArgs[i])));
     }
-    
-    char ch = expression[pos];
-    
-    // 数字
-    if (std::isdigit(ch) || ch == '.') {
-        size_t start = pos;
-        while (pos < expression.length() && (std::isdigit(expression[pos]) || expression[pos] == '.')) {
-            pos++;
-        }
-        std::string numStr = expression.substr(start, pos - start);
-        try {
-            double value = std::stod(numStr);
-            return Token(NUMBER, value);
-        } catch (const std::exception&) {
-            throw LexicalError("无效的数字格式: " + numStr);
-        }
+    node.data.call.function = function;
+    node.data.call.firstArg = static_cast<uint32_t>(argIds.size());
+    node.data.call.argCount = static_cast<uint32_t>(pendingArgs.size() - mark);
+    argIds.insert(argIds.end(), pendingArgs.begin() + mark, pendingArgs.end());
+    pendingArgs.resize(mark);
+    return push(node);
+}
+
+std::string_view AstArena::name(const ASTNode& node) const {
+    switch (node.type) {
+        case FUNC_CALL_NODE:
+            return node.data.call.function->name;
+        case CONSTANT_NODE:
+            return node.data.constant.info->name;
+        case VARIABLE_NODE:
+            return variableName(node.data.variable.slot);
+        default:
+            return std::string_view();
     }
-    
-    // 标识符（函数名或常量）
-    if (std::isalpha(ch)) {
-        size_t start = pos;
-        while (pos < expression.length() && std::isalnum(expression[pos])) {
-            pos++;
-        }
-        std::string name = expression.substr(start, pos - start);
-        
-        // 检查是否为常量
-        if (Constants::isConstant(name)) {
-            return Token(CONSTANT, 0.0, name);
+}
+
+size_t AstArena::treeSize(NodeId root) const {
+    // 显式栈代替递归，与树高无关
+    size_t count = 0;
+    std::vector<NodeId> pending{root};
+    while (!pending.empty()) {
+        NodeId id = pending.back();
+        pending.pop_back();
+        if (id == INVALID_NODE || id >= nodes.size()) {
+            continue;
         }
-        
-        // 检查是否为函数
-        if (Functions::isFunction(name)) {
-            return Token(FUNCTION, 0.0, name);
+        count++;
+        const ASTNode& n = nodes[id];
+        switch (n.type) {
+            case BIN_OP_NODE:
+                pending.push_back(n.data.binary.left);
+                pending.push_back(n.data.binary.right);
+                break;
+            case UNARY_OP_NODE:
+                pending.push_back(n.data.unary.operand);
+                break;
+            case FUNC_CALL_NODE:
+                pending.insert(pending.end(), args(n), args(n) + n.data.call.argCount);
+                break;
+            default:
+                break;
         }
-        
-        throw LexicalError("未知的标识符: " + name);
     }
-    
-    // 操作符
-    if (isOperator(ch)) {
-        pos++;
-        return Token(OPERATOR, 0.0, "", ch);
+    return count;
+}
+
+void AstArena::reset() {
+    nodes.clear();
+    argIds.clear();
+    pendingArgs.clear();
+    names.clear();
+    variables.clear();
+}
+
+Parser::Parser(std::string_view expr, AstArena& arena)
+    : lexer(expr), arena(arena) {
+}
+
+NodeId Parser::parse() {
+    return tryParse().valueOrThrow();
+}
+
+Expected<NodeId> Parser::tryParse() {
+    NodeId result = parseExpression();
+    if (status.ok() && peek().type != END) {
+        fail(ErrorCode::TRAILING_INPUT, peek());
     }
-    
-    // 括号
-    if (ch == '(') {
-        pos++;
-        return Token(LPAREN);
+    if (!status.ok()) {
+        return status;
     }
-    
-    if (ch == ')') {
-        pos++;
-        return Token(RPAREN);
+    return result;
+}
+
+const Token& Parser::peek(size_t offset) {
+    while (buffered <= offset) {
+        Token& token = lookahead[(head + buffered) % LOOKAHEAD];
+        token = lexer.scan();
+        if (token.type == INVALID) {
+            fail(token.error, token);
+        }
+        buffered++;
     }
-    
-    throw LexicalError("未知字符: " + std::string(1, ch));
+    return lookahead[(head + offset) % LOOKAHEAD];
 }
 
 void Parser::consumeToken() {
-    currentToken = getNextToken();
+    peek();
+    head = (head + 1) % LOOKAHEAD;
+    buffered--;
 }
 
-bool Parser::isOperator(char c) {
-    return c == '+' || c == '-' || c == '*' || c == '/' || c == '^';
+NodeId Parser::fail(ErrorCode code, const Token& token, const Functions::Info* function) {
+    // 只保留第一个错误，后续错误都是它的连带结果
+    if (status.ok()) {
+        status = Status(code, token.offset, token.text, function);
+    }
+    return INVALID_NODE;
+}
+
+NodeId Parser::limitHeight(NodeId id, const Token& token) {
+    if (status.ok() && arena.height(id) > MAX_HEIGHT) {
+        return fail(ErrorCode::TOO_DEEP, token);
+    }
+    return id;
 }
 
 int Parser::getOperatorPrecedence(char op) {
@@ -111,89 +209,101 @@ int Parser::getOperatorPrecedence(char op) {
     }
 }
 
-std::shared_ptr<ASTNode> Parser::parseExpression() {
+NodeId Parser::parseExpression() {
     auto left = parseTerm();
     
-    while (currentToken.type == OPERATOR && 
-           (currentToken.op == '+' || currentToken.op == '-')) {
-        char op = currentToken.op;
+    while (status.ok() && peek().type == OPERATOR && 
+           (peek().op == '+' || peek().op == '-')) {
+        Token token = peek();
         consumeToken(); // 消费操作符
         auto right = parseTerm();
-        auto node = std::make_shared<ASTNode>(BIN_OP_NODE);
-        node->op = op;
-        node->left = left;
-        node->right = right;
-        left = node;
+        left = limitHeight(arena.addBinary(token.op, left, right), token);
     }
     
     return left;
 }
 
-std::shared_ptr<ASTNode> Parser::parseTerm() {
+NodeId Parser::parseTerm() {
     auto left = parseFactor();
     
-    while (currentToken.type == OPERATOR && 
-           (currentToken.op == '*' || currentToken.op == '/' || currentToken.op == '^')) {
-        char op = currentToken.op;
+    while (status.ok() && peek().type == OPERATOR && 
+           (peek().op == '*' || peek().op == '/' || peek().op == '^')) {
+        Token token = peek();
         consumeToken(); // 消费操作符
         auto right = parseFactor();
-        auto node = std::make_shared<ASTNode>(BIN_OP_NODE);
-        node->op = op;
-        node->left = left;
-        node->right = right;
-        left = node;
+        left = limitHeight(arena.addBinary(token.op, left, right), token);
     }
     
     return left;
 }
 
-std::shared_ptr<ASTNode> Parser::parseFactor() {
-    Token token = currentToken;
+NodeId Parser::parseFactor() {
+    // 括号、一元操作符与函数调用都经这里递归，层数受限，过深的输入报错而不是耗尽调用栈
+    if (nesting >= MAX_NESTING) {
+        return fail(ErrorCode::TOO_DEEP, peek());
+    }
+    nesting++;
+    NodeId result = parsePrimary();
+    nesting--;
+    return result;
+}
+
+NodeId Parser::parsePrimary() {
+    Token token = peek();
     
     // 处理数字
     if (token.type == NUMBER) {
         consumeToken();
-        auto node = std::make_shared<ASTNode>(NUM_NODE);
-        node->value = token.value;
-        return node;
+        return arena.addNumber(token.value);
     }
     
     // 处理常量
     if (token.type == CONSTANT) {
         consumeToken();
-        auto node = std::make_shared<ASTNode>(CONSTANT_NODE);
-        node->name = token.name;
-        return node;
+        return arena.addConstant(token.constant);
+    }
+    
+    // 处理变量
+    if (token.type == VARIABLE) {
+        // 变量名后紧跟左括号多半是拼错的函数名，报告未知函数，而不是把括号当作多余的输入
+        if (peek(1).type == LPAREN) {
+            return fail(ErrorCode::UNKNOWN_FUNCTION, token);
+        }
+        consumeToken();
+        return arena.addVariable(token.text);
     }
     
     // 处理函数调用
     if (token.type == FUNCTION) {
-        std::string funcName = token.name;
+        const Functions::Info* function = token.function;
         consumeToken(); // 消费函数名
         
-        if (currentToken.type != LPAREN) {
-            throw SyntaxError("函数调用需要左括号");
+        if (peek().type != LPAREN) {
+            return fail(ErrorCode::EXPECTED_LPAREN, peek());
         }
         consumeToken(); // 消费左括号
         
-        auto node = std::make_shared<ASTNode>(FUNC_CALL_NODE);
-        node->name = funcName;
-        
         // 解析参数列表
-        if (currentToken.type != RPAREN) {
-            node->args.push_back(parseExpression());
-            while (currentToken.type == OPERATOR && currentToken.op == ',') {
+        size_t mark = arena.argMark();
+        if (peek().type != RPAREN) {
+            arena.pushArg(parseExpression());
+            while (status.ok() && peek().type == OPERATOR && peek().op == ',') {
                 consumeToken(); // 消费逗号
-                node->args.push_back(parseExpression());
+                arena.pushArg(parseExpression());
             }
         }
         
-        if (currentToken.type != RPAREN) {
-            throw SyntaxError("缺少右括号");
+        if (peek().type != RPAREN) {
+            return fail(ErrorCode::MISSING_RPAREN, peek());
         }
         consumeToken(); // 消费右括号
         
-        return node;
+        // 参数个数在解析阶段检查
+        if (arena.argMark() - mark != function->arity) {
+            return fail(ErrorCode::ARITY_MISMATCH, token, function);
+        }
+        
+        return limitHeight(arena.addCall(function, mark), token);
     }
     
     // 处理一元操作符
@@ -201,22 +311,19 @@ std::shared_ptr<ASTNode> Parser::parseFactor() {
         char op = token.op;
         consumeToken(); // 消费操作符
         auto operand = parseFactor();
-        auto node = std::make_shared<ASTNode>(UNARY_OP_NODE);
-        node->op = op;
-        node->operand = operand;
-        return node;
+        return limitHeight(arena.addUnary(op, operand), token);
     }
     
     // 处理括号表达式
     if (token.type == LPAREN) {
         consumeToken(); // 消费左括号
         auto expr = parseExpression();
-        if (currentToken.type != RPAREN) {
-            throw SyntaxError("缺少右括号");
+        if (peek().type != RPAREN) {
+            return fail(ErrorCode::MISSING_RPAREN, peek());
         }
         consumeToken(); // 消费右括号
         return expr;
     }
     
-    throw SyntaxError("意外的标记");
-}
\ No newline at end of file
+    return fail(ErrorCode::UNEXPECTED_TOKEN, token);
+}
@@ -0,0 +1,254 @@
+#include "pipe_mode.h"
+#include "compiler.h"
+#include "gradient.h"
+#include "ui.h"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <sstream>
+#include <unistd.h>
+
+LineReader::LineReader(int fd, size_t blockSize) : buffer(std::max<size_t>(blockSize, 64)), fd(fd) {}
+
+bool LineReader::next(std::string_view& line) {
+    scanned = std::max(scanned, start);
+    const char* data = buffer.data();
+    const void* newline = std::memchr(data + scanned, '\n', end - scanned);
+    size_t length;
+    if (newline != nullptr) {
+        length = static_cast<size_t>(static_cast<const char*>(newline) - (data + start));
+        line = std::string_view(data + start, length);
+        start += length + 1;
+    } else if (finished && start < end) {
+        line = std::string_view(data + start, end - start);
+        start = end;
+    } else {
+        scanned = end;
+        return false;
+    }
+    if (!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+    }
+    return true;
+}
+
+int LineReader::fill() {
+    if (finished) {
+        return 0;
+    }
+    // 把未完成的行搬到开头；仍占满缓冲区时说明行比缓冲区长，扩容
+    if (start > 0) {
+        std::memmove(buffer.data(), buffer.data() + start, end - start);
+        scanned -= start;
+        end -= start;
+        start = 0;
+    }
+    if (end == buffer.size()) {
+        buffer.resize(buffer.size() * 2);
+    }
+
+    ssize_t n;
+    do {
+        n = read(fd, buffer.data() + end, buffer.size() - end);
+    } while (n < 0 && errno == EINTR);
+    if (n < 0) {
+        return -1;
+    }
+    if (n == 0) {
+        finished = true;
+        return 0;
+    }
+    end += static_cast<size_t>(n);
+    total += static_cast<uint64_t>(n);
+    return 1;
+}
+
+OutputBuffer::OutputBuffer(int fd, size_t capacity) : buffer(std::max<size_t>(capacity, 4096)), fd(fd) {}
+
+void OutputBuffer::writeAll(const char* data, size_t size) {
+    size_t written = 0;
+    while (!broken && written < size) {
+        ssize_t n = write(fd, data + written, size - written);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            broken = true;
+            break;
+        }
+        written += static_cast<size_t>(n);
+    }
+    total += written;
+}
+
+bool OutputBuffer::flush() {
+    writeAll(buffer.data(), length);
+    length = 0;
+    return !broken;
+}
+
+void OutputBuffer::append(std::string_view text) {
+    if (length + text.size() > buffer.size()) {
+        flush();
+    }
+    // 单次追加比整个缓冲区还大时直接写出
+    if (text.size() > buffer.size()) {
+        writeAll(text.data(), text.size());
+        return;
+    }
+    std::memcpy(buffer.data() + length, text.data(), text.size());
+    length += text.size();
+}
+
+PipeSession::PipeSession(size_t cacheCapacity, uint32_t jitThreshold, const SheetOptions& sheetOptions)
+    : vm(jitThreshold), cache(cacheCapacity), sheet(sheetOptions) {}
+
+PipeStats PipeSession::run(int inputFd, int outputFd, bool& ok, size_t blockSize) {
+    auto begin = std::chrono::steady_clock::now();
+    PipeStats stats;
+    LineReader reader(inputFd, blockSize);
+    // 短表达式的结果可能比输入长，输出缓冲取两块，通常每块输入只需一次 write
+    OutputBuffer out(outputFd, blockSize * 2);
+    ok = true;
+
+    bool running = true;
+    while (running && !out.failed()) {
+        std::string_view line;
+        while (running && reader.next(line)) {
+            running = handleLine(line, out, stats);
+        }
+        if (!running || reader.eof()) {
+            break;
+        }
+        // 一块输入的结果一次写出
+        out.flush();
+        if (reader.fill() < 0) {
+            ok = false;
+            break;
+        }
+    }
+    out.flush();
+
+    stats.bytesIn = reader.bytes();
+    stats.bytesOut = out.bytes();
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    ok = ok && !out.failed();
+    return stats;
+}
+
+void PipeSession::writeError(OutputBuffer& out, const std::string& message, PipeStats& stats) {
+    out.append("错误: ");
+    out.append(message);
+    out.append("\n");
+    stats.errors++;
+}
+
+bool PipeSession::handleLine(std::string_view line, OutputBuffer& out, PipeStats& stats) {
+    // 与 C 版本的管道模式一致，忽略首尾空白：只含空白的行与空行一样输出空行
+    while (!line.empty() && std::isspace(static_cast<unsigned char>(line.back()))) {
+        line.remove_suffix(1);
+    }
+    while (!line.empty() && std::isspace(static_cast<unsigned char>(line.front()))) {
+        line.remove_prefix(1);
+    }
+    if (line == "quit" || line == "exit") {
+        return false;
+    }
+    stats.lines++;
+    // 帮助与统计沿用交互模式的输出，先写出已缓冲的结果以保持顺序
+    if (line == "help" || line == "stats") {
+        out.flush();
+        if (line == "help") {
+            UI::showHelp();
+        } else {
+            UI::showCacheStats(cache.stats());
+            UI::showOptimizerStats(optimizer.stats());
+        }
+        std::cout.flush();
+        return true;
+    }
+    if (line.empty()) {
+        out.append("\n");
+        return true;
+    }
+
+    // 错误沿错误码返回，不经过异常展开；这里只兜住内存不足之类的意外异常
+    try {
+        char text[64];
+        std::string_view name;
+        std::string_view expression;
+        if (Spreadsheet::splitAssignment(line, name, expression)) {
+            Status status = sheet.assign(name, expression);
+            if (!status.ok()) {
+                writeError(out, status.message(), stats);
+                return true;
+            }
+            sheet.recalculate();
+            Expected<double> value = sheet.value(name);
+            if (!value.ok()) {
+                writeError(out, value.error().message(), stats);
+                return true;
+            }
+            // 与结果行同样的数值格式："a = 3"
+            size_t length = UI::formatResult(text, sizeof(text), value.value());
+            out.append(name);
+            out.append(" ");
+            out.append(std::string_view(text, length));
+            out.append("\n");
+            return true;
+        }
+
+        bool gradient = GradientCommand::split(line, expression);
+        if (!gradient) {
+            expression = line;
+        }
+        ExpressionCache::normalize(expression, key);
+        const Program* program = cache.find(key);
+        if (program == nullptr) {
+            arena.reset();
+            Expected<NodeId> root = Parser(expression, arena).tryParse();
+            if (!root.ok()) {
+                writeError(out, root.error().message(), stats);
+                return true;
+            }
+            Expected<Program> compiled = Compiler::tryCompile(arena, optimizer.optimize(arena, root.value()));
+            if (!compiled.ok()) {
+                writeError(out, compiled.error().message(), stats);
+                return true;
+            }
+            program = &cache.insert(key, std::move(compiled.value()));
+        }
+
+        Expected<double> result = sheet.evaluate(*program, vm);
+        if (!result.ok()) {
+            writeError(out, result.error().message(), stats);
+            return true;
+        }
+        if (gradient) {
+            // 插入导数程序可能淘汰 program，先复制变量名
+            names = program->variables;
+            Status status =
+                GradientCommand::evaluate(key, expression, names, partials, arena, optimizer, cache, sheet, vm);
+            if (!status.ok()) {
+                writeError(out, status.message(), stats);
+                return true;
+            }
+            std::ostringstream text;
+            UI::writeGradient(text, result.value(), names, partials);
+            text << '\n';
+            out.append(text.str());
+            return true;
+        }
+        size_t length = UI::formatResult(text, sizeof(text), result.value());
+        text[length++] = '\n';
+        out.append(std::string_view(text, length));
+    } catch (const std::exception& e) {
+        writeError(out, "未知错误: " + std::string(e.what()), stats);
+    }
+    return true;
+}
@@ -0,0 +1,666 @@
+#include "server.h"
+#include "error.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+#if defined(__linux__)
+#include "line_evaluator.h"
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <sstream>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+size_t LatencyHistogram::bucketOf(uint64_t value) {
+    // 小于 2^(SUB_BITS+1) 的值各占一个桶；更大的值按最高位所在的区间与其后 SUB_BITS 位分桶
+    if (value < (uint64_t(2) << SUB_BITS)) {
+        return static_cast<size_t>(value);
+    }
+    int exponent = 63 - __builtin_clzll(value);
+    size_t sub = static_cast<size_t>(value >> (exponent - SUB_BITS)) & ((size_t(1) << SUB_BITS) - 1);
+    return (static_cast<size_t>(exponent - SUB_BITS + 1) << SUB_BITS) + sub;
+}
+
+uint64_t LatencyHistogram::upperBound(size_t bucket) {
+    if (bucket < (size_t(2) << SUB_BITS)) {
+        return bucket;
+    }
+    int exponent = static_cast<int>(bucket >> SUB_BITS) + SUB_BITS - 1;
+    uint64_t sub = bucket & ((size_t(1) << SUB_BITS) - 1);
+    uint64_t lower = ((uint64_t(1) << SUB_BITS) + sub) << (exponent - SUB_BITS);
+    return lower + ((uint64_t(1) << (exponent - SUB_BITS)) - 1);
+}
+
+void LatencyHistogram::record(uint64_t nanoseconds, uint64_t times) {
+    buckets[bucketOf(nanoseconds)] += times;
+    total += times;
+    largest = std::max(largest, nanoseconds);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (size_t i = 0; i < BUCKETS; i++) {
+        buckets[i] += other.buckets[i];
+    }
+    total += other.total;
+    largest = std::max(largest, other.largest);
+}
+
+uint64_t LatencyHistogram::percentile(double p) const {
+    if (total == 0) {
+        return 0;
+    }
+    uint64_t rank = static_cast<uint64_t>(p / 100.0 * static_cast<double>(total) + 0.999999);
+    rank = std::min(std::max<uint64_t>(rank, 1), total);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKETS; i++) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            return std::min(upperBound(i), largest);
+        }
+    }
+    return largest;
+}
+
+std::string LatencyHistogram::summary() const {
+    char text[160];
+    std::snprintf(text, sizeof(text), "n=%llu p50=%.1fus p90=%.1fus p99=%.1fus p99.9=%.1fus max=%.1fus",
+                  static_cast<unsigned long long>(total), percentile(50) / 1e3, percentile(90) / 1e3,
+                  percentile(99) / 1e3, percentile(99.9) / 1e3, largest / 1e3);
+    return text;
+}
+
+ServerAddress ServerAddress::parse(const std::string& text) {
+    ServerAddress address;
+    if (text.compare(0, 5, "unix:") == 0 && text.size() > 5) {
+        address.unixPath = text.substr(5);
+        return address;
+    }
+    if (text.compare(0, 4, "tcp:") == 0 && text.size() > 4) {
+        char* end = nullptr;
+        unsigned long port = std::strtoul(text.c_str() + 4, &end, 10);
+        if (*end == '\0' && port <= 65535) {
+            address.port = static_cast<uint16_t>(port);
+            return address;
+        }
+    }
+    throw CalcError("无效的监听地址: " + text + "（应为 unix:<路径> 或 tcp:<端口>）");
+}
+
+#if defined(__linux__)
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr uint64_t LISTEN_ID = 0;
+constexpr uint64_t WAKE_ID = 1;
+constexpr size_t JOB_LINES = 256;                 // 每个求值任务最多包含的行数
+constexpr size_t READ_CHUNK = 64 * 1024;
+constexpr size_t OUTPUT_HIGH_WATER = 4 << 20;     // 发送缓冲超过此值时暂停读取
+constexpr int ACCEPT_RETRY_MS = 100;              // 文件描述符耗尽而暂停 accept 后，至多这么久重试一次
+
+// 求值任务：同一连接连续的若干行，每行以 '\n' 结尾
+struct Job {
+    uint64_t connection = 0;
+    uint64_t seq = 0;
+    std::string lines;
+    size_t count = 0;
+};
+
+struct Completion {
+    uint64_t connection;
+    uint64_t seq;
+    std::string output;
+    size_t errors;
+};
+
+// 按序号排队等待回复的任务
+struct Slot {
+    Clock::time_point received;
+    size_t count = 0;
+    bool done = false;
+    size_t errors = 0;
+    std::string output;
+};
+
+struct Connection {
+    int fd = -1;
+    uint64_t id = 0;
+    std::string input;
+    size_t scanned = 0;            // input 中已确认没有换行符的前缀长度
+    std::string output;
+    size_t written = 0;
+    std::deque<Slot> slots;        // slots[i] 的序号为 firstSeq + i
+    uint64_t firstSeq = 0;
+    uint64_t nextSeq = 0;
+    size_t inFlight = 0;           // 已收到但尚未写入发送缓冲的请求数
+    uint32_t events = 0;           // 当前在 epoll 中登记的事件，0 表示未登记
+    bool peerClosed = false;       // 对端已关闭写方向：回复完已收到的请求后关闭
+    bool broken = false;           // 协议错误：不再读取，回复完后关闭
+    LatencyHistogram latency;
+};
+
+} // namespace
+
+struct Server::State {
+    State(const ServerOptions& options, ServerStats& totals) : options(options), totals(totals) {}
+
+    const ServerOptions& options;
+    ServerStats& totals;
+    int epollFd = -1;
+    int listenFd = -1;
+    int wakeFd = -1;
+    std::vector<char> readBuffer = std::vector<char>(READ_CHUNK);
+    std::unordered_map<uint64_t, std::unique_ptr<Connection>> connections;
+    uint64_t nextId = WAKE_ID + 1;
+    // accept 因文件描述符或内存耗尽失败时不再关注监听套接字：它是水平触发的，积压的连接会让
+    // epoll_wait 立即返回而空转。有连接关闭或等待超时后重新关注
+    bool acceptPaused = false;
+
+    std::vector<std::thread> workers;
+    std::mutex jobMutex;
+    std::condition_variable jobReady;
+    std::deque<Job> jobs;
+    bool shutdown = false;
+
+    std::mutex doneMutex;
+    std::vector<Completion> completed;
+    std::vector<Completion> draining;
+
+    void run(std::atomic<bool>& stopping);
+    void work();
+    void acceptAll();
+    void setAccepting(bool accepting);
+    bool readFrom(Connection& connection);
+    void parseLines(Connection& connection);
+    void submit(Connection& connection, Job& job);
+    void pushReply(Connection& connection, std::string text, size_t errors);
+    void drainCompletions();
+    bool flush(Connection& connection);
+    bool updateInterest(Connection& connection);
+    void close(Connection& connection);
+};
+
+void Server::State::run(std::atomic<bool>& stopping) {
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd < 0) {
+        throw CalcError(std::string("无法创建 epoll: ") + std::strerror(errno));
+    }
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u64 = LISTEN_ID;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event);
+    event.data.u64 = WAKE_ID;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event);
+
+    size_t count = options.workers != 0 ? options.workers : std::max(1u, std::thread::hardware_concurrency());
+    for (size_t i = 0; i < count; i++) {
+        workers.emplace_back([this]() { work(); });
+    }
+
+    epoll_event events[64];
+    while (!stopping.load()) {
+        int ready = epoll_wait(epollFd, events, 64, acceptPaused ? ACCEPT_RETRY_MS : -1);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        if (ready == 0 && acceptPaused) {
+            setAccepting(true);
+            continue;
+        }
+        for (int i = 0; i < ready; i++) {
+            uint64_t id = events[i].data.u64;
+            if (id == LISTEN_ID) {
+                acceptAll();
+                continue;
+            }
+            if (id == WAKE_ID) {
+                uint64_t value;
+                ssize_t ignored = read(wakeFd, &value, sizeof(value));
+                (void)ignored;
+                drainCompletions();
+                continue;
+            }
+            auto it = connections.find(id);
+            if (it == connections.end()) {
+                continue;
+            }
+            Connection& connection = *it->second;
+            if (events[i].events & EPOLLERR) {
+                close(connection);
+                continue;
+            }
+            if ((events[i].events & (EPOLLIN | EPOLLHUP)) && !readFrom(connection)) {
+                continue;
+            }
+            if (events[i].events & EPOLLOUT) {
+                flush(connection);
+            }
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        shutdown = true;
+    }
+    jobReady.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+    while (!connections.empty()) {
+        close(*connections.begin()->second);
+    }
+    ::close(epollFd);
+    epollFd = -1;
+}
+
+void Server::State::work() {
+    LineEvaluator evaluator(options.jitThreshold);
+    std::ostringstream out;
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(jobMutex);
+            jobReady.wait(lock, [this]() { return shutdown || !jobs.empty(); });
+            if (shutdown) {
+                return;
+            }
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+
+        out.str(std::string());
+        size_t errors = 0;
+        std::string_view lines(job.lines);
+        size_t start = 0;
+        while (start < lines.size()) {
+            size_t end = lines.find('\n', start);
+            evaluator.evaluate(lines.substr(start, end - start), out, errors);
+            out << '\n';
+            start = end + 1;
+        }
+
+        // 完成队列由空变为非空时才唤醒 I/O 线程
+        bool wake;
+        {
+            std::lock_guard<std::mutex> lock(doneMutex);
+            wake = completed.empty();
+            completed.push_back(Completion{job.connection, job.seq, out.str(), errors});
+        }
+        if (wake) {
+            uint64_t one = 1;
+            ssize_t ignored = write(wakeFd, &one, sizeof(one));
+            (void)ignored;
+        }
+    }
+}
+
+void Server::State::acceptAll() {
+    while (true) {
+        int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                // EMFILE、ENFILE、ENOBUFS、ENOMEM 等：连接留在积压队列中，稍后再取
+                setAccepting(false);
+            }
+            return;
+        }
+        if (!options.address.isUnix()) {
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        }
+        auto connection = std::make_unique<Connection>();
+        connection->fd = fd;
+        connection->id = nextId++;
+        connection->events = EPOLLIN;
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u64 = connection->id;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+            ::close(fd);
+            continue;
+        }
+        connections.emplace(connection->id, std::move(connection));
+        totals.connections++;
+    }
+}
+
+void Server::State::setAccepting(bool accepting) {
+    if (acceptPaused != accepting) {
+        return;
+    }
+    epoll_event event{};
+    event.events = accepting ? static_cast<uint32_t>(EPOLLIN) : 0;
+    event.data.u64 = LISTEN_ID;
+    if (epoll_ctl(epollFd, EPOLL_CTL_MOD, listenFd, &event) == 0) {
+        acceptPaused = !accepting;
+    }
+}
+
+bool Server::State::readFrom(Connection& connection) {
+    // 每次事件最多读取固定次数，避免单个连接占满 I/O 线程
+    for (int round = 0; round < 16 && !connection.peerClosed && !connection.broken; round++) {
+        ssize_t received = read(connection.fd, readBuffer.data(), readBuffer.size());
+        if (received > 0) {
+            connection.input.append(readBuffer.data(), static_cast<size_t>(received));
+            if (static_cast<size_t>(received) < readBuffer.size()) {
+                break;
+            }
+        } else if (received == 0) {
+            connection.peerClosed = true;
+        } else if (errno == EINTR) {
+            continue;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        } else {
+            close(connection);
+            return false;
+        }
+    }
+
+    parseLines(connection);
+    if (connection.peerClosed && !connection.input.empty()) {
+        // 最后一行没有换行符也照常求值
+        connection.input.push_back('\n');
+        parseLines(connection);
+    }
+    return flush(connection);
+}
+
+void Server::State::parseLines(Connection& connection) {
+    std::string& input = connection.input;
+    Job job;
+    size_t start = 0;
+    size_t end;
+    while (!connection.broken && (end = input.find('\n', std::max(start, connection.scanned))) != std::string::npos) {
+        std::string_view line(input.data() + start, end - start);
+        if (line == "stats" || line == "stats\r") {
+            submit(connection, job);
+            pushReply(connection, "连接: " + connection.latency.summary() + "; 全局: " + totals.latency.summary() + "\n", 0);
+        } else {
+            job.lines.append(line.data(), line.size());
+            job.lines.push_back('\n');
+            if (++job.count == JOB_LINES) {
+                submit(connection, job);
+            }
+        }
+        start = end + 1;
+    }
+    submit(connection, job);
+    input.erase(0, start);
+    connection.scanned = input.size();
+
+    if (input.size() > options.maxLineBytes) {
+        pushReply(connection, "错误: 请求行超过 " + std::to_string(options.maxLineBytes) + " 字节\n", 1);
+        connection.broken = true;
+        input.clear();
+        connection.scanned = 0;
+    }
+}
+
+void Server::State::submit(Connection& connection, Job& job) {
+    if (job.count == 0) {
+        return;
+    }
+    Slot slot;
+    slot.received = Clock::now();
+    slot.count = job.count;
+    connection.slots.push_back(std::move(slot));
+    connection.inFlight += job.count;
+    job.connection = connection.id;
+    job.seq = connection.nextSeq++;
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        jobs.push_back(std::move(job));
+    }
+    jobReady.notify_one();
+    job = Job();
+}
+
+void Server::State::pushReply(Connection& connection, std::string text, size_t errors) {
+    Slot slot;
+    slot.received = Clock::now();
+    slot.count = 1;
+    slot.done = true;
+    slot.errors = errors;
+    slot.output = std::move(text);
+    connection.slots.push_back(std::move(slot));
+    connection.inFlight++;
+    connection.nextSeq++;
+}
+
+void Server::State::drainCompletions() {
+    {
+        std::lock_guard<std::mutex> lock(doneMutex);
+        draining.swap(completed);
+    }
+    for (Completion& completion : draining) {
+        auto it = connections.find(completion.connection);
+        if (it == connections.end()) {
+            continue;   // 连接已关闭
+        }
+        Connection& connection = *it->second;
+        Slot& slot = connection.slots[completion.seq - connection.firstSeq];
+        slot.done = true;
+        slot.errors = completion.errors;
+        slot.output = std::move(completion.output);
+        flush(connection);
+    }
+    draining.clear();
+}
+
+bool Server::State::flush(Connection& connection) {
+    // 按序号把已完成的回复移入发送缓冲，前面的任务未完成时后面的回复继续等待
+    Clock::time_point now = Clock::now();
+    while (!connection.slots.empty() && connection.slots.front().done) {
+        Slot& slot = connection.slots.front();
+        uint64_t nanoseconds = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(now - slot.received).count());
+        connection.latency.record(nanoseconds, slot.count);
+        totals.latency.record(nanoseconds, slot.count);
+        totals.requests += slot.count;
+        totals.errors += slot.errors;
+        connection.inFlight -= slot.count;
+        connection.output.append(slot.output);
+        connection.slots.pop_front();
+        connection.firstSeq++;
+    }
+
+    while (connection.written < connection.output.size()) {
+        ssize_t sent = send(connection.fd, connection.output.data() + connection.written,
+                            connection.output.size() - connection.written, MSG_NOSIGNAL);
+        if (sent > 0) {
+            connection.written += static_cast<size_t>(sent);
+        } else if (sent < 0 && errno == EINTR) {
+            continue;
+        } else if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else {
+            close(connection);
+            return false;
+        }
+    }
+    if (connection.written == connection.output.size()) {
+        connection.output.clear();
+        connection.written = 0;
+    } else if (connection.written > connection.output.size() / 2) {
+        connection.output.erase(0, connection.written);
+        connection.written = 0;
+    }
+
+    if ((connection.peerClosed || connection.broken) && connection.slots.empty() && connection.output.empty()) {
+        close(connection);
+        return false;
+    }
+    return updateInterest(connection);
+}
+
+bool Server::State::updateInterest(Connection& connection) {
+    uint32_t wanted = 0;
+    size_t pending = connection.output.size() - connection.written;
+    if (!connection.peerClosed && !connection.broken && connection.inFlight < options.maxInFlight &&
+        pending < OUTPUT_HIGH_WATER) {
+        wanted |= EPOLLIN;
+    }
+    if (pending > 0) {
+        wanted |= EPOLLOUT;
+    }
+    if (wanted != connection.events) {
+        // 不关心任何事件时从 epoll 中移除，否则对端挂断后 EPOLLHUP 会被反复报告
+        epoll_event event{};
+        event.events = wanted;
+        event.data.u64 = connection.id;
+        int op = wanted == 0 ? EPOLL_CTL_DEL : connection.events == 0 ? EPOLL_CTL_ADD : EPOLL_CTL_MOD;
+        if (epoll_ctl(epollFd, op, connection.fd, &event) != 0) {
+            close(connection);
+            return false;
+        }
+        connection.events = wanted;
+    }
+    return true;
+}
+
+void Server::State::close(Connection& connection) {
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, connection.fd, nullptr);
+    ::close(connection.fd);
+    connections.erase(connection.id);
+    // 释放了一个文件描述符，积压的连接可以接受了
+    setAccepting(true);
+}
+
+Server::Server(const ServerOptions& options) : options(options), state(std::make_unique<State>(this->options, totals)) {}
+
+Server::~Server() {
+    if (listenFd >= 0) {
+        ::close(listenFd);
+        if (options.address.isUnix()) {
+            unlink(options.address.unixPath.c_str());
+        }
+    }
+    if (wakeFd >= 0) {
+        ::close(wakeFd);
+    }
+}
+
+void Server::listen() {
+    const ServerAddress& address = options.address;
+    std::string name = address.isUnix() ? "unix:" + address.unixPath : "tcp:127.0.0.1:" + std::to_string(address.port);
+    auto failure = [&name](const char* what) {
+        return CalcError("无法监听 " + name + ": " + what + ": " + std::strerror(errno));
+    };
+
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeFd < 0) {
+        throw failure("eventfd");
+    }
+
+    if (address.isUnix()) {
+        sockaddr_un local{};
+        local.sun_family = AF_UNIX;
+        if (address.unixPath.size() >= sizeof(local.sun_path)) {
+            throw CalcError("无法监听 " + name + ": 路径过长");
+        }
+        std::memcpy(local.sun_path, address.unixPath.c_str(), address.unixPath.size() + 1);
+        // 只清理残留的套接字文件，不覆盖其他文件
+        struct stat info;
+        if (lstat(address.unixPath.c_str(), &info) == 0 && S_ISSOCK(info.st_mode)) {
+            unlink(address.unixPath.c_str());
+        }
+        listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listenFd < 0) {
+            throw failure("socket");
+        }
+        if (bind(listenFd, reinterpret_cast<sockaddr*>(&local), sizeof(local)) != 0) {
+            CalcError error = failure("bind");
+            ::close(listenFd);
+            listenFd = -1;
+            throw error;
+        }
+    } else {
+        sockaddr_in local{};
+        local.sin_family = AF_INET;
+        local.sin_port = htons(address.port);
+        local.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        listenFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listenFd < 0) {
+            throw failure("socket");
+        }
+        int one = 1;
+        setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        if (bind(listenFd, reinterpret_cast<sockaddr*>(&local), sizeof(local)) != 0) {
+            CalcError error = failure("bind");
+            ::close(listenFd);
+            listenFd = -1;
+            throw error;
+        }
+        socklen_t length = sizeof(local);
+        getsockname(listenFd, reinterpret_cast<sockaddr*>(&local), &length);
+        boundPort = ntohs(local.sin_port);
+    }
+    if (::listen(listenFd, SOMAXCONN) != 0) {
+        throw failure("listen");
+    }
+    state->listenFd = listenFd;
+    state->wakeFd = wakeFd;
+}
+
+void Server::run() {
+    if (listenFd < 0) {
+        throw CalcError("服务尚未开始监听");
+    }
+    state->run(stopping);
+}
+
+void Server::stop() {
+    // 只使用原子写与 write()，可在信号处理函数中调用
+    stopping.store(true);
+    if (wakeFd >= 0) {
+        uint64_t one = 1;
+        ssize_t ignored = write(wakeFd, &one, sizeof(one));
+        (void)ignored;
+    }
+}
+
+#else
+
+struct Server::State {};
+
+Server::Server(const ServerOptions& options) : options(options) {}
+
+Server::~Server() = default;
+
+void Server::listen() {
+    throw CalcError("当前平台不支持服务模式");
+}
+
+void Server::run() {}
+
+void Server::stop() {
+    stopping.store(true);
+}
+
+#endif
@@ -0,0 +1,161 @@
+#include "simd_kernels.h"
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CALC_HAVE_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// 标量实现：任何平台可用，同时处理 SIMD 实现剩余的尾部元素
+void scalarAdd(double* dst, const double* src, size_t n) {
+    for (size_t i = 0; i < n; i++) dst[i] += src[i];
+}
+
+void scalarSub(double* dst, const double* src, size_t n) {
+    for (size_t i = 0; i < n; i++) dst[i] -= src[i];
+}
+
+void scalarMul(double* dst, const double* src, size_t n) {
+    for (size_t i = 0; i < n; i++) dst[i] *= src[i];
+}
+
+void scalarDiv(double* dst, const double* src, size_t n) {
+    for (size_t i = 0; i < n; i++) dst[i] /= src[i];
+}
+
+// 幂运算没有对应的向量指令，各级别共用逐元素的 std::pow，保证与标量求值逐位一致
+void scalarPow(double* dst, const double* src, size_t n) {
+    for (size_t i = 0; i < n; i++) dst[i] = std::pow(dst[i], src[i]);
+}
+
+void scalarNeg(double* dst, size_t n) {
+    for (size_t i = 0; i < n; i++) dst[i] = -dst[i];
+}
+
+bool scalarAnyZero(const double* src, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        if (src[i] == 0) return true;
+    }
+    return false;
+}
+
+const ColumnKernels SCALAR_KERNELS = {
+    scalarAdd, scalarSub, scalarMul, scalarDiv, scalarPow, scalarNeg, scalarAnyZero,
+};
+
+#ifdef CALC_HAVE_X86_SIMD
+
+// SSE2 是 x86-64 的基线指令集，无需运行时检测
+#define DEFINE_SSE2_BINARY(name, intrinsic, scalar)                                 \
+    void name(double* dst, const double* src, size_t n) {                           \
+        size_t i = 0;                                                               \
+        for (; i + 2 <= n; i += 2) {                                                \
+            _mm_storeu_pd(dst + i, intrinsic(_mm_loadu_pd(dst + i), _mm_loadu_pd(src + i))); \
+        }                                                                           \
+        scalar(dst + i, src + i, n - i);                                            \
+    }
+
+DEFINE_SSE2_BINARY(sse2Add, _mm_add_pd, scalarAdd)
+DEFINE_SSE2_BINARY(sse2Sub, _mm_sub_pd, scalarSub)
+DEFINE_SSE2_BINARY(sse2Mul, _mm_mul_pd, scalarMul)
+DEFINE_SSE2_BINARY(sse2Div, _mm_div_pd, scalarDiv)
+
+void sse2Neg(double* dst, size_t n) {
+    const __m128d sign = _mm_set1_pd(-0.0);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        _mm_storeu_pd(dst + i, _mm_xor_pd(_mm_loadu_pd(dst + i), sign));
+    }
+    scalarNeg(dst + i, n - i);
+}
+
+bool sse2AnyZero(const double* src, size_t n) {
+    const __m128d zero = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        if (_mm_movemask_pd(_mm_cmpeq_pd(_mm_loadu_pd(src + i), zero)) != 0) return true;
+    }
+    return scalarAnyZero(src + i, n - i);
+}
+
+const ColumnKernels SSE2_KERNELS = {
+    sse2Add, sse2Sub, sse2Mul, sse2Div, scalarPow, sse2Neg, sse2AnyZero,
+};
+
+// AVX2 实现只在这些函数上启用目标指令集，调用前需经 detectSimdLevel() 确认。
+// 尾部交给 SSE2 实现前先清零 ymm 高半部分：编译器对尾调用不插入 vzeroupper，
+// 高半部分未清零时其后的非 VEX 指令（包括数学库调用）每条都要付出状态切换的代价
+#define DEFINE_AVX2_BINARY(name, intrinsic, tail)                                   \
+    __attribute__((target("avx2"))) void name(double* dst, const double* src, size_t n) { \
+        size_t i = 0;                                                               \
+        for (; i + 4 <= n; i += 4) {                                                \
+            _mm256_storeu_pd(dst + i, intrinsic(_mm256_loadu_pd(dst + i), _mm256_loadu_pd(src + i))); \
+        }                                                                           \
+        _mm256_zeroupper();                                                         \
+        tail(dst + i, src + i, n - i);                                              \
+    }
+
+DEFINE_AVX2_BINARY(avx2Add, _mm256_add_pd, sse2Add)
+DEFINE_AVX2_BINARY(avx2Sub, _mm256_sub_pd, sse2Sub)
+DEFINE_AVX2_BINARY(avx2Mul, _mm256_mul_pd, sse2Mul)
+DEFINE_AVX2_BINARY(avx2Div, _mm256_div_pd, sse2Div)
+
+__attribute__((target("avx2"))) void avx2Neg(double* dst, size_t n) {
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm256_storeu_pd(dst + i, _mm256_xor_pd(_mm256_loadu_pd(dst + i), sign));
+    }
+    _mm256_zeroupper();
+    sse2Neg(dst + i, n - i);
+}
+
+__attribute__((target("avx2"))) bool avx2AnyZero(const double* src, size_t n) {
+    const __m256d zero = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        if (_mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(src + i), zero, _CMP_EQ_OQ)) != 0) return true;
+    }
+    _mm256_zeroupper();
+    return sse2AnyZero(src + i, n - i);
+}
+
+const ColumnKernels AVX2_KERNELS = {
+    avx2Add, avx2Sub, avx2Mul, avx2Div, scalarPow, avx2Neg, avx2AnyZero,
+};
+
+#endif // CALC_HAVE_X86_SIMD
+
+} // namespace
+
+SimdLevel detectSimdLevel() {
+#ifdef CALC_HAVE_X86_SIMD
+    static const SimdLevel level = __builtin_cpu_supports("avx2") ? SIMD_AVX2 : SIMD_SSE2;
+    return level;
+#else
+    return SIMD_SCALAR;
+#endif
+}
+
+const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SIMD_AVX2: return "avx2";
+        case SIMD_SSE2: return "sse2";
+        default: return "scalar";
+    }
+}
+
+const ColumnKernels& columnKernels(SimdLevel level) {
+    if (level > detectSimdLevel()) {
+        level = detectSimdLevel();
+    }
+    switch (level) {
+#ifdef CALC_HAVE_X86_SIMD
+        case SIMD_AVX2: return AVX2_KERNELS;
+        case SIMD_SSE2: return SSE2_KERNELS;
+#endif
+        default: return SCALAR_KERNELS;
+    }
+}
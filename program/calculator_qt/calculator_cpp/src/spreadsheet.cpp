@@ -0,0 +1,275 @@
+#include "spreadsheet.h"
+#include "lexer.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace {
+
+std::string_view trim(std::string_view text) {
+    const char* const spaces = " \t\r\n";
+    size_t begin = text.find_first_not_of(spaces);
+    if (begin == std::string_view::npos) {
+        return std::string_view();
+    }
+    size_t end = text.find_last_not_of(spaces);
+    return text.substr(begin, end - begin + 1);
+}
+
+// 并行求值时每个任务包含的单元格数
+constexpr size_t WAVE_CHUNK = 256;
+
+} // namespace
+
+Spreadsheet::Spreadsheet(const SheetOptions& options) : options(options), vm(options.jitThreshold) {}
+
+bool Spreadsheet::splitAssignment(std::string_view line, std::string_view& name, std::string_view& expression) {
+    size_t equals = line.find('=');
+    if (equals == std::string_view::npos) {
+        return false;
+    }
+    name = trim(line.substr(0, equals));
+    expression = line.substr(equals + 1);
+    return true;
+}
+
+Status Spreadsheet::assign(std::string_view name, std::string_view expression) {
+    // 名称须恰好是一个变量 Token：函数名、常量名与数字都不能被赋值
+    Lexer lexer(name);
+    if (lexer.scan().type != VARIABLE || lexer.scan().type != END) {
+        return Status(ErrorCode::INVALID_ASSIGNMENT, 0, name);
+    }
+
+    arena.reset();
+    Expected<NodeId> root = Parser(expression, arena).tryParse();
+    if (!root.ok()) {
+        return root.error();
+    }
+    Expected<Program> compiled = Compiler::tryCompile(arena, optimizer.optimize(arena, root.value()));
+    if (!compiled.ok()) {
+        return compiled.error();
+    }
+
+    // 引用到的名称即使尚未定义也建立单元格，定义之后引用者会随之重算
+    uint32_t id = intern(name);
+    std::vector<uint32_t> inputs;
+    inputs.reserve(compiled.value().variables.size());
+    for (const std::string& variable : compiled.value().variables) {
+        inputs.push_back(intern(variable));
+    }
+    if (createsCycle(id, inputs)) {
+        return Status(ErrorCode::CYCLIC_DEPENDENCY, 0, cells[id].name);
+    }
+
+    Cell& cell = cells[id];
+    for (uint32_t input : cell.inputs) {
+        std::vector<uint32_t>& list = cells[input].dependents;
+        list.erase(std::find(list.begin(), list.end(), id));
+    }
+    for (uint32_t input : inputs) {
+        cells[input].dependents.push_back(id);
+    }
+    cell.program = std::move(compiled.value());
+    cell.inputs = std::move(inputs);
+    cell.defined = true;
+    markDirty(id);
+    return Status();
+}
+
+uint32_t Spreadsheet::intern(std::string_view name) {
+    auto it = index.find(name);
+    if (it != index.end()) {
+        return it->second;
+    }
+    uint32_t id = static_cast<uint32_t>(cells.size());
+    cells.emplace_back();
+    cells.back().name = std::string(name);
+    index.emplace(cells.back().name, id);
+    return id;
+}
+
+void Spreadsheet::nextMarkEpoch() {
+    if (visitMark.size() < cells.size()) {
+        visitMark.resize(cells.size(), 0);
+        targetMark.resize(cells.size(), 0);
+    }
+    if (++markEpoch == 0) {
+        std::fill(visitMark.begin(), visitMark.end(), 0);
+        std::fill(targetMark.begin(), targetMark.end(), 0);
+        markEpoch = 1;
+    }
+}
+
+bool Spreadsheet::createsCycle(uint32_t id, const std::vector<uint32_t>& inputs) {
+    // 新的输入中若有 id 本身或 id 的传递依赖者，加入这些边后就会成环
+    nextMarkEpoch();
+    for (uint32_t input : inputs) {
+        if (input == id) {
+            return true;
+        }
+        targetMark[input] = markEpoch;
+    }
+    stack.clear();
+    stack.push_back(id);
+    visitMark[id] = markEpoch;
+    while (!stack.empty()) {
+        uint32_t current = stack.back();
+        stack.pop_back();
+        for (uint32_t dependent : cells[current].dependents) {
+            if (targetMark[dependent] == markEpoch) {
+                return true;
+            }
+            if (visitMark[dependent] != markEpoch) {
+                visitMark[dependent] = markEpoch;
+                stack.push_back(dependent);
+            }
+        }
+    }
+    return false;
+}
+
+void Spreadsheet::markDirty(uint32_t id) {
+    // 脏单元格的依赖者一定也是脏的，遇到已脏的单元格即可停止
+    stack.clear();
+    stack.push_back(id);
+    while (!stack.empty()) {
+        Cell& cell = cells[stack.back()];
+        uint32_t current = stack.back();
+        stack.pop_back();
+        if (cell.dirty) {
+            continue;
+        }
+        cell.dirty = true;
+        dirty.push_back(current);
+        stack.insert(stack.end(), cell.dependents.begin(), cell.dependents.end());
+    }
+}
+
+RecalcStats Spreadsheet::recalculate() {
+    auto begin = std::chrono::steady_clock::now();
+    RecalcStats stats;
+
+    // Kahn 算法：pending 为尚未求值的脏输入个数，归零的单元格进入下一层
+    for (uint32_t id : dirty) {
+        cells[id].pending = 0;
+    }
+    for (uint32_t id : dirty) {
+        for (uint32_t dependent : cells[id].dependents) {
+            cells[dependent].pending++;
+        }
+    }
+    wave.clear();
+    for (uint32_t id : dirty) {
+        if (cells[id].pending == 0) {
+            wave.push_back(id);
+        }
+    }
+
+    while (!wave.empty()) {
+        evaluateWave(stats);
+        nextWave.clear();
+        for (uint32_t id : wave) {
+            Cell& cell = cells[id];
+            cell.dirty = false;
+            for (uint32_t dependent : cell.dependents) {
+                if (--cells[dependent].pending == 0) {
+                    nextWave.push_back(dependent);
+                }
+            }
+        }
+        wave.swap(nextWave);
+        stats.levels++;
+    }
+    dirty.clear();
+
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    return stats;
+}
+
+void Spreadsheet::evaluateWave(RecalcStats& stats) {
+    size_t jobs = options.jobs != 0 ? options.jobs : std::max(1u, std::thread::hardware_concurrency());
+    size_t chunks = (wave.size() + WAVE_CHUNK - 1) / WAVE_CHUNK;
+    jobs = std::min(jobs, chunks);
+
+    if (jobs <= 1 || wave.size() < std::max<size_t>(options.parallelThreshold, 1)) {
+        for (uint32_t id : wave) {
+            evaluateCell(cells[id], vm, args);
+        }
+    } else {
+        // 同一层的单元格只读取更早层的结果，各线程写入互不相交的单元格
+        std::atomic<size_t> nextChunk{0};
+        auto work = [&](VirtualMachine& machine, std::vector<double>& values) {
+            size_t chunk;
+            while ((chunk = nextChunk.fetch_add(1)) < chunks) {
+                size_t end = std::min(wave.size(), (chunk + 1) * WAVE_CHUNK);
+                for (size_t i = chunk * WAVE_CHUNK; i < end; i++) {
+                    evaluateCell(cells[wave[i]], machine, values);
+                }
+            }
+        };
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < jobs; i++) {
+            threads.emplace_back([&]() {
+                VirtualMachine machine(options.jitThreshold);
+                std::vector<double> values;
+                work(machine, values);
+            });
+        }
+        work(vm, args);
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        stats.parallelLevels++;
+    }
+
+    stats.evaluated += wave.size();
+    for (uint32_t id : wave) {
+        if (!cells[id].status.ok()) {
+            stats.errors++;
+        }
+    }
+}
+
+void Spreadsheet::evaluateCell(Cell& cell, VirtualMachine& machine, std::vector<double>& values) {
+    values.resize(std::max(values.size(), cell.inputs.size()));
+    for (size_t slot = 0; slot < cell.inputs.size(); slot++) {
+        const Cell& input = cells[cell.inputs[slot]];
+        if (!input.defined) {
+            cell.status = Status(ErrorCode::UNBOUND_VARIABLE, 0, input.name);
+            return;
+        }
+        if (!input.status.ok()) {
+            cell.status = input.status;
+            return;
+        }
+        values[slot] = input.value;
+    }
+    Expected<double> result = machine.tryExecute(cell.program, values.data());
+    cell.status = result.error();
+    cell.value = result.value();
+}
+
+Expected<double> Spreadsheet::value(std::string_view name) const {
+    auto it = index.find(name);
+    if (it == index.end() || !cells[it->second].defined) {
+        return Status(ErrorCode::UNBOUND_VARIABLE, 0, name);
+    }
+    const Cell& cell = cells[it->second];
+    if (!cell.status.ok()) {
+        return cell.status;
+    }
+    return cell.value;
+}
+
+Expected<double> Spreadsheet::evaluate(const Program& program, VirtualMachine& machine) const {
+    std::vector<double> values(program.variables.size());
+    for (size_t slot = 0; slot < values.size(); slot++) {
+        Expected<double> input = value(program.variables[slot]);
+        if (!input.ok()) {
+            return input.error();
+        }
+        values[slot] = input.value();
+    }
+    return machine.tryExecute(program, values.empty() ? nullptr : values.data());
+}
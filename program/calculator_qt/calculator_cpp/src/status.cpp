@@ -0,0 +1,89 @@
+#include "status.h"
+
+ErrorKind Status::kind() const {
+    switch (code) {
+        case ErrorCode::OK:
+            return ErrorKind::NONE;
+        case ErrorCode::INVALID_NUMBER:
+        case ErrorCode::NUMBER_OUT_OF_RANGE:
+        case ErrorCode::UNKNOWN_CHARACTER:
+            return ErrorKind::LEXICAL;
+        case ErrorCode::TRAILING_INPUT:
+        case ErrorCode::EXPECTED_LPAREN:
+        case ErrorCode::MISSING_RPAREN:
+        case ErrorCode::UNEXPECTED_TOKEN:
+        case ErrorCode::ARITY_MISMATCH:
+        case ErrorCode::INVALID_ASSIGNMENT:
+        case ErrorCode::UNKNOWN_FUNCTION:
+        case ErrorCode::TOO_DEEP:
+            return ErrorKind::SYNTAX;
+        default:
+            return ErrorKind::EVALUATION;
+    }
+}
+
+std::string Status::detail() const {
+    switch (code) {
+        case ErrorCode::OK:
+            return std::string();
+        case ErrorCode::INVALID_NUMBER:
+            return "无效的数字格式: " + std::string(text);
+        case ErrorCode::NUMBER_OUT_OF_RANGE:
+            return "数字超出范围: " + std::string(text);
+        case ErrorCode::UNKNOWN_CHARACTER:
+            return "未知字符: " + std::string(text);
+        case ErrorCode::TRAILING_INPUT:
+            return "表达式解析完成后仍有未处理的字符";
+        case ErrorCode::EXPECTED_LPAREN:
+            return "函数调用需要左括号";
+        case ErrorCode::MISSING_RPAREN:
+            return "缺少右括号";
+        case ErrorCode::UNEXPECTED_TOKEN:
+            return "意外的标记";
+        case ErrorCode::ARITY_MISMATCH:
+            return std::string(function->name) + "函数需要" + std::to_string(function->arity) + "个参数";
+        case ErrorCode::INVALID_ASSIGNMENT:
+            return "赋值目标必须是变量名: " + std::string(text);
+        case ErrorCode::UNKNOWN_FUNCTION:
+            return "未知的函数: " + std::string(text);
+        case ErrorCode::TOO_DEEP:
+            return "表达式嵌套过深（超出解析上限）";
+        case ErrorCode::DIVISION_BY_ZERO:
+            return "除零错误";
+        case ErrorCode::DOMAIN_ERROR:
+            return function->domainError;
+        case ErrorCode::UNBOUND_VARIABLE:
+            return "未绑定的变量: " + std::string(text);
+        case ErrorCode::CYCLIC_DEPENDENCY:
+            return "循环引用: " + std::string(text);
+        case ErrorCode::NESTING_TOO_DEEP:
+            return "表达式嵌套过深";
+        case ErrorCode::INTERNAL_ERROR:
+            return std::string(text);
+    }
+    return std::string();
+}
+
+std::string Status::message() const {
+    switch (kind()) {
+        case ErrorKind::LEXICAL:
+            return LexicalError(detail()).what();
+        case ErrorKind::SYNTAX:
+            return SyntaxError(detail()).what();
+        case ErrorKind::EVALUATION:
+            return EvaluationError(detail()).what();
+        default:
+            return std::string();
+    }
+}
+
+void Status::raise() const {
+    switch (kind()) {
+        case ErrorKind::LEXICAL:
+            throw LexicalError(detail());
+        case ErrorKind::SYNTAX:
+            throw SyntaxError(detail());
+        default:
+            throw EvaluationError(detail());
+    }
+}
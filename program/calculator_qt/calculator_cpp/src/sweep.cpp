@@ -0,0 +1,84 @@
+#include "sweep.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+double parseNumber(const std::string& text, const std::string& spec) {
+    char* end = nullptr;
+    double value = std::strtod(text.c_str(), &end);
+    if (text.empty() || *end != '\0' || !std::isfinite(value)) {
+        throw CalcError("无效的扫描区间: " + spec);
+    }
+    return value;
+}
+
+} // namespace
+
+SweepSpec SweepSpec::parse(const std::string& text) {
+    size_t eq = text.find('=');
+    size_t colon1 = text.find(':', eq == std::string::npos ? 0 : eq);
+    size_t colon2 = colon1 == std::string::npos ? std::string::npos : text.find(':', colon1 + 1);
+    if (eq == std::string::npos || eq == 0 || colon2 == std::string::npos) {
+        throw CalcError("扫描区间格式应为 变量=起点:终点:步长，实际为: " + text);
+    }
+
+    SweepSpec spec;
+    spec.variable = text.substr(0, eq);
+    spec.start = parseNumber(text.substr(eq + 1, colon1 - eq - 1), text);
+    spec.stop = parseNumber(text.substr(colon1 + 1, colon2 - colon1 - 1), text);
+    spec.step = parseNumber(text.substr(colon2 + 1), text);
+    if (spec.step == 0 || (spec.stop - spec.start) / spec.step < 0) {
+        throw CalcError("扫描步长与区间方向不一致: " + text);
+    }
+    // 区间过大时步数可能溢出为无穷大，须在 count() 转换为 size_t 之前拒绝
+    double steps = (spec.stop - spec.start) / spec.step;
+    if (!std::isfinite(steps) || steps + 1 > MAX_POINTS) {
+        throw CalcError("扫描点数超出上限（1e12）: " + text);
+    }
+    return spec;
+}
+
+size_t SweepSpec::count() const {
+    // 容忍步长累计的舍入误差，使终点在数值上可达时被包含
+    double steps = (stop - start) / step;
+    return static_cast<size_t>(std::floor(steps + 1e-9)) + 1;
+}
+
+SweepStats runSweep(const Program& program, const SweepSpec& spec, ColumnEvaluator& evaluator) {
+    for (const std::string& name : program.variables) {
+        if (name != spec.variable) {
+            throw EvaluationError("未绑定的变量: " + name);
+        }
+    }
+
+    constexpr size_t CHUNK = 1 << 16;
+    std::vector<double> input(CHUNK);
+    std::vector<double> output(CHUNK);
+    const double* columns[] = {input.data()};
+
+    auto begin = std::chrono::steady_clock::now();
+    SweepStats stats;
+    stats.min = INFINITY;
+    stats.max = -INFINITY;
+    size_t total = spec.count();
+    for (size_t first = 0; first < total; first += CHUNK) {
+        size_t rows = std::min(CHUNK, total - first);
+        // 按下标直接计算取值，避免逐步累加带来的漂移
+        for (size_t i = 0; i < rows; i++) {
+            input[i] = spec.start + static_cast<double>(first + i) * spec.step;
+        }
+        evaluator.evaluate(program, program.variables.empty() ? nullptr : columns, rows, output.data());
+        for (size_t i = 0; i < rows; i++) {
+            stats.min = std::min(stats.min, output[i]);
+            stats.max = std::max(stats.max, output[i]);
+            stats.sum += output[i];
+        }
+    }
+    stats.points = total;
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    return stats;
+}
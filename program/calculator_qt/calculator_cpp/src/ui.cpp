@@ -1,4 +1,5 @@
 #include "ui.h"
+#include "double_format.h"
 #include <iostream>
 #include <limits>
 
@@ -19,6 +20,14 @@ void UI::showHelp() {
     std::cout << "  sin, cos, tan, log, ln, exp, sqrt, abs\n\n";
     std::cout << "支持的常量:\n";
     std::cout << "  pi, e\n\n";
+    std::cout << "变量:\n";
+    std::cout << "  其余标识符（如 x, y）视为变量，可通过赋值定义，或通过 --sweep 批量取值\n\n";
+    std::cout << "赋值:\n";
+    std::cout << "  a = 3, b = a*2 + sin(a)（重新赋值时只重算依赖它的变量）\n\n";
+    std::cout << "求导:\n";
+    std::cout << "  diff x^2 * sin(y)（输出表达式的值与对各变量的偏导数，变量取已赋值的值）\n\n";
+    std::cout << "其他命令:\n";
+    std::cout << "  stats (查看表达式缓存与优化统计)\n\n";
     std::cout << "示例:\n";
     std::cout << "  2 + 3 * 4\n";
     std::cout << "  sin(pi/2)\n";
@@ -26,19 +35,78 @@ void UI::showHelp() {
     std::cout << "=============================\n\n";
 }
 
-std::string UI::getUserInput() {
+bool UI::getUserInput(std::string& input) {
     std::cout << ">>> ";
-    std::string input;
-    std::getline(std::cin, input);
-    return input;
+    return static_cast<bool>(std::getline(std::cin, input));
 }
 
 void UI::showResult(double result) {
-    std::cout << "= " << result << "\n\n";
+    writeResult(std::cout, result);
+    std::cout << "\n\n";
 }
 
 void UI::showError(const std::string& error) {
-    std::cout << "错误: " << error << "\n\n";
+    writeError(std::cout, error);
+    std::cout << "\n\n";
+}
+
+void UI::writeResult(std::ostream& out, double result) {
+    char text[32];
+    out.write(text, static_cast<std::streamsize>(formatResult(text, sizeof(text), result)));
+}
+
+void UI::writeError(std::ostream& out, const std::string& error) {
+    out << "错误: " << error;
+}
+
+size_t UI::formatResult(char* buffer, size_t size, double result) {
+    if (size < 3) {
+        return 0;
+    }
+    buffer[0] = '=';
+    buffer[1] = ' ';
+    return 2 + format_shortest(buffer + 2, size - 2, result);
+}
+
+void UI::showCacheStats(const CacheStats& stats) {
+    size_t lookups = stats.hits + stats.misses;
+    double hitRate = lookups == 0 ? 0.0 : 100.0 * stats.hits / lookups;
+    std::cout << "缓存统计:\n";
+    std::cout << "  容量: " << stats.capacity << "  条目: " << stats.size << "\n";
+    std::cout << "  命中: " << stats.hits << "  未命中: " << stats.misses
+              << "  淘汰: " << stats.evictions << "  命中率: " << hitRate << "%\n\n";
+}
+
+void UI::showOptimizerStats(const OptimizerStats& stats) {
+    std::cout << "优化统计（最近一次编译的表达式）:\n";
+    std::cout << "  树节点: " << stats.nodesBefore << "  折叠后: " << stats.nodesAfter
+              << "  DAG 节点: " << stats.dagNodes << "\n\n";
+}
+
+void UI::showAssignment(std::string_view name, double value, const RecalcStats& stats) {
+    char text[DOUBLE_FORMAT_SHORTEST_SIZE + 2];
+    std::cout << name << " " << std::string_view(text, formatResult(text, sizeof(text), value)) << "\n";
+    std::cout << "  重算 " << stats.evaluated << " 个变量，共 " << stats.levels << " 层\n\n";
+}
+
+void UI::showGradient(double value, const std::vector<std::string>& names, const std::vector<double>& partials) {
+    writeResult(std::cout, value);
+    std::cout << "\n";
+    char text[DOUBLE_FORMAT_SHORTEST_SIZE];
+    for (size_t i = 0; i < names.size(); i++) {
+        std::cout << "  ∂/∂" << names[i] << " = "
+                  << std::string_view(text, format_shortest(text, sizeof(text), partials[i])) << "\n";
+    }
+    std::cout << "\n";
+}
+
+void UI::writeGradient(std::ostream& out, double value, const std::vector<std::string>& names,
+                       const std::vector<double>& partials) {
+    writeResult(out, value);
+    char text[DOUBLE_FORMAT_SHORTEST_SIZE];
+    for (size_t i = 0; i < names.size(); i++) {
+        out << "  ∂/∂" << names[i] << " = " << std::string_view(text, format_shortest(text, sizeof(text), partials[i]));
+    }
 }
 
 bool UI::shouldContinue() {
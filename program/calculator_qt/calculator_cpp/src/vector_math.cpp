@@ -0,0 +1,527 @@
+#include "vector_math.h"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CALC_HAVE_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+// 多项式系数与区间约简常数取自 fdlibm（Sun Microsystems 的可自由使用实现），算法按元素无分支地改写为向量形式
+
+namespace {
+
+#define ALWAYS_INLINE __attribute__((always_inline)) inline
+
+// 各级别的向量类型（GCC 向量扩展）：标量级别 1 个元素，SSE2 2 个，AVX2 4 个。
+// 函数核对每种宽度实例化一次；AVX2 的实例只内联进带 target 属性的入口函数，向量因而一律按引用传递，不涉及调用约定
+template <size_t N> struct Lanes;
+
+template <> struct Lanes<1> {
+    typedef double D __attribute__((vector_size(8)));
+    typedef int64_t I __attribute__((vector_size(8)));
+    typedef uint64_t U __attribute__((vector_size(8)));
+};
+
+template <> struct Lanes<2> {
+    typedef double D __attribute__((vector_size(16)));
+    typedef int64_t I __attribute__((vector_size(16)));
+    typedef uint64_t U __attribute__((vector_size(16)));
+};
+
+template <> struct Lanes<4> {
+    typedef double D __attribute__((vector_size(32)));
+    typedef int64_t I __attribute__((vector_size(32)));
+    typedef uint64_t U __attribute__((vector_size(32)));
+};
+
+#define LANE_TYPES(N)                                  \
+    using D [[maybe_unused]] = typename Lanes<N>::D;   \
+    using I [[maybe_unused]] = typename Lanes<N>::I;   \
+    using U [[maybe_unused]] = typename Lanes<N>::U
+
+// 加上 1.5·2^52 后按当前舍入方式取整，低位即整数值（要求 |x| < 2^51）
+constexpr double SHIFT = 0x1.8p52;
+constexpr int64_t SHIFT_BITS = 0x4338000000000000LL;
+constexpr uint64_t ABS_MASK = 0x7fffffffffffffffULL;
+constexpr uint64_t HIGH_WORD = 0xffffffff00000000ULL;
+
+// sin/cos/tan 的区间约简：x = q·π/2 + y，π/2 拆为三段各 33 位，q < 2^20 时各乘积精确
+constexpr double TRIG_LIMIT = 0x1p20 * 1.57079632679489655800e+00;
+constexpr double INV_PIO2 = 6.36619772367581382433e-01;
+constexpr double PIO2_1 = 1.57079632673412561417e+00;
+constexpr double PIO2_2 = 6.07710050630396597660e-11;
+constexpr double PIO2_2T = 2.02226624879595063154e-21;
+constexpr double PIO2_3 = 2.02226624871116645580e-21;
+constexpr double PIO2_3T = 8.47842766036889956997e-32;
+
+// [-π/4, π/4] 上的 sin 与 cos 逼近
+constexpr double S1 = -1.66666666666666324348e-01;
+constexpr double S2 = 8.33333333332248946124e-03;
+constexpr double S3 = -1.98412698298579493134e-04;
+constexpr double S4 = 2.75573137070700676789e-06;
+constexpr double S5 = -2.50507602534068634195e-08;
+constexpr double S6 = 1.58969099521155010221e-10;
+constexpr double C1 = 4.16666666666666019037e-02;
+constexpr double C2 = -1.38888888888741095749e-03;
+constexpr double C3 = 2.48015872894767294178e-05;
+constexpr double C4 = -2.75573143513906633035e-07;
+constexpr double C5 = 2.08757232129817482790e-09;
+constexpr double C6 = -1.13596475577881948265e-11;
+
+// [-π/4, π/4] 上的 tan 逼近；|y| ≥ 0.6744 时改为在 π/4 - |y| 上求值
+constexpr double T[] = {
+    3.33333333333334091986e-01, 1.33333333333201242699e-01, 5.39682539762260521377e-02,
+    2.18694882948595424599e-02, 8.86323982359930005737e-03, 3.59207910759131235356e-03,
+    1.45620945432529025516e-03, 5.88041240820264096874e-04, 2.46463134818469906812e-04,
+    7.81794442939557092300e-05, 7.14072491382608190305e-05, -1.85586374855275456654e-05,
+    2.59073051863633712884e-05,
+};
+constexpr double TAN_REFLECT = 0x1.59428p-1;
+constexpr double PIO4 = 7.85398163397448278999e-01;
+constexpr double PIO4_LO = 3.06161699786838301793e-17;
+
+// exp：x = k·ln2 + r，|r| ≤ ln2/2
+constexpr double LOG2E = 1.44269504088896338700e+00;
+constexpr double LN2_HI = 6.93147180369123816490e-01;
+constexpr double LN2_LO = 1.90821492927058770002e-10;
+constexpr double EXP_P1 = 1.66666666666666019037e-01;
+constexpr double EXP_P2 = -2.77777777770155933842e-03;
+constexpr double EXP_P3 = 6.61375632143793436117e-05;
+constexpr double EXP_P4 = -1.65339022054652515390e-06;
+constexpr double EXP_P5 = 4.13813679705723846039e-08;
+
+// ln / log10：x = 2^k·m，m ∈ [√2/2, √2)，s = (m - 1) / (m + 1)
+constexpr uint64_t SQRT_HALF_BITS = 0x3fe6a09e667f3bcdULL;
+constexpr double LG1 = 6.666666666666735130e-01;
+constexpr double LG2 = 3.999999999940941908e-01;
+constexpr double LG3 = 2.857142874366239149e-01;
+constexpr double LG4 = 2.222219843214978396e-01;
+constexpr double LG5 = 1.818357216161805012e-01;
+constexpr double LG6 = 1.531383769920937332e-01;
+constexpr double LG7 = 1.479819860511658591e-01;
+constexpr double LN2 = 6.93147180559945286227e-01;
+constexpr double IVLN10 = 4.34294481903251816668e-01;
+constexpr double IVLN10_HI = 4.34294481878168880939e-01;
+constexpr double IVLN10_LO = 2.50829467116452752298e-11;
+constexpr double LOG10_2_HI = 3.01029995663611771306e-01;
+constexpr double LOG10_2_LO = 3.69423907715893078616e-13;
+
+template <size_t N>
+ALWAYS_INLINE void loadLanes(const double* src, typename Lanes<N>::D& x) {
+    std::memcpy(&x, src, sizeof(x));
+}
+
+// 整数转双精度（|k| < 2^51）
+template <size_t N>
+ALWAYS_INLINE void toDouble(const typename Lanes<N>::I& k, typename Lanes<N>::D& out) {
+    LANE_TYPES(N);
+    out = (D)(k + SHIFT_BITS) - SHIFT;
+}
+
+// 将 y 乘以 2^k：分两步乘，使结果落入次正规数范围时只舍入一次，上溢时得到 inf
+template <size_t N>
+ALWAYS_INLINE void scaleByPowerOfTwo(typename Lanes<N>::D& y, const typename Lanes<N>::I& k) {
+    LANE_TYPES(N);
+    I k1 = (I)((U)(k + 2048) >> 1) - 1024;
+    I k2 = k - k1;
+    y = y * (D)((k1 + 1023) << 52) * (D)((k2 + 1023) << 52);
+}
+
+// 区间约简：π/2 的前两段（共 118 位）与 x 相减；约简结果相对 x 相消超过 49 位时再用第三段（共 151 位）。
+// 第三段以第二段的 r 为起点，只在该 r 的减法精确（相消足够多）时才能取代第二段，因此按元素选择。
+// ULP1 档同时给出尾项 y1（y0 + y1 为约简结果），ULP4 档不计尾项
+template <size_t N, bool Fast>
+ALWAYS_INLINE void reducePio2(const typename Lanes<N>::D& x, typename Lanes<N>::D& y0, typename Lanes<N>::D& y1,
+                              typename Lanes<N>::I& q) {
+    LANE_TYPES(N);
+    D t = x * INV_PIO2 + SHIFT;
+    D fn = t - SHIFT;
+    q = (I)t - SHIFT_BITS;
+    D u = x - fn * PIO2_1;
+    D w = fn * PIO2_2;
+    D r = u - w;
+    w = fn * PIO2_2T - ((u - r) - w);
+    y0 = r - w;
+    I third = (D)((U)y0 & ABS_MASK) < (D)((U)x & ABS_MASK) * 0x1p-49;
+    u = r;
+    D w3 = fn * PIO2_3;
+    D r3 = u - w3;
+    w3 = fn * PIO2_3T - ((u - r3) - w3);
+    r = third ? r3 : r;
+    w = third ? w3 : w;
+    y0 = r - w;
+    y1 = Fast ? D{} : (r - y0) - w;
+}
+
+template <size_t N, bool Fast>
+ALWAYS_INLINE void kernelSin(const typename Lanes<N>::D& x, const typename Lanes<N>::D& y,
+                             typename Lanes<N>::D& out) {
+    LANE_TYPES(N);
+    D z = x * x;
+    D w = z * z;
+    D r = S2 + z * (S3 + z * S4) + z * w * (S5 + z * S6);
+    D v = z * x;
+    if (Fast) {
+        out = x + v * (S1 + z * r);
+    } else {
+        out = x - ((z * (0.5 * y - v * r) - y) - v * S1);
+    }
+}
+
+template <size_t N, bool Fast>
+ALWAYS_INLINE void kernelCos(const typename Lanes<N>::D& x, const typename Lanes<N>::D& y,
+                             typename Lanes<N>::D& out) {
+    LANE_TYPES(N);
+    D z = x * x;
+    D w = z * z;
+    D r = z * (C1 + z * (C2 + z * C3)) + w * w * (C4 + z * (C5 + z * C6));
+    D hz = 0.5 * z;
+    if (Fast) {
+        out = (1.0 - hz) + z * r;
+    } else {
+        w = 1.0 - hz;
+        out = w + (((1.0 - w) - hz) + (z * r - x * y));
+    }
+}
+
+// 超出约简范围或非有限的元素逐个改用数学库
+template <size_t N>
+ALWAYS_INLINE void trigFallback(typename Lanes<N>::D& out, const typename Lanes<N>::D& x, double (*libm)(double)) {
+    LANE_TYPES(N);
+    I inRange = (D)((U)x & ABS_MASK) <= TRIG_LIMIT;
+    for (size_t i = 0; i < N; i++) {
+        if (inRange[i] == 0) {
+            out[i] = libm(x[i]);
+        }
+    }
+}
+
+// 象限 q & 3 为 0..3 时 sin(x) 依次为 sin(y)、cos(y)、-sin(y)、-cos(y)；cos(x) 相当于象限加一
+template <size_t N, bool Fast, int Quadrant>
+ALWAYS_INLINE void sinCos(typename Lanes<N>::D& x) {
+    LANE_TYPES(N);
+    D y0, y1, s, c;
+    I q;
+    reducePio2<N, Fast>(x, y0, y1, q);
+    kernelSin<N, Fast>(y0, y1, s);
+    kernelCos<N, Fast>(y0, y1, c);
+    q += Quadrant;
+    D result = (q & 1) != 0 ? c : s;
+    result = (D)((U)result ^ ((U)(q & 2) << 62));
+    trigFallback<N>(result, x, Quadrant == 0 ? static_cast<double (*)(double)>(std::sin)
+                                             : static_cast<double (*)(double)>(std::cos));
+    x = result;
+}
+
+template <size_t N, bool Fast>
+ALWAYS_INLINE void vsin(typename Lanes<N>::D& x) {
+    sinCos<N, Fast, 0>(x);
+}
+
+template <size_t N, bool Fast>
+ALWAYS_INLINE void vcos(typename Lanes<N>::D& x) {
+    sinCos<N, Fast, 1>(x);
+}
+
+// tan(x) 在偶数象限为 tan(y)，奇数象限为 -1/tan(y)
+template <size_t N, bool Fast>
+ALWAYS_INLINE void vtan(typename Lanes<N>::D& x) {
+    LANE_TYPES(N);
+    D y0, y1, result;
+    I q;
+    reducePio2<N, Fast>(x, y0, y1, q);
+    I odd = (q & 1) != 0;
+    if (Fast) {
+        D s, c;
+        kernelSin<N, true>(y0, y1, s);
+        kernelCos<N, true>(y0, y1, c);
+        result = (odd ? -c : s) / (odd ? s : c);
+    } else {
+        // |y| 接近 π/4 时在 π/4 - |y| 上求值：tan(π/4 - a) = (1 - tan a) / (1 + tan a)
+        I reflect = (D)((U)y0 & ABS_MASK) >= TAN_REFLECT;
+        I negative = y0 < 0.0;
+        D a = negative ? -y0 : y0;
+        D b = negative ? -y1 : y1;
+        D px = reflect ? (PIO4 - a) + (PIO4_LO - b) : y0;
+        D py = reflect ? D{} : y1;
+        D z = px * px;
+        D w = z * z;
+        D r = T[1] + w * (T[3] + w * (T[5] + w * (T[7] + w * (T[9] + w * T[11]))));
+        D v = z * (T[2] + w * (T[4] + w * (T[6] + w * (T[8] + w * (T[10] + w * T[12])))));
+        D s = z * px;
+        r = py + z * (s * (r + v) + py);
+        r += T[0] * s;
+        w = px + r;
+        // 反射分支：按象限取 ±1
+        D sign = odd ? D{} - 1.0 : D{} + 1.0;
+        D reflected = sign - 2.0 * (px - (w * w / (w + sign) - r));
+        reflected = negative ? -reflected : reflected;
+        // 奇数象限精确地计算 -1/(px + r)：将 w 与 -1/w 截去低 32 位后补偿
+        D hi = (D)((U)w & HIGH_WORD);
+        D lo = r - (hi - px);
+        D inverse = -1.0 / w;
+        D t = (D)((U)inverse & HIGH_WORD);
+        D e = 1.0 + t * hi;
+        D reciprocal = t + inverse * (e + t * lo);
+        result = reflect ? reflected : (odd ? reciprocal : w);
+    }
+    trigFallback<N>(result, x, std::tan);
+    x = result;
+}
+
+template <size_t N, bool Fast>
+ALWAYS_INLINE void vexp(typename Lanes<N>::D& x) {
+    LANE_TYPES(N);
+    // 夹到 [-746, 710]：此外的结果必为 0 或 inf，夹取后由缩放自然得到
+    D clamped = x > 710.0 ? D{} + 710.0 : x;
+    clamped = clamped < -746.0 ? D{} - 746.0 : clamped;
+    D t = clamped * LOG2E + SHIFT;
+    D kd = t - SHIFT;
+    I k = (I)t - SHIFT_BITS;
+    D hi = clamped - kd * LN2_HI;
+    D lo = kd * LN2_LO;
+    D r = hi - lo;
+    D y;
+    if (Fast) {
+        y = 1.0 + r * (1.0 + r * (1.0 / 2 + r * (1.0 / 6 + r * (1.0 / 24 + r * (1.0 / 120 + r * (1.0 / 720 +
+            r * (1.0 / 5040 + r * (1.0 / 40320 + r * (1.0 / 362880 + r * (1.0 / 3628800 +
+            r * (1.0 / 39916800 + r * (1.0 / 479001600))))))))))));
+    } else {
+        // exp(r) = 1 + 2r / (R(r) - r)，R 为 r² 的多项式，hi 与 lo 分别参与以免 r 的舍入误差放大
+        D z = r * r;
+        D c = r - z * (EXP_P1 + z * (EXP_P2 + z * (EXP_P3 + z * (EXP_P4 + z * EXP_P5))));
+        y = 1.0 - ((lo - (r * c) / (2.0 - c)) - hi);
+    }
+    scaleByPowerOfTwo<N>(y, k);
+    x = x != x ? x : y;
+}
+
+// ln 与 log10 共用的约简：x = 2^k·(1 + f)，返回 f、k、s = f / (2 + f) 与 R(s²)
+template <size_t N>
+ALWAYS_INLINE void reduceLog(const typename Lanes<N>::D& x, typename Lanes<N>::D& f, typename Lanes<N>::D& kd,
+                             typename Lanes<N>::D& s, typename Lanes<N>::D& R) {
+    LANE_TYPES(N);
+    // 次正规数先放大 2^54
+    I subnormal = x < 0x1p-1022;
+    D scaled = subnormal ? x * 0x1p54 : x;
+    U bits = (U)scaled;
+    U tmp = bits - SQRT_HALF_BITS;
+    I k = (I)((tmp + (1024ULL << 52)) >> 52) - 1024;
+    k += subnormal & -54;
+    D m = (D)(bits - (tmp & (0xfffULL << 52)));
+    toDouble<N>(k, kd);
+    f = m - 1.0;
+    s = f / (2.0 + f);
+    D z = s * s;
+    D w = z * z;
+    D t1 = w * (LG2 + w * (LG4 + w * LG6));
+    D t2 = z * (LG1 + w * (LG3 + w * (LG5 + w * LG7)));
+    R = t2 + t1;
+}
+
+// 定义域外：负数为 NaN，0 为 -inf，inf 与 NaN 保持不变
+template <size_t N>
+ALWAYS_INLINE void logSpecialCases(typename Lanes<N>::D& result, const typename Lanes<N>::D& x) {
+    LANE_TYPES(N);
+    result = x < 0.0 ? D{} + NAN : result;
+    result = x == 0.0 ? D{} - INFINITY : result;
+    result = x == INFINITY ? x : result;
+    result = x != x ? x : result;
+}
+
+template <size_t N, bool Fast>
+ALWAYS_INLINE void vln(typename Lanes<N>::D& x) {
+    LANE_TYPES(N);
+    D f, kd, s, R;
+    reduceLog<N>(x, f, kd, s, R);
+    D hfsq = 0.5 * f * f;
+    D result;
+    if (Fast) {
+        result = kd * LN2 + (f - hfsq + s * (hfsq + R));
+    } else {
+        result = kd * LN2_HI - ((hfsq - (s * (hfsq + R) + kd * LN2_LO)) - f);
+    }
+    logSpecialCases<N>(result, x);
+    x = result;
+}
+
+template <size_t N, bool Fast>
+ALWAYS_INLINE void vlog10(typename Lanes<N>::D& x) {
+    LANE_TYPES(N);
+    D f, kd, s, R;
+    reduceLog<N>(x, f, kd, s, R);
+    D hfsq = 0.5 * f * f;
+    D result;
+    if (Fast) {
+        result = (kd * LN2 + (f - hfsq + s * (hfsq + R))) * IVLN10;
+    } else {
+        // ln(1 + f) 拆为截去低 32 位的 hi 与 lo，分别乘 1/ln10 的高低两部分
+        D hi = (D)((U)(f - hfsq) & HIGH_WORD);
+        D lo = (f - hi) - hfsq + s * (hfsq + R);
+        D high = hi * IVLN10_HI;
+        D y2 = kd * LOG10_2_HI;
+        D low = kd * LOG10_2_LO + (lo + hi) * IVLN10_LO + lo * IVLN10_HI;
+        D w = y2 + high;
+        low += (y2 - w) + high;
+        result = low + w;
+    }
+    logSpecialCases<N>(result, x);
+    x = result;
+}
+
+template <size_t N, bool Fast>
+ALWAYS_INLINE void vabs(typename Lanes<N>::D& x) {
+    LANE_TYPES(N);
+    x = (D)((U)x & ABS_MASK);
+}
+
+// 开方由硬件指令完成，结果正确舍入。sqrtpd 属于 SSE2 基线，AVX2 级别拆成两半分别开方
+template <size_t N, bool Fast>
+ALWAYS_INLINE void vsqrt(typename Lanes<N>::D& x) {
+#ifdef CALC_HAVE_X86_SIMD
+    if constexpr (N == 4) {
+        __m128d lo = _mm_sqrt_pd((__m128d)__builtin_shufflevector(x, x, 0, 1));
+        __m128d hi = _mm_sqrt_pd((__m128d)__builtin_shufflevector(x, x, 2, 3));
+        x = __builtin_shufflevector((Lanes<2>::D)lo, (Lanes<2>::D)hi, 0, 1, 2, 3);
+        return;
+    } else if constexpr (N == 2) {
+        x = (typename Lanes<N>::D)_mm_sqrt_pd((__m128d)x);
+        return;
+    }
+#endif
+    for (size_t i = 0; i < N; i++) {
+        x[i] = std::sqrt(x[i]);
+    }
+}
+
+// 整段处理：每次 N 个元素，不足 N 个的尾部补 1.0（各函数的定义域内）后处理
+template <size_t N, void (*F)(typename Lanes<N>::D&)>
+ALWAYS_INLINE void apply(double* dst, size_t n) {
+    typename Lanes<N>::D x;
+    size_t i = 0;
+    for (; i + N <= n; i += N) {
+        loadLanes<N>(dst + i, x);
+        F(x);
+        std::memcpy(dst + i, &x, sizeof(x));
+    }
+    if (i < n) {
+        double tail[N];
+        for (size_t j = 0; j < N; j++) {
+            tail[j] = i + j < n ? dst[i + j] : 1.0;
+        }
+        loadLanes<N>(tail, x);
+        F(x);
+        std::memcpy(tail, &x, sizeof(x));
+        std::memcpy(dst + i, tail, (n - i) * sizeof(double));
+    }
+}
+
+template <void (*F)(Lanes<1>::D&)>
+void scalarKernel(double* dst, size_t n) {
+    apply<1, F>(dst, n);
+}
+
+#define MATH_KERNEL_TABLE(entry, fast)                                                                  \
+    {{entry<vsin<LANES, fast>>, entry<vcos<LANES, fast>>, entry<vtan<LANES, fast>>,                    \
+      entry<vlog10<LANES, fast>>, entry<vln<LANES, fast>>, entry<vexp<LANES, fast>>,                   \
+      entry<vsqrt<LANES, fast>>, entry<vabs<LANES, fast>>}}
+
+#define LANES 1
+const MathKernels SCALAR_ULP1 = MATH_KERNEL_TABLE(scalarKernel, false);
+const MathKernels SCALAR_ULP4 = MATH_KERNEL_TABLE(scalarKernel, true);
+#undef LANES
+
+// 数学库实现：逐元素调用，结果与逐行求值逐位一致
+#define DEFINE_LIBM_KERNEL(name, function)                \
+    void name(double* dst, size_t n) {                    \
+        for (size_t i = 0; i < n; i++) {                  \
+            dst[i] = function(dst[i]);                    \
+        }                                                 \
+    }
+
+DEFINE_LIBM_KERNEL(libmSin, std::sin)
+DEFINE_LIBM_KERNEL(libmCos, std::cos)
+DEFINE_LIBM_KERNEL(libmTan, std::tan)
+DEFINE_LIBM_KERNEL(libmLog10, std::log10)
+DEFINE_LIBM_KERNEL(libmLn, std::log)
+DEFINE_LIBM_KERNEL(libmExp, std::exp)
+DEFINE_LIBM_KERNEL(libmSqrt, std::sqrt)
+DEFINE_LIBM_KERNEL(libmAbs, std::fabs)
+
+const MathKernels LIBM_KERNELS = {
+    {libmSin, libmCos, libmTan, libmLog10, libmLn, libmExp, libmSqrt, libmAbs},
+};
+
+#ifdef CALC_HAVE_X86_SIMD
+
+// SSE2 是 x86-64 的基线指令集，无需运行时检测
+template <void (*F)(Lanes<2>::D&)>
+void sse2Kernel(double* dst, size_t n) {
+    apply<2, F>(dst, n);
+}
+
+// AVX2 实现只在这些函数上启用目标指令集（同时启用 FMA，多项式按乘加求值），调用前需经运行时检测确认
+template <void (*F)(Lanes<4>::D&)>
+__attribute__((target("avx2,fma"))) void avx2Kernel(double* dst, size_t n) {
+    apply<4, F>(dst, n);
+}
+
+#define LANES 2
+const MathKernels SSE2_ULP1 = MATH_KERNEL_TABLE(sse2Kernel, false);
+const MathKernels SSE2_ULP4 = MATH_KERNEL_TABLE(sse2Kernel, true);
+#undef LANES
+
+#define LANES 4
+const MathKernels AVX2_ULP1 = MATH_KERNEL_TABLE(avx2Kernel, false);
+const MathKernels AVX2_ULP4 = MATH_KERNEL_TABLE(avx2Kernel, true);
+#undef LANES
+
+#endif // CALC_HAVE_X86_SIMD
+
+} // namespace
+
+const char* mathFunctionName(MathFunction function) {
+    static const char* const names[] = {"sin", "cos", "tan", "log", "ln", "exp", "sqrt", "abs"};
+    return function < MATH_FUNCTION_COUNT ? names[function] : "none";
+}
+
+const char* mathAccuracyName(MathAccuracy accuracy) {
+    switch (accuracy) {
+        case MATH_ULP1: return "ulp1";
+        case MATH_ULP4: return "ulp4";
+        default: return "libm";
+    }
+}
+
+bool parseMathAccuracy(const std::string& name, MathAccuracy& accuracy) {
+    for (MathAccuracy candidate : {MATH_LIBM, MATH_ULP1, MATH_ULP4}) {
+        if (name == mathAccuracyName(candidate)) {
+            accuracy = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+const MathKernels& mathKernels(SimdLevel level, MathAccuracy accuracy) {
+    if (accuracy == MATH_LIBM) {
+        return LIBM_KERNELS;
+    }
+    if (level > detectSimdLevel()) {
+        level = detectSimdLevel();
+    }
+    bool fast = accuracy == MATH_ULP4;
+    switch (level) {
+#ifdef CALC_HAVE_X86_SIMD
+        case SIMD_AVX2:
+            if (__builtin_cpu_supports("fma")) {
+                return fast ? AVX2_ULP4 : AVX2_ULP1;
+            }
+            return fast ? SSE2_ULP4 : SSE2_ULP1;
+        case SIMD_SSE2: return fast ? SSE2_ULP4 : SSE2_ULP1;
+#endif
+        default: return fast ? SCALAR_ULP4 : SCALAR_ULP1;
+    }
+}
@@ -0,0 +1,89 @@
+#include "vm.h"
+#include "jit.h"
+#include <cmath>
+
+double VirtualMachine::execute(const Program& program, const double* variables) {
+    return tryExecute(program, variables).valueOrThrow();
+}
+
+Expected<double> VirtualMachine::tryExecute(const Program& program, const double* variables) {
+    if (jitThreshold != 0) {
+        ProgramTier& tier = program.tier;
+        if (tier.native) {
+            return tier.native->run(program, variables);
+        }
+        if (!tier.jitFailed && ++tier.executions >= jitThreshold) {
+            tier.native = JitCode::compile(program);
+            tier.jitFailed = !tier.native;
+        }
+    }
+    return interpret(program, variables);
+}
+
+Expected<double> VirtualMachine::interpret(const Program& program, const double* variables) {
+    if (variables == nullptr && !program.variables.empty()) {
+        return Status(ErrorCode::UNBOUND_VARIABLE, 0, program.variables[0]);
+    }
+
+    double* sp = stack.data();   // 指向下一个空闲槽位
+    const double* constants = program.constants.data();
+
+    for (const Instruction& ins : program.code) {
+        switch (ins.op) {
+            case OP_PUSH_CONST:
+                *sp++ = constants[ins.operand];
+                break;
+            case OP_LOAD_VAR:
+                *sp++ = variables[ins.operand];
+                break;
+            case OP_ADD:
+                sp--;
+                sp[-1] += sp[0];
+                break;
+            case OP_SUB:
+                sp--;
+                sp[-1] -= sp[0];
+                break;
+            case OP_MUL:
+                sp--;
+                sp[-1] *= sp[0];
+                break;
+            case OP_DIV:
+                sp--;
+                if (sp[0] == 0) {
+                    return Status(ErrorCode::DIVISION_BY_ZERO);
+                }
+                sp[-1] /= sp[0];
+                break;
+            case OP_POW:
+                sp--;
+                sp[-1] = std::pow(sp[-1], sp[0]);
+                break;
+            case OP_NEG:
+                sp[-1] = -sp[-1];
+                break;
+            case OP_CALL: {
+                // 参数在栈上连续存放，直接作为函数的参数数组，结果覆盖第一个参数
+                sp -= ins.argc;
+                const Functions::Info* function = program.functions[ins.operand];
+                if (!function->accepts(sp)) {
+                    return Status(ErrorCode::DOMAIN_ERROR, 0, std::string_view(), function);
+                }
+                *sp = function->function(sp);
+                sp++;
+                break;
+            }
+            case OP_STORE_TEMP:
+                temps[ins.operand] = sp[-1];
+                break;
+            case OP_LOAD_TEMP:
+                *sp++ = temps[ins.operand];
+                break;
+        }
+    }
+
+    if (sp != stack.data() + 1) {
+        return Status(ErrorCode::INTERNAL_ERROR, 0, "字节码栈不平衡");
+    }
+    return stack[0];
+}
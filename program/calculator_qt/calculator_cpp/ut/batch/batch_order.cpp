@@ -0,0 +1,90 @@
+// 单元测试：多线程批量求值的输出与单线程逐行求值一致，且保持输入顺序；只含空白的行输出空行；工作线程内存不足时不挂起
+#include "batch.h"
+#include "allocation_counter.h"
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+int main() {
+    static const char* const lines[] = {
+        "2 + 3 * 4", "sin(pi/2)", "", " \t ", "1 / 0", "sqrt(-1)", "foo + 1",
+        "((((((2+3)*4)-5)/6)^2)+1)", "2^10", "  abs(-5) \r", "(1 + 2",
+    };
+
+    std::string input;
+    for (int round = 0; round < 200; round++) {
+        for (const char* line : lines) {
+            input += line;
+            input += '\n';
+        }
+        input += std::to_string(round) + " * 3\n";
+    }
+
+    BatchOptions sequential;
+    sequential.jobs = 1;
+    sequential.chunkLines = 1 << 20;
+    std::ostringstream expected;
+    BatchStats expectedStats = BatchEvaluator(sequential).run(input, expected);
+
+    BatchOptions parallel;
+    parallel.jobs = 4;
+    parallel.chunkLines = 7;   // 故意取小且与输入周期互质，制造大量交错的任务块
+    std::ostringstream actual;
+    BatchStats actualStats = BatchEvaluator(parallel).run(input, actual);
+
+    if (actual.str() != expected.str()) {
+        std::fprintf(stderr, "测试失败：并行输出与顺序输出不一致\n");
+        return 1;
+    }
+    if (actualStats.lines != 200 * 12 || actualStats.errors != expectedStats.errors || actualStats.errors != 200 * 4) {
+        std::fprintf(stderr, "测试失败：统计不符 lines=%zu errors=%zu\n", actualStats.lines, actualStats.errors);
+        return 1;
+    }
+
+    // 抽查逐行对应关系
+    std::istringstream result(actual.str());
+    std::string line;
+    std::getline(result, line);
+    if (line != "= 14") {
+        std::fprintf(stderr, "测试失败：第一行期望 '= 14'，实际 '%s'\n", line.c_str());
+        return 1;
+    }
+    std::getline(result, line);
+    std::getline(result, line);
+    if (!line.empty()) {
+        std::fprintf(stderr, "测试失败：空行应原样保留\n");
+        return 1;
+    }
+    std::getline(result, line);
+    if (!line.empty()) {
+        std::fprintf(stderr, "测试失败：只含空白的行应输出空行，实际 '%s'\n", line.c_str());
+        return 1;
+    }
+    std::getline(result, line);
+    if (line.rfind("错误: ", 0) != 0) {
+        std::fprintf(stderr, "测试失败：第五行期望错误信息，实际 '%s'\n", line.c_str());
+        return 1;
+    }
+
+    // 工作线程的分配失败：失败的任务块每行输出一行错误，run 照常返回，逐行对应不变
+    {
+        worker_allocation_failures = 1;
+        std::ostringstream failed;
+        BatchStats failedStats = BatchEvaluator(parallel).run(input, failed);
+        worker_allocation_failures = 0;
+        std::string text = failed.str();
+        size_t outputLines = 0;
+        for (char c : text) {
+            outputLines += c == '\n';
+        }
+        if (outputLines != failedStats.lines || failedStats.errors <= expectedStats.errors ||
+            text.find("错误: 未知错误: std::bad_alloc\n") == std::string::npos) {
+            std::fprintf(stderr, "测试失败：分配失败后输出 %zu 行（期望 %zu 行），%zu 个错误\n", outputLines,
+                         failedStats.lines, failedStats.errors);
+            return 1;
+        }
+    }
+
+    std::printf("批量求值单元测试通过\n");
+    return 0;
+}
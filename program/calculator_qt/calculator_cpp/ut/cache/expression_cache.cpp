@@ -0,0 +1,76 @@
+// 单元测试：表达式缓存的键规范化、LRU 淘汰顺序与统计计数
+#include "expression_cache.h"
+#include <cstdio>
+
+static Program make_program(double value) {
+    Program program;
+    program.constants.push_back(value);
+    program.code.push_back(Instruction{OP_PUSH_CONST, 0, 0});
+    program.maxStack = 1;
+    return program;
+}
+
+int main() {
+    /* 1) 规范化：空白不敏感，但不合并相邻的数字/标识符 */
+    {
+        struct { const char* input; const char* key; } cases[] = {
+            {"2+3", "2+3"},
+            {"  2 +\t3  ", "2+3"},
+            {"sin ( pi / 2 )", "sin(pi/2)"},
+            {"1 2", "1 2"},
+            {"1   2", "1 2"},
+            {"1.5e-3 * 2", "1.5e-3*2"},
+            {"1e -3", "1e -3"},
+            {"1e- 3", "1e- 3"},
+            {"", ""},
+        };
+        for (const auto& c : cases) {
+            std::string key = ExpressionCache::normalize(c.input);
+            if (key != c.key) {
+                std::fprintf(stderr, "测试失败：normalize('%s') 期望 '%s'，实际 '%s'\n", c.input, c.key, key.c_str());
+                return 1;
+            }
+        }
+    }
+
+    /* 2) LRU 淘汰顺序与计数 */
+    {
+        ExpressionCache cache(2);
+        cache.insert("a", make_program(1));
+        cache.insert("b", make_program(2));
+        if (cache.find("a") == nullptr) {       // a 变为最近使用
+            std::fprintf(stderr, "测试失败：期望命中 a\n");
+            return 1;
+        }
+        cache.insert("c", make_program(3));     // 淘汰 b
+        if (cache.find("b") != nullptr) {
+            std::fprintf(stderr, "测试失败：b 应已被淘汰\n");
+            return 1;
+        }
+        const Program* a = cache.find("a");
+        const Program* c = cache.find("c");
+        if (a == nullptr || c == nullptr || a->constants[0] != 1 || c->constants[0] != 3) {
+            std::fprintf(stderr, "测试失败：a、c 应仍在缓存中\n");
+            return 1;
+        }
+        const CacheStats& stats = cache.stats();
+        if (stats.hits != 3 || stats.misses != 1 || stats.evictions != 1 || stats.size != 2 || stats.capacity != 2) {
+            std::fprintf(stderr, "测试失败：统计不符 hits=%zu misses=%zu evictions=%zu size=%zu\n",
+                         stats.hits, stats.misses, stats.evictions, stats.size);
+            return 1;
+        }
+    }
+
+    /* 3) 容量为 0 时不缓存，但插入返回的程序仍可使用 */
+    {
+        ExpressionCache cache(0);
+        const Program& program = cache.insert("a", make_program(7));
+        if (program.constants[0] != 7 || cache.find("a") != nullptr || cache.stats().size != 0) {
+            std::fprintf(stderr, "测试失败：容量为 0 时的行为不符\n");
+            return 1;
+        }
+    }
+
+    std::printf("表达式缓存单元测试通过\n");
+    return 0;
+}
@@ -0,0 +1,163 @@
+// 单元测试：各指令集级别的列式求值与逐行虚拟机求值逐位一致；向量数学核档位在误差范围内一致
+#include "parser.h"
+#include "optimizer.h"
+#include "compiler.h"
+#include "vm.h"
+#include "column_evaluator.h"
+#include "sweep.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+static Program compile(const char* input) {
+    AstArena arena;
+    Parser parser(input, arena);
+    NodeId root = Optimizer().optimize(arena, parser.parse());
+    return Compiler::compile(arena, root);
+}
+
+static bool same_bits(double a, double b) {
+    return std::memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+int main() {
+    static const char* const inputs[] = {
+        "x + y",
+        "x * y - x / (y + 0.5) + 1",
+        "-x ^ 2 + y ^ 0.5",
+        "-(x * 3) / 7 - -y",
+        "sin(x) * cos(y) + sqrt(abs(x * y))",
+        "x * 1 + 0 * y",
+        "2 * pi * x",
+    };
+
+    // 行数取非块大小、非向量宽度倍数，覆盖尾部处理
+    const size_t count = ColumnEvaluator::BLOCK_SIZE * 3 + 7;
+    std::vector<double> xs(count), ys(count), out(count);
+    for (size_t i = 0; i < count; i++) {
+        xs[i] = -50.0 + 0.37 * static_cast<double>(i);
+        ys[i] = 0.25 + 0.011 * static_cast<double>(i);
+    }
+
+    VirtualMachine vm;
+    const SimdLevel levels[] = {SIMD_SCALAR, SIMD_SSE2, SIMD_AVX2};
+    for (const char* input : inputs) {
+        Program program = compile(input);
+        // 按 Program::variables 的槽位顺序组织输入列
+        std::vector<const double*> columns;
+        for (const std::string& name : program.variables) {
+            columns.push_back(name == "x" ? xs.data() : ys.data());
+        }
+        for (SimdLevel level : levels) {
+            ColumnEvaluator evaluator(level);
+            evaluator.evaluate(program, columns.data(), count, out.data());
+            for (size_t i = 0; i < count; i++) {
+                double vars[2];
+                for (size_t slot = 0; slot < program.variables.size(); slot++) {
+                    vars[slot] = columns[slot][i];
+                }
+                double expected = vm.execute(program, vars);
+                if (!same_bits(out[i], expected)) {
+                    std::fprintf(stderr, "测试失败：'%s' [%s] 第 %zu 行期望 %.17g，实际 %.17g\n",
+                                 input, simdLevelName(evaluator.level()), i, expected, out[i]);
+                    return 1;
+                }
+            }
+        }
+    }
+
+    // 向量数学核档位：与逐行求值的相对误差在几个 ULP 之内，定义域外的行仍报告错误
+    {
+        Program program = compile("sin(x) * cos(y) + tan(x / 100) - exp(y / 10) + ln(y) + log(y) + sqrt(abs(x))");
+        std::vector<const double*> columns;
+        for (const std::string& name : program.variables) {
+            columns.push_back(name == "x" ? xs.data() : ys.data());
+        }
+        for (MathAccuracy accuracy : {MATH_ULP1, MATH_ULP4}) {
+            for (SimdLevel level : levels) {
+                ColumnEvaluator evaluator(level, accuracy);
+                evaluator.evaluate(program, columns.data(), count, out.data());
+                for (size_t i = 0; i < count; i++) {
+                    double vars[] = {columns[0][i], columns[1][i]};
+                    double expected = vm.execute(program, vars);
+                    if (std::fabs(out[i] - expected) > 1e-13 * (std::fabs(expected) + 1.0)) {
+                        std::fprintf(stderr, "测试失败：%s [%s] 第 %zu 行期望 %.17g，实际 %.17g\n",
+                                     mathAccuracyName(accuracy), simdLevelName(level), i, expected, out[i]);
+                        return 1;
+                    }
+                }
+            }
+        }
+        Program root = compile("sqrt(x)");
+        const double* xColumn[] = {xs.data()};
+        ColumnEvaluator evaluator(detectSimdLevel(), MATH_ULP4);
+        bool thrown = false;
+        try {
+            evaluator.evaluate(root, xColumn, count, out.data());
+        } catch (const EvaluationError&) {
+            thrown = true;
+        }
+        if (!thrown) {
+            std::fprintf(stderr, "测试失败：向量数学核未报告 sqrt 的定义域错误\n");
+            return 1;
+        }
+    }
+
+    // 列中出现零除数时报告除零错误
+    {
+        Program program = compile("1 / x");
+        const double* columns[] = {xs.data()};
+        std::vector<double> zeros(count, 1.0);
+        zeros[count - 1] = 0.0;
+        columns[0] = zeros.data();
+        ColumnEvaluator evaluator;
+        bool thrown = false;
+        try {
+            evaluator.evaluate(program, columns, count, out.data());
+        } catch (const EvaluationError&) {
+            thrown = true;
+        }
+        if (!thrown) {
+            std::fprintf(stderr, "测试失败：零除数未报告除零错误\n");
+            return 1;
+        }
+    }
+
+    // 扫描区间解析与汇总
+    {
+        SweepSpec spec = SweepSpec::parse("x=0:1:0.001");
+        if (spec.variable != "x" || spec.count() != 1001) {
+            std::fprintf(stderr, "测试失败：扫描区间解析错误，点数 %zu\n", spec.count());
+            return 1;
+        }
+        Program program = compile("2 * x + 1");
+        ColumnEvaluator evaluator;
+        SweepStats stats = runSweep(program, spec, evaluator);
+        if (stats.points != 1001 || stats.min != 1.0 || stats.max != 3.0 || std::fabs(stats.sum / 1001 - 2.0) > 1e-12) {
+            std::fprintf(stderr, "测试失败：扫描汇总不符 min=%g max=%g\n", stats.min, stats.max);
+            return 1;
+        }
+    }
+
+    // 点数不是有限值或超出上限的扫描区间在解析时拒绝
+    for (const char* text : {"x=0:1e300:1", "x=-1e308:1e308:1e-300", "x=0:1e12:1"}) {
+        bool thrown = false;
+        try {
+            SweepSpec::parse(text);
+        } catch (const CalcError&) {
+            thrown = true;
+        }
+        if (!thrown) {
+            std::fprintf(stderr, "测试失败：扫描区间 %s 应报告点数超出上限\n", text);
+            return 1;
+        }
+    }
+    if (SweepSpec::parse("x=0:1e7:0.001").count() != 10000000001u) {
+        std::fprintf(stderr, "测试失败：上限以内的扫描区间点数不符\n");
+        return 1;
+    }
+
+    std::printf("列式求值单元测试通过\n");
+    return 0;
+}
@@ -0,0 +1,163 @@
+// 单元测试：结构相同的子树合并为 DAG 后，树求值、字节码与本机代码的结果逐位不变，
+// 共享节点每次求值只计算一次
+#include "parser.h"
+#include "calculator.h"
+#include "optimizer.h"
+#include "dag.h"
+#include "compiler.h"
+#include "vm.h"
+#include "jit.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+static bool same_bits(double a, double b) {
+    return std::memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+struct Shape {
+    const char* input;
+    size_t treeNodes;
+    size_t dagNodes;
+    size_t sharedNodes;
+};
+
+// 节点计数：叶节点也会合并，但只有内部节点标记为共享
+static int check_shape(const Shape& shape) {
+    AstArena arena;
+    DagBuilder dag;
+    dag.build(arena, Parser(shape.input, arena).parse());
+    const DagStats& stats = dag.stats();
+    if (stats.treeNodes != shape.treeNodes || stats.dagNodes != shape.dagNodes ||
+        stats.sharedNodes != shape.sharedNodes) {
+        std::fprintf(stderr, "测试失败：'%s' 节点数 %zu/%zu/%zu，期望 %zu/%zu/%zu\n", shape.input,
+                     stats.treeNodes, stats.dagNodes, stats.sharedNodes,
+                     shape.treeNodes, shape.dagNodes, shape.sharedNodes);
+        return 1;
+    }
+    return 0;
+}
+
+// 合并前后，树求值、虚拟机与本机代码的结果逐位一致
+static int check_same_value(const char* input, const double* variables) {
+    AstArena arena;
+    Calculator calc;
+    NodeId root = Parser(input, arena).parse();
+    double expected = calc.evaluate(arena, root, variables);
+    size_t treeVisits = calc.evaluatedNodes();
+
+    root = DagBuilder().build(arena, root);
+    double shared = calc.evaluate(arena, root, variables);
+    if (!same_bits(expected, shared) || calc.evaluatedNodes() >= treeVisits) {
+        std::fprintf(stderr, "测试失败：'%s' 合并前 %.17g（%zu 个节点），合并后 %.17g（%zu 个节点）\n", input,
+                     expected, treeVisits, shared, calc.evaluatedNodes());
+        return 1;
+    }
+    // 第二次求值不得复用上一次的结果
+    double changed[2] = {variables[0] + 1.0, variables[1]};
+    double fresh = calc.evaluate(arena, root, changed);
+    if (same_bits(fresh, shared)) {
+        std::fprintf(stderr, "测试失败：'%s' 变量改变后结果未变，共享节点的缓存跨越了求值\n", input);
+        return 1;
+    }
+
+    Program program = Compiler::compile(arena, root);
+    if (program.temps == 0) {
+        std::fprintf(stderr, "测试失败：'%s' 编译后没有使用临时槽位\n", input);
+        return 1;
+    }
+    VirtualMachine vm;
+    double interpreted = vm.execute(program, variables);
+    if (!same_bits(expected, interpreted)) {
+        std::fprintf(stderr, "测试失败：'%s' 字节码结果 %.17g，期望 %.17g\n", input, interpreted, expected);
+        return 1;
+    }
+    if (JitCode::available()) {
+        std::unique_ptr<JitCode> native = JitCode::compile(program);
+        Expected<double> result = native ? native->run(program, variables) : Expected<double>(Status(ErrorCode::INTERNAL_ERROR));
+        if (!result.ok() || !same_bits(expected, result.value())) {
+            std::fprintf(stderr, "测试失败：'%s' 本机代码结果与树求值不一致\n", input);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// 共享节点只计算一次：同一函数调用出现三次，树求值只访问一次其子树
+static int check_computed_once() {
+    AstArena arena;
+    Calculator calc;
+    Optimizer optimizer;
+    NodeId root = optimizer.optimize(arena, Parser("sqrt(x) + sqrt(x) * sqrt(x)", arena).parse());
+    double x = 16.0;
+    double result = calc.evaluate(arena, root, &x);
+    // 计算的节点: +, *, sqrt, x
+    if (result != 20.0 || calc.evaluatedNodes() != 4 || optimizer.stats().dagNodes != 4) {
+        std::fprintf(stderr, "测试失败：共享的 sqrt(x) 被重复计算（%zu 个节点）\n", calc.evaluatedNodes());
+        return 1;
+    }
+    return 0;
+}
+
+// 常量按位比较：折叠后的 -0 与 0 不合并
+static int check_signed_zero() {
+    AstArena arena;
+    Optimizer optimizer;
+    NodeId root = optimizer.optimize(arena, Parser("0 * x + -0 * x", arena).parse());
+    double x = -1.0;
+    double result = Calculator().evaluate(arena, root, &x);
+    if (optimizer.stats().dagNodes != 6 || !same_bits(result, 0.0)) {
+        std::fprintf(stderr, "测试失败：-0 与 0 被合并（%zu 个节点，结果 %g）\n", optimizer.stats().dagNodes, result);
+        return 1;
+    }
+    return 0;
+}
+
+// 共享节点上的错误照常报告
+static int check_error_kept() {
+    AstArena arena;
+    Optimizer optimizer;
+    NodeId root = optimizer.optimize(arena, Parser("sqrt(x) + sqrt(x)", arena).parse());
+    double x = -1.0;
+    Expected<double> tree = Calculator().tryEvaluate(arena, root, &x);
+    Expected<double> bytecode = VirtualMachine().tryExecute(Compiler::compile(arena, root), &x);
+    if (tree.ok() || bytecode.ok() || tree.error().code != ErrorCode::DOMAIN_ERROR ||
+        bytecode.error().code != ErrorCode::DOMAIN_ERROR) {
+        std::fprintf(stderr, "测试失败：共享节点上的定义域错误未被报告\n");
+        return 1;
+    }
+    return 0;
+}
+
+int main() {
+    const Shape shapes[] = {
+        {"sin(x)^2 + cos(x)^2 + sin(x)*cos(x)", 15, 9, 2},
+        {"(x + 1) * (x + 1)", 7, 4, 1},
+        // 函数参数中的公共子表达式
+        {"sin(x * y) + cos(x * y)", 9, 6, 1},
+        {"1 + 2", 3, 3, 0},
+    };
+    for (const Shape& shape : shapes) {
+        if (check_shape(shape) != 0) {
+            return 1;
+        }
+    }
+
+    const double variables[2] = {0.75, -2.5};
+    const char* const inputs[] = {
+        "sin(x)^2 + cos(x)^2 + sin(x)*cos(x)",
+        "exp(x * y) / (1 + exp(x * y)) - abs(x * y)",
+        "((x - y) ^ 2 + (x - y)) * ((x - y) ^ 2 + (x - y))",
+    };
+    for (const char* input : inputs) {
+        if (check_same_value(input, variables) != 0) {
+            return 1;
+        }
+    }
+
+    if (check_computed_once() != 0 || check_signed_zero() != 0 || check_error_kept() != 0) {
+        return 1;
+    }
+    std::printf("DAG 公共子表达式单元测试通过\n");
+    return 0;
+}
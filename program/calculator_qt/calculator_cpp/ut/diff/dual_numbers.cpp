@@ -0,0 +1,178 @@
+// 单元测试：前向模式自动微分与符号求导的结果一致，且与有限差分相符
+#include "parser.h"
+#include "calculator.h"
+#include "derivative.h"
+#include "optimizer.h"
+#include "compiler.h"
+#include "vm.h"
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+static bool close(double actual, double expected, double tolerance) {
+    if (std::isnan(expected) || std::isinf(expected)) {
+        return actual == expected || (std::isnan(actual) && std::isnan(expected));
+    }
+    return std::fabs(actual - expected) <= tolerance * std::fmax(1.0, std::fabs(expected));
+}
+
+// 在 point 处比较：对偶数的值等于 Calculator 的值；偏导数与符号导数（经优化并编译执行）一致，与中心差分相符
+static int check_gradient(const char* input, const std::vector<double>& point) {
+    AstArena arena;
+    Parser parser(input, arena);
+    NodeId root = parser.parse();
+    size_t count = arena.variableCount();
+    if (count != point.size()) {
+        std::fprintf(stderr, "测试失败：'%s' 变量个数 %zu 与取值个数不符\n", input, count);
+        return 1;
+    }
+
+    Calculator calc;
+    double expected = calc.evaluate(arena, root, point.data());
+    DualEvaluator dual;
+    std::vector<double> gradient(count);
+    double value = dual.evaluate(arena, root, point.data(), gradient.data());
+    if (value != expected) {
+        std::fprintf(stderr, "测试失败：'%s' 对偶数求值 %.17g，期望 %.17g\n", input, value, expected);
+        return 1;
+    }
+
+    Optimizer optimizer;
+    VirtualMachine vm;
+    for (uint32_t slot = 0; slot < count; slot++) {
+        NodeId derivative = optimizer.optimize(arena, Differentiator::differentiate(arena, root, slot));
+        double symbolic = vm.execute(Compiler::compile(arena, derivative), point.data());
+        if (!close(gradient[slot], symbolic, 1e-14)) {
+            std::fprintf(stderr, "测试失败：'%s' 对 %s 的偏导数：对偶数 %.17g，符号求导 %.17g\n", input,
+                         std::string(arena.variableName(slot)).c_str(), gradient[slot], symbolic);
+            return 1;
+        }
+
+        std::vector<double> shifted = point;
+        double h = 1e-6 * std::fmax(1.0, std::fabs(point[slot]));
+        shifted[slot] = point[slot] + h;
+        double upper = calc.evaluate(arena, root, shifted.data());
+        shifted[slot] = point[slot] - h;
+        double lower = calc.evaluate(arena, root, shifted.data());
+        double difference = (upper - lower) / (2 * h);
+        if (!close(gradient[slot], difference, 1e-6)) {
+            std::fprintf(stderr, "测试失败：'%s' 对 %s 的偏导数 %.17g，中心差分 %.17g\n", input,
+                         std::string(arena.variableName(slot)).c_str(), gradient[slot], difference);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// 对偶数求值报告与 Calculator 相同的错误码
+static int check_error(const char* input, const std::vector<double>& point, ErrorCode code) {
+    AstArena arena;
+    Parser parser(input, arena);
+    NodeId root = parser.parse();
+    DualEvaluator dual;
+    std::vector<double> gradient(arena.variableCount());
+    Expected<double> result = dual.tryEvaluate(arena, root, point.empty() ? nullptr : point.data(), gradient.data());
+    if (result.ok() || result.error().code != code) {
+        std::fprintf(stderr, "测试失败：'%s' 未报告期望的错误\n", input);
+        return 1;
+    }
+    return 0;
+}
+
+// 符号导数折叠后的节点数
+static int check_folded(const char* input, uint32_t slot, size_t nodes) {
+    AstArena arena;
+    Parser parser(input, arena);
+    NodeId root = parser.parse();
+    Optimizer optimizer;
+    NodeId derivative = optimizer.optimize(arena, Differentiator::differentiate(arena, root, slot));
+    if (arena.treeSize(derivative) != nodes) {
+        std::fprintf(stderr, "测试失败：'%s' 的导数折叠后 %zu 个节点，期望 %zu 个\n", input,
+                     arena.treeSize(derivative), nodes);
+        return 1;
+    }
+    return 0;
+}
+
+int main() {
+    struct Case {
+        const char* input;
+        std::vector<double> point;
+    };
+    const Case cases[] = {
+        {"x + y", {1.5, -2.0}},
+        {"x - y * 3", {1.5, -2.0}},
+        {"x * y / (x + 1)", {0.7, 2.5}},
+        {"-x + +y", {0.7, 2.5}},
+        {"x ^ 3", {1.3}},
+        {"2 ^ x", {0.8}},
+        {"x ^ y", {1.7, 2.3}},
+        {"pi * x ^ 2 - e / y", {0.9, 1.1}},
+        {"sin(x) * cos(y) + tan(x * y)", {0.4, 0.6}},
+        {"log(x) + ln(x * y) + exp(-y)", {2.0, 0.5}},
+        {"sqrt(x ^ 2 + y ^ 2)", {3.0, 4.0}},
+        {"abs(x - y) * (x - y)", {1.0, 3.0}},
+        {"(x + y) * (x + y) / (1 + (x + y) ^ 2)", {0.3, 0.4}},
+        {"sin(sin(sin(x)))", {0.9}},
+        {"3", {}},
+        // 指数为 0 时导数为 0，底数为 0 也不得 0 * inf
+        {"x ^ 0", {0.0}},
+        {"(x - x) ^ 0 + y", {1.0, 2.0}},
+        {"x ^ (1 - 1) * y", {0.0, 3.0}},
+    };
+    for (const Case& c : cases) {
+        if (check_gradient(c.input, c.point) != 0) {
+            return 1;
+        }
+    }
+
+    // 注册表中的每个函数都有求导规则
+    for (const auto& entry : Functions::getFunctions()) {
+        std::string input = std::string(entry.first) + "(x * 0.3 + 0.7)";
+        if (check_gradient(input.c_str(), {0.5}) != 0) {
+            return 1;
+        }
+    }
+
+    // 不可导点：abs 在 0 处取 0，sqrt 在 0 处为 +inf，两种求导方式一致
+    if (check_gradient("abs(x)", {0.0}) != 0) {
+        return 1;
+    }
+    {
+        AstArena arena;
+        NodeId root = Parser("sqrt(x)", arena).parse();
+        double zero = 0.0;
+        double slope = 0.0;
+        DualEvaluator().evaluate(arena, root, &zero, &slope);
+        NodeId derivative = Optimizer().optimize(arena, Differentiator::differentiate(arena, root, 0));
+        double symbolic = Calculator().evaluate(arena, derivative, &zero);
+        if (!std::isinf(slope) || symbolic != slope) {
+            std::fprintf(stderr, "测试失败：sqrt 在 0 处的导数为 %g 与 %g\n", slope, symbolic);
+            return 1;
+        }
+    }
+
+    if (check_error("x / (y - 1)", {1.0, 1.0}, ErrorCode::DIVISION_BY_ZERO) != 0 ||
+        check_error("ln(x)", {-1.0}, ErrorCode::DOMAIN_ERROR) != 0 ||
+        check_error("sqrt(x - 5)", {1.0}, ErrorCode::DOMAIN_ERROR) != 0 ||
+        check_error("x ^ y", {-2.0, 2.0}, ErrorCode::DOMAIN_ERROR) != 0 ||
+        check_error("x + 1", {}, ErrorCode::UNBOUND_VARIABLE) != 0) {
+        return 1;
+    }
+    // 指数不含变量时底数可以为负
+    if (check_gradient("x ^ 3 + y", {-2.0, 1.0}) != 0) {
+        return 1;
+    }
+
+    // 不含该变量的项直接为 0，导数式可折叠为常量
+    if (check_folded("3 * x + 2 * y", 0, 1) != 0 ||
+        check_folded("3 * x + 2 * y", 1, 1) != 0 ||
+        check_folded("x ^ 2 + sin(y)", 1, 2) != 0 ||
+        check_folded("y * sqrt(16) + x", 1, 1) != 0) {
+        return 1;
+    }
+
+    std::printf("自动微分单元测试通过\n");
+    return 0;
+}
@@ -0,0 +1,141 @@
+// 单元测试：JIT 本机代码与 Calculator::evaluate 差分比对——随机表达式、随机变量取值下结果逐位一致，
+// 错误种类一致；以及虚拟机在达到阈值后升级为本机代码
+#include "parser.h"
+#include "calculator.h"
+#include "optimizer.h"
+#include "compiler.h"
+#include "vm.h"
+#include "jit.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+
+static bool same_result(double a, double b) {
+    // NaN 的载荷可能因运算顺序不同而不同，只要求两边都是 NaN
+    if (std::isnan(a) || std::isnan(b)) {
+        return std::isnan(a) && std::isnan(b);
+    }
+    return std::memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+// 随机生成深度受限的表达式，覆盖全部操作符与函数
+static std::string generate(std::mt19937& rng, int depth) {
+    static const char* const functions[] = {"sin", "cos", "tan", "log", "ln", "exp", "sqrt", "abs"};
+    static const char* const atoms[] = {"x", "y", "pi", "e", "0", "1", "2.5", "0.001", "1e3"};
+    if (depth == 0 || rng() % 4 == 0) {
+        return atoms[rng() % 9];
+    }
+    switch (rng() % 5) {
+        case 0:
+            return std::string(functions[rng() % 8]) + "(" + generate(rng, depth - 1) + ")";
+        case 1:
+            return "-" + generate(rng, depth - 1);
+        case 2:
+            return "(" + generate(rng, depth - 1) + ")";
+        default: {
+            static const char ops[] = {'+', '-', '*', '/', '^'};
+            return generate(rng, depth - 1) + " " + ops[rng() % 5] + " " + generate(rng, depth - 1);
+        }
+    }
+}
+
+static int check_differential() {
+    std::mt19937 rng(7);
+    AstArena arena;
+    Calculator calc;
+    size_t compared = 0;
+    size_t errors = 0;
+
+    for (int i = 0; i < 2000; i++) {
+        std::string input = generate(rng, 6);
+        arena.reset();
+        Expected<NodeId> root = Parser(input, arena).tryParse();
+        if (!root.ok()) {
+            std::fprintf(stderr, "测试失败：生成的表达式无法解析：%s\n", input.c_str());
+            return 1;
+        }
+        // 不经优化直接编译，指令序列与树一一对应，错误出现的先后顺序也相同
+        Program program = Compiler::compile(arena, root.value());
+        std::unique_ptr<JitCode> native = JitCode::compile(program);
+        if (!native) {
+            std::fprintf(stderr, "测试失败：'%s' 无法编译为本机代码\n", input.c_str());
+            return 1;
+        }
+
+        for (int sample = 0; sample < 8; sample++) {
+            double vars[2];
+            for (double& value : vars) {
+                // 包含 0、负数与大数，覆盖除零和定义域错误
+                switch (rng() % 4) {
+                    case 0: value = 0.0; break;
+                    case 1: value = -std::ldexp(static_cast<double>(rng()), -28); break;
+                    default: value = std::ldexp(static_cast<double>(rng()), -30); break;
+                }
+            }
+            const double* variables = program.variables.empty() ? nullptr : vars;
+            // 树求值按变量首次出现的槽位取值，与 Program::variables 的顺序相同
+            Expected<double> expected = calc.tryEvaluate(arena, root.value(), variables);
+            Expected<double> actual = native->run(program, variables);
+            if (expected.error().code != actual.error().code) {
+                std::fprintf(stderr, "测试失败：'%s' 错误不一致：'%s' 与 '%s'\n", input.c_str(),
+                             expected.error().message().c_str(), actual.error().message().c_str());
+                return 1;
+            }
+            if (!expected.ok()) {
+                errors++;
+                continue;
+            }
+            if (!same_result(expected.value(), actual.value())) {
+                std::fprintf(stderr, "测试失败：'%s' (x=%.17g, y=%.17g) 期望 %.17g，实际 %.17g\n", input.c_str(),
+                             vars[0], vars[1], expected.value(), actual.value());
+                return 1;
+            }
+            compared++;
+        }
+    }
+    if (compared == 0 || errors == 0) {
+        std::fprintf(stderr, "测试失败：样本未同时覆盖正常结果与错误（%zu / %zu）\n", compared, errors);
+        return 1;
+    }
+    return 0;
+}
+
+static int check_tiering() {
+    AstArena arena;
+    Parser parser("sqrt(x) * 2 + y", arena);
+    Program program = Compiler::compile(arena, Optimizer().optimize(arena, parser.parse()));
+    VirtualMachine vm(10);
+    double vars[2] = {16.0, 1.0};
+    for (int i = 0; i < 20; i++) {
+        Expected<double> result = vm.tryExecute(program, vars);
+        if (!result.ok() || result.value() != 9.0) {
+            std::fprintf(stderr, "测试失败：分层执行第 %d 次结果错误\n", i);
+            return 1;
+        }
+    }
+    if (!program.tier.native) {
+        std::fprintf(stderr, "测试失败：执行次数达到阈值后未升级为本机代码\n");
+        return 1;
+    }
+    vars[0] = -1.0;
+    Expected<double> domain = vm.tryExecute(program, vars);
+    if (domain.ok() || domain.error().message() != "计算错误: sqrt函数的参数不能为负数") {
+        std::fprintf(stderr, "测试失败：本机代码未报告定义域错误\n");
+        return 1;
+    }
+    return 0;
+}
+
+int main() {
+    if (!JitCode::available()) {
+        std::printf("当前平台不支持 JIT，跳过本机代码单元测试\n");
+        return 0;
+    }
+    if (check_differential() != 0 || check_tiering() != 0) {
+        return 1;
+    }
+    std::printf("JIT 差分单元测试通过\n");
+    return 0;
+}
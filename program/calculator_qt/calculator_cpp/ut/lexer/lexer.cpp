@@ -0,0 +1,124 @@
+// 单元测试：词法分析器的数字格式（含指数记数法、十六进制与分隔符）、切片位置、错误报告与零分配
+#include "lexer.h"
+#include "parser.h"
+#include "calculator.h"
+#include "allocation_counter.h"
+#include <cmath>
+#include <cstdio>
+#include <string>
+
+static int check_numbers() {
+    struct { const char* input; double expected; } cases[] = {
+        {"42", 42.0},
+        {"3.25", 3.25},
+        {".5", 0.5},
+        {"5.", 5.0},
+        {"1.5e-3", 1.5e-3},
+        {"2E+2", 200.0},
+        {"6e2", 600.0},
+        {"0.1", 0.1},
+        {"0x1.8p1", 3.0},
+        {"0xFF", 255.0},
+        {"1_000_000", 1e6},
+    };
+    for (const auto& c : cases) {
+        Lexer lexer(c.input);
+        Token token = lexer.next();
+        if (token.type != NUMBER || token.value != c.expected || token.text != c.input) {
+            std::fprintf(stderr, "测试失败：'%s' 期望数字 %g\n", c.input, c.expected);
+            return 1;
+        }
+        if (lexer.next().type != END) {
+            std::fprintf(stderr, "测试失败：'%s' 未被完整识别为一个数字\n", c.input);
+            return 1;
+        }
+    }
+
+    // e 后没有数字时属于下一个标识符（常量 e）
+    Lexer lexer("2e");
+    Token number = lexer.next();
+    Token constant = lexer.next();
+    if (number.type != NUMBER || number.value != 2.0 || constant.type != CONSTANT || constant.offset != 1) {
+        std::fprintf(stderr, "测试失败：'2e' 应识别为数字 2 与常量 e\n");
+        return 1;
+    }
+    return 0;
+}
+
+static int check_errors() {
+    const char* inputs[] = {"1.2.3", ".", "1e400", "2 $ 3", "1__0", "0x", "1e5.0"};
+    for (const char* input : inputs) {
+        try {
+            Lexer lexer(input);
+            while (lexer.next().type != END) {
+            }
+            std::fprintf(stderr, "测试失败：'%s' 应报告词法错误\n", input);
+            return 1;
+        } catch (const LexicalError&) {
+        }
+    }
+    return 0;
+}
+
+static int check_slices() {
+    const char* input = "  sqrt(x1) * pi";
+    Lexer lexer(input);
+    struct { TokenType type; const char* text; size_t offset; } expected[] = {
+        {FUNCTION, "sqrt", 2},
+        {LPAREN, "(", 6},
+        {VARIABLE, "x1", 7},
+        {RPAREN, ")", 9},
+        {OPERATOR, "*", 11},
+        {CONSTANT, "pi", 13},
+        {END, "", 15},
+    };
+    for (const auto& e : expected) {
+        Token token = lexer.next();
+        if (token.type != e.type || token.text != e.text || token.offset != e.offset) {
+            std::fprintf(stderr, "测试失败：'%s' 在位置 %zu 的 Token 不符\n", input, e.offset);
+            return 1;
+        }
+        if (token.type == FUNCTION && token.function != Functions::find("sqrt")) {
+            std::fprintf(stderr, "测试失败：函数 Token 未指向函数描述符\n");
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int check_zero_allocation() {
+    const std::string input = "sin(1.5e-3) * (x + 2.5E2) - pi / sqrt(16) ^ 2";
+    AstArena arena;
+    Calculator calc;
+    double x = 1.0;
+
+    // 预热节点池与函数/常量表
+    arena.reset();
+    Parser(input, arena).parse();
+
+    size_t before = allocation_count;
+    size_t tokens = 0;
+    for (int round = 0; round < 100; round++) {
+        Lexer lexer(input);
+        while (lexer.next().type != END) {
+            tokens++;
+        }
+        arena.reset();
+        Parser parser(input, arena);
+        calc.evaluate(arena, parser.parse(), &x);
+    }
+    size_t allocations = allocation_count - before;
+    if (allocations != 0 || tokens == 0) {
+        std::fprintf(stderr, "测试失败：稳态下词法与语法分析期望 0 次堆分配，实际 %zu 次\n", allocations);
+        return 1;
+    }
+    return 0;
+}
+
+int main() {
+    if (check_numbers() != 0 || check_errors() != 0 || check_slices() != 0 || check_zero_allocation() != 0) {
+        return 1;
+    }
+    std::printf("词法分析器单元测试通过\n");
+    return 0;
+}
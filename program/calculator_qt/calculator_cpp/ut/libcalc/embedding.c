@@ -0,0 +1,95 @@
+// 单元测试：纯 C 程序只包含 libcalc.h、只链接共享库 libcalc.so 即可编译并求值表达式
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "libcalc.h"
+
+int main(void) {
+    calc_error error;
+
+    /* 1) 不含变量的表达式：vars 可为 NULL */
+    {
+        calc_expr* expr = calc_prepare("2 * (3 + 4) - sqrt(16)", &error);
+        if (expr == NULL || calc_variable_count(expr) != 0) {
+            fprintf(stderr, "测试失败：常量表达式编译失败\n");
+            return 1;
+        }
+        double value = calc_eval(expr, NULL, &error);
+        if (value != 10.0 || error.status != CALC_OK) {
+            fprintf(stderr, "测试失败：结果 %g，期望 10\n", value);
+            return 1;
+        }
+        calc_release(expr);
+    }
+
+    /* 2) 变量按首次出现的顺序占用槽位，可按名称查询 */
+    calc_expr* expr = calc_prepare("y * 10 + x", &error);
+    if (expr == NULL || calc_variable_count(expr) != 2 || strcmp(calc_variable_name(expr, 0), "y") != 0 ||
+        calc_variable_slot(expr, "x") != 1 || calc_variable_slot(expr, "z") != -1 ||
+        calc_variable_name(expr, 2) != NULL) {
+        fprintf(stderr, "测试失败：变量槽位不符\n");
+        return 1;
+    }
+    double vars[2] = {4.0, 2.0};
+    if (calc_eval(expr, vars, NULL) != 42.0) {
+        fprintf(stderr, "测试失败：y * 10 + x 应为 42\n");
+        return 1;
+    }
+
+    /* 3) 批量求值：每个变量一列 */
+    {
+        enum { ROWS = 1000 };
+        double ys[ROWS], xs[ROWS], out[ROWS];
+        for (int i = 0; i < ROWS; i++) {
+            ys[i] = i;
+            xs[i] = 0.5;
+        }
+        const double* columns[2] = {ys, xs};
+        if (calc_eval_batch(expr, columns, ROWS, out, &error) != CALC_OK) {
+            fprintf(stderr, "测试失败：批量求值失败：%s\n", error.message);
+            return 1;
+        }
+        for (int i = 0; i < ROWS; i++) {
+            if (out[i] != i * 10.0 + 0.5) {
+                fprintf(stderr, "测试失败：第 %d 行结果 %g\n", i, out[i]);
+                return 1;
+            }
+        }
+    }
+
+    /* 4) 错误：类别、位置与可执行文件一致的信息；求值出错返回 NaN */
+    {
+        if (calc_prepare("2 + $", &error) != NULL || error.status != CALC_LEXICAL_ERROR || error.offset != 4 ||
+            strcmp(error.message, "词法错误: 未知字符: $") != 0) {
+            fprintf(stderr, "测试失败：'2 + $' 报错 \"%s\"\n", error.message);
+            return 1;
+        }
+        if (calc_prepare("(1 + 2", &error) != NULL || error.status != CALC_SYNTAX_ERROR) {
+            fprintf(stderr, "测试失败：'(1 + 2' 应报告语法错误\n");
+            return 1;
+        }
+        calc_expr* division = calc_prepare("1 / x", &error);
+        double zero = 0.0;
+        if (division == NULL || !isnan(calc_eval(division, &zero, &error)) || error.status != CALC_EVALUATION_ERROR ||
+            strcmp(error.message, "计算错误: 除零错误") != 0) {
+            fprintf(stderr, "测试失败：'1 / x' 在 x = 0 时应报告除零错误\n");
+            return 1;
+        }
+        if (!isnan(calc_eval(division, NULL, &error)) || error.status != CALC_EVALUATION_ERROR) {
+            fprintf(stderr, "测试失败：缺少变量取值时应报告计算错误\n");
+            return 1;
+        }
+        calc_release(division);
+        if (calc_prepare(NULL, &error) != NULL || error.status != CALC_INVALID_ARGUMENT ||
+            calc_eval_batch(NULL, NULL, 0, NULL, &error) != CALC_INVALID_ARGUMENT) {
+            fprintf(stderr, "测试失败：空参数应报告 CALC_INVALID_ARGUMENT\n");
+            return 1;
+        }
+    }
+
+    calc_release(expr);
+    calc_release(NULL);
+    printf("libcalc C 接口单元测试通过\n");
+    return 0;
+}
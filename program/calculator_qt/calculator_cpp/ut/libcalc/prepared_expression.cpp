@@ -0,0 +1,155 @@
+// 单元测试：预编译句柄的结果与 Calculator 逐位一致，同一句柄可被多个线程同时求值，C++ 包装的异常与移动语义
+#include "libcalc.h"
+#include "parser.h"
+#include "calculator.h"
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+static bool same_bits(double a, double b) {
+    return std::memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+static double point(size_t row, size_t slot) {
+    return 0.25 + 0.013 * static_cast<double>(row) - 0.7 * static_cast<double>(slot);
+}
+
+int main() {
+    static const char* const inputs[] = {
+        "x * x + 3 * x - 2",
+        "(x + 1) / (x - 0.5) * (y + 2) - x / 3",
+        "sin(x) * cos(y) + sqrt(abs(x * y))",
+        "((x - 1) ^ 2 + (y - 2) ^ 2) / (2 * pi)",
+        "exp(-x ^ 2) * 2 + 0 * y",
+    };
+
+    // 1) 逐行与批量结果都与 AST 求值逐位一致
+    const size_t rows = 2000;
+    for (const char* input : inputs) {
+        calc::Expression expr(input);
+        AstArena arena;
+        NodeId root = Parser(input, arena).parse();
+        if (arena.variableCount() != expr.variableCount()) {
+            std::fprintf(stderr, "测试失败：'%s' 变量个数不符\n", input);
+            return 1;
+        }
+        std::vector<std::vector<double>> columns(expr.variableCount(), std::vector<double>(rows));
+        std::vector<const double*> pointers;
+        for (size_t slot = 0; slot < columns.size(); slot++) {
+            for (size_t row = 0; row < rows; row++) {
+                columns[slot][row] = point(row, slot);
+            }
+            pointers.push_back(columns[slot].data());
+        }
+        std::vector<double> out(rows);
+        expr.evaluate(pointers.data(), rows, out.data());
+
+        Calculator calculator;
+        for (size_t row = 0; row < rows; row++) {
+            double vars[2];
+            for (size_t slot = 0; slot < columns.size(); slot++) {
+                vars[slot] = columns[slot][row];
+            }
+            double expected = calculator.evaluate(arena, root, vars);
+            if (!same_bits(expr(vars), expected) || !same_bits(out[row], expected)) {
+                std::fprintf(stderr, "测试失败：'%s' 第 %zu 行结果 %.17g / %.17g，期望 %.17g\n", input, row, expr(vars),
+                             out[row], expected);
+                return 1;
+            }
+        }
+    }
+
+    // 2) 多个线程同时使用同一句柄，逐行与批量交替进行
+    {
+        const calc::Expression expr("sin(x) * cos(y) + sqrt(abs(x * y))");
+        std::vector<double> expected(rows);
+        for (size_t row = 0; row < rows; row++) {
+            double vars[2] = {point(row, 0), point(row, 1)};
+            expected[row] = expr(vars);
+        }
+        std::atomic<size_t> mismatches{0};
+        std::vector<std::thread> threads;
+        for (unsigned t = 0; t < 8; t++) {
+            threads.emplace_back([&, t] {
+                std::vector<double> xs(rows), ys(rows), out(rows);
+                for (size_t row = 0; row < rows; row++) {
+                    xs[row] = point(row, 0);
+                    ys[row] = point(row, 1);
+                }
+                const double* columns[2] = {xs.data(), ys.data()};
+                for (int round = 0; round < 50; round++) {
+                    if ((round + t) % 2 == 0) {
+                        expr.evaluate(columns, rows, out.data());
+                    } else {
+                        for (size_t row = 0; row < rows; row++) {
+                            double vars[2] = {xs[row], ys[row]};
+                            out[row] = expr(vars);
+                        }
+                    }
+                    for (size_t row = 0; row < rows; row++) {
+                        if (!same_bits(out[row], expected[row])) {
+                            mismatches++;
+                        }
+                    }
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        if (mismatches != 0) {
+            std::fprintf(stderr, "测试失败：并发求值有 %zu 个结果不一致\n", mismatches.load());
+            return 1;
+        }
+    }
+
+    // 3) 出错时抛出 calc::Error，带类别与位置
+    try {
+        calc::Expression expr("sqrt(1 + ");
+        std::fprintf(stderr, "测试失败：'sqrt(1 + ' 应编译失败\n");
+        return 1;
+    } catch (const calc::Error& e) {
+        if (e.status() != CALC_SYNTAX_ERROR) {
+            std::fprintf(stderr, "测试失败：'sqrt(1 + ' 报错类别 %d\n", static_cast<int>(e.status()));
+            return 1;
+        }
+    }
+    {
+        calc::Expression expr("ln(x)");
+        std::vector<double> xs = {1.0, 2.0, -1.0};
+        const double* columns[1] = {xs.data()};
+        std::vector<double> out(xs.size());
+        try {
+            expr.evaluate(columns, xs.size(), out.data());
+            std::fprintf(stderr, "测试失败：ln(-1) 应整批失败\n");
+            return 1;
+        } catch (const calc::Error& e) {
+            if (e.status() != CALC_EVALUATION_ERROR) {
+                std::fprintf(stderr, "测试失败：ln(-1) 报错类别 %d\n", static_cast<int>(e.status()));
+                return 1;
+            }
+        }
+    }
+
+    // 4) 移动后句柄归新对象所有
+    {
+        calc::Expression first("a + b");
+        calc::Expression second(std::move(first));
+        double vars[2] = {1.5, 2.5};
+        if (first.get() != nullptr || second(vars) != 4.0 || second.variableName(1) != "b") {
+            std::fprintf(stderr, "测试失败：移动后句柄不符\n");
+            return 1;
+        }
+        first = std::move(second);
+        if (first(vars) != 4.0) {
+            std::fprintf(stderr, "测试失败：移动赋值后句柄不符\n");
+            return 1;
+        }
+    }
+
+    std::printf("libcalc 预编译表达式单元测试通过\n");
+    return 0;
+}
@@ -0,0 +1,98 @@
+// 单元测试：常量折叠与代数化简保持求值结果与错误行为不变
+#include "parser.h"
+#include "calculator.h"
+#include "optimizer.h"
+#include <cstdio>
+
+struct Shape {
+    const char* input;
+    size_t nodesAfter;   // 优化后期望的可达节点数
+};
+
+// 优化前后求值结果逐位一致
+static int check_same_value(const char* input) {
+    AstArena arena;
+    Calculator calc;
+    Optimizer optimizer;
+
+    Parser parser(input, arena);
+    NodeId root = parser.parse();
+    double expected = calc.evaluate(arena, root);
+    root = optimizer.optimize(arena, root);
+    double actual = calc.evaluate(arena, root);
+    if (actual != expected) {
+        std::fprintf(stderr, "测试失败：'%s' 优化前 %.17g，优化后 %.17g\n", input, expected, actual);
+        return 1;
+    }
+    return 0;
+}
+
+// 优化后仍然抛出与原来相同类别的错误
+template <typename Error>
+static int check_error_kept(const char* input) {
+    AstArena arena;
+    Calculator calc;
+    Optimizer optimizer;
+
+    Parser parser(input, arena);
+    NodeId root = optimizer.optimize(arena, parser.parse());
+    try {
+        calc.evaluate(arena, root);
+    } catch (const Error&) {
+        return 0;
+    }
+    std::fprintf(stderr, "测试失败：'%s' 优化后未保留原有错误\n", input);
+    return 1;
+}
+
+int main() {
+    static const char* const values[] = {
+        "2*pi/4",
+        "sqrt(16)+1*3",
+        "-(-(2^0.5))",
+        "sin(pi/2) + cos(pi/4) * tan(pi/6)",
+        "ln(e) + log(1000) - exp(2)",
+        "((((((2+3)*4)-5)/6)^2)+1)",
+        "0.1 + 0.2",
+    };
+    for (const char* input : values) {
+        if (check_same_value(input) != 0) {
+            return 1;
+        }
+    }
+
+    static const Shape shapes[] = {
+        {"2*pi/4", 1},
+        {"sqrt(16) + 1", 1},
+        {"sqrt(-1) * 1", 2},        // x*1 -> x，sqrt(-1) 本身不可折叠
+        {"-(-(1/0))", 3},           // 双重取负消去，1/0 保留
+        {"(1/0) ^ 1", 3},
+        {"(1/0) - 0", 3},
+        {"(1/0) + -0", 3},
+        {"(1/0) + 0", 5},           // x + 0 对 x == -0 不成立，不做化简
+        {"log(0) + 2*3", 4},
+    };
+    for (const Shape& shape : shapes) {
+        AstArena arena;
+        Optimizer optimizer;
+        Parser parser(shape.input, arena);
+        NodeId root = parser.parse();
+        optimizer.optimize(arena, root);
+        const OptimizerStats& stats = optimizer.stats();
+        if (stats.nodesAfter != shape.nodesAfter || stats.removed() != stats.nodesBefore - shape.nodesAfter) {
+            std::fprintf(stderr, "测试失败：'%s' 期望优化后 %zu 个节点，实际 %zu 个（移除 %zu 个）\n",
+                         shape.input, shape.nodesAfter, stats.nodesAfter, stats.removed());
+            return 1;
+        }
+    }
+
+    if (check_error_kept<EvaluationError>("1 / (3 - 3)") != 0 ||
+        check_error_kept<EvaluationError>("sqrt(-4) + 1") != 0 ||
+        check_error_kept<EvaluationError>("log(0)") != 0 ||
+        check_error_kept<EvaluationError>("ln(-e)") != 0) {
+        return 1;
+    }
+
+    std::printf("常量折叠单元测试通过\n");
+    return 0;
+}
@@ -0,0 +1,62 @@
+// 单元测试：节点池复用后，稳态下的解析与求值不再进行堆分配
+#include "parser.h"
+#include "calculator.h"
+#include "allocation_counter.h"
+#include <cmath>
+#include <cstdio>
+
+struct Case {
+    const char* input;
+    double expected;
+};
+
+static const Case cases[] = {
+    {"2 + 3 * 4", 14.0},
+    {"(2 + 3) * 4", 20.0},
+    {"-2 + 5", 3.0},
+    {"sin(pi/2)", 1.0},
+    {"sqrt(16) + log(100)", 6.0},
+    {"abs(-5) * exp(0) + ln(e)", 6.0},
+    {"((((((2+3)*4)-5)/6)^2)+1)", 7.25},
+    {"sqrt(abs(-16)) + sqrt(sqrt(81))", 7.0},
+};
+
+static int run_all(AstArena& arena, Calculator& calc) {
+    for (const Case& c : cases) {
+        arena.reset();
+        Parser parser(c.input, arena);
+        NodeId root = parser.parse();
+        double result = calc.evaluate(arena, root);
+        if (std::fabs(result - c.expected) > 1e-12) {
+            std::fprintf(stderr, "测试失败：'%s' 期望 %g，实际 %g\n", c.input, c.expected, result);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int main() {
+    AstArena arena;
+    Calculator calc;
+
+    // 预热：节点池、参数缓冲区与函数/常量表在此完成首次分配
+    if (run_all(arena, calc) != 0) {
+        return 1;
+    }
+
+    size_t before = allocation_count;
+    for (int round = 0; round < 100; round++) {
+        if (run_all(arena, calc) != 0) {
+            return 1;
+        }
+    }
+    size_t allocations = allocation_count - before;
+
+    if (allocations != 0) {
+        std::fprintf(stderr, "测试失败：稳态下期望 0 次堆分配，实际 %zu 次\n", allocations);
+        return 1;
+    }
+
+    std::printf("节点池零分配单元测试通过\n");
+    return 0;
+}
@@ -0,0 +1,93 @@
+// 单元测试：函数与常量标识符在解析阶段解析为描述符，参数个数错误在解析阶段报告，
+// 注册表可被多个线程同时首次访问
+#include "parser.h"
+#include "calculator.h"
+#include "functions.h"
+#include "constants.h"
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+static int check_resolution() {
+    AstArena arena;
+    Parser parser("sin(pi)", arena);
+    NodeId root = parser.parse();
+
+    const ASTNode& call = arena.node(root);
+    if (call.type != FUNC_CALL_NODE || call.data.call.function != Functions::find("sin")) {
+        std::fprintf(stderr, "测试失败：sin 调用节点未指向函数表中的描述符\n");
+        return 1;
+    }
+    if (arena.name(call) != "sin") {
+        std::fprintf(stderr, "测试失败：调用节点名称错误\n");
+        return 1;
+    }
+
+    const ASTNode& constant = arena.node(arena.args(call)[0]);
+    if (constant.type != CONSTANT_NODE || constant.data.constant.info != Constants::find("pi") ||
+        constant.data.constant.info->value != M_PI) {
+        std::fprintf(stderr, "测试失败：pi 常量节点未在解析阶段取值\n");
+        return 1;
+    }
+    return 0;
+}
+
+static int check_arity_error() {
+    const char* inputs[] = {"sin()", "1 + sqrt()"};
+    for (const char* input : inputs) {
+        AstArena arena;
+        try {
+            Parser parser(input, arena);
+            parser.parse();
+            std::fprintf(stderr, "测试失败：'%s' 应在解析阶段报告参数个数错误\n", input);
+            return 1;
+        } catch (const SyntaxError& e) {
+            if (std::string(e.what()).find("个参数") == std::string::npos) {
+                std::fprintf(stderr, "测试失败：'%s' 报错信息不符：%s\n", input, e.what());
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+static int check_concurrent_first_access() {
+    // 注册表以局部静态变量实现，首次访问可以发生在任意线程
+    const int threadCount = 8;
+    std::vector<int> failures(threadCount, 0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; t++) {
+        threads.emplace_back([t, &failures]() {
+            AstArena arena;
+            Calculator calc;
+            for (int i = 0; i < 1000; i++) {
+                arena.reset();
+                Parser parser("sqrt(16) + ln(e) * cos(0)", arena);
+                double result = calc.evaluate(arena, parser.parse());
+                if (result != 5.0) {
+                    failures[t]++;
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    for (int t = 0; t < threadCount; t++) {
+        if (failures[t] != 0) {
+            std::fprintf(stderr, "测试失败：线程 %d 求值结果错误 %d 次\n", t, failures[t]);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int main() {
+    if (check_concurrent_first_access() != 0 || check_resolution() != 0 || check_arity_error() != 0) {
+        return 1;
+    }
+    std::printf("标识符解析单元测试通过\n");
+    return 0;
+}
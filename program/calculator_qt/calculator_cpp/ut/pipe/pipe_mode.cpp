@@ -0,0 +1,177 @@
+// 单元测试：管道模式的按块行读取（跨块的长行、无换行结尾、\r\n）、逐行输出、diff 求导、数百 KB 的单行与稳态零分配
+#include "pipe_mode.h"
+#include "line_evaluator.h"
+#include "allocation_counter.h"
+#include "parser.h"
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// 写入临时文件并回到开头
+static FILE* temp_input(const std::string& text) {
+    FILE* file = std::tmpfile();
+    if (file == nullptr || std::fwrite(text.data(), 1, text.size(), file) != text.size()) {
+        return nullptr;
+    }
+    std::fflush(file);
+    std::rewind(file);
+    return file;
+}
+
+static std::string read_all(FILE* file) {
+    std::string text;
+    char buffer[4096];
+    std::rewind(file);
+    size_t n;
+    while ((n = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        text.append(buffer, n);
+    }
+    return text;
+}
+
+static int check_reader() {
+    std::string text = "ab\r\n\n" + std::string(10000, 'x') + "\ntail";
+    FILE* file = temp_input(text);
+    LineReader reader(fileno(file), 64);
+    std::vector<size_t> lengths;
+    int status = 1;
+    while (true) {
+        std::string_view line;
+        while (reader.next(line)) {
+            lengths.push_back(line.size());
+        }
+        if (status <= 0) {
+            break;
+        }
+        status = reader.fill();
+    }
+    std::fclose(file);
+    if (status < 0 || lengths != std::vector<size_t>{2, 0, 10000, 4} || reader.bytes() != text.size()) {
+        std::fprintf(stderr, "测试失败：按块读取的行数或行长不符（%zu 行）\n", lengths.size());
+        return 1;
+    }
+    return 0;
+}
+
+static int check_session() {
+    // 表达式行的输出与批量模式逐行求值一致；赋值行输出 "变量 = 值"；quit 之后的行不再处理
+    std::vector<std::string> expressions = {"1 + 2", "", "sqrt(16)\r", "1 / 0", "(1 + 2", "2 ^ 10"};
+    std::string longLine = "1";
+    for (int i = 1; i < 5000; i++) {
+        longLine += " + 1";
+    }
+    expressions.push_back(longLine);
+
+    std::string input;
+    LineEvaluator evaluator(0);
+    std::ostringstream expected;
+    size_t errors = 0;
+    for (const std::string& line : expressions) {
+        input += line + "\n";
+        evaluator.evaluate(line, expected, errors);
+        expected << '\n';
+    }
+    // 首尾空白被忽略，只含空白的行与空行一样输出空行，不计为错误
+    input += "   \n\t 1 + 1  \na = 3\nb = a * 2\na * b\n quit \n4 + 4\n";
+    expected << "\n= 2\na = 3\nb = 6\n= 18\n";
+
+    FILE* in = temp_input(input);
+    FILE* out = std::tmpfile();
+    bool ok = false;
+    PipeSession session(16, 0);
+    PipeStats stats = session.run(fileno(in), fileno(out), ok, 64);
+    std::string actual = read_all(out);
+    std::fclose(in);
+    std::fclose(out);
+    if (!ok || actual != expected.str()) {
+        std::fprintf(stderr, "测试失败：管道模式输出不符：\n%s\n期望：\n%s\n", actual.c_str(), expected.str().c_str());
+        return 1;
+    }
+    if (stats.lines != expressions.size() + 5 || stats.errors != errors || stats.bytesOut != actual.size()) {
+        std::fprintf(stderr, "测试失败：统计不符（%zu 行，%zu 个错误）\n", stats.lines, stats.errors);
+        return 1;
+    }
+    return 0;
+}
+
+static int check_gradient() {
+    // diff 与交互模式一样求值与求偏导数，变量取已赋值的值，每行输入输出一行；重复的 diff 命中缓存
+    std::string input = "x = 2\ny = 3\ndiff x^2\ndiff x * y + sin(0)\ndiff x^2\ndiff 7\ndiff 1 / (x - 2)\n";
+    std::string expected = "x = 2\ny = 3\n= 4  ∂/∂x = 4\n= 6  ∂/∂x = 3  ∂/∂y = 2\n= 4  ∂/∂x = 4\n= 7\n"
+                           "错误: 计算错误: 除零错误\n";
+    FILE* in = temp_input(input);
+    FILE* out = std::tmpfile();
+    bool ok = false;
+    PipeSession session(16, 0);
+    PipeStats stats = session.run(fileno(in), fileno(out), ok, 64);
+    std::string actual = read_all(out);
+    std::fclose(in);
+    std::fclose(out);
+    if (!ok || actual != expected || stats.errors != 1) {
+        std::fprintf(stderr, "测试失败：管道模式求导输出不符：\n%s\n期望：\n%s\n", actual.c_str(), expected.c_str());
+        return 1;
+    }
+    return 0;
+}
+
+static int check_long_lines() {
+    // 数百 KB 的单行：嵌套或树高超出解析上限时报错而不是耗尽调用栈，树高在上限内的长链照常求值
+    auto chain = [](size_t terms) {
+        std::string line = "1";
+        for (size_t i = 1; i < terms; i++) {
+            line += "+1";
+        }
+        return line;
+    };
+    std::string input = chain(200000) + "\n" + std::string(100000, '(') + "1" + std::string(100000, ')') + "\n" +
+                        "1 +" + std::string(300000, ' ') + "2\n" + chain(Parser::MAX_HEIGHT / 2) + "\n2 * 3\n";
+    std::string tooDeep = "错误: 语法错误: 表达式嵌套过深（超出解析上限）\n";
+    std::string expected = tooDeep + tooDeep + "= 3\n= " + std::to_string(Parser::MAX_HEIGHT / 2) + "\n= 6\n";
+    FILE* in = temp_input(input);
+    FILE* out = std::tmpfile();
+    bool ok = false;
+    PipeSession session(16, 0);
+    PipeStats stats = session.run(fileno(in), fileno(out), ok, 4096);
+    std::string actual = read_all(out);
+    std::fclose(in);
+    std::fclose(out);
+    if (!ok || actual != expected || stats.errors != 2) {
+        std::fprintf(stderr, "测试失败：长行输出不符：\n%s\n期望：\n%s\n", actual.c_str(), expected.c_str());
+        return 1;
+    }
+    return 0;
+}
+
+static int check_steady_state_allocations() {
+    // 缓存命中的行不分配内存：一次运行的分配次数与行数无关，只有读写缓冲等固定开销
+    std::string input;
+    for (int i = 0; i < 20000; i++) {
+        input += i % 2 == 0 ? "sin(pi / 6) + 2 * 3\n" : "sqrt(16) + log(100)\n";
+    }
+    PipeSession session(16, 0);
+    FILE* in = temp_input(input);
+    FILE* out = std::tmpfile();
+    bool ok = false;
+    session.run(fileno(in), fileno(out), ok, 4096);
+    std::rewind(in);
+    size_t before = allocation_count;
+    PipeStats stats = session.run(fileno(in), fileno(out), ok, 4096);
+    size_t allocations = allocation_count - before;
+    std::fclose(in);
+    std::fclose(out);
+    if (!ok || stats.lines != 20000 || allocations > 8) {
+        std::fprintf(stderr, "测试失败：稳态下 %zu 行发生 %zu 次堆分配\n", stats.lines, allocations);
+        return 1;
+    }
+    return 0;
+}
+
+int main() {
+    if (check_reader() != 0 || check_session() != 0 || check_gradient() != 0 || check_long_lines() != 0 ||
+        check_steady_state_allocations() != 0) {
+        return 1;
+    }
+    std::printf("管道模式单元测试通过\n");
+    return 0;
+}
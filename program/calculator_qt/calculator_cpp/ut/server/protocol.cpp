@@ -0,0 +1,255 @@
+// 单元测试：服务模式的行协议——多个连接同时流水线发送请求，回复与逐行求值一致且保持顺序；
+// stats 请求返回延迟分位数；文件描述符耗尽时监听套接字不空转，恢复后积压的连接照常处理；
+// 延迟直方图的分位数误差在一个桶以内
+#include "server.h"
+#include "line_evaluator.h"
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// 一次写出全部请求后关闭写方向，再读到对端关闭为止
+static std::string exchange(const ServerAddress& address, uint16_t port, const std::string& request) {
+    int fd;
+    if (address.isUnix()) {
+        sockaddr_un remote{};
+        remote.sun_family = AF_UNIX;
+        address.unixPath.copy(remote.sun_path, sizeof(remote.sun_path) - 1);
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (connect(fd, reinterpret_cast<sockaddr*>(&remote), sizeof(remote)) != 0) {
+            close(fd);
+            return "<连接失败>";
+        }
+    } else {
+        sockaddr_in remote{};
+        remote.sin_family = AF_INET;
+        remote.sin_port = htons(port);
+        remote.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (connect(fd, reinterpret_cast<sockaddr*>(&remote), sizeof(remote)) != 0) {
+            close(fd);
+            return "<连接失败>";
+        }
+    }
+
+    // 写与读放在不同线程，请求很多时双方的发送缓冲都不会被填满而互相等待
+    std::thread writer([fd, &request]() {
+        size_t sent = 0;
+        while (sent < request.size()) {
+            ssize_t n = send(fd, request.data() + sent, request.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0) {
+                break;
+            }
+            sent += static_cast<size_t>(n);
+        }
+        shutdown(fd, SHUT_WR);
+    });
+    std::string response;
+    char buffer[4096];
+    ssize_t n;
+    while ((n = read(fd, buffer, sizeof(buffer))) > 0) {
+        response.append(buffer, static_cast<size_t>(n));
+    }
+    writer.join();
+    close(fd);
+    return response;
+}
+
+static std::string expected_response(const std::vector<std::string>& lines) {
+    LineEvaluator evaluator(0);
+    std::ostringstream out;
+    size_t errors = 0;
+    for (const std::string& line : lines) {
+        evaluator.evaluate(line, out, errors);
+        out << '\n';
+    }
+    return out.str();
+}
+
+static int check_pipelined(const ServerAddress& address) {
+    ServerOptions options;
+    options.address = address;
+    options.workers = 3;
+    Server server(options);
+    server.listen();
+    std::thread loop([&server]() { server.run(); });
+
+    static const char* const samples[] = {
+        "2 + 3 * 4", "sin(pi/2)", "", "1 / 0", "sqrt(-1)", "foo + 1", "2^10", "abs(-5)\r", "(1 + 2",
+    };
+    // 每个连接的请求各不相同，回复错位时能被发现
+    const int clients = 4;
+    std::vector<std::string> requests(clients);
+    std::vector<std::string> expected(clients);
+    for (int c = 0; c < clients; c++) {
+        std::vector<std::string> lines;
+        for (int i = 0; i < 3000; i++) {
+            lines.push_back(i % 10 == 9 ? std::to_string(c * 100000 + i) + " * 2" : samples[i % 9]);
+        }
+        for (const std::string& line : lines) {
+            requests[c] += line + "\n";
+        }
+        expected[c] = expected_response(lines);
+    }
+    std::vector<std::string> actual(clients);
+    std::vector<std::thread> threads;
+    for (int c = 0; c < clients; c++) {
+        threads.emplace_back([&, c]() { actual[c] = exchange(address, server.port(), requests[c]); });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    // stats 夹在普通请求之间，最后一行没有换行符
+    std::string tail = exchange(address, server.port(), "1 + 1\nstats\n3 * 3");
+    server.stop();
+    loop.join();
+
+    for (int c = 0; c < clients; c++) {
+        if (actual[c] != expected[c]) {
+            std::fprintf(stderr, "测试失败：第 %d 个连接的回复与逐行求值不一致（%zu / %zu 字节）\n", c,
+                         actual[c].size(), expected[c].size());
+            return 1;
+        }
+    }
+    if (tail.find("= 2\n连接") != 0 || tail.find("p99=") == std::string::npos ||
+        tail.size() < 4 || tail.compare(tail.size() - 4, 4, "= 9\n") != 0) {
+        std::fprintf(stderr, "测试失败：stats 回复或无换行结尾的请求不符：%s\n", tail.c_str());
+        return 1;
+    }
+    const ServerStats& stats = server.stats();
+    if (stats.connections != clients + 1 || stats.requests != clients * 3000 + 3 ||
+        stats.latency.count() != stats.requests || stats.errors == 0) {
+        std::fprintf(stderr, "测试失败：服务统计不符（%zu 个连接，%zu 个请求）\n", stats.connections, stats.requests);
+        return 1;
+    }
+    return 0;
+}
+
+static double thread_cpu_seconds(std::thread& thread) {
+    clockid_t clock;
+    timespec time{};
+    if (pthread_getcpuclockid(thread.native_handle(), &clock) != 0 || clock_gettime(clock, &time) != 0) {
+        return 0.0;
+    }
+    return static_cast<double>(time.tv_sec) + static_cast<double>(time.tv_nsec) / 1e9;
+}
+
+static int check_descriptor_exhaustion(const ServerAddress& address) {
+    ServerOptions options;
+    options.address = address;
+    options.workers = 1;
+    Server server(options);
+    server.listen();
+    std::thread loop([&server]() { server.run(); });
+    // 收到回复说明 epoll 与工作线程都已创建
+    if (exchange(address, 0, "1\n") != "= 1\n") {
+        std::fprintf(stderr, "测试失败：服务未就绪\n");
+        server.stop();
+        loop.join();
+        return 1;
+    }
+
+    // 先创建客户端套接字，再把软上限降到最小的空闲描述符号：之后任何新描述符都会 EMFILE，
+    // 服务端 accept 失败，连接留在积压队列中
+    sockaddr_un remote{};
+    remote.sun_family = AF_UNIX;
+    address.unixPath.copy(remote.sun_path, sizeof(remote.sun_path) - 1);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    int lowest = dup(0);
+    close(lowest);
+    rlimit original{};
+    getrlimit(RLIMIT_NOFILE, &original);
+    rlimit limited = original;
+    limited.rlim_cur = static_cast<rlim_t>(lowest);
+    setrlimit(RLIMIT_NOFILE, &limited);
+    bool connected = connect(fd, reinterpret_cast<sockaddr*>(&remote), sizeof(remote)) == 0;
+
+    double before = thread_cpu_seconds(loop);
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    double busy = thread_cpu_seconds(loop) - before;
+    setrlimit(RLIMIT_NOFILE, &original);
+
+    // 上限恢复后，积压的连接在重试间隔内被接受并照常回复
+    std::string response;
+    if (connected) {
+        send(fd, "1 + 2\n", 6, MSG_NOSIGNAL);
+        shutdown(fd, SHUT_WR);
+        char buffer[256];
+        ssize_t n;
+        while ((n = read(fd, buffer, sizeof(buffer))) > 0) {
+            response.append(buffer, static_cast<size_t>(n));
+        }
+    }
+    close(fd);
+    server.stop();
+    loop.join();
+
+    if (!connected || busy > 0.05) {
+        std::fprintf(stderr, "测试失败：文件描述符耗尽的 300 毫秒内 I/O 线程占用 %.3f 秒 CPU\n", busy);
+        return 1;
+    }
+    if (response != "= 3\n") {
+        std::fprintf(stderr, "测试失败：恢复后积压连接的回复为 \"%s\"\n", response.c_str());
+        return 1;
+    }
+    return 0;
+}
+
+#endif
+
+static int check_histogram() {
+    LatencyHistogram histogram;
+    for (uint64_t value = 1; value <= 100000; value++) {
+        histogram.record(value * 1000);
+    }
+    const double points[] = {50, 90, 99, 99.9};
+    for (double p : points) {
+        double exact = p / 100.0 * 100000 * 1000;
+        double reported = static_cast<double>(histogram.percentile(p));
+        if (reported < exact || reported > exact * (1.0 + 1.0 / 16)) {
+            std::fprintf(stderr, "测试失败：p%g 为 %.0f，精确值 %.0f\n", p, reported, exact);
+            return 1;
+        }
+    }
+    if (histogram.percentile(100) != 100000 * 1000 || histogram.count() != 100000) {
+        std::fprintf(stderr, "测试失败：最大值或样本数不符\n");
+        return 1;
+    }
+    LatencyHistogram small;
+    small.record(7, 3);
+    if (small.percentile(50) != 7 || LatencyHistogram().percentile(50) != 0) {
+        std::fprintf(stderr, "测试失败：小值应精确记录\n");
+        return 1;
+    }
+    return 0;
+}
+
+int main() {
+    if (check_histogram() != 0) {
+        return 1;
+    }
+#if defined(__linux__)
+    ServerAddress unixAddress = ServerAddress::parse("unix:/tmp/calculator_ut_server_" + std::to_string(getpid()));
+    if (check_pipelined(unixAddress) != 0 || check_pipelined(ServerAddress::parse("tcp:0")) != 0 ||
+        check_descriptor_exhaustion(unixAddress) != 0) {
+        return 1;
+    }
+#else
+    std::printf("当前平台不支持服务模式，跳过连接测试\n");
+#endif
+    std::printf("服务模式单元测试通过\n");
+    return 0;
+}
@@ -0,0 +1,198 @@
+// 单元测试：增量重算只求值被修改单元格的传递依赖者，按拓扑顺序分层；
+// 循环引用被拒绝，错误沿依赖链传递，并行重算与串行结果一致
+#include "spreadsheet.h"
+#include <cmath>
+#include <cstdio>
+#include <string>
+
+static int check_assign(Spreadsheet& sheet, const char* name, const char* expression) {
+    Status status = sheet.assign(name, expression);
+    if (!status.ok()) {
+        std::fprintf(stderr, "测试失败：'%s = %s' 赋值失败：%s\n", name, expression, status.message().c_str());
+        return 1;
+    }
+    return 0;
+}
+
+static int check_value(const Spreadsheet& sheet, const char* name, double expected) {
+    Expected<double> value = sheet.value(name);
+    if (!value.ok() || std::fabs(value.value() - expected) > 1e-12) {
+        std::fprintf(stderr, "测试失败：%s 期望 %.17g，实际 %s\n", name, expected,
+                     value.ok() ? std::to_string(value.value()).c_str() : value.error().message().c_str());
+        return 1;
+    }
+    return 0;
+}
+
+static int check_recalc(const RecalcStats& stats, size_t evaluated, size_t levels, const char* what) {
+    if (stats.evaluated != evaluated || stats.levels != levels) {
+        std::fprintf(stderr, "测试失败：%s 重算 %zu 个单元格 %zu 层，期望 %zu 个 %zu 层\n", what,
+                     stats.evaluated, stats.levels, evaluated, levels);
+        return 1;
+    }
+    return 0;
+}
+
+// 菱形依赖：修改 a 只重算 a、b、c、d，与 a 无关的 z 不重算
+static int check_incremental() {
+    Spreadsheet sheet;
+    if (check_assign(sheet, "a", "3") || check_assign(sheet, "b", "a*2+sin(a)") ||
+        check_assign(sheet, "c", "a - 1") || check_assign(sheet, "d", "b * c") || check_assign(sheet, "z", "42")) {
+        return 1;
+    }
+    if (check_recalc(sheet.recalculate(), 5, 3, "首次") != 0 ||
+        check_value(sheet, "b", 6 + std::sin(3.0)) != 0 || check_value(sheet, "d", (6 + std::sin(3.0)) * 2) != 0) {
+        return 1;
+    }
+    if (check_recalc(sheet.recalculate(), 0, 0, "无修改") != 0) {
+        return 1;
+    }
+
+    if (check_assign(sheet, "a", "1") != 0 || check_recalc(sheet.recalculate(), 4, 3, "修改 a") != 0 ||
+        check_value(sheet, "d", 0.0) != 0 || check_value(sheet, "z", 42.0) != 0) {
+        return 1;
+    }
+
+    // 改变依赖关系：c 不再依赖 a，此后修改 a 不影响 c
+    if (check_assign(sheet, "c", "z / 2") != 0 || check_recalc(sheet.recalculate(), 2, 2, "重定义 c") != 0 ||
+        check_assign(sheet, "a", "2") != 0 || check_recalc(sheet.recalculate(), 3, 3, "再次修改 a") != 0 ||
+        check_value(sheet, "d", (4 + std::sin(2.0)) * 21) != 0) {
+        return 1;
+    }
+    return 0;
+}
+
+// 引用未定义的名称：先报告未绑定变量，定义后自动重算
+static int check_forward_reference() {
+    Spreadsheet sheet;
+    if (check_assign(sheet, "u", "w + 1") != 0) {
+        return 1;
+    }
+    sheet.recalculate();
+    Expected<double> pending = sheet.value("u");
+    if (pending.ok() || pending.error().code != ErrorCode::UNBOUND_VARIABLE) {
+        std::fprintf(stderr, "测试失败：引用未定义的名称应报告未绑定变量\n");
+        return 1;
+    }
+    if (check_assign(sheet, "w", "1") != 0 || check_recalc(sheet.recalculate(), 2, 2, "定义 w") != 0 ||
+        check_value(sheet, "u", 2.0) != 0) {
+        return 1;
+    }
+    return 0;
+}
+
+// 循环引用被拒绝，原定义保持不变
+static int check_cycles() {
+    Spreadsheet sheet;
+    if (check_assign(sheet, "p", "1") != 0 || check_assign(sheet, "q", "p * 2") != 0 ||
+        check_assign(sheet, "r", "q + p") != 0) {
+        return 1;
+    }
+    sheet.recalculate();
+    const char* const cycles[][2] = {{"p", "r - 1"}, {"p", "q"}, {"s", "s + 1"}};
+    for (const auto& cycle : cycles) {
+        Status status = sheet.assign(cycle[0], cycle[1]);
+        if (status.code != ErrorCode::CYCLIC_DEPENDENCY) {
+            std::fprintf(stderr, "测试失败：'%s = %s' 应报告循环引用\n", cycle[0], cycle[1]);
+            return 1;
+        }
+    }
+    if (sheet.dirtyCount() != 0 || check_assign(sheet, "p", "5") != 0 ||
+        check_recalc(sheet.recalculate(), 3, 3, "拒绝循环后修改 p") != 0 || check_value(sheet, "r", 15.0) != 0) {
+        return 1;
+    }
+    return 0;
+}
+
+// 计算错误沿依赖链传递，修正后恢复
+static int check_errors() {
+    Spreadsheet sheet;
+    if (check_assign(sheet, "n", "0") != 0 || check_assign(sheet, "m", "1 / n") != 0 ||
+        check_assign(sheet, "k", "m + 1") != 0) {
+        return 1;
+    }
+    RecalcStats stats = sheet.recalculate();
+    Expected<double> k = sheet.value("k");
+    if (stats.errors != 2 || k.ok() || k.error().code != ErrorCode::DIVISION_BY_ZERO) {
+        std::fprintf(stderr, "测试失败：除零错误未沿依赖链传递\n");
+        return 1;
+    }
+    if (check_assign(sheet, "n", "4") != 0 || sheet.recalculate().errors != 0 || check_value(sheet, "k", 1.25) != 0) {
+        return 1;
+    }
+
+    const char* const targets[] = {"sin", "pi", "2", "a b", ""};
+    for (const char* target : targets) {
+        if (sheet.assign(target, "1").code != ErrorCode::INVALID_ASSIGNMENT) {
+            std::fprintf(stderr, "测试失败：'%s' 不应允许被赋值\n", target);
+            return 1;
+        }
+    }
+    if (sheet.assign("t", "1 +").kind() != ErrorKind::SYNTAX || sheet.value("t").ok()) {
+        std::fprintf(stderr, "测试失败：语法错误的赋值不应定义变量\n");
+        return 1;
+    }
+
+    std::string_view name;
+    std::string_view expression;
+    if (!Spreadsheet::splitAssignment("  total = a + b", name, expression) || name != "total" ||
+        expression != " a + b" || Spreadsheet::splitAssignment("a + b", name, expression)) {
+        std::fprintf(stderr, "测试失败：赋值语句拆分错误\n");
+        return 1;
+    }
+    return 0;
+}
+
+// 宽层并行重算：每层数千个单元格，结果与串行逐一相同
+static int check_parallel() {
+    const size_t width = 5000;
+    SheetOptions parallelOptions;
+    parallelOptions.jobs = 4;
+    parallelOptions.parallelThreshold = 1024;
+    Spreadsheet serial;
+    Spreadsheet parallel(parallelOptions);
+    for (Spreadsheet* sheet : {&serial, &parallel}) {
+        if (check_assign(*sheet, "base", "0.5") != 0) {
+            return 1;
+        }
+        for (size_t i = 0; i < width; i++) {
+            std::string name = "x" + std::to_string(i);
+            std::string expression = "sin(base * " + std::to_string(i) + ") + base";
+            if (check_assign(*sheet, name.c_str(), expression.c_str()) != 0 ||
+                check_assign(*sheet, ("y" + std::to_string(i)).c_str(), (name + " ^ 2").c_str()) != 0) {
+                return 1;
+            }
+        }
+    }
+    for (int round = 0; round < 2; round++) {
+        RecalcStats serialStats = serial.recalculate();
+        RecalcStats parallelStats = parallel.recalculate();
+        if (serialStats.evaluated != 2 * width + 1 || parallelStats.evaluated != serialStats.evaluated ||
+            parallelStats.levels != 3 || parallelStats.parallelLevels != 2 || serialStats.parallelLevels != 0) {
+            std::fprintf(stderr, "测试失败：第 %d 轮并行重算统计不符（%zu 个，%zu 个并行层）\n", round,
+                         parallelStats.evaluated, parallelStats.parallelLevels);
+            return 1;
+        }
+        for (size_t i = 0; i < width; i += 97) {
+            std::string name = "y" + std::to_string(i);
+            Expected<double> a = serial.value(name);
+            Expected<double> b = parallel.value(name);
+            if (!a.ok() || !b.ok() || a.value() != b.value()) {
+                std::fprintf(stderr, "测试失败：%s 并行与串行结果不一致\n", name.c_str());
+                return 1;
+            }
+        }
+        serial.assign("base", "0.25");
+        parallel.assign("base", "0.25");
+    }
+    return 0;
+}
+
+int main() {
+    if (check_incremental() != 0 || check_forward_reference() != 0 || check_cycles() != 0 ||
+        check_errors() != 0 || check_parallel() != 0) {
+        return 1;
+    }
+    std::printf("增量重算单元测试通过\n");
+    return 0;
+}
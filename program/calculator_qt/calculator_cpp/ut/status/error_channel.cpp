@@ -0,0 +1,140 @@
+// 单元测试：不抛异常的错误通道给出正确的错误码与位置，信息与异常接口一致，且出错时不分配内存
+#include "parser.h"
+#include "calculator.h"
+#include "compiler.h"
+#include "vm.h"
+#include "status.h"
+#include "allocation_counter.h"
+#include <cstdio>
+#include <string>
+
+struct Case {
+    const char* input;
+    ErrorCode code;
+    ErrorKind kind;
+    size_t offset;
+    const char* message;
+};
+
+static const Case cases[] = {
+    {"2 + $", ErrorCode::UNKNOWN_CHARACTER, ErrorKind::LEXICAL, 4, "词法错误: 未知字符: $"},
+    {"1 + 1.2.3", ErrorCode::INVALID_NUMBER, ErrorKind::LEXICAL, 7, "词法错误: 无效的数字格式: 1.2.3"},
+    {"2 * 1__0", ErrorCode::INVALID_NUMBER, ErrorKind::LEXICAL, 5, "词法错误: 无效的数字格式: 1__0"},
+    {"1e999 + 1", ErrorCode::NUMBER_OUT_OF_RANGE, ErrorKind::LEXICAL, 0, "词法错误: 数字超出范围: 1e999"},
+    {"(1 + 2", ErrorCode::MISSING_RPAREN, ErrorKind::SYNTAX, 6, "语法错误: 缺少右括号"},
+    {"1 2", ErrorCode::TRAILING_INPUT, ErrorKind::SYNTAX, 2, "语法错误: 表达式解析完成后仍有未处理的字符"},
+    {"sin 1", ErrorCode::EXPECTED_LPAREN, ErrorKind::SYNTAX, 4, "语法错误: 函数调用需要左括号"},
+    {"3 * sqrt()", ErrorCode::ARITY_MISMATCH, ErrorKind::SYNTAX, 4, "语法错误: sqrt函数需要1个参数"},
+    {"2 * * 3", ErrorCode::UNEXPECTED_TOKEN, ErrorKind::SYNTAX, 4, "语法错误: 意外的标记"},
+    {"1 + foo(1)", ErrorCode::UNKNOWN_FUNCTION, ErrorKind::SYNTAX, 4, "语法错误: 未知的函数: foo"},
+    {"sqr (2)", ErrorCode::UNKNOWN_FUNCTION, ErrorKind::SYNTAX, 0, "语法错误: 未知的函数: sqr"},
+    {"1 / (2 - 2)", ErrorCode::DIVISION_BY_ZERO, ErrorKind::EVALUATION, 0, "计算错误: 除零错误"},
+    {"1 + sqrt(-4)", ErrorCode::DOMAIN_ERROR, ErrorKind::EVALUATION, 0, "计算错误: sqrt函数的参数不能为负数"},
+    {"rate * 2", ErrorCode::UNBOUND_VARIABLE, ErrorKind::EVALUATION, 0, "计算错误: 未绑定的变量: rate"},
+};
+
+// 依次走解析、树求值与字节码执行三条不抛异常的路径，返回第一个错误
+static Status evaluate_all(const char* input, AstArena& arena, Calculator& calc, VirtualMachine& vm) {
+    arena.reset();
+    Expected<NodeId> root = Parser(input, arena).tryParse();
+    if (!root.ok()) {
+        return root.error();
+    }
+    Expected<double> tree = calc.tryEvaluate(arena, root.value());
+    Expected<Program> program = Compiler::tryCompile(arena, root.value());
+    if (!program.ok()) {
+        return program.error();
+    }
+    Expected<double> bytecode = vm.tryExecute(program.value());
+    if (tree.error().code != bytecode.error().code) {
+        return Status(ErrorCode::INTERNAL_ERROR, 0, "树求值与字节码执行的错误不一致");
+    }
+    return bytecode.error();
+}
+
+static std::string thrown_message(const char* input) {
+    try {
+        AstArena arena;
+        Calculator calc;
+        Parser parser(input, arena);
+        calc.evaluate(arena, parser.parse());
+    } catch (const CalcError& e) {
+        return e.what();
+    }
+    return std::string();
+}
+
+static int check_cases() {
+    AstArena arena;
+    Calculator calc;
+    VirtualMachine vm;
+    for (const Case& c : cases) {
+        Status status = evaluate_all(c.input, arena, calc, vm);
+        if (status.code != c.code || status.kind() != c.kind || status.offset != c.offset) {
+            std::fprintf(stderr, "测试失败：'%s' 错误码或位置不符（位置 %u）\n", c.input, status.offset);
+            return 1;
+        }
+        if (status.message() != c.message) {
+            std::fprintf(stderr, "测试失败：'%s' 错误信息为 '%s'\n", c.input, status.message().c_str());
+            return 1;
+        }
+        // 异常接口是同一通道的薄封装，信息必须一致
+        if (thrown_message(c.input) != c.message) {
+            std::fprintf(stderr, "测试失败：'%s' 异常信息与错误通道不一致\n", c.input);
+            return 1;
+        }
+    }
+
+    Status ok = evaluate_all("2 * (3 + 4)", arena, calc, vm);
+    if (!ok.ok() || ok.kind() != ErrorKind::NONE) {
+        std::fprintf(stderr, "测试失败：有效表达式报告了错误\n");
+        return 1;
+    }
+    return 0;
+}
+
+static int check_error_path_allocations() {
+    AstArena arena;
+    Calculator calc;
+    VirtualMachine vm;
+
+    // 预编译一个会在执行时出错的程序，执行阶段本身不再分配
+    arena.reset();
+    Program divide = Compiler::compile(arena, Parser("1 / (2 - 2)", arena).parse());
+
+    auto run = [&]() {
+        size_t errors = 0;
+        for (const Case& c : cases) {
+            arena.reset();
+            Expected<NodeId> root = Parser(c.input, arena).tryParse();
+            if (!root.ok() || !calc.tryEvaluate(arena, root.value()).ok()) {
+                errors++;
+            }
+        }
+        if (!vm.tryExecute(divide).ok()) {
+            errors++;
+        }
+        return errors;
+    };
+
+    run();   // 预热节点池
+    size_t before = allocation_count;
+    size_t errors = 0;
+    for (int round = 0; round < 100; round++) {
+        errors += run();
+    }
+    size_t allocations = allocation_count - before;
+    if (allocations != 0 || errors != 100 * (sizeof(cases) / sizeof(cases[0]) + 1)) {
+        std::fprintf(stderr, "测试失败：错误路径期望 0 次堆分配，实际 %zu 次（错误 %zu 个）\n", allocations, errors);
+        return 1;
+    }
+    return 0;
+}
+
+int main() {
+    if (check_cases() != 0 || check_error_path_allocations() != 0) {
+        return 1;
+    }
+    std::printf("错误通道单元测试通过\n");
+    return 0;
+}
@@ -0,0 +1,39 @@
+// 替换全局 operator new/delete，统计堆分配次数，并可让工作线程的分配失败
+#include "allocation_counter.h"
+#include <cstdlib>
+#include <new>
+#include <thread>
+
+size_t allocation_count = 0;
+std::atomic<size_t> worker_allocation_failures{0};
+
+static const std::thread::id main_thread = std::this_thread::get_id();
+
+static bool inject_failure() {
+    size_t left = worker_allocation_failures.load(std::memory_order_relaxed);
+    while (left > 0 && std::this_thread::get_id() != main_thread) {
+        if (worker_allocation_failures.compare_exchange_weak(left, left - 1)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void* operator new(std::size_t size) {
+    allocation_count++;
+    if (inject_failure()) {
+        throw std::bad_alloc();
+    }
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
@@ -0,0 +1,14 @@
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+#include <atomic>
+#include <cstddef>
+
+// 全局 operator new 的调用次数。链接 ut_allocation_counter 的测试程序中，
+// allocation_counter.cpp 替换了全局 operator new/delete，用来断言稳态路径不分配堆内存
+extern size_t allocation_count;
+
+// 大于 0 时，主线程以外的线程接下来这么多次分配抛出 std::bad_alloc，用来测试工作线程的异常处理
+extern std::atomic<size_t> worker_allocation_failures;
+
+#endif // ALLOCATION_COUNTER_H
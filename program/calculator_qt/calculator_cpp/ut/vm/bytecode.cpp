@@ -0,0 +1,79 @@
+// 单元测试：字节码编译与虚拟机执行结果与树遍历求值一致，且重复执行不分配内存
+#include "parser.h"
+#include "calculator.h"
+#include "compiler.h"
+#include "vm.h"
+#include "allocation_counter.h"
+#include <cstdio>
+
+static const char* const inputs[] = {
+    "2 + 3 * 4",
+    "(2 + 3) * 4",
+    "10 - 6 / 2",
+    "2^3^2",
+    "-(-2) + +3",
+    "sin(pi/2) + cos(0)",
+    "sqrt(16) + log(100) - ln(e)",
+    "abs(-5) * exp(1) / tan(1)",
+    "((((((2+3)*4)-5)/6)^2)+1)",
+    "sqrt(abs(-16)) + sqrt(sqrt(81))",
+};
+
+int main() {
+    AstArena arena;
+    Calculator calc;
+    VirtualMachine vm;
+
+    // 1) 与 Calculator::evaluate 逐位一致
+    for (const char* input : inputs) {
+        arena.reset();
+        Parser parser(input, arena);
+        NodeId root = parser.parse();
+        double expected = calc.evaluate(arena, root);
+        Program program = Compiler::compile(arena, root);
+        double actual = vm.execute(program);
+        if (actual != expected) {
+            std::fprintf(stderr, "测试失败：'%s' 期望 %.17g，实际 %.17g\n", input, expected, actual);
+            return 1;
+        }
+    }
+
+    // 2) 编译一次后重复执行不分配内存
+    {
+        arena.reset();
+        Parser parser("sqrt(2^2 + 3^2) * abs(-5) + sin(pi/4)", arena);
+        Program program = Compiler::compile(arena, parser.parse());
+        double first = vm.execute(program);
+        size_t before = allocation_count;
+        for (int i = 0; i < 100000; i++) {
+            if (vm.execute(program) != first) {
+                std::fprintf(stderr, "测试失败：重复执行结果不一致\n");
+                return 1;
+            }
+        }
+        if (allocation_count != before) {
+            std::fprintf(stderr, "测试失败：重复执行期望 0 次堆分配，实际 %zu 次\n", allocation_count - before);
+            return 1;
+        }
+    }
+
+    // 3) 除零错误与树遍历求值一致
+    {
+        arena.reset();
+        Parser parser("1 / (2 - 2)", arena);
+        Program program = Compiler::compile(arena, parser.parse());
+        bool thrown = false;
+        try {
+            vm.execute(program);
+        } catch (const EvaluationError&) {
+            thrown = true;
+        }
+        if (!thrown) {
+            std::fprintf(stderr, "测试失败：除零未抛出 EvaluationError\n");
+            return 1;
+        }
+    }
+
+    std::printf("字节码虚拟机单元测试通过\n");
+    return 0;
+}
@@ -0,0 +1,180 @@
+// 单元测试：向量数学核在各指令集级别、两个精度档位上逐元素与参考值比较，
+// 输入为稠密扫描、随机位模式、约简边界（π/2 的整数倍附近）与特殊值；误差不超过档位声明的 ULP。
+// 参考值由 long double 数学库计算后舍入到双精度，即正确舍入的结果（双精度的 log10 等本身可有 2 ULP 误差，不宜作参考）
+#include "vector_math.h"
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+
+// 双精度按数值顺序映射到整数，相邻的可表示数相差 1；+0 与 -0 重合
+int64_t ordered(double value) {
+    int64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits < 0 ? std::numeric_limits<int64_t>::min() - bits : bits;
+}
+
+// 两个 NaN 视为相同；一个 NaN 一个非 NaN 视为无穷大的误差
+uint64_t ulpDistance(double actual, double expected) {
+    if (std::isnan(actual) || std::isnan(expected)) {
+        return std::isnan(actual) && std::isnan(expected) ? 0 : UINT64_MAX;
+    }
+    int64_t a = ordered(actual);
+    int64_t b = ordered(expected);
+    return a > b ? static_cast<uint64_t>(a) - static_cast<uint64_t>(b) : static_cast<uint64_t>(b) - static_cast<uint64_t>(a);
+}
+
+double reference(MathFunction function, double x) {
+    long double value = x;
+    switch (function) {
+        case MATH_SIN: return static_cast<double>(std::sin(value));
+        case MATH_COS: return static_cast<double>(std::cos(value));
+        case MATH_TAN: return static_cast<double>(std::tan(value));
+        case MATH_LOG: return static_cast<double>(std::log10(value));
+        case MATH_LN: return static_cast<double>(std::log(value));
+        case MATH_EXP: return static_cast<double>(std::exp(value));
+        case MATH_SQRT: return std::sqrt(x);
+        default: return std::fabs(x);
+    }
+}
+
+double fromBits(uint64_t bits) {
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+void sweep(std::vector<double>& inputs, double lo, double hi, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        inputs.push_back(lo + (hi - lo) * static_cast<double>(i) / static_cast<double>(count - 1));
+    }
+}
+
+// 各函数的测试输入：稠密扫描覆盖常用区间，随机输入覆盖整个定义域
+std::vector<double> inputsFor(MathFunction function) {
+    std::mt19937_64 random(2024 + function);
+    std::vector<double> inputs;
+    const double specials[] = {0.0, -0.0, 1.0, -1.0, INFINITY, -INFINITY, NAN, 5e-324, -5e-324, 0x1p-1022,
+                               std::numeric_limits<double>::max(), -std::numeric_limits<double>::max()};
+    for (double special : specials) {
+        inputs.push_back(special);
+    }
+    switch (function) {
+        case MATH_SIN:
+        case MATH_COS:
+        case MATH_TAN: {
+            sweep(inputs, -10.0, 10.0, 200001);
+            sweep(inputs, -1e-6, 1e-6, 2001);
+            std::uniform_real_distribution<double> wide(-1e5, 1e5);
+            std::uniform_real_distribution<double> huge(-4e6, 4e6);
+            for (int i = 0; i < 100000; i++) {
+                inputs.push_back(wide(random));
+            }
+            for (int i = 0; i < 10000; i++) {
+                inputs.push_back(huge(random));
+            }
+            // π/2 的整数倍及其相邻的可表示数：约简结果接近 0 时相对误差最敏感
+            for (int k = -2000; k <= 2000; k++) {
+                double center = k * (M_PI / 2);
+                inputs.push_back(center);
+                inputs.push_back(std::nextafter(center, INFINITY));
+                inputs.push_back(std::nextafter(center, -INFINITY));
+            }
+            break;
+        }
+        case MATH_EXP:
+            sweep(inputs, -746.0, 710.0, 200001);
+            sweep(inputs, -1.0, 1.0, 20001);
+            sweep(inputs, -1e-10, 1e-10, 2001);
+            inputs.push_back(709.782712893384);
+            inputs.push_back(709.7827128933841);
+            inputs.push_back(-745.1332191019411);
+            inputs.push_back(-745.1332191019412);
+            inputs.push_back(-708.3964185322641);
+            break;
+        default: {
+            sweep(inputs, 0.5, 2.0, 200001);
+            sweep(inputs, 1.0 - 1e-6, 1.0 + 1e-6, 2001);
+            sweep(inputs, -2.0, 0.0, 101);
+            // 随机位模式，覆盖次正规数与整个指数范围
+            for (int i = 0; i < 200000; i++) {
+                double value = fromBits(random() & 0x7fefffffffffffffULL);
+                inputs.push_back(function == MATH_ABS && (i & 1) ? -value : value);
+            }
+            break;
+        }
+    }
+    return inputs;
+}
+
+} // namespace
+
+int main() {
+    const SimdLevel levels[] = {SIMD_SCALAR, SIMD_SSE2, SIMD_AVX2};
+    const struct { MathAccuracy accuracy; uint64_t bound; } tiers[] = {{MATH_ULP1, 1}, {MATH_ULP4, 4}};
+    for (int function = 0; function < MATH_FUNCTION_COUNT; function++) {
+        MathFunction f = static_cast<MathFunction>(function);
+        std::vector<double> inputs = inputsFor(f);
+        // 长度不是向量宽度的倍数，覆盖尾部处理
+        inputs.push_back(0.75);
+        std::vector<double> expected(inputs.size());
+        for (size_t i = 0; i < inputs.size(); i++) {
+            expected[i] = reference(f, inputs[i]);
+        }
+        for (const auto& tier : tiers) {
+            for (SimdLevel level : levels) {
+                std::vector<double> values = inputs;
+                mathKernels(level, tier.accuracy).kernel[f](values.data(), values.size());
+                uint64_t worst = 0;
+                double worstInput = 0.0;
+                for (size_t i = 0; i < inputs.size(); i++) {
+                    uint64_t error = ulpDistance(values[i], expected[i]);
+                    if (error > worst) {
+                        worst = error;
+                        worstInput = inputs[i];
+                    }
+                }
+                std::printf("%-5s %-4s %-6s 最大误差 %llu ULP（输入 %.17g）\n", mathFunctionName(f),
+                            mathAccuracyName(tier.accuracy), simdLevelName(level),
+                            static_cast<unsigned long long>(worst), worstInput);
+                if (worst > tier.bound) {
+                    std::fprintf(stderr, "测试失败：%s 在 %s 档、%s 级别的误差 %llu ULP 超过 %llu（输入 %.17g）\n",
+                                 mathFunctionName(f), mathAccuracyName(tier.accuracy), simdLevelName(level),
+                                 static_cast<unsigned long long>(worst), static_cast<unsigned long long>(tier.bound),
+                                 worstInput);
+                    return 1;
+                }
+            }
+        }
+    }
+
+    // 数学库档位与逐元素调用逐位一致
+    {
+        std::vector<double> inputs = inputsFor(MATH_SIN);
+        std::vector<double> values = inputs;
+        mathKernels(SIMD_AVX2, MATH_LIBM).kernel[MATH_SIN](values.data(), values.size());
+        for (size_t i = 0; i < inputs.size(); i++) {
+            if (ulpDistance(values[i], std::sin(inputs[i])) != 0) {
+                std::fprintf(stderr, "测试失败：libm 档的 sin(%.17g) 与数学库不一致\n", inputs[i]);
+                return 1;
+            }
+        }
+    }
+
+    // 档位名称的解析
+    {
+        MathAccuracy accuracy = MATH_LIBM;
+        if (!parseMathAccuracy("ulp4", accuracy) || accuracy != MATH_ULP4 || parseMathAccuracy("fast", accuracy)) {
+            std::fprintf(stderr, "测试失败：精度档位名称解析错误\n");
+            return 1;
+        }
+    }
+
+    std::printf("向量数学核单元测试通过\n");
+    return 0;
+}
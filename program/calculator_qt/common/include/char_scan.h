@@ -0,0 +1,90 @@
+#ifndef CHAR_SCAN_H
+#define CHAR_SCAN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 词法分析关心的字符类别；不属于任何类别的字节（包括 '.'、'=' 与非 ASCII）在各位图中均为 0
+typedef enum {
+    CHAR_WHITESPACE,   // ' '、'\t'、'\n'、'\v'、'\f'、'\r'
+    CHAR_DIGIT,        // '0'..'9'
+    CHAR_ALPHA,        // ASCII 字母
+    CHAR_OPERATOR,     // '+'、'-'、'*'、'/'、'^'
+    CHAR_PAREN,        // '('、')'
+    CHAR_CLASS_COUNT
+} CharClass;
+
+#define CHAR_CLASS_BIT(c) (1u << (c))
+
+// 每块 64 字节，位图的第 i 位对应块中第 i 个字节
+#define CHAR_SCAN_BLOCK 64
+
+typedef struct {
+    uint64_t masks[CHAR_CLASS_COUNT];
+} CharClassBlock;
+
+// 分类所用的指令集：SSE2 每步 16 字节，AVX2 每步 32 字节
+typedef enum {
+    CHAR_SCAN_SCALAR,
+    CHAR_SCAN_SSE2,
+    CHAR_SCAN_AVX2
+} CharScanLevel;
+
+// 对 text 开头的 length（不超过 CHAR_SCAN_BLOCK）个字节分类，其余位为 0
+typedef void (*CharClassifyFunction)(const char* text, size_t length, CharClassBlock* block);
+
+// 运行时检测当前 CPU 支持的最高级别（非 x86-64 平台恒为 CHAR_SCAN_SCALAR）
+CharScanLevel char_scan_detect_level(void);
+const char* char_scan_level_name(CharScanLevel level);
+// 取指定级别的分类函数；当前 CPU 不支持该级别时退回到可用的最高级别
+CharClassifyFunction char_classify_function(CharScanLevel level);
+// 新建的扫描器默认使用的级别，初始为检测到的最高级别；用于基准与测试比较各级别
+void char_scan_set_level(CharScanLevel level);
+CharScanLevel char_scan_level(void);
+
+// 一次性预扫描整段文本：写入 (length + 63) / 64 个块
+void char_classify(const char* text, size_t length, CharClassBlock* blocks, CharScanLevel level);
+
+// 词法分析器使用的流式扫描器：只保留当前 64 字节块的位图，跨块时才分类下一块，不分配内存
+typedef struct {
+    const char* text;
+    size_t length;
+    size_t base;                   // 当前块在文本中的起点；尚未分类时为 SIZE_MAX
+    CharClassBlock block;
+    CharClassifyFunction classify;
+} CharScanner;
+
+void char_scanner_init(CharScanner* scanner, const char* text, size_t length);
+// 跨块时的慢路径：分类 pos 所在的块后继续跳过
+size_t char_scanner_skip_slow(CharScanner* scanner, size_t pos, unsigned classes);
+
+// 从 pos 起跳过属于 classes（CHAR_CLASS_BIT 的组合）的连续字节，返回第一个不属于的位置，最大为 length。
+// 词法分析器的每个记号都会调用，块内命中的快路径内联，classes 为常量时位图的合并在编译期展开
+static inline size_t char_scanner_skip(CharScanner* scanner, size_t pos, unsigned classes) {
+    size_t base = pos & ~(size_t)(CHAR_SCAN_BLOCK - 1);
+    if (base == scanner->base) {
+        uint64_t members = 0;
+        for (int c = 0; c < CHAR_CLASS_COUNT; c++) {
+            if (classes & CHAR_CLASS_BIT(c)) {
+                members |= scanner->block.masks[c];
+            }
+        }
+        // 块内 pos 之后第一个不属于这些类别的字节；文本末尾之后的位为 0，因而最多停在 length
+        uint64_t others = ~members >> (pos - base);
+        if (others != 0) {
+            return pos + (size_t)__builtin_ctzll(others);
+        }
+        pos = base + CHAR_SCAN_BLOCK;
+    }
+    return char_scanner_skip_slow(scanner, pos, classes);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CHAR_SCAN_H
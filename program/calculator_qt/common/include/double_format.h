@@ -0,0 +1,44 @@
+#ifndef DOUBLE_FORMAT_H
+#define DOUBLE_FORMAT_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 最短模式输出的最大长度（含 '\0'）："-1.2345678901234567e-308" 为 25 字节
+#define DOUBLE_FORMAT_SHORTEST_SIZE 32
+
+// 最短往返表示最多 17 位有效数字
+#define DOUBLE_FORMAT_MAX_DIGITS 17
+
+// 格式模式
+typedef enum {
+    FORMAT_SHORTEST,     // 能精确读回原值的最短表示；十进制指数在 [-5, 17) 内用定点，否则用科学记数法
+    FORMAT_FIXED,        // 定点，precision 为小数位数；版式同 %.*f，舍入不同（见 format_double）
+    FORMAT_SCIENTIFIC,   // 科学记数法，precision 为小数位数；版式同 %.*e，舍入不同
+    FORMAT_SIGNIFICANT   // precision 位有效数字，去除尾随零；版式选择同 %.*g，舍入不同
+} FormatMode;
+
+// 最短往返数字：有限的 |value| 等于 0.d1d2...dn × 10^point，digits 不含尾随零、不以 '\0' 结尾（零为 "0"）。
+// 先用 Grisu3 只做 64 位整数运算，极少数无法确定最短结果的值退回逐位数试探。返回位数 n
+int shortest_digits(double value, char digits[DOUBLE_FORMAT_MAX_DIGITS], int* point);
+
+// 将 value 按 mode 写入 buffer（以 '\0' 结尾），返回长度（不含 '\0'）；缓冲区不足时返回 0。
+// 定点、科学记数法与有效数字模式不与 printf 逐位一致：它们对最短往返数字（即 FORMAT_SHORTEST 显示的十进制数）
+// 在所需位数处四舍五入（恰为一半时远离零进位），位数不足时补零；printf 则对二进制精确值舍入，恰为一半时取偶。
+// 例如保留两位小数时 2.675（精确值略小于 2.675）得到 "2.68"，printf 为 "2.67"；
+// 3182.625（可精确表示）得到 "3182.63"，printf 为 "3182.62"；0.5 保留零位得到 "1"，printf 为 "0"。
+// 这三种模式只供库的调用方使用，两个计算器的输出都是最短模式。
+// 非有限值输出 "inf"、"-inf"、"nan"，负零保留符号
+size_t format_double(char* buffer, size_t size, double value, FormatMode mode, int precision);
+
+// 等价于 format_double(buffer, size, value, FORMAT_SHORTEST, 0)
+size_t format_shortest(char* buffer, size_t size, double value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DOUBLE_FORMAT_H
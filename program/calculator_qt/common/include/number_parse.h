@@ -0,0 +1,37 @@
+#ifndef NUMBER_PARSE_H
+#define NUMBER_PARSE_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 数字字面量的解析结果
+typedef enum {
+    NUMBER_OK,            // 解析成功
+    NUMBER_INVALID,       // 格式错误：第二个小数点、位置不当的分隔符、缺少数字等
+    NUMBER_OUT_OF_RANGE   // 超出双精度范围（上溢）；下溢按 IEEE 舍入为次正规数或零，不视为错误
+} NumberStatus;
+
+typedef struct {
+    NumberStatus status;
+    size_t length;        // 字面量的长度；出错时延伸到其后紧邻的数字、小数点与分隔符，如 "1.2.3" 为 5
+    size_t error_offset;  // 出错字符相对字面量起点的偏移，如 "1.2.3" 为 3；上溢时为 0
+} NumberResult;
+
+// 从 [first, last) 的开头解析一个无符号数字字面量，结果按 IEEE 舍入到最近（偶数优先），与 strtod 一致。
+// 支持的语法：
+//   十进制    123、1.5、.5、1.、1e10、2.5E-3
+//   十六进制  0x1F、0x1.8p3、0X.Ap-2（p 指数为二进制，可省略）
+//   分隔符    1_000_000、0xFF_FF（'_' 只能出现在两个数字之间）
+// 指数标记后没有数字时不属于字面量（"2e" 解析为 2，e 留给下一个标识符）。
+// 不分配内存、与区域设置无关。十进制先走 Clinger 快速路径，再走 Eisel-Lemire；
+// 有效数字超过 19 位且截断后无法确定舍入方向时，退回在栈上规整数字后调用 strtod
+NumberResult parse_number(const char* first, const char* last, double* value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NUMBER_PARSE_H
@@ -0,0 +1,198 @@
+#include "char_scan.h"
+#include <string.h>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CHAR_SCAN_HAVE_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+// 标量实现：逐字节判断，任何平台可用
+static unsigned char scalar_classes(unsigned char c) {
+    if (c == ' ' || (c >= '\t' && c <= '\r')) {
+        return CHAR_CLASS_BIT(CHAR_WHITESPACE);
+    }
+    if (c >= '0' && c <= '9') {
+        return CHAR_CLASS_BIT(CHAR_DIGIT);
+    }
+    if ((unsigned char)((c | 0x20) - 'a') < 26) {
+        return CHAR_CLASS_BIT(CHAR_ALPHA);
+    }
+    if (c == '+' || c == '-' || c == '*' || c == '/' || c == '^') {
+        return CHAR_CLASS_BIT(CHAR_OPERATOR);
+    }
+    if (c == '(' || c == ')') {
+        return CHAR_CLASS_BIT(CHAR_PAREN);
+    }
+    return 0;
+}
+
+static void scalar_classify(const char* text, size_t length, CharClassBlock* block) {
+    memset(block, 0, sizeof(*block));
+    for (size_t i = 0; i < length; i++) {
+        unsigned classes = scalar_classes((unsigned char)text[i]);
+        for (int c = 0; c < CHAR_CLASS_COUNT; c++) {
+            block->masks[c] |= (uint64_t)((classes >> c) & 1) << i;
+        }
+    }
+}
+
+#ifdef CHAR_SCAN_HAVE_X86_SIMD
+
+// 不足一块时复制到补零的缓冲区，'\0' 不属于任何类别
+#define LOAD_BLOCK(text, length, buffer)                     \
+    if ((length) < CHAR_SCAN_BLOCK) {                        \
+        memset(buffer, 0, sizeof(buffer));                   \
+        memcpy(buffer, text, length);                        \
+        text = buffer;                                       \
+    }
+
+// SSE2 是 x86-64 的基线指令集，无需运行时检测。
+// 区间判断：按字节回绕的 x - lo 与 min(x - lo, hi - lo)（无符号）相等即 x ∈ [lo, hi]
+static void sse2_classify(const char* text, size_t length, CharClassBlock* block) {
+    char buffer[CHAR_SCAN_BLOCK];
+    LOAD_BLOCK(text, length, buffer)
+    const __m128i zero_char = _mm_set1_epi8('0');
+    const __m128i nine = _mm_set1_epi8(9);
+    const __m128i lower = _mm_set1_epi8(0x20);
+    const __m128i a = _mm_set1_epi8('a');
+    const __m128i z = _mm_set1_epi8(25);
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i four = _mm_set1_epi8(4);
+    memset(block, 0, sizeof(*block));
+    for (int i = 0; i < CHAR_SCAN_BLOCK; i += 16) {
+        __m128i x = _mm_loadu_si128((const __m128i*)(text + i));
+        __m128i control = _mm_sub_epi8(x, tab);
+        __m128i space = _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8(' ')),
+                                     _mm_cmpeq_epi8(_mm_min_epu8(control, four), control));
+        __m128i offset = _mm_sub_epi8(x, zero_char);
+        __m128i digit = _mm_cmpeq_epi8(_mm_min_epu8(offset, nine), offset);
+        __m128i letter = _mm_sub_epi8(_mm_or_si128(x, lower), a);
+        __m128i alpha = _mm_cmpeq_epi8(_mm_min_epu8(letter, z), letter);
+        __m128i op = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8('+')), _mm_cmpeq_epi8(x, _mm_set1_epi8('-'))),
+            _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8('*')), _mm_cmpeq_epi8(x, _mm_set1_epi8('/'))),
+                         _mm_cmpeq_epi8(x, _mm_set1_epi8('^'))));
+        __m128i paren = _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8('(')), _mm_cmpeq_epi8(x, _mm_set1_epi8(')')));
+        block->masks[CHAR_WHITESPACE] |= (uint64_t)(uint16_t)_mm_movemask_epi8(space) << i;
+        block->masks[CHAR_DIGIT] |= (uint64_t)(uint16_t)_mm_movemask_epi8(digit) << i;
+        block->masks[CHAR_ALPHA] |= (uint64_t)(uint16_t)_mm_movemask_epi8(alpha) << i;
+        block->masks[CHAR_OPERATOR] |= (uint64_t)(uint16_t)_mm_movemask_epi8(op) << i;
+        block->masks[CHAR_PAREN] |= (uint64_t)(uint16_t)_mm_movemask_epi8(paren) << i;
+    }
+}
+
+// AVX2 实现只在该函数上启用目标指令集，调用前需经 char_scan_detect_level() 确认
+__attribute__((target("avx2"))) static void avx2_classify(const char* text, size_t length, CharClassBlock* block) {
+    char buffer[CHAR_SCAN_BLOCK];
+    LOAD_BLOCK(text, length, buffer)
+    const __m256i zero_char = _mm256_set1_epi8('0');
+    const __m256i nine = _mm256_set1_epi8(9);
+    const __m256i lower = _mm256_set1_epi8(0x20);
+    const __m256i a = _mm256_set1_epi8('a');
+    const __m256i z = _mm256_set1_epi8(25);
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i four = _mm256_set1_epi8(4);
+    memset(block, 0, sizeof(*block));
+    for (int i = 0; i < CHAR_SCAN_BLOCK; i += 32) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)(text + i));
+        __m256i control = _mm256_sub_epi8(x, tab);
+        __m256i space = _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8(' ')),
+                                        _mm256_cmpeq_epi8(_mm256_min_epu8(control, four), control));
+        __m256i offset = _mm256_sub_epi8(x, zero_char);
+        __m256i digit = _mm256_cmpeq_epi8(_mm256_min_epu8(offset, nine), offset);
+        __m256i letter = _mm256_sub_epi8(_mm256_or_si256(x, lower), a);
+        __m256i alpha = _mm256_cmpeq_epi8(_mm256_min_epu8(letter, z), letter);
+        __m256i op = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('+')), _mm256_cmpeq_epi8(x, _mm256_set1_epi8('-'))),
+            _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('*')), _mm256_cmpeq_epi8(x, _mm256_set1_epi8('/'))),
+                _mm256_cmpeq_epi8(x, _mm256_set1_epi8('^'))));
+        __m256i paren =
+            _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('(')), _mm256_cmpeq_epi8(x, _mm256_set1_epi8(')')));
+        block->masks[CHAR_WHITESPACE] |= (uint64_t)(uint32_t)_mm256_movemask_epi8(space) << i;
+        block->masks[CHAR_DIGIT] |= (uint64_t)(uint32_t)_mm256_movemask_epi8(digit) << i;
+        block->masks[CHAR_ALPHA] |= (uint64_t)(uint32_t)_mm256_movemask_epi8(alpha) << i;
+        block->masks[CHAR_OPERATOR] |= (uint64_t)(uint32_t)_mm256_movemask_epi8(op) << i;
+        block->masks[CHAR_PAREN] |= (uint64_t)(uint32_t)_mm256_movemask_epi8(paren) << i;
+    }
+}
+
+#endif // CHAR_SCAN_HAVE_X86_SIMD
+
+CharScanLevel char_scan_detect_level(void) {
+#ifdef CHAR_SCAN_HAVE_X86_SIMD
+    return __builtin_cpu_supports("avx2") ? CHAR_SCAN_AVX2 : CHAR_SCAN_SSE2;
+#else
+    return CHAR_SCAN_SCALAR;
+#endif
+}
+
+const char* char_scan_level_name(CharScanLevel level) {
+    switch (level) {
+        case CHAR_SCAN_AVX2: return "avx2";
+        case CHAR_SCAN_SSE2: return "sse2";
+        default: return "scalar";
+    }
+}
+
+CharClassifyFunction char_classify_function(CharScanLevel level) {
+    if (level > char_scan_detect_level()) {
+        level = char_scan_detect_level();
+    }
+    switch (level) {
+#ifdef CHAR_SCAN_HAVE_X86_SIMD
+        case CHAR_SCAN_AVX2: return avx2_classify;
+        case CHAR_SCAN_SSE2: return sse2_classify;
+#endif
+        default: return scalar_classify;
+    }
+}
+
+// 只在基准与测试中修改；-1 表示使用检测到的最高级别
+static int selected_level = -1;
+
+void char_scan_set_level(CharScanLevel level) {
+    selected_level = (int)level;
+}
+
+CharScanLevel char_scan_level(void) {
+    return selected_level < 0 ? char_scan_detect_level() : (CharScanLevel)selected_level;
+}
+
+void char_classify(const char* text, size_t length, CharClassBlock* blocks, CharScanLevel level) {
+    CharClassifyFunction classify = char_classify_function(level);
+    for (size_t offset = 0; offset < length; offset += CHAR_SCAN_BLOCK) {
+        size_t rest = length - offset;
+        classify(text + offset, rest < CHAR_SCAN_BLOCK ? rest : CHAR_SCAN_BLOCK, blocks++);
+    }
+}
+
+void char_scanner_init(CharScanner* scanner, const char* text, size_t length) {
+    scanner->text = text;
+    scanner->length = length;
+    scanner->base = SIZE_MAX;
+    scanner->classify = char_classify_function(char_scan_level());
+}
+
+size_t char_scanner_skip_slow(CharScanner* scanner, size_t pos, unsigned classes) {
+    while (pos < scanner->length) {
+        size_t base = pos & ~(size_t)(CHAR_SCAN_BLOCK - 1);
+        if (base != scanner->base) {
+            size_t rest = scanner->length - base;
+            scanner->classify(scanner->text + base, rest < CHAR_SCAN_BLOCK ? rest : CHAR_SCAN_BLOCK, &scanner->block);
+            scanner->base = base;
+        }
+        uint64_t members = 0;
+        for (int c = 0; c < CHAR_CLASS_COUNT; c++) {
+            if (classes & CHAR_CLASS_BIT(c)) {
+                members |= scanner->block.masks[c];
+            }
+        }
+        uint64_t others = ~members >> (pos - base);
+        if (others != 0) {
+            return pos + (size_t)__builtin_ctzll(others);
+        }
+        pos = base + CHAR_SCAN_BLOCK;
+    }
+    return scanner->length;
+}
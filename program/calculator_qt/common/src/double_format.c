@@ -0,0 +1,502 @@
+#include "double_format.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// 64 位有效数字与二进制指数表示的浮点数：值为 f × 2^e
+typedef struct {
+    uint64_t f;
+    int e;
+} DiyFp;
+
+// 缓存的 10 的幂：10^k ≈ f × 2^e，f 已规格化（最高位为 1）并舍入到最近。
+// k 从 -348 到 340，间隔 8，由精确的有理数运算生成
+typedef struct {
+    uint64_t f;
+    int16_t e;
+    int16_t k;
+} CachedPower;
+
+static const CachedPower cached_powers[] = {
+    {0xfa8fd5a0081c0288ULL, -1220, -348},
+    {0xbaaee17fa23ebf76ULL, -1193, -340},
+    {0x8b16fb203055ac76ULL, -1166, -332},
+    {0xcf42894a5dce35eaULL, -1140, -324},
+    {0x9a6bb0aa55653b2dULL, -1113, -316},
+    {0xe61acf033d1a45dfULL, -1087, -308},
+    {0xab70fe17c79ac6caULL, -1060, -300},
+    {0xff77b1fcbebcdc4fULL, -1034, -292},
+    {0xbe5691ef416bd60cULL, -1007, -284},
+    {0x8dd01fad907ffc3cULL, -980, -276},
+    {0xd3515c2831559a83ULL, -954, -268},
+    {0x9d71ac8fada6c9b5ULL, -927, -260},
+    {0xea9c227723ee8bcbULL, -901, -252},
+    {0xaecc49914078536dULL, -874, -244},
+    {0x823c12795db6ce57ULL, -847, -236},
+    {0xc21094364dfb5637ULL, -821, -228},
+    {0x9096ea6f3848984fULL, -794, -220},
+    {0xd77485cb25823ac7ULL, -768, -212},
+    {0xa086cfcd97bf97f4ULL, -741, -204},
+    {0xef340a98172aace5ULL, -715, -196},
+    {0xb23867fb2a35b28eULL, -688, -188},
+    {0x84c8d4dfd2c63f3bULL, -661, -180},
+    {0xc5dd44271ad3cdbaULL, -635, -172},
+    {0x936b9fcebb25c996ULL, -608, -164},
+    {0xdbac6c247d62a584ULL, -582, -156},
+    {0xa3ab66580d5fdaf6ULL, -555, -148},
+    {0xf3e2f893dec3f126ULL, -529, -140},
+    {0xb5b5ada8aaff80b8ULL, -502, -132},
+    {0x87625f056c7c4a8bULL, -475, -124},
+    {0xc9bcff6034c13053ULL, -449, -116},
+    {0x964e858c91ba2655ULL, -422, -108},
+    {0xdff9772470297ebdULL, -396, -100},
+    {0xa6dfbd9fb8e5b88fULL, -369, -92},
+    {0xf8a95fcf88747d94ULL, -343, -84},
+    {0xb94470938fa89bcfULL, -316, -76},
+    {0x8a08f0f8bf0f156bULL, -289, -68},
+    {0xcdb02555653131b6ULL, -263, -60},
+    {0x993fe2c6d07b7facULL, -236, -52},
+    {0xe45c10c42a2b3b06ULL, -210, -44},
+    {0xaa242499697392d3ULL, -183, -36},
+    {0xfd87b5f28300ca0eULL, -157, -28},
+    {0xbce5086492111aebULL, -130, -20},
+    {0x8cbccc096f5088ccULL, -103, -12},
+    {0xd1b71758e219652cULL, -77, -4},
+    {0x9c40000000000000ULL, -50, 4},
+    {0xe8d4a51000000000ULL, -24, 12},
+    {0xad78ebc5ac620000ULL, 3, 20},
+    {0x813f3978f8940984ULL, 30, 28},
+    {0xc097ce7bc90715b3ULL, 56, 36},
+    {0x8f7e32ce7bea5c70ULL, 83, 44},
+    {0xd5d238a4abe98068ULL, 109, 52},
+    {0x9f4f2726179a2245ULL, 136, 60},
+    {0xed63a231d4c4fb27ULL, 162, 68},
+    {0xb0de65388cc8ada8ULL, 189, 76},
+    {0x83c7088e1aab65dbULL, 216, 84},
+    {0xc45d1df942711d9aULL, 242, 92},
+    {0x924d692ca61be758ULL, 269, 100},
+    {0xda01ee641a708deaULL, 295, 108},
+    {0xa26da3999aef774aULL, 322, 116},
+    {0xf209787bb47d6b85ULL, 348, 124},
+    {0xb454e4a179dd1877ULL, 375, 132},
+    {0x865b86925b9bc5c2ULL, 402, 140},
+    {0xc83553c5c8965d3dULL, 428, 148},
+    {0x952ab45cfa97a0b3ULL, 455, 156},
+    {0xde469fbd99a05fe3ULL, 481, 164},
+    {0xa59bc234db398c25ULL, 508, 172},
+    {0xf6c69a72a3989f5cULL, 534, 180},
+    {0xb7dcbf5354e9beceULL, 561, 188},
+    {0x88fcf317f22241e2ULL, 588, 196},
+    {0xcc20ce9bd35c78a5ULL, 614, 204},
+    {0x98165af37b2153dfULL, 641, 212},
+    {0xe2a0b5dc971f303aULL, 667, 220},
+    {0xa8d9d1535ce3b396ULL, 694, 228},
+    {0xfb9b7cd9a4a7443cULL, 720, 236},
+    {0xbb764c4ca7a44410ULL, 747, 244},
+    {0x8bab8eefb6409c1aULL, 774, 252},
+    {0xd01fef10a657842cULL, 800, 260},
+    {0x9b10a4e5e9913129ULL, 827, 268},
+    {0xe7109bfba19c0c9dULL, 853, 276},
+    {0xac2820d9623bf429ULL, 880, 284},
+    {0x80444b5e7aa7cf85ULL, 907, 292},
+    {0xbf21e44003acdd2dULL, 933, 300},
+    {0x8e679c2f5e44ff8fULL, 960, 308},
+    {0xd433179d9c8cb841ULL, 986, 316},
+    {0x9e19db92b4e31ba9ULL, 1013, 324},
+    {0xeb96bf6ebadf77d9ULL, 1039, 332},
+    {0xaf87023b9bf0ee6bULL, 1066, 340},
+};
+
+#define CACHED_POWERS_OFFSET 348
+#define CACHED_POWERS_STEP 8
+// 缩放后 w 的二进制指数落在 [MIN_TARGET_EXPONENT, MAX_TARGET_EXPONENT] 内，整数部分可放进 32 位
+#define MIN_TARGET_EXPONENT (-60)
+#define MAX_TARGET_EXPONENT (-32)
+
+#define SIGNIFICAND_MASK 0x000FFFFFFFFFFFFFULL
+#define HIDDEN_BIT 0x0010000000000000ULL
+#define EXPONENT_BIAS 1075
+
+static DiyFp normalize(DiyFp x) {
+    while ((x.f & 0xFFC0000000000000ULL) == 0) {
+        x.f <<= 10;
+        x.e -= 10;
+    }
+    while ((x.f & 0x8000000000000000ULL) == 0) {
+        x.f <<= 1;
+        x.e--;
+    }
+    return x;
+}
+
+// 乘积取高 64 位并舍入，误差不超过 0.5 ulp
+static DiyFp multiply(DiyFp x, DiyFp y) {
+    const uint64_t mask = 0xFFFFFFFFULL;
+    uint64_t a = x.f >> 32, b = x.f & mask;
+    uint64_t c = y.f >> 32, d = y.f & mask;
+    uint64_t ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+    uint64_t middle = (bd >> 32) + (ad & mask) + (bc & mask) + (1ULL << 31);
+    DiyFp result = {ac + (ad >> 32) + (bc >> 32) + (middle >> 32), x.e + y.e + 64};
+    return result;
+}
+
+// 取 10^k 使 w × 10^k 的二进制指数落在目标区间内，k 通过 *decimal_exponent 返回
+static DiyFp cached_power(int binary_exponent, int* decimal_exponent) {
+    int min_exponent = MIN_TARGET_EXPONENT - (binary_exponent + 64);
+    // ceil(x × log10(2))，78913 / 2^18 ≈ log10(2)，在 |x| < 1300 内与浮点计算结果一致（负数右移按算术移位）
+    int k = -((-(min_exponent + 63) * 78913) >> 18);
+    int index = (CACHED_POWERS_OFFSET + k - 1) / CACHED_POWERS_STEP + 1;
+    const CachedPower* power = &cached_powers[index];
+    *decimal_exponent = power->k;
+    DiyFp result = {power->f, power->e};
+    return result;
+}
+
+// 朝 w 修正最后一位，并检查结果是否一定在舍入区间内且最接近 w；无法确定时返回 0
+static int round_weed(char* digits, int length, uint64_t distance_too_high_w, uint64_t unsafe_interval,
+                      uint64_t rest, uint64_t ten_kappa, uint64_t unit) {
+    uint64_t small_distance = distance_too_high_w - unit;
+    uint64_t big_distance = distance_too_high_w + unit;
+    while (rest < small_distance && unsafe_interval - rest >= ten_kappa &&
+           (rest + ten_kappa < small_distance || small_distance - rest >= rest + ten_kappa - small_distance)) {
+        digits[length - 1]--;
+        rest += ten_kappa;
+    }
+    if (rest < big_distance && unsafe_interval - rest >= ten_kappa &&
+        (rest + ten_kappa < big_distance || big_distance - rest > rest + ten_kappa - big_distance)) {
+        return 0;
+    }
+    return 2 * unit <= rest && rest <= unsafe_interval - 4 * unit;
+}
+
+// Grisu3 的逐位生成：在 (low, high) 内产生最短的数字串，成功时写入位数与 kappa
+static int digit_gen(DiyFp low, DiyFp w, DiyFp high, char* digits, int* length, int* kappa) {
+    uint64_t unit = 1;
+    DiyFp too_low = {low.f - unit, low.e};
+    DiyFp too_high = {high.f + unit, high.e};
+    uint64_t unsafe_interval = too_high.f - too_low.f;
+    int shift = -w.e;
+    uint64_t one = 1ULL << shift;
+    uint32_t integrals = (uint32_t)(too_high.f >> shift);
+    uint64_t fractionals = too_high.f & (one - 1);
+
+    uint32_t divisor = 1000000000;
+    int divisor_exponent_plus_one = 10;
+    while (divisor_exponent_plus_one > 0 && integrals < divisor) {
+        divisor /= 10;
+        divisor_exponent_plus_one--;
+    }
+    *kappa = divisor_exponent_plus_one;
+    *length = 0;
+
+    while (*kappa > 0) {
+        digits[(*length)++] = (char)('0' + integrals / divisor);
+        integrals %= divisor;
+        (*kappa)--;
+        uint64_t rest = ((uint64_t)integrals << shift) + fractionals;
+        if (rest < unsafe_interval) {
+            return round_weed(digits, *length, too_high.f - w.f, unsafe_interval, rest,
+                              (uint64_t)divisor << shift, unit);
+        }
+        divisor /= 10;
+    }
+    while (1) {
+        fractionals *= 10;
+        unit *= 10;
+        unsafe_interval *= 10;
+        digits[(*length)++] = (char)('0' + (fractionals >> shift));
+        fractionals &= one - 1;
+        (*kappa)--;
+        if (fractionals < unsafe_interval) {
+            return round_weed(digits, *length, (too_high.f - w.f) * unit, unsafe_interval, fractionals, one, unit);
+        }
+    }
+}
+
+static int grisu3(double value, char* digits, int* length, int* point) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    int biased = (int)((bits >> 52) & 0x7FF);
+    uint64_t significand = bits & SIGNIFICAND_MASK;
+    DiyFp v;
+    if (biased != 0) {
+        v.f = significand | HIDDEN_BIT;
+        v.e = biased - EXPONENT_BIAS;
+    } else {
+        v.f = significand;
+        v.e = 1 - EXPONENT_BIAS;
+    }
+
+    // 舍入区间的上下边界；有效数字为 2 的幂时下边界离得更近
+    DiyFp plus = {(v.f << 1) + 1, v.e - 1};
+    plus = normalize(plus);
+    DiyFp minus;
+    if (v.f == HIDDEN_BIT && biased > 1) {
+        minus.f = (v.f << 2) - 1;
+        minus.e = v.e - 2;
+    } else {
+        minus.f = (v.f << 1) - 1;
+        minus.e = v.e - 1;
+    }
+    minus.f <<= minus.e - plus.e;
+    minus.e = plus.e;
+    DiyFp w = normalize(v);
+
+    int mk;
+    DiyFp ten_mk = cached_power(w.e, &mk);
+    DiyFp scaled_w = multiply(w, ten_mk);
+    DiyFp scaled_minus = multiply(minus, ten_mk);
+    DiyFp scaled_plus = multiply(plus, ten_mk);
+    int kappa;
+    if (!digit_gen(scaled_minus, scaled_w, scaled_plus, digits, length, &kappa)) {
+        return 0;
+    }
+    *point = *length + kappa - mk;
+    return 1;
+}
+
+// 把 count 位数字按 d.ddd e±x 写成文本后用 strtod 读回，检查是否等于 value
+static int reads_back(double value, const char* digits, int count, int exponent) {
+    char text[40];
+    char* p = text;
+    *p++ = digits[0];
+    if (count > 1) {
+        *p++ = '.';
+        memcpy(p, digits + 1, (size_t)(count - 1));
+        p += count - 1;
+    }
+    snprintf(p, sizeof(text) - (size_t)(p - text), "e%d", exponent);
+    return strtod(text, NULL) == value;
+}
+
+// 退路：只调用一次 snprintf 取 17 位（必然能精确读回），再从 1 位起按十进制舍入截短，
+// 取第一个能精确读回的位数。17 位的尾部恰为 5000... 时舍入方向可能与直接舍入不同，此时两个方向都试
+static int shortest_by_search(double value, char* digits, int* point) {
+    char text[40];
+    snprintf(text, sizeof(text), "%.*e", DOUBLE_FORMAT_MAX_DIGITS - 1, value);
+    char full[DOUBLE_FORMAT_MAX_DIGITS];
+    full[0] = text[0];
+    memcpy(full + 1, text + 2, DOUBLE_FORMAT_MAX_DIGITS - 1);
+    int exponent = atoi(text + DOUBLE_FORMAT_MAX_DIGITS + 2);
+
+    for (int length = 1; length < DOUBLE_FORMAT_MAX_DIGITS; length++) {
+        char candidate[DOUBLE_FORMAT_MAX_DIGITS];
+        memcpy(candidate, full, (size_t)length);
+        int tie = full[length] == '5';
+        for (int i = length + 1; tie && i < DOUBLE_FORMAT_MAX_DIGITS; i++) {
+            tie = full[i] == '0';
+        }
+        if (tie && reads_back(value, candidate, length, exponent)) {
+            memcpy(digits, candidate, (size_t)length);
+            *point = exponent + 1;
+            return length;
+        }
+        int candidate_exponent = exponent;
+        if (full[length] >= '5') {
+            int i = length - 1;
+            while (i >= 0 && candidate[i] == '9') {
+                candidate[i--] = '0';
+            }
+            if (i >= 0) {
+                candidate[i]++;
+            } else {
+                candidate[0] = '1';
+                candidate_exponent++;
+            }
+        }
+        if (reads_back(value, candidate, length, candidate_exponent)) {
+            memcpy(digits, candidate, (size_t)length);
+            *point = candidate_exponent + 1;
+            return length;
+        }
+    }
+    memcpy(digits, full, DOUBLE_FORMAT_MAX_DIGITS);
+    *point = exponent + 1;
+    return DOUBLE_FORMAT_MAX_DIGITS;
+}
+
+int shortest_digits(double value, char digits[DOUBLE_FORMAT_MAX_DIGITS], int* point) {
+    value = fabs(value);
+    if (value == 0.0) {
+        digits[0] = '0';
+        *point = 1;
+        return 1;
+    }
+    int length;
+    if (!grisu3(value, digits, &length, point)) {
+        length = shortest_by_search(value, digits, point);
+    }
+    while (length > 1 && digits[length - 1] == '0') {
+        length--;
+    }
+    return length;
+}
+
+// 带边界检查的顺序写入
+typedef struct {
+    char* buffer;
+    size_t size;
+    size_t length;
+    int overflow;
+} Writer;
+
+static void put(Writer* out, char c) {
+    if (out->length + 1 < out->size) {
+        out->buffer[out->length++] = c;
+    } else {
+        out->overflow = 1;
+    }
+}
+
+static void put_repeat(Writer* out, char c, int count) {
+    for (int i = 0; i < count; i++) {
+        put(out, c);
+    }
+}
+
+static void put_text(Writer* out, const char* text, int count) {
+    for (int i = 0; i < count; i++) {
+        put(out, text[i]);
+    }
+}
+
+// 指数至少两位，与 printf 一致："e+20"、"e-07"
+static void put_exponent(Writer* out, int exponent) {
+    put(out, 'e');
+    put(out, exponent < 0 ? '-' : '+');
+    unsigned magnitude = (unsigned)(exponent < 0 ? -exponent : exponent);
+    char text[4];
+    int count = 0;
+    do {
+        text[count++] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+    if (count < 2) {
+        text[count++] = '0';
+    }
+    while (count > 0) {
+        put(out, text[--count]);
+    }
+}
+
+// 把 0.d1...dn × 10^point 写成定点形式，小数部分恰好 decimals 位（不足补零）
+static void put_fixed(Writer* out, const char* digits, int length, int point, int decimals) {
+    if (point <= 0) {
+        put(out, '0');
+    } else {
+        int integral = point < length ? point : length;
+        put_text(out, digits, integral);
+        put_repeat(out, '0', point - integral);
+    }
+    if (decimals <= 0) {
+        return;
+    }
+    put(out, '.');
+    int written = 0;
+    for (int position = point; written < decimals; position++, written++) {
+        put(out, position >= 0 && position < length ? digits[position] : '0');
+    }
+}
+
+// 科学记数法：d1.d2...，小数部分恰好 decimals 位（不足补零）
+static void put_scientific(Writer* out, const char* digits, int length, int point, int decimals) {
+    put(out, digits[0]);
+    if (decimals > 0) {
+        put(out, '.');
+        put_text(out, digits + 1, length - 1 < decimals ? length - 1 : decimals);
+        put_repeat(out, '0', decimals - (length - 1));
+    }
+    put_exponent(out, point - 1);
+}
+
+// 把数字串四舍五入到前 keep 位（keep 可为 0 或负数）；进位溢出时 point 加一。返回新位数，结果为 0 时返回 0
+static int round_digits(char* digits, int length, int* point, int keep) {
+    if (keep >= length) {
+        return length;
+    }
+    if (keep < 0) {
+        return 0;
+    }
+    int round_up = digits[keep] >= '5';
+    length = keep;
+    if (!round_up) {
+        while (length > 0 && digits[length - 1] == '0') {
+            length--;
+        }
+        return length;
+    }
+    while (length > 0 && digits[length - 1] == '9') {
+        length--;
+    }
+    if (length == 0) {
+        digits[0] = '1';
+        (*point)++;
+        return 1;
+    }
+    digits[length - 1]++;
+    return length;
+}
+
+size_t format_double(char* buffer, size_t size, double value, FormatMode mode, int precision) {
+    Writer out = {buffer, size, 0, 0};
+    if (size == 0) {
+        return 0;
+    }
+    if (precision < 0) {
+        precision = 0;
+    }
+    if (signbit(value) && !isnan(value)) {
+        put(&out, '-');
+    }
+
+    if (isnan(value) || isinf(value)) {
+        put_text(&out, isnan(value) ? "nan" : "inf", 3);
+    } else {
+        char digits[DOUBLE_FORMAT_MAX_DIGITS + 1];
+        int point;
+        int length = shortest_digits(value, digits, &point);
+
+        switch (mode) {
+        case FORMAT_SHORTEST:
+            if (point - 1 >= -5 && point - 1 < DOUBLE_FORMAT_MAX_DIGITS) {
+                put_fixed(&out, digits, length, point, length - point);
+            } else {
+                put_scientific(&out, digits, length, point, length - 1);
+            }
+            break;
+        case FORMAT_FIXED:
+            length = round_digits(digits, length, &point, point + precision);
+            put_fixed(&out, digits, length, length == 0 ? 0 : point, precision);
+            break;
+        case FORMAT_SCIENTIFIC:
+            length = round_digits(digits, length, &point, precision + 1);
+            put_scientific(&out, digits, length, point, precision);
+            break;
+        case FORMAT_SIGNIFICANT: {
+            // 与 %g 相同：指数小于 -4 或不小于有效位数时用科学记数法，去除尾随零
+            int significant = precision == 0 ? 1 : precision;
+            length = round_digits(digits, length, &point, significant);
+            int exponent = point - 1;
+            if (exponent < -4 || exponent >= significant) {
+                put_scientific(&out, digits, length, point, length - 1);
+            } else {
+                put_fixed(&out, digits, length, point, length > point ? length - point : 0);
+            }
+            break;
+        }
+        }
+    }
+
+    if (out.overflow) {
+        buffer[0] = '\0';
+        return 0;
+    }
+    buffer[out.length] = '\0';
+    return out.length;
+}
+
+size_t format_shortest(char* buffer, size_t size, double value) {
+    return format_double(buffer, size, value, FORMAT_SHORTEST, 0);
+}
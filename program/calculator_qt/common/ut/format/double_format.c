@@ -0,0 +1,141 @@
+// 单元测试：最短往返格式化——随机值与边界值都能精确读回，位数与逐位数试探得到的最短位数一致；
+// 定点、科学记数法与有效数字模式的舍入与补零；缓冲区不足
+#include <float.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "double_format.h"
+
+// 逐位数试探的最短位数，作为对照
+static int reference_length(double value) {
+    char text[40];
+    for (int precision = 1; precision < 17; precision++) {
+        snprintf(text, sizeof(text), "%.*e", precision - 1, value);
+        if (strtod(text, NULL) == value) {
+            return precision;
+        }
+    }
+    return 17;
+}
+
+static int check_round_trip(double value) {
+    char text[DOUBLE_FORMAT_SHORTEST_SIZE];
+    size_t length = format_shortest(text, sizeof(text), value);
+    if (length == 0 || strlen(text) != length || strtod(text, NULL) != value) {
+        fprintf(stderr, "测试失败：%.17g 格式化为 '%s'，无法精确读回\n", value, text);
+        return 1;
+    }
+    char digits[DOUBLE_FORMAT_MAX_DIGITS];
+    int point;
+    int count = shortest_digits(value, digits, &point);
+    if (value != 0.0 && count != reference_length(value)) {
+        fprintf(stderr, "测试失败：%.17g 的最短位数为 %d，期望 %d\n", value, count, reference_length(value));
+        return 1;
+    }
+    return 0;
+}
+
+static uint64_t next_random(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+int main(void) {
+    /* 1) 边界值与随机位模式都能精确读回且位数最短 */
+    {
+        const double edges[] = {
+            0.1, 0.2, 0.3, 0.1 + 0.2, 1.0 / 3, 2.0 / 3, 5e-324, DBL_MIN, DBL_MAX, DBL_EPSILON,
+            1e15, 1e16, 1e17, 1e21, 1e22, 1e23, 9007199254740993.0, 123456789012345680.0,
+            4.35, 2.675, 1.7976931348623157e308, 2.2250738585072009e-308, 0.5, 100, 1e-5, 1e-7,
+        };
+        for (size_t i = 0; i < sizeof(edges) / sizeof(edges[0]); i++) {
+            if (check_round_trip(edges[i]) != 0 || check_round_trip(-edges[i]) != 0) {
+                return 1;
+            }
+        }
+        uint64_t state = 0x9E3779B97F4A7C15ULL;
+        for (int i = 0; i < 20000; i++) {
+            uint64_t bits = next_random(&state);
+            double value;
+            memcpy(&value, &bits, sizeof(value));
+            if (isfinite(value) && check_round_trip(value) != 0) {
+                return 1;
+            }
+        }
+        // 整数与短小数：实际计算结果多为这类值
+        for (int i = 0; i < 20000; i++) {
+            double value = (double)(next_random(&state) % 2000000) / 1000.0;
+            if (check_round_trip(value) != 0 || check_round_trip((double)i) != 0) {
+                return 1;
+            }
+        }
+    }
+
+    /* 2) 各模式的具体输出；定点等模式对最短往返数字四舍五入，恰为一半时远离零，与 printf 不同 */
+    {
+        struct { double value; FormatMode mode; int precision; const char* expected; } cases[] = {
+            {0.0, FORMAT_SHORTEST, 0, "0"},
+            {-0.0, FORMAT_SHORTEST, 0, "-0"},
+            {5.0, FORMAT_SHORTEST, 0, "5"},
+            {0.1 + 0.2, FORMAT_SHORTEST, 0, "0.30000000000000004"},
+            {-2.5, FORMAT_SHORTEST, 0, "-2.5"},
+            {1e-5, FORMAT_SHORTEST, 0, "0.00001"},
+            {1.5e-7, FORMAT_SHORTEST, 0, "1.5e-07"},
+            {1e16, FORMAT_SHORTEST, 0, "10000000000000000"},
+            {1e17, FORMAT_SHORTEST, 0, "1e+17"},
+            {1.5e300, FORMAT_SHORTEST, 0, "1.5e+300"},
+            {5e-324, FORMAT_SHORTEST, 0, "5e-324"},
+            {INFINITY, FORMAT_SHORTEST, 0, "inf"},
+            {-INFINITY, FORMAT_SHORTEST, 0, "-inf"},
+            {NAN, FORMAT_SHORTEST, 0, "nan"},
+            {3.14159, FORMAT_FIXED, 2, "3.14"},
+            {2.675, FORMAT_FIXED, 2, "2.68"},
+            {3182.625, FORMAT_FIXED, 2, "3182.63"},
+            {0.5, FORMAT_FIXED, 0, "1"},
+            {0.006, FORMAT_FIXED, 2, "0.01"},
+            {0.0004, FORMAT_FIXED, 2, "0.00"},
+            {-0.0004, FORMAT_FIXED, 2, "-0.00"},
+            {99.99, FORMAT_FIXED, 1, "100.0"},
+            {1e20, FORMAT_FIXED, 1, "100000000000000000000.0"},
+            {0.0, FORMAT_FIXED, 3, "0.000"},
+            {12345.678, FORMAT_SCIENTIFIC, 3, "1.235e+04"},
+            {9.9999, FORMAT_SCIENTIFIC, 2, "1.00e+01"},
+            {0.125, FORMAT_SCIENTIFIC, 1, "1.3e-01"},
+            {0.0, FORMAT_SCIENTIFIC, 2, "0.00e+00"},
+            {1e-300, FORMAT_SCIENTIFIC, 0, "1e-300"},
+            {3.14159, FORMAT_SIGNIFICANT, 3, "3.14"},
+            {1234567.0, FORMAT_SIGNIFICANT, 3, "1.23e+06"},
+            {0.0001234, FORMAT_SIGNIFICANT, 2, "0.00012"},
+            {0.00001234, FORMAT_SIGNIFICANT, 2, "1.2e-05"},
+            {100.0, FORMAT_SIGNIFICANT, 6, "100"},
+            {999.96, FORMAT_SIGNIFICANT, 4, "1000"},
+            {999.96, FORMAT_SIGNIFICANT, 3, "1e+03"},
+        };
+        for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+            char text[64];
+            size_t length = format_double(text, sizeof(text), cases[i].value, cases[i].mode, cases[i].precision);
+            if (strcmp(text, cases[i].expected) != 0 || length != strlen(cases[i].expected)) {
+                fprintf(stderr, "测试失败：第 %zu 例期望 '%s'，实际 '%s'\n", i + 1, cases[i].expected, text);
+                return 1;
+            }
+        }
+    }
+
+    /* 3) 缓冲区不足时返回 0 并写入空串 */
+    {
+        char text[4];
+        if (format_shortest(text, sizeof(text), 12345.0) != 0 || text[0] != '\0' ||
+            format_shortest(text, sizeof(text), 123.0) != 3) {
+            fprintf(stderr, "测试失败：缓冲区不足时应返回 0\n");
+            return 1;
+        }
+    }
+
+    printf("数值格式化单元测试通过\n");
+    return 0;
+}
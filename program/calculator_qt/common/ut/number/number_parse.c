@@ -0,0 +1,186 @@
+// 单元测试：数字字面量解析——随机与边界的十进制、十六进制文本与 strtod 逐位一致（含超过 19 位有效数字的慢路径）；
+// 分隔符与指数的语法；格式错误给出准确的出错偏移与字面量长度；上溢报错
+#include <float.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "number_parse.h"
+
+static int check_value(const char* text) {
+    double expected = strtod(text, NULL);
+    double actual = -1.0;
+    NumberResult result = parse_number(text, text + strlen(text), &actual);
+    NumberStatus status = isinf(expected) ? NUMBER_OUT_OF_RANGE : NUMBER_OK;
+    if (result.status != status || result.length != strlen(text) || memcmp(&actual, &expected, sizeof(double)) != 0) {
+        fprintf(stderr, "测试失败：'%s' 解析为 %.17g（状态 %d，长度 %zu），期望 %.17g\n", text, actual,
+                (int)result.status, result.length, expected);
+        return 1;
+    }
+    return 0;
+}
+
+static uint64_t next_random(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+int main(void) {
+    /* 1) 边界值：恰好居中、次正规数、最大值附近、超过 19 位与超过 768 位有效数字 */
+    {
+        static const char* const edges[] = {
+            "0", "0.0", "000123", "1", "3.14159", ".5", "1.", "9007199254740993", "9007199254740992.5",
+            "1e22", "1e23", "8.98846567431158e307", "1.7976931348623157e308", "1.7976931348623158e308",
+            "1.7976931348623159e308", "1e309", "2.2250738585072011e-308", "2.2250738585072012e-308",
+            "4.9406564584124654e-324", "2.4703282292062327e-324", "2.4703282292062328e-324", "1e-400",
+            "0.000000000000000000000000000000000000000000001", "123456789012345678901234567890",
+            "0.1000000000000000055511151231257827021181583404541015625",
+            "0.1000000000000000055511151231257827021181583404541015624",
+            "0.1000000000000000055511151231257827021181583404541015626",
+            "7.0420557077594588669468784357561207962098443483187940792729600000e-312",
+            "2.22507385850720113605740979670913197593481954635164564802342610972482222202107694551652952390813508"
+            "7914149158913039621106870086438694594645527657207407820621743379988141063267329253552286881372149012"
+            "9811224514518898490572223072852551331557550159143974763979834118019993239625482890171070818506906306"
+            "6665599493827577257201576306269066333264756530000924588831643303777979186961204949739037782970490505"
+            "1080609940730262937128958950003583799967207254304360284078895771796150945516748243471030702609144621"
+            "5722898802581825451803257070188608721131280795122334262883686223215037756666225039825343359745688844"
+            "2390026549819838548794829220689472168983109969836584681402285424333066033985088644580400103493397042"
+            "7567186443383770486037861622771738545623065874679014086723327636718751e-308",
+            "9007199254740993.0000000000001", "9007199254740993.0000000000000", "9007199254740992.9999999999999",
+            "1e-5", "100000000000000000000000", "1.5E+10", "2.5e-3",
+        };
+        for (size_t i = 0; i < sizeof(edges) / sizeof(edges[0]); i++) {
+            if (check_value(edges[i]) != 0) {
+                return 1;
+            }
+        }
+    }
+
+    /* 2) 随机值：%.17g、随机精度的 %.*e、以及 1 到 30 位随机数字串配随机指数 */
+    {
+        uint64_t state = 0x9E3779B97F4A7C15ULL;
+        char text[64];
+        for (int i = 0; i < 20000; i++) {
+            uint64_t bits = next_random(&state) & 0x7FFFFFFFFFFFFFFFULL;
+            double value;
+            memcpy(&value, &bits, sizeof(value));
+            if (!isfinite(value)) {
+                continue;
+            }
+            snprintf(text, sizeof(text), "%.17g", value);
+            if (check_value(text) != 0) {
+                return 1;
+            }
+            snprintf(text, sizeof(text), "%.*e", (int)(next_random(&state) % 25), value);
+            if (check_value(text) != 0) {
+                return 1;
+            }
+        }
+        for (int i = 0; i < 20000; i++) {
+            int digits = 1 + (int)(next_random(&state) % 30);
+            int point = (int)(next_random(&state) % (uint64_t)(digits + 1));
+            char* p = text;
+            for (int d = 0; d < digits; d++) {
+                if (d == point && d > 0) {
+                    *p++ = '.';
+                }
+                *p++ = (char)('0' + next_random(&state) % 10);
+            }
+            snprintf(p, sizeof(text) - (size_t)(p - text), "e%d", (int)(next_random(&state) % 700) - 350);
+            if (check_value(text) != 0) {
+                return 1;
+            }
+        }
+    }
+
+    /* 3) 十六进制与分隔符 */
+    {
+        static const char* const hex[] = {
+            "0x1F", "0X1.8p3", "0x.Ap-2", "0x1p-1074", "0x1p-1075", "0x1.8p-1075", "0x1p1023", "0x1.fffffffffffffp1023",
+            "0x1.fffffffffffff8p1023", "0x1p1024", "0x123456789abcdef0123", "0x1.00000000000008p0",
+            "0x1.000000000000080001p0", "0x1.00000000000018p0", "0x0.0000001p-1000",
+        };
+        for (size_t i = 0; i < sizeof(hex) / sizeof(hex[0]); i++) {
+            if (check_value(hex[i]) != 0) {
+                return 1;
+            }
+        }
+        struct { const char* text; double value; } separated[] = {
+            {"1_000_000", 1e6}, {"0xFF_FF", 65535.0}, {"3.141_592", 3.141592}, {"1e1_0", 1e10},
+        };
+        for (size_t i = 0; i < sizeof(separated) / sizeof(separated[0]); i++) {
+            double value = 0.0;
+            const char* text = separated[i].text;
+            NumberResult result = parse_number(text, text + strlen(text), &value);
+            if (result.status != NUMBER_OK || result.length != strlen(text) || value != separated[i].value) {
+                fprintf(stderr, "测试失败：'%s' 解析为 %.17g\n", text, value);
+                return 1;
+            }
+        }
+    }
+
+    /* 4) 字面量的边界：指数标记后没有数字时不属于字面量 */
+    {
+        struct { const char* text; size_t length; double value; } cases[] = {
+            {"2e", 1, 2.0}, {"2e+", 1, 2.0}, {"2e+3x", 4, 2000.0}, {"12abc", 2, 12.0}, {"0x1pz", 3, 1.0},
+            {"1.5)", 3, 1.5}, {"7 + 1", 1, 7.0},
+        };
+        for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+            double value = 0.0;
+            const char* text = cases[i].text;
+            NumberResult result = parse_number(text, text + strlen(text), &value);
+            if (result.status != NUMBER_OK || result.length != cases[i].length || value != cases[i].value) {
+                fprintf(stderr, "测试失败：'%s' 的字面量长度为 %zu，期望 %zu\n", text, result.length, cases[i].length);
+                return 1;
+            }
+        }
+    }
+
+    /* 5) 格式错误：出错偏移与字面量长度 */
+    {
+        struct { const char* text; NumberStatus status; size_t offset; size_t length; } cases[] = {
+            {"1.2.3", NUMBER_INVALID, 3, 5},
+            {"1e5.0", NUMBER_INVALID, 3, 5},
+            {".", NUMBER_INVALID, 0, 1},
+            {"0x", NUMBER_INVALID, 2, 2},
+            {"0xg", NUMBER_INVALID, 2, 2},
+            {"1__0", NUMBER_INVALID, 1, 4},
+            {"1_", NUMBER_INVALID, 1, 2},
+            {"1_.5", NUMBER_INVALID, 1, 4},
+            {"1._5", NUMBER_INVALID, 2, 4},
+            {"0x_1", NUMBER_INVALID, 2, 4},
+            {"1e400", NUMBER_OUT_OF_RANGE, 0, 5},
+            {"0x1p2000", NUMBER_OUT_OF_RANGE, 0, 8},
+        };
+        for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+            double value = 0.0;
+            const char* text = cases[i].text;
+            NumberResult result = parse_number(text, text + strlen(text), &value);
+            if (result.status != cases[i].status || result.error_offset != cases[i].offset ||
+                result.length != cases[i].length) {
+                fprintf(stderr, "测试失败：'%s' 的状态 %d、偏移 %zu、长度 %zu，期望 %d、%zu、%zu\n", text,
+                        (int)result.status, result.error_offset, result.length, (int)cases[i].status,
+                        cases[i].offset, cases[i].length);
+                return 1;
+            }
+        }
+    }
+
+    /* 6) 不越过 last 读取：输入不以 '\0' 结尾 */
+    {
+        const char text[] = {'1', '.', '5', 'e', '3'};
+        double value = 0.0;
+        NumberResult result = parse_number(text, text + 3, &value);
+        if (result.status != NUMBER_OK || result.length != 3 || value != 1.5) {
+            fprintf(stderr, "测试失败：截断的输入解析为 %.17g\n", value);
+            return 1;
+        }
+    }
+
+    printf("数字解析单元测试通过\n");
+    return 0;
+}
@@ -0,0 +1,113 @@
+// 单元测试：字符类别预扫描——各指令集级别的位图与逐字节判断一致（含不足一块的尾部与非 ASCII 字节）；
+// 流式扫描器跳过连续同类字符的结果与逐字节扫描一致，且不越过文本末尾
+#include <ctype.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "char_scan.h"
+
+static unsigned reference_classes(unsigned char c) {
+    if (c < 0x80 && isspace(c)) {
+        return CHAR_CLASS_BIT(CHAR_WHITESPACE);
+    }
+    if (c < 0x80 && isdigit(c)) {
+        return CHAR_CLASS_BIT(CHAR_DIGIT);
+    }
+    if (c < 0x80 && isalpha(c)) {
+        return CHAR_CLASS_BIT(CHAR_ALPHA);
+    }
+    if (c != 0 && strchr("+-*/^", c) != NULL) {
+        return CHAR_CLASS_BIT(CHAR_OPERATOR);
+    }
+    if (c == '(' || c == ')') {
+        return CHAR_CLASS_BIT(CHAR_PAREN);
+    }
+    return 0;
+}
+
+static uint64_t next_random(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+// 一半是表达式中常见的字符，一半是任意字节
+static void fill_random(char* text, size_t length, uint64_t* state) {
+    static const char common[] = " \t\r\n0123456789.abcxyzXYZ+-*/^()=_";
+    for (size_t i = 0; i < length; i++) {
+        uint64_t r = next_random(state);
+        text[i] = (r & 1) ? common[(r >> 8) % (sizeof(common) - 1)] : (char)(r >> 16);
+    }
+}
+
+int main(void) {
+    static char text[4096 + 37];
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    static CharClassBlock blocks[(sizeof(text) + CHAR_SCAN_BLOCK - 1) / CHAR_SCAN_BLOCK];
+
+    /* 1) 各级别的位图与逐字节判断一致 */
+    for (int round = 0; round < 200; round++) {
+        size_t length = (size_t)(next_random(&state) % sizeof(text));
+        fill_random(text, length, &state);
+        for (int level = CHAR_SCAN_SCALAR; level <= CHAR_SCAN_AVX2; level++) {
+            memset(blocks, 0xFF, sizeof(blocks));
+            char_classify(text, length, blocks, (CharScanLevel)level);
+            for (size_t i = 0; i < (length + CHAR_SCAN_BLOCK - 1) / CHAR_SCAN_BLOCK * CHAR_SCAN_BLOCK; i++) {
+                unsigned expected = i < length ? reference_classes((unsigned char)text[i]) : 0;
+                const CharClassBlock* block = &blocks[i / CHAR_SCAN_BLOCK];
+                for (int c = 0; c < CHAR_CLASS_COUNT; c++) {
+                    unsigned actual = (unsigned)((block->masks[c] >> (i % CHAR_SCAN_BLOCK)) & 1);
+                    if (actual != ((expected >> c) & 1)) {
+                        fprintf(stderr, "测试失败：%s 级别下第 %zu 个字节 0x%02x 的类别 %d 不符\n",
+                                char_scan_level_name((CharScanLevel)level), i, (unsigned char)text[i], c);
+                        return 1;
+                    }
+                }
+            }
+        }
+    }
+
+    /* 2) 流式扫描器：从随机位置跳过随机类别组合 */
+    for (int round = 0; round < 200; round++) {
+        size_t length = (size_t)(next_random(&state) % sizeof(text));
+        fill_random(text, length, &state);
+        for (int level = CHAR_SCAN_SCALAR; level <= CHAR_SCAN_AVX2; level++) {
+            char_scan_set_level((CharScanLevel)level);
+            CharScanner scanner;
+            char_scanner_init(&scanner, text, length);
+            size_t pos = 0;
+            while (pos < length) {
+                unsigned classes = (unsigned)(next_random(&state) % (1u << CHAR_CLASS_COUNT));
+                size_t expected = pos;
+                while (expected < length && (reference_classes((unsigned char)text[expected]) & classes) != 0) {
+                    expected++;
+                }
+                size_t actual = char_scanner_skip(&scanner, pos, classes);
+                if (actual != expected) {
+                    fprintf(stderr, "测试失败：%s 级别下从 %zu 跳过类别 0x%x 停在 %zu，期望 %zu\n",
+                            char_scan_level_name((CharScanLevel)level), pos, classes, actual, expected);
+                    return 1;
+                }
+                pos = expected + 1 + (size_t)(next_random(&state) % 3);
+            }
+        }
+    }
+    char_scan_set_level(char_scan_detect_level());
+
+    /* 3) 全是空白的文本跳到末尾 */
+    {
+        memset(text, ' ', 200);
+        CharScanner scanner;
+        char_scanner_init(&scanner, text, 200);
+        if (char_scanner_skip(&scanner, 3, CHAR_CLASS_BIT(CHAR_WHITESPACE)) != 200 ||
+            char_scanner_skip(&scanner, 200, CHAR_CLASS_BIT(CHAR_WHITESPACE)) != 200) {
+            fprintf(stderr, "测试失败：全空白文本应跳到末尾\n");
+            return 1;
+        }
+    }
+
+    printf("字符类别预扫描单元测试通过（检测到的级别: %s）\n", char_scan_level_name(char_scan_detect_level()));
+    return 0;
+}
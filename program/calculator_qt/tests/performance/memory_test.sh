@@ -180,6 +180,91 @@ build_project_wrapper() {
     build_project "$lang_version" "$SCRIPT_DIR"
 }
 
+# 用 Massif 比较 C 版本引入 AST 节点池前后的峰值堆内存。
+# 基线默认取首次引入 AstPool 的提交的父提交，可用 BASELINE_REV 指定；两个版本各自构建到临时目录，
+# 以管道模式处理同一份输入（互不相同的表达式全部进入缓存，峰值主要由缓存中的 AST 决定）
+compare_ast_peak_heap() {
+    local project_dir
+    project_dir="$(cd "$SCRIPT_DIR/../.." && pwd)"
+    local repo_root
+    repo_root="$(git -C "$project_dir" rev-parse --show-toplevel 2>/dev/null)"
+    if ! command -v valgrind &> /dev/null || [ -z "$repo_root" ]; then
+        echo -e "${YELLOW}跳过 AST 内存对比 (需要 valgrind 与 git 仓库)${NC}"
+        return 0
+    fi
+
+    local baseline="$BASELINE_REV"
+    if [ -z "$baseline" ]; then
+        local introduced
+        introduced=$(git -C "$repo_root" log -S "AstPool" --format=%H --reverse -- \
+            "$project_dir/calculator_c/include/parser.h" | head -1)
+        if [ -z "$introduced" ]; then
+            echo -e "${YELLOW}跳过 AST 内存对比 (找不到引入节点池的提交，可设置 BASELINE_REV)${NC}"
+            return 0
+        fi
+        baseline="${introduced}^"
+    fi
+
+    local work_dir
+    work_dir=$(mktemp -d /tmp/calculator_ast_memory.XXXXXX)
+    local relative="${project_dir#$repo_root/}"
+    echo "正在构建基线 $(git -C "$repo_root" rev-parse --short "$baseline") 与当前版本..."
+    git -C "$repo_root" worktree add --detach "$work_dir/baseline" "$baseline" >/dev/null 2>&1
+    local built=1
+    for version in baseline current; do
+        local source_dir="$project_dir"
+        if [ "$version" = "baseline" ]; then
+            source_dir="$work_dir/baseline/$relative"
+        fi
+        if ! cmake -S "$source_dir" -B "$work_dir/build_$version" -DCALCULATOR_BENCHMARK=OFF >/dev/null 2>&1 ||
+           ! cmake --build "$work_dir/build_$version" --target scientific_calculator_c -j"$(nproc)" >/dev/null 2>&1; then
+            echo -e "${RED}构建 $version 版本失败${NC}"
+            built=0
+        fi
+    done
+
+    if [ $built -eq 1 ]; then
+        printf "%-24s %14s %14s %8s\n" "场景" "基线峰值(B)" "节点池峰值(B)" "变化"
+        local scenario
+        for scenario in "算术 4096 行" "函数嵌套 4096 行" "长表达式 256 行"; do
+            local input_file="$work_dir/input.txt"
+            : > "$input_file"
+            for ((i=1; i<=4096; i++)); do
+                case "$scenario" in
+                    "算术"*) echo "$i + $((i+1)) * $((i+2)) - $i / 7" >> "$input_file" ;;
+                    "函数"*) echo "sqrt(abs(sin($i) * cos(pi / $i)) + exp(ln($i)))" >> "$input_file" ;;
+                    *)
+                        if [ $i -le 256 ]; then
+                            local line="$i"
+                            for ((j=1; j<=64; j++)); do line="$line + sqrt($j) * $i"; done
+                            echo "$line" >> "$input_file"
+                        fi
+                        ;;
+                esac
+            done
+
+            local peaks=()
+            for version in baseline current; do
+                local massif_out="$work_dir/massif.$version.out"
+                valgrind --tool=massif --time-unit=B --massif-out-file="$massif_out" \
+                    "$work_dir/build_$version/calculator_c/scientific_calculator_c" \
+                    < "$input_file" > /dev/null 2>&1
+                # 各快照中 mem_heap_B 的最大值即峰值堆内存（不含分配器开销，开销见 mem_heap_extra_B）
+                peaks+=("$(grep -E '^mem_heap_B=' "$massif_out" | cut -d= -f2 | sort -n | tail -1)")
+            done
+            local change="-"
+            if [ -n "${peaks[0]}" ] && [ "${peaks[0]}" -gt 0 ] && [ -n "${peaks[1]}" ]; then
+                change="$(( (peaks[1] - peaks[0]) * 100 / peaks[0] ))%"
+            fi
+            printf "%-24s %14s %14s %8s\n" "$scenario" "${peaks[0]:--}" "${peaks[1]:--}" "$change"
+        done
+    fi
+
+    git -C "$repo_root" worktree remove --force "$work_dir/baseline" >/dev/null 2>&1
+    rm -rf "$work_dir"
+    return 0
+}
+
 # 检查必要工具
 check_tools
 
@@ -202,6 +287,11 @@ monitor_memory_usage "c" "大量计算任务" "2 + 3 * 4" 5000
 # 内存泄漏测试
 test_memory_leaks "c"
 
+# AST 节点池前后的峰值堆内存对比
+echo ""
+echo "AST 节点池峰值堆内存对比 (Massif)"
+compare_ast_peak_heap
+
 # 测试C++版本
 echo ""
 echo "-------------------------------------------"
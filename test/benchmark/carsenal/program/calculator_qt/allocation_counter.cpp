@@ -0,0 +1,23 @@
+// 替换全局 operator new/delete，统计堆分配次数。
+// 放在单独的翻译单元中，避免替换后的函数被内联进基准库的头文件代码
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+size_t allocation_count = 0;
+
+void* operator new(std::size_t size) {
+    allocation_count++;
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
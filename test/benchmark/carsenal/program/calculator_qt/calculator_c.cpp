@@ -0,0 +1,176 @@
+// C 版本的进程内基准：get_next_token、tokenize、parse_expression、evaluate、evaluate_direct 与 evaluate_function，
+// 各自在四类表达式上运行，并报告每次迭代的堆分配次数
+//
+// 用法: benchmark_calculator_c [Google Benchmark 参数]，结果默认写入 benchmark_calculator_c.json
+#include "corpus.h"
+#include <cstddef>
+#include <string>
+
+extern "C" {
+#include "lexer.h"
+#include "parser.h"
+#include "calculator.h"
+#include "functions.h"
+#include "shunting_yard.h"
+}
+
+// C 核心库的 malloc/calloc/realloc 在链接时经 --wrap 转到这里计数（仅 Linux，见 CMakeLists.txt）
+static size_t allocation_count = 0;
+
+#if defined(CALCULATOR_BENCHMARK_WRAP_MALLOC)
+extern "C" {
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* p, size_t size);
+
+void* __wrap_malloc(size_t size) {
+    allocation_count++;
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+    allocation_count++;
+    return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* p, size_t size) {
+    allocation_count++;
+    return __real_realloc(p, size);
+}
+}
+#endif
+
+namespace {
+
+void benchLexer(benchmark::State& state, const std::string& text) {
+    size_t tokens = 0;
+    size_t before = allocation_count;
+    for (auto _ : state) {
+        Lexer lexer;
+        init_lexer(&lexer, text.c_str());
+        while (lexer.current_token.type != TOKEN_END && lexer.current_token.type != TOKEN_ERROR) {
+            consume_token(&lexer);
+            tokens++;
+        }
+        benchmark::DoNotOptimize(lexer.current_token);
+    }
+    corpus::reportAllocations(state, allocation_count - before);
+    state.counters["tokens"] = benchmark::Counter(static_cast<double>(tokens), benchmark::Counter::kIsRate);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+}
+
+// 一次切分出整个记号数组；每次迭代从空数组开始，包含数组的增长与释放
+void benchTokenize(benchmark::State& state, const std::string& text) {
+    size_t tokens = 0;
+    size_t before = allocation_count;
+    for (auto _ : state) {
+        TokenArray array;
+        init_token_array(&array);
+        tokenize(&array, text.c_str());
+        tokens += array.count - 1;
+        benchmark::DoNotOptimize(token_data(&array));
+        free_token_array(&array);
+    }
+    corpus::reportAllocations(state, allocation_count - before);
+    state.counters["tokens"] = benchmark::Counter(static_cast<double>(tokens), benchmark::Counter::kIsRate);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+}
+
+// 每次迭代包含释放节点池，与交互模式未命中缓存时的开销一致
+void benchParse(benchmark::State& state, const std::string& text) {
+    size_t before = allocation_count;
+    for (auto _ : state) {
+        Parser parser;
+        init_parser(&parser, text.c_str());
+        NodeId root = parse_expression(&parser);
+        benchmark::DoNotOptimize(root);
+        free_parser(&parser);
+    }
+    corpus::reportAllocations(state, allocation_count - before);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+}
+
+void benchEvaluate(benchmark::State& state, const std::string& text) {
+    Parser parser;
+    init_parser(&parser, text.c_str());
+    NodeId root = parse_expression(&parser);
+    if (root == NODE_NONE) {
+        state.SkipWithError("表达式解析失败");
+        free_parser(&parser);
+        return;
+    }
+    size_t before = allocation_count;
+    for (auto _ : state) {
+        Calculator calc;
+        init_calculator(&calc);
+        benchmark::DoNotOptimize(evaluate(&calc, &parser.pool, root));
+    }
+    corpus::reportAllocations(state, allocation_count - before);
+    free_parser(&parser);
+}
+
+// 调度场求值器一遍算出结果，对照 parse + evaluate（交互模式未命中缓存时的两种路径）
+void benchDirect(benchmark::State& state, const std::string& text) {
+    ShuntingYard yard;
+    double check = 0.0;
+    CalcError failure;
+    if (!evaluate_direct(&yard, text.c_str(), &check, &failure)) {
+        state.SkipWithError(failure.message);
+        return;
+    }
+    size_t before = allocation_count;
+    for (auto _ : state) {
+        double result = 0.0;
+        CalcError error;
+        benchmark::DoNotOptimize(evaluate_direct(&yard, text.c_str(), &result, &error));
+        benchmark::DoNotOptimize(result);
+    }
+    corpus::reportAllocations(state, allocation_count - before);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+}
+
+// 1 MB 表达式上的词法分析，level 为空白与标识符跳过所用的字符类别预扫描级别
+void benchLexerLong(benchmark::State& state, const std::string& text, CharScanLevel level) {
+    char_scan_set_level(level);
+    benchLexer(state, text);
+    char_scan_set_level(char_scan_detect_level());
+}
+
+void benchTokenizeLong(benchmark::State& state, const std::string& text, CharScanLevel level) {
+    char_scan_set_level(level);
+    benchTokenize(state, text);
+    char_scan_set_level(char_scan_detect_level());
+}
+
+void benchFunctions(benchmark::State& state) {
+    static const char* const names[] = {"sin", "cos", "tan", "log", "ln", "exp", "sqrt", "abs"};
+    double arg = 0.5;
+    size_t i = 0;
+    size_t before = allocation_count;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(evaluate_function(names[i++ & 7], &arg, 1));
+    }
+    corpus::reportAllocations(state, allocation_count - before);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    static const std::vector<corpus::Expression> expressions = corpus::expressions();
+    for (const corpus::Expression& expression : expressions) {
+        std::string suffix = std::string("/") + expression.name;
+        benchmark::RegisterBenchmark(("c/lexer" + suffix).c_str(), benchLexer, expression.text);
+        benchmark::RegisterBenchmark(("c/tokenize" + suffix).c_str(), benchTokenize, expression.text);
+        benchmark::RegisterBenchmark(("c/parse" + suffix).c_str(), benchParse, expression.text);
+        benchmark::RegisterBenchmark(("c/evaluate" + suffix).c_str(), benchEvaluate, expression.text);
+        benchmark::RegisterBenchmark(("c/direct" + suffix).c_str(), benchDirect, expression.text);
+    }
+    benchmark::RegisterBenchmark("c/functions/by_name", benchFunctions);
+    static const std::string longText = corpus::longExpression();
+    for (const auto& [name, level] : corpus::scanLevels()) {
+        benchmark::RegisterBenchmark((std::string("c/lexer_1mb/") + name).c_str(), benchLexerLong, longText, level);
+        benchmark::RegisterBenchmark((std::string("c/tokenize_1mb/") + name).c_str(), benchTokenizeLong, longText,
+                                     level);
+    }
+    return corpus::run(argc, argv, "benchmark_calculator_c.json");
+}
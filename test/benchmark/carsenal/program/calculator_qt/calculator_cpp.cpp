@@ -0,0 +1,114 @@
+// C++ 版本的进程内基准：词法分析、语法分析、AST 求值与函数调用，各自在四类表达式上运行，
+// 并报告每次迭代的堆分配次数
+//
+// 用法: benchmark_calculator_cpp [Google Benchmark 参数]，结果默认写入 benchmark_calculator_cpp.json
+#include "corpus.h"
+#include "lexer.h"
+#include "parser.h"
+#include "calculator.h"
+#include "functions.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// 堆分配次数，见 allocation_counter.cpp
+extern size_t allocation_count;
+
+namespace {
+
+void benchLexer(benchmark::State& state, const std::string& text) {
+    size_t tokens = 0;
+    size_t before = allocation_count;
+    for (auto _ : state) {
+        Lexer lexer(text);
+        Token token;
+        while ((token = lexer.scan()).type != END && token.type != INVALID) {
+            tokens++;
+        }
+        benchmark::DoNotOptimize(token);
+    }
+    corpus::reportAllocations(state, allocation_count - before);
+    state.counters["tokens"] = benchmark::Counter(static_cast<double>(tokens), benchmark::Counter::kIsRate);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+}
+
+void benchParse(benchmark::State& state, const std::string& text) {
+    // 节点池在迭代之间复用，与交互模式的稳态一致
+    AstArena arena;
+    size_t before = allocation_count;
+    for (auto _ : state) {
+        arena.reset();
+        Expected<NodeId> root = Parser(text, arena).tryParse();
+        benchmark::DoNotOptimize(root);
+    }
+    corpus::reportAllocations(state, allocation_count - before);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+}
+
+void benchEvaluate(benchmark::State& state, const std::string& text) {
+    AstArena arena;
+    NodeId root = Parser(text, arena).parse();
+    Calculator calculator;
+    size_t before = allocation_count;
+    for (auto _ : state) {
+        Expected<double> result = calculator.tryEvaluate(arena, root);
+        benchmark::DoNotOptimize(result);
+    }
+    corpus::reportAllocations(state, allocation_count - before);
+    state.counters["nodes"] = static_cast<double>(arena.size());
+}
+
+// 1 MB 表达式上的词法分析，level 为空白与标识符跳过所用的字符类别预扫描级别
+void benchLexerLong(benchmark::State& state, const std::string& text, CharScanLevel level) {
+    char_scan_set_level(level);
+    benchLexer(state, text);
+    char_scan_set_level(char_scan_detect_level());
+}
+
+const char* const functionNames[] = {"sin", "cos", "tan", "log", "ln", "exp", "sqrt", "abs"};
+
+// 按名称调用：每次查表并通过 std::vector 传参
+void benchFunctionsByName(benchmark::State& state) {
+    std::vector<std::string> names(std::begin(functionNames), std::end(functionNames));
+    std::vector<double> args = {0.5};
+    size_t i = 0;
+    size_t before = allocation_count;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Functions::evaluate(names[i++ & 7], args));
+    }
+    corpus::reportAllocations(state, allocation_count - before);
+}
+
+// 通过解析阶段得到的描述符调用，即求值器的实际路径
+void benchFunctionsByDescriptor(benchmark::State& state) {
+    std::vector<const Functions::Info*> infos;
+    for (const char* name : functionNames) {
+        infos.push_back(Functions::find(name));
+    }
+    double arg = 0.5;
+    size_t i = 0;
+    size_t before = allocation_count;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(infos[i++ & 7]->function(&arg));
+    }
+    corpus::reportAllocations(state, allocation_count - before);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    static const std::vector<corpus::Expression> expressions = corpus::expressions();
+    for (const corpus::Expression& expression : expressions) {
+        std::string suffix = std::string("/") + expression.name;
+        benchmark::RegisterBenchmark(("cpp/lexer" + suffix).c_str(), benchLexer, expression.text);
+        benchmark::RegisterBenchmark(("cpp/parse" + suffix).c_str(), benchParse, expression.text);
+        benchmark::RegisterBenchmark(("cpp/evaluate" + suffix).c_str(), benchEvaluate, expression.text);
+    }
+    benchmark::RegisterBenchmark("cpp/functions/by_name", benchFunctionsByName);
+    benchmark::RegisterBenchmark("cpp/functions/by_descriptor", benchFunctionsByDescriptor);
+    static const std::string longText = corpus::longExpression();
+    for (const auto& [name, level] : corpus::scanLevels()) {
+        benchmark::RegisterBenchmark((std::string("cpp/lexer_1mb/") + name).c_str(), benchLexerLong, longText, level);
+    }
+    return corpus::run(argc, argv, "benchmark_calculator_cpp.json");
+}
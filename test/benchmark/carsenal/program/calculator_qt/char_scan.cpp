@@ -0,0 +1,74 @@
+// 字符类别预扫描基准：在 1 MB 生成表达式上比较标量、SSE2（每步 16 字节）与 AVX2（每步 32 字节）的分类吞吐量，
+// 以及流式扫描器跳过空白与标识符相对逐字节循环的开销
+//
+// 用法: benchmark_char_scan [Google Benchmark 参数]，结果默认写入 benchmark_char_scan.json
+#include "corpus.h"
+#include <cctype>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+
+void benchClassify(benchmark::State& state, const std::string& text, CharScanLevel level) {
+    std::vector<CharClassBlock> blocks((text.size() + CHAR_SCAN_BLOCK - 1) / CHAR_SCAN_BLOCK);
+    for (auto _ : state) {
+        char_classify(text.data(), text.size(), blocks.data(), level);
+        benchmark::DoNotOptimize(blocks.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+}
+
+// 与词法分析器相同的访问模式：交替跳过空白与一段非空白（标识符、数字或单个符号）
+void benchSkip(benchmark::State& state, const std::string& text, CharScanLevel level) {
+    const unsigned word = CHAR_CLASS_BIT(CHAR_ALPHA) | CHAR_CLASS_BIT(CHAR_DIGIT);
+    for (auto _ : state) {
+        char_scan_set_level(level);
+        CharScanner scanner;
+        char_scanner_init(&scanner, text.data(), text.size());
+        size_t pos = 0;
+        size_t runs = 0;
+        while (pos < text.size()) {
+            pos = char_scanner_skip(&scanner, pos, CHAR_CLASS_BIT(CHAR_WHITESPACE));
+            size_t end = char_scanner_skip(&scanner, pos, word);
+            pos = end > pos ? end : pos + 1;
+            runs++;
+        }
+        benchmark::DoNotOptimize(runs);
+    }
+    char_scan_set_level(char_scan_detect_level());
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+}
+
+// 对照：原词法分析器的逐字节 isspace / isalnum 循环
+void benchSkipBytewise(benchmark::State& state, const std::string& text) {
+    for (auto _ : state) {
+        size_t pos = 0;
+        size_t runs = 0;
+        while (pos < text.size()) {
+            while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) {
+                pos++;
+            }
+            size_t end = pos;
+            while (end < text.size() && std::isalnum(static_cast<unsigned char>(text[end]))) {
+                end++;
+            }
+            pos = end > pos ? end : pos + 1;
+            runs++;
+        }
+        benchmark::DoNotOptimize(runs);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    static const std::string text = corpus::longExpression();
+    for (const auto& [name, level] : corpus::scanLevels()) {
+        benchmark::RegisterBenchmark((std::string("classify_1mb/") + name).c_str(), benchClassify, text, level);
+        benchmark::RegisterBenchmark((std::string("skip_1mb/") + name).c_str(), benchSkip, text, level);
+    }
+    benchmark::RegisterBenchmark("skip_1mb/bytewise", benchSkipBytewise, text);
+    return corpus::run(argc, argv, "benchmark_char_scan.json");
+}
@@ -0,0 +1,42 @@
+#!/usr/bin/env python3
+"""比较两次基准运行的 JSON 输出（--benchmark_out_format=json），按基准名称对齐。
+
+用法: compare.py <旧.json> <新.json>
+"""
+import json
+import sys
+
+
+def load(path):
+    with open(path, encoding="utf-8") as f:
+        data = json.load(f)
+    # 重复运行（--benchmark_repetitions）时只取均值
+    results = {}
+    for bench in data["benchmarks"]:
+        if bench.get("run_type") == "aggregate" and bench.get("aggregate_name") != "mean":
+            continue
+        results[bench["run_name"]] = bench
+    return results
+
+
+def main():
+    if len(sys.argv) != 3:
+        print(__doc__.strip(), file=sys.stderr)
+        return 1
+    old, new = load(sys.argv[1]), load(sys.argv[2])
+    print(f"{'基准':<32}{'旧 (ns)':>12}{'新 (ns)':>12}{'变化':>9}{'旧分配':>10}{'新分配':>10}")
+    for name, bench in new.items():
+        if name not in old:
+            print(f"{name:<32}{'-':>12}{bench['cpu_time']:>12.1f}")
+            continue
+        before = old[name]["cpu_time"]
+        after = bench["cpu_time"]
+        change = (after - before) / before * 100 if before else 0.0
+        allocs_before = old[name].get("allocs_per_iter", 0.0)
+        allocs_after = bench.get("allocs_per_iter", 0.0)
+        print(f"{name:<32}{before:>12.1f}{after:>12.1f}{change:>+8.1f}%{allocs_before:>10.2f}{allocs_after:>10.2f}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
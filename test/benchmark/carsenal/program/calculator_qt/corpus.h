@@ -0,0 +1,117 @@
+#ifndef CALCULATOR_BENCHMARK_CORPUS_H
+#define CALCULATOR_BENCHMARK_CORPUS_H
+
+// 计算器基准的公共部分：C 与 C++ 两个版本共用的表达式语料，以及默认输出 JSON 的 main
+#include <benchmark/benchmark.h>
+#include "char_scan.h"
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace corpus {
+
+struct Expression {
+    const char* name;
+    std::string text;
+};
+
+// 只使用两个版本都支持的语法（不含指数记数法与变量）
+inline std::vector<Expression> expressions() {
+    // 深：100 层括号嵌套
+    std::string deep = "1";
+    for (int i = 0; i < 100; i++) {
+        deep = "(" + deep + " + 1)";
+    }
+    // 宽：256 项，四种运算符轮换
+    static const char ops[] = {'+', '-', '*', '/'};
+    std::string wide = "1";
+    for (int i = 1; i < 256; i++) {
+        wide += ' ';
+        wide += ops[i % 4];
+        wide += ' ';
+        wide += std::to_string(i % 97 + 1);
+    }
+    // 函数密集：8 个函数各调用 4 次
+    std::string functions;
+    for (int i = 0; i < 4; i++) {
+        if (i > 0) {
+            functions += " + ";
+        }
+        functions += "sin(pi / 6) + cos(pi / 3) + tan(pi / 4) + sqrt(16) + log(100) + ln(e) + exp(1) + abs(-5)";
+    }
+    // 数字密集：256 个带小数的字面量，位数从 1 到 17 轮换
+    std::string numbers = "0.5";
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    for (int i = 1; i < 256; i++) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        std::string digits = std::to_string(state >> 8).substr(0, static_cast<size_t>(i % 17 + 1));
+        size_t point = (state >> 4) % digits.size();
+        numbers += " + " + digits.substr(0, point + 1) + "." + digits.substr(point + 1);
+    }
+    return {
+        {"small", "2 + 3 * 4"},
+        {"deep", deep},
+        {"wide", wide},
+        {"functions", functions},
+        {"numbers", numbers},
+    };
+}
+
+// 约 1 MB 的生成表达式（多项式展开式）：每行四项并缩进，数字、常量、函数与运算符交替，
+// 用于衡量长输入上逐字节判断字符类别的开销
+inline std::string longExpression(size_t bytes = 1 << 20) {
+    static const char* const terms[] = {
+        "12.5 * pi ^ 3", "7 * e ^ 2", "0.25 * sqrt(pi)", "(3 - e) * 4.75", "sin(pi / 6) * 1024", "abs(-3.5) ^ 2",
+    };
+    std::string text = "1";
+    for (size_t i = 0; text.size() < bytes; i++) {
+        text += i % 4 == 0 ? "\n    " : " ";
+        text += i % 2 == 0 ? "+ " : "- ";
+        text += terms[i % 6];
+    }
+    return text;
+}
+
+// 字符类别预扫描的各指令集级别，用于在同一输入上比较标量与 SIMD
+inline std::vector<std::pair<const char*, CharScanLevel>> scanLevels() {
+    std::vector<std::pair<const char*, CharScanLevel>> levels;
+    for (int level = CHAR_SCAN_SCALAR; level <= char_scan_detect_level(); level++) {
+        levels.emplace_back(char_scan_level_name(static_cast<CharScanLevel>(level)), static_cast<CharScanLevel>(level));
+    }
+    return levels;
+}
+
+// 每次迭代的堆分配次数，结果中显示为 allocs_per_iter
+inline void reportAllocations(benchmark::State& state, size_t allocations) {
+    state.counters["allocs_per_iter"] =
+        benchmark::Counter(static_cast<double>(allocations), benchmark::Counter::kAvgIterations);
+}
+
+// 未指定 --benchmark_out 时把结果以 JSON 写入 defaultOut，便于在提交之间比较
+inline int run(int argc, char** argv, const char* defaultOut) {
+    std::vector<char*> args(argv, argv + argc);
+    std::string out = std::string("--benchmark_out=") + defaultOut;
+    std::string format = "--benchmark_out_format=json";
+    bool hasOut = false;
+    for (int i = 1; i < argc; i++) {
+        hasOut = hasOut || std::strncmp(argv[i], "--benchmark_out=", 16) == 0;
+    }
+    if (!hasOut) {
+        args.push_back(out.data());
+        args.push_back(format.data());
+    }
+    int count = static_cast<int>(args.size());
+    benchmark::Initialize(&count, args.data());
+    if (benchmark::ReportUnrecognizedArguments(count, args.data())) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
+
+} // namespace corpus
+
+#endif // CALCULATOR_BENCHMARK_CORPUS_H
@@ -0,0 +1,132 @@
+// 数值格式化基准：共享格式化库 format_double 与 snprintf、std::ostringstream、std::to_chars 对比，
+// 输入分为随机位模式的双精度数与计算器常见的短小数两类
+//
+// 用法: benchmark_double_format [Google Benchmark 参数]，结果默认写入 benchmark_double_format.json
+#include "corpus.h"
+#include "double_format.h"
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+constexpr size_t VALUE_COUNT = 1 << 12;
+
+// 随机位模式，跳过非有限值
+std::vector<double> randomValues() {
+    std::mt19937_64 random(42);
+    std::vector<double> values;
+    while (values.size() < VALUE_COUNT) {
+        uint64_t bits = random();
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        if (std::isfinite(value)) {
+            values.push_back(value);
+        }
+    }
+    return values;
+}
+
+// 至多三位小数的短小数，如 0.125、42、-3.5
+std::vector<double> decimalValues() {
+    std::mt19937_64 random(7);
+    std::uniform_int_distribution<int> mantissa(-100000, 100000);
+    std::uniform_int_distribution<int> scale(0, 3);
+    static const double divisors[] = {1, 10, 100, 1000};
+    std::vector<double> values;
+    for (size_t i = 0; i < VALUE_COUNT; i++) {
+        values.push_back(mantissa(random) / divisors[scale(random)]);
+    }
+    return values;
+}
+
+const std::vector<double>& inputs(int kind) {
+    static const std::vector<double> random = randomValues();
+    static const std::vector<double> decimal = decimalValues();
+    return kind == 0 ? random : decimal;
+}
+
+const char* const inputNames[] = {"random", "decimal"};
+
+template <typename Format>
+void run(benchmark::State& state, int kind, Format format) {
+    const std::vector<double>& values = inputs(kind);
+    char buffer[64];
+    size_t i = 0;
+    size_t bytes = 0;
+    for (auto _ : state) {
+        size_t length = format(buffer, sizeof(buffer), values[i++ & (VALUE_COUNT - 1)]);
+        benchmark::DoNotOptimize(buffer);
+        bytes += length;
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+
+void benchShortest(benchmark::State& state, int kind) {
+    run(state, kind, [](char* buffer, size_t size, double value) {
+        return format_shortest(buffer, size, value);
+    });
+}
+
+void benchSignificant(benchmark::State& state, int kind) {
+    run(state, kind, [](char* buffer, size_t size, double value) {
+        return format_double(buffer, size, value, FORMAT_SIGNIFICANT, 10);
+    });
+}
+
+// %.17g 总能读回原值，但不是最短
+void benchPrintfRoundTrip(benchmark::State& state, int kind) {
+    run(state, kind, [](char* buffer, size_t size, double value) {
+        return static_cast<size_t>(std::snprintf(buffer, size, "%.17g", value));
+    });
+}
+
+// 原 C 版本交互输出使用的格式
+void benchPrintfSignificant(benchmark::State& state, int kind) {
+    run(state, kind, [](char* buffer, size_t size, double value) {
+        return static_cast<size_t>(std::snprintf(buffer, size, "%.10g", value));
+    });
+}
+
+// 原 C++ 版本交互输出使用的方式；流在迭代之间复用，只计格式化本身
+void benchStream(benchmark::State& state, int kind) {
+    std::ostringstream stream;
+    stream.precision(17);
+    run(state, kind, [&stream](char* buffer, size_t size, double value) {
+        stream.str(std::string());
+        stream << value;
+        size_t length = stream.str().copy(buffer, size - 1);
+        buffer[length] = '\0';
+        return length;
+    });
+}
+
+// 标准库的最短往返实现，作为参考
+void benchToChars(benchmark::State& state, int kind) {
+    run(state, kind, [](char* buffer, size_t size, double value) {
+        std::to_chars_result result = std::to_chars(buffer, buffer + size - 1, value);
+        *result.ptr = '\0';
+        return static_cast<size_t>(result.ptr - buffer);
+    });
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    for (int kind = 0; kind < 2; kind++) {
+        std::string suffix = std::string("/") + inputNames[kind];
+        benchmark::RegisterBenchmark(("format/shortest" + suffix).c_str(), benchShortest, kind);
+        benchmark::RegisterBenchmark(("format/significant_10" + suffix).c_str(), benchSignificant, kind);
+        benchmark::RegisterBenchmark(("printf/%.17g" + suffix).c_str(), benchPrintfRoundTrip, kind);
+        benchmark::RegisterBenchmark(("printf/%.10g" + suffix).c_str(), benchPrintfSignificant, kind);
+        benchmark::RegisterBenchmark(("ostream/precision_17" + suffix).c_str(), benchStream, kind);
+        benchmark::RegisterBenchmark(("to_chars/shortest" + suffix).c_str(), benchToChars, kind);
+    }
+    return corpus::run(argc, argv, "benchmark_double_format.json");
+}
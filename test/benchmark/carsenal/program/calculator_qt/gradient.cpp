@@ -0,0 +1,114 @@
+// 梯度基准：同一表达式对 N 个变量求值与求全部偏导数的三种方式
+//   finite_difference  编译为字节码后按中心差分执行 2N+1 次（对照）
+//   dual               DualEvaluator 在优化后的 AST 上一次遍历
+//   symbolic           N 个偏导数式预先符号求导、折叠并编译，每次执行 N+1 个程序（相当于缓存命中后的开销）
+//
+// 用法: benchmark_gradient [Google Benchmark 参数]，结果默认写入 benchmark_gradient.json
+#include "corpus.h"
+#include "compiler.h"
+#include "derivative.h"
+#include "optimizer.h"
+#include "parser.h"
+#include "vm.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+
+// N 个变量首尾相连的目标函数：sum(sin(x_i) * x_{i+1} + exp(-x_i^2) + sqrt(x_i^2 + 1))
+std::string objective(size_t variables) {
+    std::string text;
+    for (size_t i = 0; i < variables; i++) {
+        std::string x = "x" + std::to_string(i);
+        std::string next = "x" + std::to_string((i + 1) % variables);
+        if (i != 0) {
+            text += " + ";
+        }
+        text += "sin(" + x + ") * " + next + " + exp(-" + x + "^2) + sqrt(" + x + "^2 + 1)";
+    }
+    return text;
+}
+
+std::vector<double> point(size_t variables) {
+    std::vector<double> values(variables);
+    for (size_t i = 0; i < variables; i++) {
+        values[i] = 0.1 + 0.05 * static_cast<double>(i);
+    }
+    return values;
+}
+
+void benchFiniteDifference(benchmark::State& state, size_t n) {
+    std::string text = objective(n);
+    AstArena arena;
+    NodeId root = Optimizer().optimize(arena, Parser(text, arena).parse());
+    Program program = Compiler::compile(arena, root);
+    VirtualMachine vm;
+    std::vector<double> values = point(n);
+    std::vector<double> gradient(n);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(vm.execute(program, values.data()));
+        for (size_t i = 0; i < n; i++) {
+            double x = values[i];
+            double h = 1e-6 * (x < 0 ? -x : x) + 1e-6;
+            values[i] = x + h;
+            double upper = vm.execute(program, values.data());
+            values[i] = x - h;
+            double lower = vm.execute(program, values.data());
+            values[i] = x;
+            gradient[i] = (upper - lower) / (2 * h);
+        }
+        benchmark::DoNotOptimize(gradient.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+void benchDual(benchmark::State& state, size_t n) {
+    std::string text = objective(n);
+    AstArena arena;
+    NodeId root = Optimizer().optimize(arena, Parser(text, arena).parse());
+    DualEvaluator dual;
+    std::vector<double> values = point(n);
+    std::vector<double> gradient(n);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(dual.evaluate(arena, root, values.data(), gradient.data()));
+        benchmark::DoNotOptimize(gradient.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+void benchSymbolic(benchmark::State& state, size_t n) {
+    std::string text = objective(n);
+    AstArena arena;
+    Optimizer optimizer;
+    NodeId root = Parser(text, arena).parse();
+    std::vector<Program> partials;
+    for (uint32_t slot = 0; slot < n; slot++) {
+        NodeId derivative = optimizer.optimize(arena, Differentiator::differentiate(arena, root, slot));
+        partials.push_back(Compiler::compile(arena, derivative));
+    }
+    Program program = Compiler::compile(arena, optimizer.optimize(arena, root));
+    VirtualMachine vm;
+    std::vector<double> values = point(n);
+    std::vector<double> gradient(n);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(vm.execute(program, values.data()));
+        for (size_t i = 0; i < n; i++) {
+            gradient[i] = vm.execute(partials[i], values.data());
+        }
+        benchmark::DoNotOptimize(gradient.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    for (size_t n : {2, 8, 32}) {
+        std::string suffix = "/" + std::to_string(n);
+        benchmark::RegisterBenchmark(("gradient/finite_difference" + suffix).c_str(), benchFiniteDifference, n);
+        benchmark::RegisterBenchmark(("gradient/dual" + suffix).c_str(), benchDual, n);
+        benchmark::RegisterBenchmark(("gradient/symbolic" + suffix).c_str(), benchSymbolic, n);
+    }
+    return corpus::run(argc, argv, "benchmark_gradient.json");
+}
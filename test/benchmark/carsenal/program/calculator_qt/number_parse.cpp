@@ -0,0 +1,119 @@
+// 数字解析基准：共享数字解析 parse_number 与 strtod、std::from_chars，以及旧 C 词法分析器的
+// 复制词素 + atof，输入为整数、短小数、17 位有效数字与科学记数法四类数字密集文本
+//
+// 用法: benchmark_number_parse [Google Benchmark 参数]，结果默认写入 benchmark_number_parse.json
+#include "corpus.h"
+#include "number_parse.h"
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr size_t VALUE_COUNT = 1 << 12;
+
+// 以空格分隔的数字文本；各函数逐个解析，累计字节与个数
+struct Input {
+    const char* name;
+    std::string text;
+};
+
+std::vector<Input> inputs() {
+    std::mt19937_64 random(42);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::string integers, decimals, full, scientific;
+    char buffer[64];
+    for (size_t i = 0; i < VALUE_COUNT; i++) {
+        double value = unit(random);
+        std::snprintf(buffer, sizeof(buffer), "%llu ", static_cast<unsigned long long>(random() % 1000000));
+        integers += buffer;
+        std::snprintf(buffer, sizeof(buffer), "%.3f ", value * 1000.0);
+        decimals += buffer;
+        std::snprintf(buffer, sizeof(buffer), "%.17g ", value);
+        full += buffer;
+        std::snprintf(buffer, sizeof(buffer), "%.6e ", std::ldexp(value, static_cast<int>(random() % 200) - 100));
+        scientific += buffer;
+    }
+    return {{"integers", integers}, {"decimals", decimals}, {"17_digits", full}, {"scientific", scientific}};
+}
+
+template <typename Parse>
+void run(benchmark::State& state, const std::string& text, Parse parse) {
+    const char* first = text.data();
+    const char* last = first + text.size();
+    size_t numbers = 0;
+    for (auto _ : state) {
+        double sum = 0.0;
+        for (const char* p = first; p < last; p++) {
+            p = parse(p, last, &sum);
+            numbers++;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.counters["numbers"] = benchmark::Counter(static_cast<double>(numbers), benchmark::Counter::kIsRate);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+}
+
+void benchParseNumber(benchmark::State& state, const std::string& text) {
+    run(state, text, [](const char* p, const char* last, double* sum) {
+        double value;
+        NumberResult result = parse_number(p, last, &value);
+        *sum += value;
+        return p + result.length;
+    });
+}
+
+// 文本以空格分隔且整体以 '\0' 结尾，strtod 不会越界
+void benchStrtod(benchmark::State& state, const std::string& text) {
+    run(state, text, [](const char* p, const char*, double* sum) {
+        char* end;
+        *sum += std::strtod(p, &end);
+        return static_cast<const char*>(end);
+    });
+}
+
+void benchFromChars(benchmark::State& state, const std::string& text) {
+    run(state, text, [](const char* p, const char* last, double* sum) {
+        double value = 0.0;
+        std::from_chars_result result = std::from_chars(p, last, value);
+        *sum += value;
+        return result.ptr;
+    });
+}
+
+// 旧 C 词法分析器的做法：扫描数字与小数点，复制到 malloc 的临时串后调用 atof
+void benchMallocAtof(benchmark::State& state, const std::string& text) {
+    run(state, text, [](const char* p, const char* last, double* sum) {
+        const char* end = p;
+        while (end < last && ((*end >= '0' && *end <= '9') || *end == '.' || *end == 'e' || *end == '-')) {
+            end++;
+        }
+        size_t length = static_cast<size_t>(end - p);
+        char* copy = static_cast<char*>(std::malloc(length + 1));
+        std::memcpy(copy, p, length);
+        copy[length] = '\0';
+        *sum += std::atof(copy);
+        std::free(copy);
+        return end;
+    });
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    static const std::vector<Input> cases = inputs();
+    for (const Input& input : cases) {
+        std::string suffix = std::string("/") + input.name;
+        benchmark::RegisterBenchmark(("parse_number" + suffix).c_str(), benchParseNumber, input.text);
+        benchmark::RegisterBenchmark(("strtod" + suffix).c_str(), benchStrtod, input.text);
+        benchmark::RegisterBenchmark(("from_chars" + suffix).c_str(), benchFromChars, input.text);
+        benchmark::RegisterBenchmark(("malloc_atof" + suffix).c_str(), benchMallocAtof, input.text);
+    }
+    return corpus::run(argc, argv, "benchmark_number_parse.json");
+}
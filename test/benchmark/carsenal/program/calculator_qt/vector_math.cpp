@@ -0,0 +1,94 @@
+// 向量数学核基准：sin/cos/tan/log/ln/exp/sqrt/abs 在各指令集级别、ULP1 与 ULP4 两档上的吞吐量，
+// 对照为逐元素调用数学库（libm 档）；另比较三档下列式求值含函数表达式的扫描
+//
+// 用法: benchmark_vector_math [Google Benchmark 参数]，结果默认写入 benchmark_vector_math.json
+#include "corpus.h"
+#include "column_evaluator.h"
+#include "compiler.h"
+#include "optimizer.h"
+#include "parser.h"
+#include "vector_math.h"
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// 一个列式求值行块的元素个数
+constexpr size_t VALUE_COUNT = ColumnEvaluator::BLOCK_SIZE;
+
+// 各函数常用区间上的均匀随机输入
+std::vector<double> inputsFor(MathFunction function) {
+    std::mt19937_64 random(42 + function);
+    double lo = -10.0;
+    double hi = 10.0;
+    if (function == MATH_LOG || function == MATH_LN || function == MATH_SQRT) {
+        lo = 1e-3;
+        hi = 1e6;
+    } else if (function == MATH_EXP) {
+        lo = -700.0;
+        hi = 700.0;
+    }
+    std::uniform_real_distribution<double> distribution(lo, hi);
+    std::vector<double> values(VALUE_COUNT);
+    for (double& value : values) {
+        value = distribution(random);
+    }
+    return values;
+}
+
+// 每次迭代把输入复制到工作区后原地求值；复制的开销对各档相同
+void benchKernel(benchmark::State& state, MathFunction function, SimdLevel level, MathAccuracy accuracy) {
+    const std::vector<double> inputs = inputsFor(function);
+    std::vector<double> values(inputs.size());
+    MathKernel kernel = mathKernels(level, accuracy).kernel[function];
+    for (auto _ : state) {
+        values = inputs;
+        kernel(values.data(), values.size());
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * inputs.size()));
+}
+
+// 扫描 x ∈ [0, 100)：阻尼振荡与对数项，函数调用占主要开销
+void benchSweep(benchmark::State& state, MathAccuracy accuracy) {
+    AstArena arena;
+    Parser parser("exp(-x / 50) * sin(3 * x) + cos(x) * ln(x + 1) + sqrt(x)", arena);
+    NodeId root = Optimizer().optimize(arena, parser.parse());
+    Program program = Compiler::compile(arena, root);
+    std::vector<double> xs(VALUE_COUNT * 8);
+    for (size_t i = 0; i < xs.size(); i++) {
+        xs[i] = 100.0 * static_cast<double>(i) / static_cast<double>(xs.size());
+    }
+    std::vector<double> out(xs.size());
+    const double* columns[] = {xs.data()};
+    ColumnEvaluator evaluator(detectSimdLevel(), accuracy);
+    for (auto _ : state) {
+        evaluator.evaluate(program, columns, xs.size(), out.data());
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * xs.size()));
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    for (int function = 0; function < MATH_FUNCTION_COUNT; function++) {
+        MathFunction f = static_cast<MathFunction>(function);
+        std::string prefix = std::string(mathFunctionName(f)) + "/";
+        benchmark::RegisterBenchmark((prefix + "libm").c_str(), benchKernel, f, SIMD_SCALAR, MATH_LIBM);
+        for (int level = SIMD_SCALAR; level <= detectSimdLevel(); level++) {
+            SimdLevel l = static_cast<SimdLevel>(level);
+            for (MathAccuracy accuracy : {MATH_ULP1, MATH_ULP4}) {
+                benchmark::RegisterBenchmark((prefix + mathAccuracyName(accuracy) + "/" + simdLevelName(l)).c_str(),
+                                             benchKernel, f, l, accuracy);
+            }
+        }
+    }
+    for (MathAccuracy accuracy : {MATH_LIBM, MATH_ULP1, MATH_ULP4}) {
+        benchmark::RegisterBenchmark((std::string("sweep/") + mathAccuracyName(accuracy)).c_str(), benchSweep,
+                                     accuracy);
+    }
+    return corpus::run(argc, argv, "benchmark_vector_math.json");
+}